@@ -0,0 +1,215 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/** @file reblock_accumulator.h
+ * @brief Define reblock_accumulator to estimate the errors of correlated samples
+ */
+#ifndef QMCPLUSPLUS_REBLOCK_ACCUMULATOR_H
+#define QMCPLUSPLUS_REBLOCK_ACCUMULATOR_H
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+/** accumulator of a weighted series with the streaming reblocking
+ *
+ * The samples are combined into the blocks of \f$2^k\f$ samples at every
+ * level k as they arrive, the blocking analysis of Flyvbjerg and Petersen
+ * in O(log N) memory. The error is taken at the level chosen by the criterion
+ * of Lee et al, PRE 83, 066706 (2011): the smallest block size B satisfying
+ * \f$B^3 > 2N(\sigma_B/\sigma_1)^4\f$.
+ */
+template<typename T>
+struct reblock_accumulator
+{
+  typedef T value_type;
+
+  ///sums of the blocks of a level
+  struct level_type
+  {
+    ///weighted sum and weight of the block waiting for its partner
+    T pendingWX, pendingW;
+    bool pending;
+    ///number of the complete blocks
+    long n;
+    ///sums over the complete blocks: W_b m_b, W_b, W_b^2, W_b^2 m_b, W_b^2 m_b^2
+    T sWX, sW, sW2, sW2M, sW2M2;
+    level_type()
+      : pendingWX(T()), pendingW(T()), pending(false), n(0)
+      , sWX(T()), sW(T()), sW2(T()), sW2M(T()), sW2M2(T())
+    {}
+  };
+
+  ///number of the samples
+  long NumSamples;
+  ///sums of w*x, w*x*x and w of all the samples
+  T SumWX, SumWX2, SumW;
+  ///levels of the blocks of 2^k samples
+  std::vector<level_type> Levels;
+
+  inline reblock_accumulator(): NumSamples(0), SumWX(T()), SumWX2(T()), SumW(T()) {}
+
+  /** add a sample
+   * @param x value
+   * @param w weight
+   */
+  inline void operator()(T x, T w=1)
+  {
+    ++NumSamples;
+    T wx=w*x;
+    SumWX+=wx;
+    SumWX2+=wx*x;
+    SumW+=w;
+    for(int k=0; ; ++k)
+    {
+      if(k==Levels.size())
+        Levels.push_back(level_type());
+      level_type& l(Levels[k]);
+      ++l.n;
+      if(w>0)
+      {
+        T m=wx/w;
+        T w2=w*w;
+        l.sWX+=wx;
+        l.sW+=w;
+        l.sW2+=w2;
+        l.sW2M+=w2*m;
+        l.sW2M2+=w2*m*m;
+      }
+      if(!l.pending)
+      {
+        l.pendingWX=wx;
+        l.pendingW=w;
+        l.pending=true;
+        return;
+      }
+      //a block of 2^(k+1) samples is complete
+      wx+=l.pendingWX;
+      w+=l.pendingW;
+      l.pending=false;
+    }
+  }
+
+  inline long count() const
+  {
+    return NumSamples;
+  }
+
+  inline T weight() const
+  {
+    return SumW;
+  }
+
+  inline T mean() const
+  {
+    return SumW>0? SumWX/SumW:T();
+  }
+
+  ///return the weighted variance of the samples
+  inline T variance() const
+  {
+    if(SumW<=0)
+      return T();
+    T m=SumWX/SumW;
+    return std::max(SumWX2/SumW-m*m,T());
+  }
+
+  ///return the number of the levels with at least two blocks
+  inline int levels() const
+  {
+    int k=0;
+    while(k<Levels.size() && Levels[k].n>1)
+      ++k;
+    return k;
+  }
+
+  ///return the error of the mean with the blocks of 2^k samples
+  inline T error(int k) const
+  {
+    const level_type& l(Levels[k]);
+    if(l.n<2 || l.sW<=0)
+      return T();
+    T m=l.sWX/l.sW;
+    T v=(l.sW2M2-2.0*m*l.sW2M+m*m*l.sW2)/(l.sW*l.sW);
+    return std::sqrt(std::max(v,T())*static_cast<T>(l.n)/static_cast<T>(l.n-1));
+  }
+
+  /** return the optimal level
+   * @param converged false, if no level satisfies the criterion
+   *
+   * When the series is too short, the level with the largest error of those
+   * having at least 32 blocks is used.
+   */
+  inline int optimal_level(bool& converged) const
+  {
+    converged=true;
+    const int nk=levels();
+    if(nk==0)
+      return 0;
+    const T e0=error(0);
+    if(e0<=0)
+      return 0;
+    for(int k=0; k<nk; ++k)
+    {
+      T r=error(k)/e0;
+      T b=static_cast<T>(1L<<k);
+      if(b*b*b>2.0*static_cast<T>(NumSamples)*r*r*r*r)
+        return k;
+    }
+    converged=false;
+    int kmax=0;
+    for(int k=1; k<nk && Levels[k].n>=32; ++k)
+      if(error(k)>error(kmax))
+        kmax=k;
+    return kmax;
+  }
+
+  ///return the error at the optimal level
+  inline T error() const
+  {
+    bool converged;
+    return levels()? error(optimal_level(converged)):T();
+  }
+
+  /** return the autocorrelation time in the unit of the samples
+   *
+   * \f$\kappa=(\sigma_B/\sigma_1)^2\f$ which is one for uncorrelated samples
+   */
+  inline T kappa() const
+  {
+    if(levels()==0)
+      return 1;
+    bool converged;
+    T e0=error(0);
+    if(e0<=0)
+      return 1;
+    T r=error(optimal_level(converged))/e0;
+    return r*r;
+  }
+
+  inline void clear()
+  {
+    NumSamples=0;
+    SumWX=SumWX2=SumW=T();
+    Levels.clear();
+  }
+};
+
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,172 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013- by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file ParticleBCondsSoA.h
+ * @brief boundary conditions on displacements stored as structure of arrays
+ *
+ * The displacements are stored as D rows of length stride,
+ * dr[d*stride+i] for the d-th component of the i-th displacement.
+ * The generic function falls back to DTD_BConds<T,D,SC>::apply_bc for each
+ * displacement. Overloads for the specific boundary conditions are written
+ * as simple loops over the components so that the compilers can vectorize them.
+ */
+#ifndef QMCPLUSPLUS_PARTICLE_BCONDS_SOA_H
+#define QMCPLUSPLUS_PARTICLE_BCONDS_SOA_H
+
+#include <Lattice/ParticleBConds.h>
+
+namespace qmcplusplus
+{
+
+/** apply BC on the SoA displacements and evaluate the distances
+ * @param bc boundary condition
+ * @param dr displacements, in and out
+ * @param stride distance between the components in dr
+ * @param r distances
+ * @param n number of displacements
+ */
+template<typename T, unsigned D, int SC>
+inline void apply_bc_soa(const DTD_BConds<T,D,SC>& bc, T* restrict dr, int stride, T* restrict r, int n)
+{
+  TinyVector<T,D> displ;
+  for(int i=0; i<n; ++i)
+  {
+    for(int d=0; d<D; ++d)
+      displ[d]=dr[d*stride+i];
+    r[i]=std::sqrt(bc.apply_bc(displ));
+    for(int d=0; d<D; ++d)
+      dr[d*stride+i]=displ[d];
+  }
+}
+
+/** open boundary conditions: only the distances are computed */
+template<typename T, unsigned D>
+inline void apply_bc_soa(const DTD_BConds<T,D,SUPERCELL_OPEN>& bc, T* restrict dr, int stride, T* restrict r, int n)
+{
+  for(int i=0; i<n; ++i)
+    r[i]=dr[i]*dr[i];
+  for(int d=1; d<D; ++d)
+  {
+    const T* restrict x=dr+d*stride;
+    for(int i=0; i<n; ++i)
+      r[i]+=x[i]*x[i];
+  }
+  for(int i=0; i<n; ++i)
+    r[i]=std::sqrt(r[i]);
+}
+
+#if OHMMS_DIM == 3
+/** orthorhombic cell with the periodic boundary conditions in three dimensions */
+template<typename T>
+inline void apply_bc_soa(const DTD_BConds<T,3,PPPO>& bc, T* restrict dr, int stride, T* restrict r, int n)
+{
+  T* restrict x=dr;
+  T* restrict y=dr+stride;
+  T* restrict z=dr+2*stride;
+  for(int i=0; i<n; ++i)
+  {
+    const T sx=x[i]*bc.Linv0;
+    const T sy=y[i]*bc.Linv1;
+    const T sz=z[i]*bc.Linv2;
+    x[i]=bc.L0*(sx-round(sx));
+    y[i]=bc.L1*(sy-round(sy));
+    z[i]=bc.L2*(sz-round(sz));
+    r[i]=std::sqrt(x[i]*x[i]+y[i]*y[i]+z[i]*z[i]);
+  }
+}
+
+/** general cell with the periodic boundary conditions in three dimensions
+ *
+ * Same as DTD_BConds<T,3,PPPG>::apply_bc: the displacement is brought into the
+ * cell of the reduced basis and the image is selected among the eight corners.
+ * The selection is done with the conditional assignments, without a branch.
+ */
+template<typename T>
+inline void apply_bc_soa(const DTD_BConds<T,3,PPPG>& bc, T* restrict dr, int stride, T* restrict r, int n)
+{
+  T* restrict x=dr;
+  T* restrict y=dr+stride;
+  T* restrict z=dr+2*stride;
+  const T r00=bc.rb[0][0], r01=bc.rb[0][1], r02=bc.rb[0][2];
+  const T r10=bc.rb[1][0], r11=bc.rb[1][1], r12=bc.rb[1][2];
+  const T r20=bc.rb[2][0], r21=bc.rb[2][1], r22=bc.rb[2][2];
+  T cx[8], cy[8], cz[8];
+  for(int c=0; c<8; ++c)
+  {
+    cx[c]=bc.corners[c][0];
+    cy[c]=bc.corners[c][1];
+    cz[c]=bc.corners[c][2];
+  }
+  for(int i=0; i<n; ++i)
+  {
+    const T ar0=-std::floor(x[i]*bc.g00+y[i]*bc.g10+z[i]*bc.g20);
+    const T ar1=-std::floor(x[i]*bc.g01+y[i]*bc.g11+z[i]*bc.g21);
+    const T ar2=-std::floor(x[i]*bc.g02+y[i]*bc.g12+z[i]*bc.g22);
+    const T dx=x[i]+ar0*r00+ar1*r10+ar2*r20;
+    const T dy=y[i]+ar0*r01+ar1*r11+ar2*r21;
+    const T dz=z[i]+ar0*r02+ar1*r12+ar2*r22;
+    T rmin2=dx*dx+dy*dy+dz*dz;
+    T sx=0.0, sy=0.0, sz=0.0;
+    for(int c=1; c<8; ++c)
+    {
+      const T tx=dx+cx[c];
+      const T ty=dy+cy[c];
+      const T tz=dz+cz[c];
+      const T r2=tx*tx+ty*ty+tz*tz;
+      const bool smaller=(r2<rmin2);
+      rmin2=smaller?r2:rmin2;
+      sx=smaller?cx[c]:sx;
+      sy=smaller?cy[c]:sy;
+      sz=smaller?cz[c]:sz;
+    }
+    x[i]=dx+sx;
+    y[i]=dy+sy;
+    z[i]=dz+sz;
+    r[i]=std::sqrt(rmin2);
+  }
+}
+#endif
+
+/** compute the displacements of a position to a set of sources and apply BC
+ * @param bc boundary condition
+ * @param rnew position
+ * @param pos source positions in SoA, pos[d*stride+i]
+ * @param dr displacements rnew-pos, dr[d*stride+i]
+ * @param stride distance between the components in pos and dr
+ * @param r distances
+ * @param n number of sources
+ */
+template<typename T, unsigned D, int SC>
+inline void compute_displ_soa(const DTD_BConds<T,D,SC>& bc, const TinyVector<T,D>& rnew
+                              , const T* restrict pos, T* restrict dr, int stride, T* restrict r, int n)
+{
+  for(int d=0; d<D; ++d)
+  {
+    const T x=rnew[d];
+    const T* restrict src=pos+d*stride;
+    T* restrict dx=dr+d*stride;
+    for(int i=0; i<n; ++i)
+      dx[i]=x-src[i];
+  }
+  apply_bc_soa(bc,dr,stride,r,n);
+}
+
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -25,6 +25,7 @@
 #include "Numerics/OneDimGridFunctor.h"
 #include "Numerics/OneDimCubicSpline.h"
 #include "Numerics/OneDimLinearSpline.h"
+#include "LongRange/SRCoulombSpline.h"
 
 namespace qmcplusplus
 {
@@ -37,6 +38,7 @@ struct LRCoulombSingleton
   typedef LinearGrid<RealType>                               GridType;
   //    typedef OneDimLinearSpline<RealType>                 RadFunctorType;
   typedef OneDimCubicSpline<RealType>                       RadFunctorType;
+  typedef SRCoulombSpline<RealType>                          SRSplineType;
 
   static LRHandlerType* CoulombHandler;
 
@@ -0,0 +1,145 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/** @file SRCoulombSpline.h
+ * @brief Declaration of SRCoulombSpline, the short-range kernel of the Coulomb sums
+ */
+#ifndef QMCPLUSPLUS_SR_COULOMB_SPLINE_H
+#define QMCPLUSPLUS_SR_COULOMB_SPLINE_H
+#include "Numerics/CubicBsplineGrid.h"
+#include <vector>
+
+namespace qmcplusplus
+{
+
+/** @ingroup longrange
+ * \brief uniform cubic B-spline of \f$rV_s(r)\f$ for the short-range pair sums
+ *
+ * The control points are solved from the values of a OneDimCubicSpline on a
+ * linear grid with the same first derivatives at the ends. Both are the
+ * clamped cubic interpolant of the same data, so this is a drop-in replacement
+ * of RadFunctorType::splint for \f$r<\f$ Rcut.
+ *
+ * The functions on a row of distances have no branch in the loop body:
+ * a distance beyond Rcut or a zero distance of a self pair is replaced by Rcut
+ * and masked, so that the loops are vectorized by the compilers.
+ */
+template<typename T>
+struct SRCoulombSpline
+{
+  ///start of the grid
+  T Rmin;
+  ///cutoff radius
+  T Rcut;
+  ///inverse of the grid spacing
+  T DeltaInv;
+  ///number of the grid intervals
+  int NumIntervals;
+  ///control points, P.size()=NumIntervals+3
+  std::vector<T> P;
+
+  inline SRCoulombSpline(): Rmin(0.0), Rcut(0.0), DeltaInv(0.0), NumIntervals(0) {}
+
+  /** initialize with a cubic spline on a linear grid
+   * @param f a OneDimCubicSpline with the first derivatives at the ends
+   */
+  template<typename FT>
+  void init(const FT& f)
+  {
+    int ng=f.m_Y.size();
+    std::vector<double> data(ng), p;
+    for(int i=0; i<ng; ++i)
+      data[i]=f.m_Y[i];
+    CubicBsplineGrid<double,LINEAR_1DGRID,FIRSTDERIV_CONSTRAINTS> agrid;
+    agrid.spline(f.r_min,f.r_max,f.first_deriv,f.last_deriv,data,p);
+    Rmin=f.r_min;
+    Rcut=f.r_max;
+    DeltaInv=agrid.GridDeltaInv;
+    NumIntervals=ng-1;
+    P.assign(p.begin(),p.end());
+  }
+
+  /** return \f$rV_s(r)\f$, zero for r>=Rcut
+   */
+  inline T splint(T r) const
+  {
+    if(r>=Rcut)
+      return 0.0;
+    T x=(r-Rmin)*DeltaInv;
+    int i=static_cast<int>(x);
+    i=(i<NumIntervals)?i:NumIntervals-1;
+    return interpolate(x-i,&P[i]);
+  }
+
+  /** evaluate \f$V_s(r_j)=rV_s(r_j)/r_j\f$ for a row of distances
+   * @param n number of distances
+   * @param r distances
+   * @param v \f$V_s\f$, zero for \f$r_j\ge\f$ Rcut or \f$r_j=0\f$
+   */
+  inline void evaluateV(int n, const T* restrict r, T* restrict v) const
+  {
+    const T* restrict p=&P[0];
+    const int imax=NumIntervals-1;
+    for(int j=0; j<n; ++j)
+    {
+      const bool inside=(r[j]<Rcut && r[j]>0.0);
+      const T rs=inside?r[j]:Rcut;
+      const T x=(rs-Rmin)*DeltaInv;
+      int i=static_cast<int>(x);
+      i=(i<imax)?i:imax;
+      v[j]=inside?interpolate(x-i,p+i)/rs:0.0;
+    }
+  }
+
+  /** return \f$\sum_j q_j V_s(r_j)\f$ over a row of distances
+   * @param n number of distances
+   * @param r distances
+   * @param q charges
+   */
+  inline T sumV(int n, const T* restrict r, const T* restrict q) const
+  {
+    const T* restrict p=&P[0];
+    const int imax=NumIntervals-1;
+    T res=0.0;
+    for(int j=0; j<n; ++j)
+    {
+      const bool inside=(r[j]<Rcut && r[j]>0.0);
+      const T rs=inside?r[j]:Rcut;
+      const T x=(rs-Rmin)*DeltaInv;
+      int i=static_cast<int>(x);
+      i=(i<imax)?i:imax;
+      res+=inside?q[j]*interpolate(x-i,p+i)/rs:0.0;
+    }
+    return res;
+  }
+
+private:
+  ///value of the cubic B-spline at t in [0,1] of the interval starting at p
+  inline T interpolate(T t, const T* restrict p) const
+  {
+    const T onesixth=1.0/6.0;
+    return onesixth*(((( -p[0]+3.0*p[1]-3.0*p[2]+p[3])*t
+                       +(3.0*p[0]-6.0*p[1]+3.0*p[2]))*t
+                      +(-3.0*p[0]+3.0*p[2]))*t
+                     +(p[0]+4.0*p[1]+p[2]));
+  }
+};
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
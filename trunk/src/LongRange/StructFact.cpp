@@ -78,6 +78,12 @@ void StructFact::resize()
   //int maxdim = std::max(KLists.mmax[0],std::max(KLists.mmax[1],KLists.mmax[2]));
   int maxdim=KLists.mmax[DIM];
   C.resize(DIM,2*maxdim+1);
+  C_r.resize(DIM,2*maxdim+1);
+  C_i.resize(DIM,2*maxdim+1);
+  KIndex.resize(DIM,KLists.numk);
+  for(int idim=0; idim<DIM; ++idim)
+    for(int ki=0; ki<KLists.numk; ++ki)
+      KIndex(idim,ki)=KLists.kpts[ki][idim]+maxdim;
 }
 
 //void
@@ -132,53 +138,6 @@ void
 StructFact::FillRhok()
 {
   int npart = PtclRef.getTotalNum();
-#if defined(QMC_SK_USE_RECURSIVE)
-  rhok=0.0;
-  for(int i=0; i<npart; i++)
-  {
-    //operate with a reduced positon
-    PosType tau_red=PtclRef.Lattice.toUnit(PtclRef.R[i]);
-    for(int idim=0; idim<DIM; idim++)
-    {
-      RealType phi=TWOPI*tau_red[idim];
-      ComplexType ctemp(std::cos(phi),std::sin(phi));
-      C(idim,KLists.mmax[idim])=1.0;
-      for(int n=1; n<=KLists.mmax[idim]; n++)
-      {
-        C(idim,KLists.mmax[idim]+n) = ctemp*C(idim,KLists.mmax[idim]+n-1);
-        C(idim,KLists.mmax[idim]-n) = conj(C(idim,KLists.mmax[idim]+n));
-      }
-    }
-    ComplexType* restrict eikr_ref=eikr[i];
-    for(int ki=0; ki<KLists.numk; ki++)
-    {
-      eikr_ref[ki]=C(0,KLists.kpts[ki][0]+KLists.mmax[0]);
-      for(idim=1; idim<DIM; id++)
-        eikr_ref[ki] *= C(idim,KLists.kpts[ki][idim]+KLists.mmax[idim]);
-    }
-    accumulate_elements(eikr_ref,eikr_ref+KLists.numk,rhok[PtclRef.GroupID[i]]);
-    //valid version only with orthorohmbic cell, generalized to any cell above
-    //  for(int idim=0; idim<3; idim++){
-    //    complex<double> Ctemp;
-    //    //start the recursion with the 111 vector.
-    //    double phi = (PtclRef.R[i])[idim] * k111[idim];
-    //    Ctemp = complex<double>(std::cos(phi), std::sin(phi));
-    //    C(idim,KLists.mmax[idim]) = 1.0; // K=0 term
-    //    //Recursively generate all Cs.
-    //    for(int n=1; n<=KLists.mmax[idim]; n++){
-    //      C(idim,KLists.mmax[idim]+n) = Ctemp*C(idim,KLists.mmax[idim]+n-1);
-    //      C(idim,KLists.mmax[idim]-n) = conj(C(idim,KLists.mmax[idim]+n));
-    //    }
-    //  }
-    //Now add the contribution to Rhok for this particle
-    //for(int ki=0; ki<KLists.numk; ki++){
-    //  eikr(i,ki) = ComplexType(1.0,0.0); //Initialize
-    //  for(int idim=0; idim<3; idim++)
-    //    eikr(i,ki) *= C(idim,KLists.kpts[ki][idim]+KLists.mmax[idim]);
-    //  rhok(PtclRef.GroupID[i],ki) += eikr(i,ki);
-    //}
-  } //End particle loop
-#else
 #if defined(USE_REAL_STRUCT_FACTOR)
   rhok_r=0.0;
   rhok_i=0.0;
@@ -207,21 +166,62 @@ StructFact::FillRhok()
   rhok=0.0;
   for(int i=0; i<npart; i++)
   {
-    PosType pos(PtclRef.R[i]);
-    RealType s,c;//get sin and cos
     ComplexType* restrict eikr_ref=eikr[i];
     ComplexType* restrict rhok_ref=rhok[PtclRef.GroupID[i]];
+    evalPhases(PtclRef.R[i],eikr_ref);
     for(int ki=0; ki<KLists.numk; ki++)
-    {
-      //RealType phi(dot(KLists.kpts_cart[ki],pos));
-      //eikr_ref[ki] = ComplexType(std::cos(phi),std::sin(phi));
-      sincos(dot(KLists.kpts_cart[ki],pos),&s,&c);
-      eikr_ref[ki]=ComplexType(c,s);
       rhok_ref[ki]+= eikr_ref[ki];
-    }
   }
 #endif
-#endif
+}
+
+/** evaluate \f$e^{i{\bf k}\cdot{\bf r}}\f$ for all the k-vectors
+ * @param pos Cartesian position
+ * @param eikr_ptr starting address of the numk phase factors
+ *
+ * With the reduced position u and the integer kpts n, \f${\bf k}\cdot{\bf r}=2\pi\sum_d n_d u_d\f$.
+ * The phase factors per dimension, \f$e^{i2\pi n u_d}\f$ with \f$|n|\le\f$ mmax[d],
+ * are generated by the recurrence from one sincos and stored in C_r and C_i.
+ * Each phase factor is then a product of DIM complex numbers in the real arithmetic.
+ */
+void StructFact::evalPhases(const PosType& pos, ComplexType* restrict eikr_ptr)
+{
+  const int maxdim=KLists.mmax[DIM];
+  PosType tau_red(PtclRef.Lattice.toUnit(pos));
+  for(int idim=0; idim<DIM; ++idim)
+  {
+    RealType s,c;
+    sincos(TWOPI*tau_red[idim],&s,&c);
+    RealType* restrict cr=C_r[idim]+maxdim;
+    RealType* restrict ci=C_i[idim]+maxdim;
+    cr[0]=1.0;
+    ci[0]=0.0;
+    for(int n=1; n<=KLists.mmax[idim]; ++n)
+    {
+      cr[n]=c*cr[n-1]-s*ci[n-1];
+      ci[n]=s*cr[n-1]+c*ci[n-1];
+      cr[-n]=cr[n];
+      ci[-n]=-ci[n];
+    }
+  }
+  const int nk=KLists.numk;
+  const int* restrict k0=KIndex[0];
+  const RealType* restrict c0r=C_r[0];
+  const RealType* restrict c0i=C_i[0];
+  for(int ki=0; ki<nk; ++ki)
+    eikr_ptr[ki]=ComplexType(c0r[k0[ki]],c0i[k0[ki]]);
+  for(int idim=1; idim<DIM; ++idim)
+  {
+    const int* restrict kd=KIndex[idim];
+    const RealType* restrict cdr=C_r[idim];
+    const RealType* restrict cdi=C_i[idim];
+    for(int ki=0; ki<nk; ++ki)
+    {
+      const RealType ar=eikr_ptr[ki].real(), ai=eikr_ptr[ki].imag();
+      const RealType br=cdr[kd[ki]], bi=cdi[kd[ki]];
+      eikr_ptr[ki]=ComplexType(ar*br-ai*bi,ar*bi+ai*br);
+    }
+  }
 }
 
 
@@ -299,12 +299,7 @@ void StructFact::makeMove(int active, const PosType& pos)
     phiV[ki]=dot(KLists.kpts_cart[ki],pos);
   eval_e2iphi(KLists.numk, phiV.data(), eikr_r_temp.data(), eikr_i_temp.data());
 #else
-  RealType s,c;//get sin and cos
-  for(int ki=0; ki<KLists.numk; ++ki)
-  {
-    sincos(dot(KLists.kpts_cart[ki],pos),&s,&c);
-    eikr_temp[ki]=ComplexType(c,s);
-  }
+  evalPhases(pos,eikr_temp.data());
 #endif
 }
 
@@ -51,7 +51,11 @@ public:
   Matrix<ComplexType> rhok;
   ///eikr[particle-index][K]
   Matrix<ComplexType> eikr;
-  ///eikr[K] for a proposed move
+  /** eikr[K] for a proposed move
+   *
+   * Evaluated once by makeMove and shared by all the long-range
+   * objects of the particle set.
+   */
   Vector<ComplexType> eikr_temp;
 #endif
   /** Constructor - copy ParticleSet and init. k-shells
@@ -163,6 +167,12 @@ public:
 private:
   ///data for recursive evaluation for a given position
   Matrix<ComplexType> C;
+  ///real and imaginary parts of the phase factors per dimension, [DIM][2*mmax[DIM]+1]
+  Matrix<RealType> C_r, C_i;
+  ///KIndex(d,k) index of kpts[k][d] in C_r[d] and C_i[d]
+  Matrix<int> KIndex;
+  ///evaluate eikr for all the k-vectors at pos using the recurrence per dimension
+  void evalPhases(const PosType& pos, ComplexType* restrict eikr_ptr);
   ///Compute all rhok elements from the start
   void FillRhok();
   ///Smart update of rhok for 1-particle move. Simply supply old+new position
@@ -123,6 +123,19 @@ Communicate::Communicate(const Communicate& comm, const std::vector<int>& jobs)
 }
 
 
+Communicate::Communicate(const Communicate& comm, int color, int key)
+{
+  MPI_Comm row;
+  MPI_Comm_split(comm.getMPI(),color,key,&row);
+  myComm=OOMPI_Intra_comm(row);
+  myMPI = myComm.Get_mpi();
+  d_mycontext=myComm.Rank();
+  d_ncontexts=myComm.Size();
+  d_groupid=color;
+  //count the groups by their first tasks
+  int first=(d_mycontext==0);
+  MPI_Allreduce(&first,&d_ngroups,1,MPI_INT,MPI_SUM,comm.getMPI());
+}
 
 //================================================================
 // Implements Communicate with OOMPI library
@@ -230,6 +243,11 @@ Communicate::Communicate(const Communicate& comm, const std::vector<int>& jobs)
 {
 }
 
+Communicate::Communicate(const Communicate& comm, int color, int key)
+  : myMPI(0), d_mycontext(0), d_ncontexts(1), d_groupid(0)
+{
+}
+
 #endif // !HAVE_OOMPI
 /***************************************************************************
  * $RCSfile$   $Author$
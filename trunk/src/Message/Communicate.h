@@ -82,6 +82,13 @@ public:
    */
   Communicate(const Communicate& comm, const std::vector<int>& jobs);
 
+  /** constructor
+   * @param comm a communicator which will be split into groups
+   * @param color tasks with the same color belong to a group
+   * @param key order of the tasks within a group
+   */
+  Communicate(const Communicate& comm, int color, int key);
+
   /**destructor
    * Call proper finalization of Communication library
    */
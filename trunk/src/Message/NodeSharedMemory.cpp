@@ -0,0 +1,182 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013- by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+#include <Configuration.h>
+#include "Message/NodeSharedMemory.h"
+#include "Message/CommOperators.h"
+#include <sstream>
+#include <cstring>
+#if defined(HAVE_MPI)
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <signal.h>
+#include <cstdlib>
+#endif
+
+namespace qmcplusplus
+{
+
+#if defined(HAVE_MPI)
+///maximum number of the read-only segments checked by readonly_segv
+const int MaxReadOnlySegments=256;
+///first bytes and sizes of the segments mapped read-only by this task
+static char* ReadOnlyFirst[MaxReadOnlySegments];
+static size_t ReadOnlySize[MaxReadOnlySegments];
+static int NumReadOnlySegments=0;
+///handler of SIGSEGV before readonly_segv is installed
+static struct sigaction PreviousSegv;
+
+/** SIGSEGV handler which reports a write to a read-only segment
+ *
+ * A fault outside the segments restores the previous handler, which handles
+ * the fault when the instruction is executed again.
+ */
+static void readonly_segv(int sig, siginfo_t* info, void* context)
+{
+  char* addr=static_cast<char*>(info->si_addr);
+  for(int i=0; i<NumReadOnlySegments; ++i)
+    if(addr>=ReadOnlyFirst[i] && addr<ReadOnlyFirst[i]+ReadOnlySize[i])
+    {
+      const char msg[]="NodeSharedMemory: a task other than the node leader wrote to"
+                       " the read-only shared data. Only the node leader may fill them.\n";
+      if(write(STDERR_FILENO,msg,sizeof(msg)-1)<0)
+        _exit(EXIT_FAILURE);
+      abort();
+    }
+  sigaction(SIGSEGV,&PreviousSegv,0);
+}
+
+/** record a segment mapped read-only, install readonly_segv with the first one */
+static void add_readonly_segment(void* ptr, size_t nbytes)
+{
+  if(NumReadOnlySegments==MaxReadOnlySegments)
+    return;
+  if(NumReadOnlySegments==0)
+  {
+    struct sigaction sa;
+    std::memset(&sa,0,sizeof(sa));
+    sa.sa_sigaction=readonly_segv;
+    sa.sa_flags=SA_SIGINFO;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGSEGV,&sa,&PreviousSegv);
+  }
+  ReadOnlySize[NumReadOnlySegments]=nbytes;
+  ReadOnlyFirst[NumReadOnlySegments++]=static_cast<char*>(ptr);
+}
+#endif
+
+NodeSharedMemory::NodeSharedMemory(Communicate* comm)
+  : NodeComm(0), LeaderComm(0), SegmentCount(0)
+{
+#if defined(HAVE_MPI)
+  //group the tasks by the processor name
+  char name[MPI_MAX_PROCESSOR_NAME];
+  std::memset(name,0,MPI_MAX_PROCESSOR_NAME);
+  int len=0;
+  MPI_Get_processor_name(name,&len);
+  std::vector<char> names(MPI_MAX_PROCESSOR_NAME*comm->size());
+  MPI_Allgather(name,MPI_MAX_PROCESSOR_NAME,MPI_CHAR
+                ,&names[0],MPI_MAX_PROCESSOR_NAME,MPI_CHAR,comm->getMPI());
+  int color=0;
+  while(std::strncmp(&names[color*MPI_MAX_PROCESSOR_NAME],name,MPI_MAX_PROCESSOR_NAME))
+    ++color;
+  NodeComm=new Communicate(*comm,color,comm->rank());
+  LeaderComm=new Communicate(*comm,NodeComm->rank()==0?0:1,comm->rank());
+  //the leader names the segments
+  static int object_id=0;
+  int ids[2]= {static_cast<int>(getpid()),object_id++};
+  NodeComm->bcast(ids,2);
+  std::ostringstream o;
+  o << "/qmcpack." << ids[0] << "." << ids[1];
+  BaseName=o.str();
+#else
+  NodeComm=new Communicate(*comm,0,0);
+  LeaderComm=new Communicate(*comm,0,0);
+#endif
+}
+
+NodeSharedMemory::~NodeSharedMemory()
+{
+  delete NodeComm;
+  delete LeaderComm;
+}
+
+void* NodeSharedMemory::allocate(size_t nbytes, int owner)
+{
+  if(!isShared() || nbytes==0)
+    return 0;
+#if defined(HAVE_MPI)
+  std::ostringstream o;
+  o << BaseName << "." << SegmentCount++;
+  std::string sname=o.str();
+  const bool creator=(NodeComm->rank()==owner);
+  void* ptr=MAP_FAILED;
+  int created=0;
+  if(creator)
+  {
+    int fd=shm_open(sname.c_str(),O_CREAT|O_EXCL|O_RDWR,S_IRUSR|S_IWUSR);
+    if(fd>=0)
+    {
+      if(ftruncate(fd,static_cast<off_t>(nbytes))==0)
+        ptr=mmap(0,nbytes,PROT_READ|PROT_WRITE,MAP_SHARED,fd,0);
+      close(fd);
+      if(ptr==MAP_FAILED)
+        shm_unlink(sname.c_str());
+    }
+    created=(ptr!=MAP_FAILED);
+  }
+  MPI_Bcast(&created,1,MPI_INT,owner,NodeComm->getMPI());
+  if(!created)
+  {
+    app_warning() << "  NodeSharedMemory cannot create a segment of " << nbytes
+                  << " bytes. Using private memory." << endl;
+    return 0;
+  }
+  if(!creator)
+  {
+    int fd=shm_open(sname.c_str(),O_RDONLY,0);
+    if(fd>=0)
+    {
+      ptr=mmap(0,nbytes,PROT_READ,MAP_SHARED,fd,0);
+      close(fd);
+    }
+    if(ptr==MAP_FAILED)
+    {
+      APP_ABORT("NodeSharedMemory::allocate failed to map "+sname);
+    }
+    add_readonly_segment(ptr,nbytes);
+  }
+  NodeComm->barrier();
+  if(creator)
+    shm_unlink(sname.c_str());
+  return ptr;
+#else
+  return 0;
+#endif
+}
+
+void NodeSharedMemory::fence()
+{
+  NodeComm->barrier();
+}
+}
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
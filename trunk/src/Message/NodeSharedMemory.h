@@ -0,0 +1,94 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013- by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/** @file NodeSharedMemory.h
+ * @brief declaration of NodeSharedMemory
+ */
+#ifndef QMCPLUSPLUS_NODE_SHARED_MEMORY_H
+#define QMCPLUSPLUS_NODE_SHARED_MEMORY_H
+#include "Message/Communicate.h"
+#include <vector>
+#include <string>
+
+namespace qmcplusplus
+{
+
+/** node-level shared memory for large read-only data
+ *
+ * The tasks of a communicator are grouped by the processor name.
+ * The owner of a segment, by default the node leader with the node rank 0,
+ * creates a POSIX shared-memory segment and maps it for writing. The other
+ * tasks on the node map the same segment read-only. The owner fills the data
+ * and calls fence() with the other tasks before any of them reads it. A write
+ * by another task aborts the run with a message instead of a bare SIGSEGV.
+ *
+ * The segments are unlinked once mapped, so that they are released
+ * when the tasks exit. They are never unmapped because the data are owned
+ * by the objects, e.g. spline tables, for the lifetime of a run.
+ */
+class NodeSharedMemory
+{
+public:
+
+  ///communicator of the tasks on a node
+  Communicate* NodeComm;
+  ///communicator of the node leaders, meaningful only on the leaders
+  Communicate* LeaderComm;
+
+  /** constructor
+   * @param comm communicator to be split by the node
+   */
+  NodeSharedMemory(Communicate* comm);
+
+  ~NodeSharedMemory();
+
+  ///return true, if this task fills the shared data
+  inline bool isLeader() const
+  {
+    return NodeComm->rank()==0;
+  }
+
+  ///return true, if more than one task is on the node
+  inline bool isShared() const
+  {
+    return NodeComm->size()>1;
+  }
+
+  /** allocate a segment on the node, collective over NodeComm
+   * @param nbytes size in bytes
+   * @param owner rank in NodeComm of the task that fills the data
+   * @return the address, writable on the owner and read-only on the others
+   *
+   * Returns 0 on all the tasks of the node if a segment cannot be created.
+   * The caller then allocates private memory as usual.
+   */
+  void* allocate(size_t nbytes, int owner=0);
+
+  ///synchronize the tasks on the node after the leader has filled the data
+  void fence();
+
+private:
+  ///number of segments created by this object
+  int SegmentCount;
+  ///name of this object shared by the tasks of a node
+  std::string BaseName;
+};
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
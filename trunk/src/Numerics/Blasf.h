@@ -45,8 +45,12 @@ using namespace std;
 #define dsymm  dsymm_
 #define dgemm  dgemm_
 #define zgemm  zgemm_
+#define sgemm  sgemm_
+#define cgemm  cgemm_
 #define dgemv  dgemv_
 #define zgemv  zgemv_
+#define sgemv  sgemv_
+#define cgemv  cgemv_
 #define dsyr2k dsyr2k_
 #define dgetrf dgetrf_
 #define dgetri dgetri_
@@ -59,6 +63,8 @@ using namespace std;
 #define dggev dggev_
 #define dger dger_
 #define zgeru zgeru_
+#define sger sger_
+#define cgeru cgeru_
 
 #define dgeqrf dgeqrf_
 #define dormqr dormqr_
@@ -145,6 +151,16 @@ extern "C" {
              const complex<double>&, const complex<double>*, const int&, const complex<double>*, const int&,
              const complex<double>&, complex<double>*, const int&);
 
+  void sgemm(const char&, const char&,
+             const int&, const int&, const int&,
+             const float&, const float*, const int&, const float*, const int&,
+             const float&, float*, const int&);
+
+  void cgemm(const char&, const char&,
+             const int&, const int&, const int&,
+             const complex<float>&, const complex<float>*, const int&, const complex<float>*, const int&,
+             const complex<float>&, complex<float>*, const int&);
+
   void dgemv(const char& trans, const int& nr, const int& nc,
              const double& alpha, const double* amat, const int& lda,
              const double* bv, const int& incx,
@@ -155,6 +171,16 @@ extern "C" {
              const complex<double>* bv, const int& incx,
              const complex<double>& beta, complex<double>* cv, const int& incy);
 
+  void sgemv(const char& trans, const int& nr, const int& nc,
+             const float& alpha, const float* amat, const int& lda,
+             const float* bv, const int& incx,
+             const float& beta, float* cv, const int& incy);
+
+  void cgemv(const char& trans, const int& nr, const int& nc,
+             const complex<float>& alpha, const complex<float>* amat, const int& lda,
+             const complex<float>* bv, const int& incx,
+             const complex<float>& beta, complex<float>* cv, const int& incy);
+
   void dsyrk(const char&, const char&, const int&, const int&,
              const double&, const double*, const int&,
              const double&, double*,const int&);
@@ -196,6 +222,14 @@ extern "C" {
              , const complex<double>* x, const int* incx, const complex<double>* y, const int* incy
              , complex<double>* a, const int* lda);
 
+  void sger(const int* m, const int* n, const float* alpha
+            , const float* x, const int* incx, const float* y, const int* incy
+            , float* a, const int* lda);
+
+  void cgeru(const int* m, const int* n, const complex<float>* alpha
+             , const complex<float>* x, const int* incx, const complex<float>* y, const int* incy
+             , complex<float>* a, const int* lda);
+
   void dgeqrf( const int *M, const int *N, double *A, const int *LDA, double *TAU, double *WORK, const int *LWORK, int *INFO );
 
   void dormqr( const char *SIDE, const char *TRANS, const int *M, const int *N, const int *K, const double *A, const int * LDA, const double *TAU, double *C, const int *LDC, double *WORK, int *LWORK, int *INFO );
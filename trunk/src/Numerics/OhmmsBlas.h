@@ -160,6 +160,24 @@ struct BLAS
     zgemv(trans_in, n, m, alpha, amat, lda, x, incx, beta, y, incy);
   }
 
+  inline static
+  void gemv(char trans_in, int n, int m
+            ,float alpha, const float* restrict amat, int lda
+            , const float* x, int incx, float beta
+            , float* y, int incy)
+  {
+    sgemv(trans_in, n, m, alpha, amat, lda, x, incx, beta, y, incy);
+  }
+
+  inline static
+  void gemv(char trans_in, int n, int m
+            , const complex<float>& alpha, const complex<float>* restrict amat, int lda
+            , const complex<float>* restrict x, int incx, const complex<float>& beta
+            , complex<float>* y, int incy)
+  {
+    cgemv(trans_in, n, m, alpha, amat, lda, x, incx, beta, y, incy);
+  }
+
   inline static
   void gemm (char Atrans, char Btrans, int M, int N, int K, double alpha,
              const double *A, int lda, const double* restrict B, int ldb,
@@ -176,6 +194,22 @@ struct BLAS
     zgemm (Atrans, Btrans, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
   }
 
+  inline static
+  void gemm (char Atrans, char Btrans, int M, int N, int K, float alpha,
+             const float *A, int lda, const float* restrict B, int ldb,
+             float beta, float* restrict C, int ldc)
+  {
+    sgemm (Atrans, Btrans, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+  }
+
+  inline static
+  void gemm (char Atrans, char Btrans, int M, int N, int K, complex<float> alpha,
+             const complex<float> *A, int lda, const complex<float>* restrict B, int ldb,
+             complex<float> beta, complex<float>* restrict C, int ldc)
+  {
+    cgemm (Atrans, Btrans, M, N, K, alpha, A, lda, B, ldb, beta, C, ldc);
+  }
+
 
 //   inline static
 //   void symv(char uplo, int n, const double alpha, double* a, int lda,
@@ -381,6 +415,24 @@ struct BLAS
     zgeru(&m,&n,&alpha,x,&incx,y,&incy,a,&lda);
   }
 
+  inline static
+  void ger(int m, int n, float alpha
+           , const float* x, int incx
+           , const float* y , int incy
+           , float* a, int lda)
+  {
+    sger(&m,&n,&alpha,x,&incx,y,&incy,a,&lda);
+  }
+
+  inline static
+  void ger(int m, int n, const complex<float>& alpha
+           , const complex<float>* x
+           , int incx, const complex<float>* y, int incy
+           , complex<float>* a, int lda)
+  {
+    cgeru(&m,&n,&alpha,x,&incx,y,&incy,a,&lda);
+  }
+
 };
 #endif // OHMMS_BLAS_H
 /***************************************************************************
@@ -47,12 +47,12 @@ struct OptimizableFunctorBase
   typedef optimize::VariableSet opt_variables_type;
   ///typedef for name-value lists
   typedef optimize::VariableSet::variable_map_type variable_map_type;
-  ///maximum cutoff
+  ///maximum cutoff, zero if the functor does not set it
   real_type cutoff_radius;
   ///set of variables to be optimized
   opt_variables_type myVars;
   ///default constructor
-  inline OptimizableFunctorBase() {}
+  inline OptimizableFunctorBase(): cutoff_radius(0.0) {}
   ///virtual destrutor
   virtual ~OptimizableFunctorBase() {}
 
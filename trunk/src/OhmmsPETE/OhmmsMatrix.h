@@ -144,6 +144,15 @@ public:
     assign(*this, rhs);
   }
 
+  ///exchange the content with rhs without copying the elements
+  inline void swap(Matrix<T,C>& rhs)
+  {
+    std::swap(D1,rhs.D1);
+    std::swap(D2,rhs.D2);
+    std::swap(TotSize,rhs.TotSize);
+    X.swap(rhs.X);
+  }
+
   // Assignment Operators
   inline This_t& operator=(const Matrix<T,C> &rhs)
   {
@@ -0,0 +1,139 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+#ifndef QMCPLUSPLUS_ASYMMETRICDISTANCETABLEDATA_CELL_H
+#define QMCPLUSPLUS_ASYMMETRICDISTANCETABLEDATA_CELL_H
+
+#include "Particle/CellList.h"
+
+namespace qmcplusplus
+{
+
+/**@ingroup nnlist
+ * @brief AsymmetricDTD with the neighbor lists from the cell lists of the sources
+ *
+ * A proposed move evaluates only the sources in the cells around the new
+ * position, listed in TempNeighbors. The other entries of Temp are kept at
+ * r1=NeighborCutoff and dr1=0. The cell lists are rebuilt by evaluate.
+ */
+template<typename T, unsigned D, int SC>
+struct AsymmetricDTDCell: public AsymmetricDTD<T,D,SC>
+{
+  typedef AsymmetricDTD<T,D,SC> base_type;
+  typedef DistanceTableData::IndexType IndexType;
+  typedef DistanceTableData::PosType PosType;
+
+  ///cell lists of the sources
+  CellList<T,D> Cells;
+  ///old position of the proposed move
+  PosType Rold;
+  ///sources around the old position
+  std::vector<int> OldNeighbors;
+
+  AsymmetricDTDCell(const ParticleSet& source, const ParticleSet& target, T rcut)
+    : base_type(source,target)
+  {
+    this->DTType=DistanceTableData::DT_CELL;
+    this->NeighborCutoff=rcut;
+    Cells.init(target.Lattice,rcut);
+    Cells.build(source.R,this->N[DistanceTableData::SourceIndex]);
+    resetTemp();
+  }
+
+  void create(int walkers)
+  {
+    base_type::create(walkers);
+    resetTemp();
+  }
+
+  inline void evaluate(const ParticleSet& P)
+  {
+    base_type::evaluate(P);
+    Cells.build(this->Origin.R,this->N[DistanceTableData::SourceIndex]);
+  }
+
+  inline void move(const ParticleSet& P, const PosType& rnew, IndexType jat)
+  {
+    moveCell(P,rnew,jat);
+  }
+
+  inline void moveOnSphere(const ParticleSet& P, const PosType& rnew, IndexType jat)
+  {
+    moveCell(P,rnew,jat);
+  }
+
+  ///update the pairs of the jat-th target with the sources around the old and new positions
+  inline void update(IndexType jat)
+  {
+    Cells.getNeighbors(Rold,OldNeighbors);
+    for(int k=0; k<OldNeighbors.size(); ++k)
+      setPair(OldNeighbors[k],jat);
+    const std::vector<int>& nbrs(this->TempNeighbors);
+    for(int k=0; k<nbrs.size(); ++k)
+      setPair(nbrs[k],jat);
+  }
+
+private:
+  ///set the entries of Temp to the value beyond the cutoff
+  inline void resetTemp()
+  {
+    for(int i=0; i<this->Temp.size(); ++i)
+      resetTemp(i);
+    this->TempNeighbors.clear();
+  }
+
+  inline void resetTemp(int i)
+  {
+    this->Temp[i].r1=this->NeighborCutoff;
+    this->Temp[i].rinv1=1.0/this->NeighborCutoff;
+    this->Temp[i].dr1=0.0;
+  }
+
+  inline void moveCell(const ParticleSet& P, const PosType& rnew, IndexType jat)
+  {
+    this->activePtcl=jat;
+    Rold=P.R[jat];
+    std::vector<int>& nbrs(this->TempNeighbors);
+    for(int k=0; k<nbrs.size(); ++k)
+      resetTemp(nbrs[k]);
+    Cells.getNeighbors(rnew,nbrs);
+    for(int k=0; k<nbrs.size(); ++k)
+    {
+      const int iat=nbrs[k];
+      PosType drij(rnew-this->Origin.R[iat]);
+      T sep(std::sqrt(DTD_BConds<T,D,SC>::apply_bc(drij)));
+      this->Temp[iat].r1=sep;
+      this->Temp[iat].rinv1=1.0/sep;
+      this->Temp[iat].dr1=drij;
+    }
+  }
+
+  ///copy Temp[iat] to the pair of the iat-th source and the jat-th target
+  inline void setPair(int iat, int jat)
+  {
+    const int loc=iat*this->N[DistanceTableData::VisitorIndex]+jat;
+    this->r_m[loc]=this->Temp[iat].r1;
+    this->rinv_m[loc]=1.0/this->Temp[iat].r1;
+    this->dr_m[loc]=this->Temp[iat].dr1;
+  }
+};
+
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,157 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+#ifndef QMCPLUSPLUS_ASYMMETRICDISTANCETABLEDATA_SOA_H
+#define QMCPLUSPLUS_ASYMMETRICDISTANCETABLEDATA_SOA_H
+
+#include "Lattice/ParticleBCondsSoA.h"
+
+namespace qmcplusplus
+{
+
+/**@ingroup nnlist
+ * @brief AsymmetricDTD with the structure-of-arrays storage
+ *
+ * Distances and Displacements hold a row for each target particle
+ * with respect to all the sources. The positions of the sources are
+ * copied to RSoA by evaluate.
+ */
+template<typename T, unsigned D, int SC>
+struct AsymmetricDTDSoA: public AsymmetricDTD<T,D,SC>
+{
+  typedef AsymmetricDTD<T,D,SC> base_type;
+  typedef DistanceTableData::IndexType IndexType;
+  typedef DistanceTableData::PosType PosType;
+  typedef DistanceTableData::aligned_matrix_type aligned_matrix_type;
+
+  ///positions of the sources, RSoA(dim,source)
+  aligned_matrix_type RSoA;
+
+  AsymmetricDTDSoA(const ParticleSet& source, const ParticleSet& target)
+    : base_type(source,target)
+  {
+    this->DTType=DistanceTableData::DT_SOA;
+    resizeSoA();
+    copySources();
+  }
+
+  void create(int walkers)
+  {
+    base_type::create(walkers);
+    resizeSoA();
+  }
+
+  inline void resizeSoA()
+  {
+    const int ns=this->N[DistanceTableData::SourceIndex];
+    const int nt=this->N[DistanceTableData::VisitorIndex];
+    if(nt == this->Distances.rows() && getAlignedSize<T>(ns) == this->PaddedSize)
+      return;
+    this->PaddedSize=getAlignedSize<T>(ns);
+    this->Temp_r.resize(this->PaddedSize);
+    this->Temp_dr.resize(D,this->PaddedSize);
+    this->Distances.resize(nt,this->PaddedSize);
+    this->Displacements.resize(nt*D,this->PaddedSize);
+    RSoA.resize(D,this->PaddedSize);
+  }
+
+  inline void copySources()
+  {
+    const ParticleSet& s(this->Origin);
+    for(int iat=0; iat<this->N[DistanceTableData::SourceIndex]; ++iat)
+      for(int d=0; d<D; ++d)
+        RSoA(d,iat)=s.R[iat][d];
+  }
+
+  inline void evaluate(const ParticleSet& P)
+  {
+    base_type::evaluate(P);
+    copySources();
+    const int ns=this->N[DistanceTableData::SourceIndex];
+    const int nt=this->N[DistanceTableData::VisitorIndex];
+    //transpose the pair data: dr_m[i*nt+j]=P.R[j]-Origin.R[i]
+    for(int i=0,ij=0; i<ns; i++)
+      for(int j=0; j<nt; j++,ij++)
+      {
+        this->Distances(j,i)=this->r_m[ij];
+        for(int d=0; d<D; ++d)
+          this->Displacements(j*D+d,i)=this->dr_m[ij][d];
+      }
+  }
+
+  ///evaluate the temporary pair relations on the SoA rows and fill Temp if needed
+  inline void move(const ParticleSet& P, const PosType& rnew, IndexType jat)
+  {
+    moveSoA(rnew,jat);
+    if(!this->NeedTemp)
+      return;
+    const int ns=this->N[DistanceTableData::SourceIndex];
+    for(int iat=0; iat<ns; ++iat)
+    {
+      const T r=this->Temp_r[iat];
+      this->Temp[iat].r1=r;
+      this->Temp[iat].rinv1=1.0/r;
+      for(int d=0; d<D; ++d)
+        this->Temp[iat].dr1[d]=this->Temp_dr(d,iat);
+    }
+  }
+
+  inline void moveOnSphere(const ParticleSet& P, const PosType& rnew, IndexType jat)
+  {
+    moveSoA(rnew,jat);
+    if(!this->NeedTemp)
+      return;
+    const int ns=this->N[DistanceTableData::SourceIndex];
+    for(int iat=0; iat<ns; ++iat)
+    {
+      this->Temp[iat].r1=this->Temp_r[iat];
+      for(int d=0; d<D; ++d)
+        this->Temp[iat].dr1[d]=this->Temp_dr(d,iat);
+    }
+  }
+
+  ///update the row of the jat-th target and the pair data
+  inline void update(IndexType jat)
+  {
+    const int ns=this->N[DistanceTableData::SourceIndex];
+    for(int iat=0,loc=jat; iat<ns; iat++,loc+=this->N[DistanceTableData::VisitorIndex])
+    {
+      this->r_m[loc]=this->Temp_r[iat];
+      this->rinv_m[loc]=1.0/this->Temp_r[iat];
+      for(int d=0; d<D; ++d)
+        this->dr_m[loc][d]=this->Temp_dr(d,iat);
+    }
+    simd::copy(this->Distances[jat],&(this->Temp_r[0]),ns);
+    for(int d=0; d<D; ++d)
+      simd::copy(this->Displacements[jat*D+d],this->Temp_dr[d],ns);
+  }
+
+private:
+  inline void moveSoA(const PosType& rnew, IndexType jat)
+  {
+    this->activePtcl=jat;
+    compute_displ_soa(static_cast<const DTD_BConds<T,D,SC>&>(*this),rnew
+                      ,RSoA.data(),this->Temp_dr.data(),this->PaddedSize
+                      ,&(this->Temp_r[0]),this->N[DistanceTableData::SourceIndex]);
+  }
+};
+
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
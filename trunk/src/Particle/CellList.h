@@ -0,0 +1,184 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/** @file CellList.h
+ * @brief Declaration of CellList, linked-cell lists of the particles in a periodic cell
+ */
+#ifndef QMCPLUSPLUS_CELLLIST_H
+#define QMCPLUSPLUS_CELLLIST_H
+#include "Lattice/CrystalLattice.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace qmcplusplus
+{
+
+/** @ingroup nnlist
+ * @brief linked-cell lists of the particles in a periodic cell
+ *
+ * The cell is divided along each lattice vector into NumCells[d] slabs
+ * whose widths are not smaller than the cutoff, so that the particles within
+ * the cutoff of a position, including the periodic images, are in the
+ * \f$3^D\f$ cells around it. A direction which holds less than three slabs is not divided.
+ * The particles of a cell are kept in a doubly-linked list for the
+ * reassignment of a particle in O(1).
+ */
+template<typename T, unsigned D>
+struct CellList
+{
+  typedef TinyVector<T,D> PosType;
+
+  ///reciprocal vectors, the reduced coordinates are \f$u_d=r\cdot G_d\f$
+  TinyVector<PosType,D> Gv;
+  ///number of the cells in each direction
+  TinyVector<int,D> NumCells;
+  ///first particle of each cell, -1 if empty
+  std::vector<int> Head;
+  ///next and previous particles of the same cell, -1 at the ends
+  std::vector<int> Next, Prev;
+  ///cell of each particle
+  std::vector<int> CellID;
+
+  /** initialize the cells
+   * @param lattice periodic cell
+   * @param rcut cutoff radius
+   */
+  void init(const CrystalLattice<T,D>& lattice, T rcut)
+  {
+    int ntot=1;
+    for(int d=0; d<D; ++d)
+    {
+      Gv[d]=lattice.Gv[d];
+      //the width of the cell along the d-th direction is 1/|G_d|
+      int n=static_cast<int>(1.0/(rcut*std::sqrt(dot(Gv[d],Gv[d]))));
+      NumCells[d]=(n<3)?1:n;
+      ntot*=NumCells[d];
+    }
+    Head.resize(ntot);
+    std::fill(Head.begin(),Head.end(),-1);
+  }
+
+  ///return the total number of the cells
+  inline int size() const
+  {
+    return Head.size();
+  }
+
+  ///return the cell of a position
+  inline int getCell(const PosType& pos) const
+  {
+    int c=0;
+    for(int d=0; d<D; ++d)
+    {
+      T u=dot(pos,Gv[d]);
+      int i=static_cast<int>((u-std::floor(u))*NumCells[d]);
+      c=c*NumCells[d]+((i<NumCells[d])?i:NumCells[d]-1);
+    }
+    return c;
+  }
+
+  /** assign the particles to the cells
+   * @param pos positions
+   * @param n number of the particles
+   */
+  template<typename PA>
+  void build(const PA& pos, int n)
+  {
+    Next.resize(n);
+    Prev.resize(n);
+    CellID.resize(n);
+    std::fill(Head.begin(),Head.end(),-1);
+    for(int i=0; i<n; ++i)
+    {
+      CellID[i]=getCell(pos[i]);
+      insert(i);
+    }
+  }
+
+  /** move the iat-th particle to a new position
+   */
+  inline void move(int iat, const PosType& pos)
+  {
+    int c=getCell(pos);
+    if(c == CellID[iat])
+      return;
+    remove(iat);
+    CellID[iat]=c;
+    insert(iat);
+  }
+
+  /** collect the particles in the cells around a position
+   * @param pos position
+   * @param plist indices of the particles, a superset of those within the cutoff
+   */
+  void getNeighbors(const PosType& pos, std::vector<int>& plist) const
+  {
+    plist.clear();
+    TinyVector<int,D> first, len, k;
+    int ncells=1;
+    for(int d=0; d<D; ++d)
+    {
+      T u=dot(pos,Gv[d]);
+      int i=static_cast<int>((u-std::floor(u))*NumCells[d]);
+      first[d]=(NumCells[d]>1)?std::min(i,NumCells[d]-1)-1+NumCells[d]:0;
+      len[d]=(NumCells[d]>1)?3:1;
+      k[d]=0;
+      ncells*=len[d];
+    }
+    for(int n=0; n<ncells; ++n)
+    {
+      int c=0;
+      for(int d=0; d<D; ++d)
+        c=c*NumCells[d]+(first[d]+k[d])%NumCells[d];
+      for(int i=Head[c]; i>=0; i=Next[i])
+        plist.push_back(i);
+      for(int d=D-1; d>=0; --d)
+      {
+        if(++k[d]<len[d])
+          break;
+        k[d]=0;
+      }
+    }
+  }
+
+private:
+  inline void insert(int i)
+  {
+    int c=CellID[i];
+    Prev[i]=-1;
+    Next[i]=Head[c];
+    if(Head[c]>=0)
+      Prev[Head[c]]=i;
+    Head[c]=i;
+  }
+
+  inline void remove(int i)
+  {
+    if(Prev[i]>=0)
+      Next[Prev[i]]=Next[i];
+    else
+      Head[CellID[i]]=Next[i];
+    if(Next[i]>=0)
+      Prev[Next[i]]=Prev[i];
+  }
+};
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
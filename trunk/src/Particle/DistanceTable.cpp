@@ -19,14 +19,45 @@
 #include "Lattice/ParticleBConds.h"
 #include "Particle/SymmetricDistanceTableData.h"
 #include "Particle/AsymmetricDistanceTableData.h"
+#include "Particle/SymmetricDistanceTableDataSoA.h"
+#include "Particle/AsymmetricDistanceTableDataSoA.h"
+#include "Particle/SymmetricDistanceTableDataCell.h"
+#include "Particle/AsymmetricDistanceTableDataCell.h"
 namespace qmcplusplus
 {
 
+/** create a symmetric table with the storage type dt_type */
+template<int SC>
+inline DistanceTableData* createSymmetricDTD(ParticleSet& s, int dt_type)
+{
+  typedef OHMMS_PRECISION RealType;
+  enum {DIM=OHMMS_DIM};
+  if(dt_type == DistanceTableData::DT_SOA)
+    return new SymmetricDTDSoA<RealType,DIM,SC>(s,s);
+  if(dt_type == DistanceTableData::DT_CELL)
+    return new SymmetricDTDCell<RealType,DIM,SC>(s,s,s.CellListCutoff);
+  return new SymmetricDTD<RealType,DIM,SC>(s,s);
+}
+
+/** create an asymmetric table with the storage type dt_type */
+template<int SC>
+inline DistanceTableData* createAsymmetricDTD(const ParticleSet& s, ParticleSet& t, int dt_type)
+{
+  typedef OHMMS_PRECISION RealType;
+  enum {DIM=OHMMS_DIM};
+  if(dt_type == DistanceTableData::DT_SOA)
+    return new AsymmetricDTDSoA<RealType,DIM,SC>(s,t);
+  if(dt_type == DistanceTableData::DT_CELL)
+    return new AsymmetricDTDCell<RealType,DIM,SC>(s,t,t.CellListCutoff);
+  return new AsymmetricDTD<RealType,DIM,SC>(s,t);
+}
+
 /** Adding SymmetricDTD to the list, e.g., el-el distance table
  *\param s source/target particle set
+ *\param dt_type storage type, DistanceTableData::DT_AOS or DT_SOA
  *\return index of the distance table with the name
  */
-DistanceTableData* createDistanceTable(ParticleSet& s)
+DistanceTableData* createDistanceTable(ParticleSet& s, int dt_type)
 {
   typedef OHMMS_PRECISION RealType;
   enum {DIM=OHMMS_DIM};
@@ -34,12 +65,24 @@ DistanceTableData* createDistanceTable(ParticleSet& s)
   DistanceTableData* dt=0;
   ostringstream o;
   o << "  Distance table for AA: source/target = " << s.getName() << "\n";
+  if(dt_type == DistanceTableData::DT_SOA)
+    o << "    Using structure-of-arrays (SoA) storage\n";
+  if(dt_type == DistanceTableData::DT_CELL)
+  {
+    if(sc == SUPERCELL_BULK)
+      o << "    Using cell lists with the cutoff " << s.CellListCutoff << "\n";
+    else
+    {
+      o << "    Cell lists need a bulk cell. Using the default storage\n";
+      dt_type=DistanceTableData::DT_AOS;
+    }
+  }
   if(sc == SUPERCELL_BULK)
   {
     if(s.Lattice.DiagonalOnly)
     {
       o << "    PBC=bulk Orthorhombic=yes Using SymmetricDTD<T,DIM,PPPO> " << PPPO <<endl;
-      dt = new SymmetricDTD<RealType,DIM,PPPO>(s,s);
+      dt = createSymmetricDTD<PPPO>(s,dt_type);
     }
     else
     {
@@ -47,14 +90,14 @@ DistanceTableData* createDistanceTable(ParticleSet& s)
       if(s.Lattice.WignerSeitzRadius>s.Lattice.SimulationCellRadius)
       {
         o << "  Using SymmetricDTD<T,D,PPPG> " << PPPG <<endl;
-        dt = new  SymmetricDTD<RealType,DIM,PPPG>(s,s);
+        dt = createSymmetricDTD<PPPG>(s,dt_type);
         //o << "    PBC=bulk Orthorhombic=no SymmetricDTD<T,DIM,PPPX> " << PPPX <<endl;
         //dt = new  SymmetricDTD<RealType,DIM,PPPX>(s,s);
       }
       else
       {
         o << "  Using SymmetricDTD<T,D,PPPS> " << PPPS <<endl;
-        dt = new  SymmetricDTD<RealType,DIM,PPPS>(s,s);
+        dt = createSymmetricDTD<PPPS>(s,dt_type);
       }
       o << "\n    Setting Rmax = " << s.Lattice.SimulationCellRadius;
     }
@@ -65,19 +108,19 @@ DistanceTableData* createDistanceTable(ParticleSet& s)
       if(s.Lattice.DiagonalOnly)
       {
         o << "    PBC=slab Orthorhombic=yes Using SymmetricDTD<T,D,PPNO> " << PPNO <<endl;
-        dt = new SymmetricDTD<RealType,DIM,PPNO>(s,s);
+        dt = createSymmetricDTD<PPNO>(s,dt_type);
       }
       else
       {
         if(s.Lattice.WignerSeitzRadius>s.Lattice.SimulationCellRadius)
         {
           o << "    PBC=slab Orthorhombic=no Using SymmetricDTD<T,D,PPNX> " << PPNX <<endl;
-          dt = new SymmetricDTD<RealType,DIM,PPNX>(s,s);
+          dt = createSymmetricDTD<PPNX>(s,dt_type);
         }
         else
         {
           o << "    PBC=slab Orthorhombic=no Using SymmetricDTD<T,D,PPNS> " << PPNS <<endl;
-          dt = new SymmetricDTD<RealType,DIM,PPNS>(s,s);
+          dt = createSymmetricDTD<PPNS>(s,dt_type);
         }
       }
     }
@@ -85,12 +128,12 @@ DistanceTableData* createDistanceTable(ParticleSet& s)
       if(sc == SUPERCELL_WIRE)
       {
         o << "    PBC=wire Orthorhombic=NA\n";
-        dt = new SymmetricDTD<RealType,DIM,SUPERCELL_WIRE>(s,s);
+        dt = createSymmetricDTD<SUPERCELL_WIRE>(s,dt_type);
       }
       else  //open boundary condition
       {
         o << "    PBC=open Orthorhombic=NA\n";
-        dt = new SymmetricDTD<RealType,DIM,SUPERCELL_OPEN>(s,s);
+        dt = createSymmetricDTD<SUPERCELL_OPEN>(s,dt_type);
       }
   dt->CellType=sc;
   ostringstream p;
@@ -105,11 +148,13 @@ DistanceTableData* createDistanceTable(ParticleSet& s)
   return dt;
 }
 
-/** Adding SymmetricDTD to the list, e.g., el-el distance table
- *\param s source/target particle set
+/** Adding AsymmetricDTD to the list, e.g., el-ion distance table
+ *\param s source particle set
+ *\param t target particle set
+ *\param dt_type storage type, DistanceTableData::DT_AOS or DT_SOA
  *\return index of the distance table with the name
  */
-DistanceTableData* createDistanceTable(const ParticleSet& s, ParticleSet& t)
+DistanceTableData* createDistanceTable(const ParticleSet& s, ParticleSet& t, int dt_type)
 {
   typedef OHMMS_PRECISION RealType;
   enum {DIM=OHMMS_DIM};
@@ -118,12 +163,24 @@ DistanceTableData* createDistanceTable(const ParticleSet& s, ParticleSet& t)
   int sc=t.Lattice.SuperCellEnum;
   ostringstream o;
   o << "  Distance table for AB: source = " << s.getName() << " target = " << t.getName() << "\n";
+  if(dt_type == DistanceTableData::DT_SOA)
+    o << "    Using structure-of-arrays (SoA) storage\n";
+  if(dt_type == DistanceTableData::DT_CELL)
+  {
+    if(sc == SUPERCELL_BULK)
+      o << "    Using cell lists with the cutoff " << t.CellListCutoff << "\n";
+    else
+    {
+      o << "    Cell lists need a bulk cell. Using the default storage\n";
+      dt_type=DistanceTableData::DT_AOS;
+    }
+  }
   if(sc == SUPERCELL_BULK)
   {
     if(s.Lattice.DiagonalOnly)
     {
       o << "    PBC=bulk Orthorhombic=yes Using AsymmetricDTD<T,D,PPPO> " << PPPO <<endl;
-      dt = new AsymmetricDTD<RealType,DIM,PPPO>(s,t);
+      dt = createAsymmetricDTD<PPPO>(s,t,dt_type);
     }
     else
     {
@@ -131,12 +188,12 @@ DistanceTableData* createDistanceTable(const ParticleSet& s, ParticleSet& t)
       if(s.Lattice.WignerSeitzRadius>s.Lattice.SimulationCellRadius)
       {
         o << " Using AsymmetricDTD<T,D,PPPG> " << PPPG <<endl;
-        dt = new AsymmetricDTD<RealType,DIM,PPPG>(s,t);
+        dt = createAsymmetricDTD<PPPG>(s,t,dt_type);
       }
       else
       {
         o << " Using AsymmetricDTD<T,D,PPPS> " << PPPS <<endl;
-        dt = new AsymmetricDTD<RealType,DIM,PPPS>(s,t);
+        dt = createAsymmetricDTD<PPPS>(s,t,dt_type);
       }
       o << "    Setting Rmax = " << s.Lattice.SimulationCellRadius;
     }
@@ -147,7 +204,7 @@ DistanceTableData* createDistanceTable(const ParticleSet& s, ParticleSet& t)
       if(s.Lattice.DiagonalOnly)
       {
         o << "    PBC=slab Orthorhombic=yes Using AsymmetricDTD<T,D,PPNO> " << PPNO <<endl;
-        dt = new AsymmetricDTD<RealType,DIM,PPNO>(s,t);
+        dt = createAsymmetricDTD<PPNO>(s,t,dt_type);
       }
       else
       {
@@ -155,12 +212,12 @@ DistanceTableData* createDistanceTable(const ParticleSet& s, ParticleSet& t)
         if(s.Lattice.WignerSeitzRadius>s.Lattice.SimulationCellRadius)
         {
           o << " Using AsymmetricDTD<T,DIM,PPNX> " << PPNX <<endl;
-          dt = new AsymmetricDTD<RealType,DIM,PPNX>(s,t);
+          dt = createAsymmetricDTD<PPNX>(s,t,dt_type);
         }
         else
         {
           o << " Using AsymmetricDTD<T,DIM,PPNS> " << PPNS <<endl;
-          dt = new AsymmetricDTD<RealType,DIM,PPNS>(s,t);
+          dt = createAsymmetricDTD<PPNS>(s,t,dt_type);
         }
       }
     }
@@ -168,12 +225,12 @@ DistanceTableData* createDistanceTable(const ParticleSet& s, ParticleSet& t)
       if(sc == SUPERCELL_WIRE)
       {
         o << "    PBC=wire Orthorhombic=NA\n";
-        dt = new AsymmetricDTD<RealType,DIM,SUPERCELL_WIRE>(s,t);
+        dt = createAsymmetricDTD<SUPERCELL_WIRE>(s,t,dt_type);
       }
       else  //open boundary condition
       {
         o << "    PBC=open Orthorhombic=NA\n";
-        dt = new AsymmetricDTD<RealType,DIM,SUPERCELL_OPEN>(s,t);
+        dt = createAsymmetricDTD<SUPERCELL_OPEN>(s,t,dt_type);
       }
   dt->CellType=sc;
   ostringstream p;
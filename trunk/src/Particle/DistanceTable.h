@@ -51,10 +51,10 @@ struct DistanceTable
 };
 
 ///free function to create a distable table of s-s
-DistanceTableData* createDistanceTable(ParticleSet& s);
+DistanceTableData* createDistanceTable(ParticleSet& s, int dt_type=0);
 
 ///free function create a distable table of s-t
-DistanceTableData* createDistanceTable(const ParticleSet& s, ParticleSet& t);
+DistanceTableData* createDistanceTable(const ParticleSet& s, ParticleSet& t, int dt_type=0);
 }
 #endif
 /***************************************************************************
@@ -20,6 +20,7 @@
 #include "Utilities/PooledData.h"
 #include "OhmmsPETE/OhmmsVector.h"
 #include "OhmmsPETE/OhmmsMatrix.h"
+#include "simd/allocator.hpp"
 #include <bitset>
 
 namespace qmcplusplus
@@ -111,12 +112,25 @@ public:
    */
   enum {WalkerIndex=0, SourceIndex, VisitorIndex, PairIndex};
 
+  /** enum for the storage layout
+   *
+   * - DT_AOS : pair data in r_m, rinv_m and dr_m and the temporary data in Temp
+   * - DT_SOA : pair data + full rows of the distances and displacements in aligned arrays,
+   *   Temp only if NeedTemp
+   * - DT_CELL : DT_AOS + neighbor lists of the proposed moves from the cell lists
+   */
+  enum {DT_AOS=0, DT_SOA, DT_CELL};
+
   typedef std::vector<IndexType>       IndexVectorType;
   typedef TempDisplacement<RealType,DIM> TempDistType;
   typedef PooledData<RealType>           BufferType;
+  typedef std::vector<RealType,aligned_allocator<RealType> > aligned_vector_type;
+  typedef Matrix<RealType,aligned_vector_type> aligned_matrix_type;
 
   ///type of cell
   int CellType;
+  ///type of the storage, DT_AOS or DT_SOA
+  int DTType;
   ///ID of this table among many
   int ID;
   ///Index of the particle  with a trial move
@@ -168,11 +182,67 @@ public:
   std::vector<RealType> temp_r;
   std::vector<PosType> temp_dr;
 
+  /**@defgroup SoA data for DTType==DT_SOA
+   *
+   * Each row holds the data of a target particle with respect to all the sources
+   * and is padded to PaddedSize for the alignment.
+   * The displacement is \f$R_{target}-R_{source}\f$ with the BC applied.
+   * For the symmetric tables, the diagonal elements are zero and
+   * should be skipped by the consumers.
+   */
+  /*@{*/
+  ///padded size of the number of sources
+  int PaddedSize;
+  ///distances of the proposed move, Temp_r[source]
+  aligned_vector_type Temp_r;
+  ///displacements of the proposed move, Temp_dr(dim,source)
+  aligned_matrix_type Temp_dr;
+  ///distances, Distances(target,source)
+  aligned_matrix_type Distances;
+  ///displacements, Displacements(target*DIM+dim,source)
+  aligned_matrix_type Displacements;
+  /** true, if a consumer reads Temp
+   *
+   * Temp of a DT_SOA table is filled by move only when NeedTemp is set. It is
+   * set by ParticleSet::addTable unless the consumer reads only Temp_r and Temp_dr.
+   */
+  bool NeedTemp;
+  /*@}*/
+
+  /**@defgroup neighbor-list data for DTType==DT_CELL
+   *
+   * Temp is evaluated only for the sources in TempNeighbors, a superset of
+   * the sources within NeighborCutoff of the proposed move. The other entries
+   * of Temp and the pairs beyond NeighborCutoff may hold r=NeighborCutoff and dr=0,
+   * which is valid only for the consumers vanishing beyond NeighborCutoff.
+   * The consumers of all the entries, BackflowTransformation which reads Temp
+   * of the moved particle and PairCorrEstimator beyond NeighborCutoff, abort
+   * by checkNeighborCutoff.
+   */
+  /*@{*/
+  RealType NeighborCutoff;
+  std::vector<int> TempNeighbors;
+  /*@}*/
+
+  /** abort if a consumer of a DT_CELL table needs the pairs beyond NeighborCutoff
+   * @param rcut cutoff radius of the consumer, negative if it does not vanish beyond any radius
+   * @param who name of the consumer
+   */
+  inline void checkNeighborCutoff(RealType rcut, const std::string& who) const
+  {
+    if(DTType != DT_CELL)
+      return;
+    if(rcut<0.0)
+      APP_ABORT(who << " does not vanish beyond celllist_rcut and cannot use the cell lists of " << Name);
+    if(rcut>NeighborCutoff)
+      APP_ABORT(who << " cutoff " << rcut << " is larger than celllist_rcut " << NeighborCutoff << " of " << Name);
+  }
+
   ///name of the table
   std::string Name;
   ///constructor using source and target ParticleSet
   DistanceTableData(const ParticleSet& source, const ParticleSet& target)
-    : Origin(source), N(0)//, Rmax(1e6), Rmax2(1e12)
+    : Origin(source), DTType(DT_AOS), N(0), PaddedSize(0), NeedTemp(false), NeighborCutoff(0.0)//, Rmax(1e6), Rmax2(1e12)
   {  }
 
   ///virutal destructor
@@ -236,8 +306,49 @@ public:
   {
     return rinv_m[j];
   }
+  ///return the address of the distance of the j-th pair, the pairs [M[i],M[i+1]) are contiguous
+  inline const RealType* r_ptr(int j) const
+  {
+    return &r_m[j];
+  }
   //@}
 
+  //@{access functions to the SoA data, valid only with DTType==DT_SOA
+  ///return the distances of the iat-th target to all the sources
+  inline const RealType* getDistRow(int iat) const
+  {
+    return Distances[iat];
+  }
+  ///return the idim-th component of the displacements of the iat-th target to all the sources
+  inline const RealType* getDisplRow(int iat, int idim) const
+  {
+    return Displacements[iat*DIM+idim];
+  }
+  //@}
+
+  /** return the distances of the proposed move in a contiguous array
+   * @param buf scratch of size N[SourceIndex], used by DT_AOS tables
+   */
+  inline const RealType* getTempDistances(RealType* restrict buf) const
+  {
+    if(DTType == DT_SOA)
+      return &Temp_r[0];
+    for(int i=0; i<N[SourceIndex]; ++i)
+      buf[i]=Temp[i].r1;
+    return buf;
+  }
+
+  ///return the displacement of the proposed move to the j-th source
+  inline PosType getTempDispl(int j) const
+  {
+    if(DTType != DT_SOA)
+      return Temp[j].dr1;
+    PosType dr;
+    for(int d=0; d<DIM; ++d)
+      dr[d]=Temp_dr(d,j);
+    return dr;
+  }
+
   ///returns the number of centers
   inline IndexType centers() const
   {
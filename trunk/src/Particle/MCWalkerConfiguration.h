@@ -242,6 +242,18 @@ public:
     WalkerList.insert(it,first,last);
   }
 
+  /** remove elements without destroying them
+   * @param first starting iterator
+   * @param last ending iterator
+   * @return the next valid iterator
+   *
+   * Provide std::vector::erase interface
+   */
+  inline iterator erase(iterator first, iterator last)
+  {
+    return WalkerList.erase(first,last);
+  }
+
   /** add Walker_t* at the end
    * @param awalker pointer to a walker
    *
@@ -70,10 +70,15 @@ ParticleSet::ParticleSet(const ParticleSet& p)
   PropertyList.Values=p.PropertyList.Values;
   PropertyHistory=p.PropertyHistory;
   Collectables=p.Collectables;
+  SoASources=p.SoASources;
+  CellListSources=p.CellListSources;
+  CellListCutoff=p.CellListCutoff;
   //construct the distance tables with the same order
   //first is always for this-this paier
   for (int i=1; i<p.DistTables.size(); ++i)
-    addTable(p.DistTables[i]->origin());
+    addTable(p.DistTables[i]->origin(),p.DistTables[i]->DTType,false);
+  for (int i=0; i<DistTables.size(); ++i)
+    DistTables[i]->NeedTemp=p.DistTables[i]->NeedTemp;
   if(p.SK)
   {
     R.InUnit=p.R.InUnit;
@@ -100,6 +105,7 @@ void ParticleSet::initParticleSet()
   ObjectTag = PtclObjectCounter;
   #pragma omp atomic
   PtclObjectCounter++;
+  CellListCutoff=0.0;
 #if defined(QMC_COMPLEX)
   G.setTypeName(ParticleTags::gradtype_tag);
   L.setTypeName(ParticleTags::laptype_tag);
@@ -353,23 +359,40 @@ void ParticleSet::checkBoundBox(RealType rb)
 //  }
 //  DistTables.push_back(d_table);
 //}
-int ParticleSet::addTable(const ParticleSet& psrc)
+int ParticleSet::getTableType(const ParticleSet& psrc) const
 {
+  for (int i=0; i<CellListSources.size(); ++i)
+    if (CellListSources[i] == "yes" || CellListSources[i] == psrc.getName())
+      return DistanceTableData::DT_CELL;
+  for (int i=0; i<SoASources.size(); ++i)
+    if (SoASources[i] == "yes" || SoASources[i] == psrc.getName())
+      return DistanceTableData::DT_SOA;
+  return DistanceTableData::DT_AOS;
+}
+
+int ParticleSet::addTable(const ParticleSet& psrc, int dt_type, bool need_temp)
+{
+  if (dt_type<0)
+    dt_type=getTableType(psrc);
   if (DistTables.empty())
   {
     DistTables.reserve(4);
-    DistTables.push_back(createDistanceTable(*this));
+    DistTables.push_back(createDistanceTable(*this,(psrc.tag()==ObjectTag)?dt_type:getTableType(*this)));
     //add  this-this pair
     myDistTableMap.clear();
     myDistTableMap[ObjectTag]=0;
     app_log() << "  ... ParticleSet::addTable Create Table #0 " << DistTables[0]->Name << endl;
     DistTables[0]->ID=0;
     if (psrc.tag() == ObjectTag)
+    {
+      DistTables[0]->NeedTemp=need_temp;
       return 0;
+    }
   }
   if (psrc.tag() == ObjectTag)
   {
     app_log() << "  ... ParticleSet::addTable Reuse Table #" << 0 << " " << DistTables[0]->Name <<endl;
+    DistTables[0]->NeedTemp |= need_temp;
     return 0;
   }
   int tsize=DistTables.size(),tid;
@@ -377,7 +400,7 @@ int ParticleSet::addTable(const ParticleSet& psrc)
   if (tit == myDistTableMap.end())
   {
     tid=DistTables.size();
-    DistTables.push_back(createDistanceTable(psrc,*this));
+    DistTables.push_back(createDistanceTable(psrc,*this,dt_type));
     myDistTableMap[psrc.tag()]=tid;
     DistTables[tid]->ID=tid;
     app_log() << "  ... ParticleSet::addTable Create Table #" << tid << " " << DistTables[tid]->Name <<endl;
@@ -387,6 +410,7 @@ int ParticleSet::addTable(const ParticleSet& psrc)
     tid = (*tit).second;
     app_log() << "  ... ParticleSet::addTable Reuse Table #" << tid << " " << DistTables[tid]->Name << endl;
   }
+  DistTables[tid]->NeedTemp |= need_temp;
   app_log().flush();
   return tid;
 }
@@ -137,6 +137,23 @@ public:
   ///distance tables that need to be updated by moving this ParticleSet
   vector<DistanceTableData*> DistTables;
 
+  /** names of the sources whose distance tables use the SoA storage
+   *
+   * Set by the soa attribute of particleset: "yes" selects all the tables
+   * and a list of names selects the tables of those sources.
+   */
+  vector<string> SoASources;
+
+  /** names of the sources whose distance tables use the cell lists
+   *
+   * Set by the celllist attribute of particleset as SoASources.
+   * It takes precedence over SoASources.
+   */
+  vector<string> CellListSources;
+
+  ///cutoff radius of the neighbor lists of the tables with the cell lists
+  RealType CellListCutoff;
+
   ///spherical-grids for non-local PP
   vector<ParticlePos_t*> Sphere;
 
@@ -211,10 +228,19 @@ public:
 
   /**  add a distance table
    * @param psrc source particle set
+   * @param dt_type storage type of the table, negative to use SoASources
+   * @param need_temp false, if the caller reads only Temp_r and Temp_dr of the proposed moves
    *
    * Ensure that the distance for this-this is always created first.
    */
-  int  addTable(const ParticleSet& psrc);
+  int  addTable(const ParticleSet& psrc, int dt_type=-1, bool need_temp=true);
+
+  /** return the storage type of the distance table for psrc
+   * @param psrc source particle set
+   * @return DistanceTableData::DT_CELL if psrc is in CellListSources,
+   * DistanceTableData::DT_SOA if psrc is in SoASources
+   */
+  int getTableType(const ParticleSet& psrc) const;
 
   /** reset all the collectable quantities during a MC iteration
    */
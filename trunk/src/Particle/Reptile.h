@@ -0,0 +1,179 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/** @file Reptile.h
+ * @brief Declaration of Reptile, a ring buffer of the beads for reptation Monte Carlo
+ */
+#ifndef QMCPLUSPLUS_REPTILE_H
+#define QMCPLUSPLUS_REPTILE_H
+#include "Particle/MCWalkerConfiguration.h"
+
+namespace qmcplusplus
+{
+
+/** @ingroup QMC
+ * @brief a reptile whose beads are the walkers of a MCWalkerConfiguration
+ *
+ * The walkers [first,last) are preallocated: last-first-1 of them are the beads
+ * in a ring buffer and the other is the trial head. Each bead keeps its own
+ * R, G, L, the buffer of the trial wavefunction and the properties, e.g., the
+ * local energy and the observables of the Hamiltonian. The collectables of
+ * the Hamiltonian of each bead are kept by the reptile.
+ *
+ * A reptation move takes the tail slot for the accepted trial head and a bounce
+ * exchanges the head and the tail. Both only update the indices.
+ */
+class Reptile
+{
+public:
+  typedef MCWalkerConfiguration::Walker_t Walker_t;
+  typedef MCWalkerConfiguration::iterator WalkerIter_t;
+  typedef Walker_t::Buffer_t Buffer_t;
+
+  /** constructor
+   * @param first first walker
+   * @param last last walker, last-first is the number of the beads plus one
+   */
+  inline Reptile(WalkerIter_t first, WalkerIter_t last)
+    : Beads(first,last-1), Trial(*(last-1)), Head(0), Direction(1)
+  {
+    Collectables.resize(Beads.size());
+    for(int i=0; i<Collectables.size(); ++i)
+      Collectables[i]=new Buffer_t;
+    TrialCollectables=new Buffer_t;
+  }
+
+  ///destructor
+  inline ~Reptile()
+  {
+    for(int i=0; i<Collectables.size(); ++i)
+      delete Collectables[i];
+    delete TrialCollectables;
+  }
+
+  ///return the number of the beads
+  inline int size() const
+  {
+    return Beads.size();
+  }
+
+  ///return the i-th bead from the head
+  inline Walker_t& getBead(int i) const
+  {
+    return *Beads[wrap(Head+Direction*i)];
+  }
+
+  inline Walker_t& getHead() const
+  {
+    return getBead(0);
+  }
+
+  inline Walker_t& getTail() const
+  {
+    return getBead(size()-1);
+  }
+
+  ///return the bead next to the tail
+  inline Walker_t& getNext() const
+  {
+    return getBead(size()-2);
+  }
+
+  ///return the walker to hold the proposed head
+  inline Walker_t& getTrial() const
+  {
+    return *Trial;
+  }
+
+  ///return the collectables of the proposed head
+  inline Buffer_t& getTrialCollectables() const
+  {
+    return *TrialCollectables;
+  }
+
+  /** the trial becomes the head and the tail is released as the next trial
+   */
+  inline void grow()
+  {
+    int t=wrap(Head-Direction);
+    std::swap(Beads[t],Trial);
+    std::swap(Collectables[t],TrialCollectables);
+    Head=t;
+  }
+
+  /** reverse the direction: the tail becomes the head
+   */
+  inline void flip()
+  {
+    Head=wrap(Head+Direction*(size()-1));
+    Direction=-Direction;
+  }
+
+  /** collect the beads around the center
+   * @param n number of the beads
+   * @param beads the beads [(size()-n)/2, (size()-n)/2+n) from the head
+   */
+  inline void getCenter(int n, std::vector<Walker_t*>& beads) const
+  {
+    beads.resize(n);
+    int first=(size()-n)/2;
+    for(int i=0; i<n; ++i)
+      beads[i]=Beads[wrap(Head+Direction*(first+i))];
+  }
+
+  /** sum the collectables of the beads around the center
+   * @param n number of the beads of getCenter
+   * @param c sum of the collectables
+   */
+  inline void sumCenter(int n, Buffer_t& c) const
+  {
+    std::fill(c.begin(),c.end(),0.0);
+    int first=(size()-n)/2;
+    for(int i=0; i<n; ++i)
+      c += *Collectables[wrap(Head+Direction*(first+i))];
+  }
+
+private:
+  ///beads
+  std::vector<Walker_t*> Beads;
+  ///trial head
+  Walker_t* Trial;
+  ///collectables of the beads
+  std::vector<Buffer_t*> Collectables;
+  ///collectables of the trial head
+  Buffer_t* TrialCollectables;
+  ///index of the head in Beads
+  int Head;
+  ///+1 or -1 from the head to the tail
+  int Direction;
+
+  inline int wrap(int i) const
+  {
+    const int n=Beads.size();
+    return (i%n+n)%n;
+  }
+
+  ///copy constructor (disabled)
+  Reptile(const Reptile&);
+  ///copy operator (disabled)
+  Reptile& operator=(const Reptile&);
+};
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,149 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+#ifndef QMCPLUSPLUS_SYMMETRICDISTANCETABLEDATA_CELL_H
+#define QMCPLUSPLUS_SYMMETRICDISTANCETABLEDATA_CELL_H
+
+#include "Particle/CellList.h"
+
+namespace qmcplusplus
+{
+
+/**@ingroup nnlist
+ * @brief SymmetricDTD with the neighbor lists from the cell lists
+ *
+ * A proposed move evaluates only the particles in the cells around the new
+ * position, listed in TempNeighbors. The other entries of Temp are kept at
+ * r1=NeighborCutoff and dr1=0. When a move is accepted, the pairs with the
+ * particles around the old and the new positions are updated from Temp and
+ * the particle is reassigned to its new cell.
+ */
+template<typename T, unsigned D, int SC>
+struct SymmetricDTDCell: public SymmetricDTD<T,D,SC>
+{
+  typedef SymmetricDTD<T,D,SC> base_type;
+  typedef DistanceTableData::IndexType IndexType;
+  typedef DistanceTableData::PosType PosType;
+
+  ///cell lists of the particles
+  CellList<T,D> Cells;
+  ///old and new positions of the proposed move
+  PosType Rold, Rnew;
+  ///particles around the old position
+  std::vector<int> OldNeighbors;
+
+  SymmetricDTDCell(const ParticleSet& source, const ParticleSet& target, T rcut)
+    : base_type(source,target)
+  {
+    this->DTType=DistanceTableData::DT_CELL;
+    this->NeighborCutoff=rcut;
+    Cells.init(source.Lattice,rcut);
+    resetTemp();
+  }
+
+  void create(int walkers)
+  {
+    base_type::create(walkers);
+    resetTemp();
+  }
+
+  inline void evaluate(const ParticleSet& P)
+  {
+    base_type::evaluate(P);
+    Cells.build(P.R,this->N[DistanceTableData::SourceIndex]);
+  }
+
+  inline void move(const ParticleSet& P, const PosType& rnew, IndexType jat)
+  {
+    moveCell(P,rnew,jat);
+  }
+
+  inline void moveOnSphere(const ParticleSet& P, const PosType& rnew, IndexType jat)
+  {
+    moveCell(P,rnew,jat);
+  }
+
+  ///update the pairs of the jat-th particle with the particles around the old and new positions
+  inline void update(IndexType jat)
+  {
+    Cells.getNeighbors(Rold,OldNeighbors);
+    for(int k=0; k<OldNeighbors.size(); ++k)
+      setPair(OldNeighbors[k],jat);
+    const std::vector<int>& nbrs(this->TempNeighbors);
+    for(int k=0; k<nbrs.size(); ++k)
+      setPair(nbrs[k],jat);
+    Cells.move(jat,Rnew);
+  }
+
+private:
+  ///set the entries of Temp to the value beyond the cutoff
+  inline void resetTemp()
+  {
+    for(int i=0; i<this->Temp.size(); ++i)
+      resetTemp(i);
+    this->TempNeighbors.clear();
+  }
+
+  inline void resetTemp(int i)
+  {
+    this->Temp[i].r1=this->NeighborCutoff;
+    this->Temp[i].rinv1=1.0/this->NeighborCutoff;
+    this->Temp[i].dr1=0.0;
+    this->Temp[i].dr1_nobox=0.0;
+  }
+
+  inline void moveCell(const ParticleSet& P, const PosType& rnew, IndexType jat)
+  {
+    this->activePtcl=jat;
+    Rold=P.R[jat];
+    Rnew=rnew;
+    std::vector<int>& nbrs(this->TempNeighbors);
+    for(int k=0; k<nbrs.size(); ++k)
+      resetTemp(nbrs[k]);
+    Cells.getNeighbors(rnew,nbrs);
+    for(int k=0; k<nbrs.size(); ++k)
+    {
+      const int iat=nbrs[k];
+      PosType drij(rnew - P.R[iat]);
+      this->Temp[iat].dr1_nobox=drij;
+      T sep=std::sqrt(DTD_BConds<T,D,SC>::apply_bc(drij));
+      this->Temp[iat].r1=sep;
+      this->Temp[iat].rinv1=1.0/sep;
+      this->Temp[iat].dr1=drij;
+    }
+  }
+
+  ///copy Temp[iat] to the pair (iat,jat), \f$dr=R_j-R_i\f$ for i<j
+  inline void setPair(int iat, int jat)
+  {
+    if(iat == jat)
+      return;
+    const int loc=this->IJ[iat*this->N[DistanceTableData::SourceIndex]+jat];
+    this->r_m[loc]=this->Temp[iat].r1;
+    this->rinv_m[loc]=1.0/this->Temp[iat].r1;
+    if(iat<jat)
+      this->dr_m[loc]=this->Temp[iat].dr1;
+    else
+      this->dr_m[loc]=-1.0*this->Temp[iat].dr1;
+  }
+};
+
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,182 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+#ifndef QMCPLUSPLUS_SYMMETRICDISTANCETABLEDATA_SOA_H
+#define QMCPLUSPLUS_SYMMETRICDISTANCETABLEDATA_SOA_H
+
+#include "Lattice/ParticleBCondsSoA.h"
+
+namespace qmcplusplus
+{
+
+/**@ingroup nnlist
+ * @brief SymmetricDTD with the structure-of-arrays storage
+ *
+ * The proposed move is evaluated on the SoA positions and stored in
+ * Temp_r and Temp_dr. The full rows, Distances and Displacements, and the pair
+ * data of SymmetricDTD are updated from them when the move is accepted.
+ * Temp is filled only for the consumers which need it, see NeedTemp.
+ */
+template<typename T, unsigned D, int SC>
+struct SymmetricDTDSoA: public SymmetricDTD<T,D,SC>
+{
+  typedef SymmetricDTD<T,D,SC> base_type;
+  typedef DistanceTableData::IndexType IndexType;
+  typedef DistanceTableData::PosType PosType;
+  typedef DistanceTableData::aligned_matrix_type aligned_matrix_type;
+
+  ///positions of the particles, RSoA(dim,iat)
+  aligned_matrix_type RSoA;
+  ///position of the proposed move
+  PosType Rnew;
+
+  SymmetricDTDSoA(const ParticleSet& source, const ParticleSet& target)
+    : base_type(source,target)
+  {
+    this->DTType=DistanceTableData::DT_SOA;
+    resizeSoA();
+  }
+
+  void create(int walkers)
+  {
+    base_type::create(walkers);
+    resizeSoA();
+  }
+
+  inline void resizeSoA()
+  {
+    const int n=this->N[DistanceTableData::SourceIndex];
+    if(n == this->Distances.rows())
+      return;
+    this->PaddedSize=getAlignedSize<T>(n);
+    this->Temp_r.resize(this->PaddedSize);
+    this->Temp_dr.resize(D,this->PaddedSize);
+    this->Distances.resize(n,this->PaddedSize);
+    this->Displacements.resize(n*D,this->PaddedSize);
+    RSoA.resize(D,this->PaddedSize);
+  }
+
+  inline void evaluate(const ParticleSet& P)
+  {
+    base_type::evaluate(P);
+    const int n=this->N[DistanceTableData::SourceIndex];
+    for(int iat=0; iat<n; ++iat)
+      for(int d=0; d<D; ++d)
+        RSoA(d,iat)=P.R[iat][d];
+    //unfold the pair data: dr_m[ij]=R[j]-R[i] for i<j
+    for(int i=0,ij=0; i<n; i++)
+    {
+      this->Distances(i,i)=0.0;
+      for(int d=0; d<D; ++d)
+        this->Displacements(i*D+d,i)=0.0;
+      for(int j=i+1; j<n; j++, ij++)
+      {
+        this->Distances(i,j)=this->Distances(j,i)=this->r_m[ij];
+        for(int d=0; d<D; ++d)
+        {
+          this->Displacements(j*D+d,i)=this->dr_m[ij][d];
+          this->Displacements(i*D+d,j)=-this->dr_m[ij][d];
+        }
+      }
+    }
+  }
+
+  ///evaluate the temporary pair relations on the SoA rows and fill Temp if needed
+  inline void move(const ParticleSet& P, const PosType& rnew, IndexType jat)
+  {
+    moveSoA(rnew,jat);
+    if(!this->NeedTemp)
+      return;
+    const int n=this->N[DistanceTableData::SourceIndex];
+    for(int iat=0; iat<n; ++iat)
+    {
+      const T r=this->Temp_r[iat];
+      this->Temp[iat].r1=r;
+      this->Temp[iat].rinv1=1.0/r;
+      for(int d=0; d<D; ++d)
+        this->Temp[iat].dr1[d]=this->Temp_dr(d,iat);
+      this->Temp[iat].dr1_nobox=rnew-P.R[iat];
+    }
+  }
+
+  inline void moveOnSphere(const ParticleSet& P, const PosType& rnew, IndexType jat)
+  {
+    moveSoA(rnew,jat);
+    if(!this->NeedTemp)
+      return;
+    const int n=this->N[DistanceTableData::SourceIndex];
+    for(int iat=0; iat<n; ++iat)
+    {
+      this->Temp[iat].r1=this->Temp_r[iat];
+      for(int d=0; d<D; ++d)
+        this->Temp[iat].dr1[d]=this->Temp_dr(d,iat);
+    }
+  }
+
+  ///update the row and column of the jat-th particle and the pair data
+  inline void update(IndexType jat)
+  {
+    const int n=this->N[DistanceTableData::SourceIndex];
+    for(int iat=0,nn=jat; iat<jat; iat++,nn+=n)
+    {
+      const int loc=this->IJ[nn];
+      this->r_m[loc]=this->Temp_r[iat];
+      this->rinv_m[loc]=1.0/this->Temp_r[iat];
+      for(int d=0; d<D; ++d)
+        this->dr_m[loc][d]=this->Temp_dr(d,iat);
+    }
+    for(int nn=this->M[jat]; nn<this->M[jat+1]; nn++)
+    {
+      const int iat=this->J[nn];
+      this->r_m[nn]=this->Temp_r[iat];
+      this->rinv_m[nn]=1.0/this->Temp_r[iat];
+      for(int d=0; d<D; ++d)
+        this->dr_m[nn][d]=-this->Temp_dr(d,iat);
+    }
+    simd::copy(this->Distances[jat],&(this->Temp_r[0]),n);
+    for(int d=0; d<D; ++d)
+      simd::copy(this->Displacements[jat*D+d],this->Temp_dr[d],n);
+    for(int iat=0; iat<n; ++iat)
+    {
+      this->Distances(iat,jat)=this->Temp_r[iat];
+      for(int d=0; d<D; ++d)
+        this->Displacements(iat*D+d,jat)=-this->Temp_dr(d,iat);
+    }
+    this->Distances(jat,jat)=0.0;
+    for(int d=0; d<D; ++d)
+    {
+      this->Displacements(jat*D+d,jat)=0.0;
+      RSoA(d,jat)=Rnew[d];
+    }
+  }
+
+private:
+  inline void moveSoA(const PosType& rnew, IndexType jat)
+  {
+    this->activePtcl=jat;
+    Rnew=rnew;
+    compute_displ_soa(static_cast<const DTD_BConds<T,D,SC>&>(*this),rnew
+                      ,RSoA.data(),this->Temp_dr.data(),this->PaddedSize
+                      ,&(this->Temp_r[0]),this->N[DistanceTableData::SourceIndex]);
+  }
+};
+
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
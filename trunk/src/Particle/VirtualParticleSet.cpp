@@ -0,0 +1,54 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+#include "Particle/VirtualParticleSet.h"
+#include "Particle/DistanceTable.h"
+#include "Particle/DistanceTableData.h"
+
+namespace qmcplusplus
+{
+
+VirtualParticleSet::VirtualParticleSet(ParticleSet& p, int nptcl)
+  : refPS(p), refPtcl(-1)
+{
+  ostringstream o;
+  o<<p.getName()<<"_vp"<<ObjectTag;
+  this->setName(o.str());
+  Lattice.copy(p.Lattice);
+  create(nptcl);
+  //the i-th table is for the source of the i-th table of refPS: no this-this table
+  DistTables.reserve(p.DistTables.size());
+  for (int i=0; i<p.DistTables.size(); ++i)
+  {
+    DistTables.push_back(createDistanceTable(p.DistTables[i]->origin(),*this,DistanceTableData::DT_SOA));
+    DistTables[i]->ID=i;
+  }
+}
+
+void VirtualParticleSet::makeMoves(int iat, const vector<SingleParticlePos_t>& deltaV)
+{
+  refPtcl=iat;
+  for (int k=0; k<deltaV.size(); ++k)
+    R[k]=refPS.R[iat]+deltaV[k];
+  for (int i=0; i<DistTables.size(); ++i)
+    DistTables[i]->evaluate(*this);
+}
+
+}
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,69 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file VirtualParticleSet.h
+ * @brief A ParticleSet holding the virtual positions of a particle
+ */
+#ifndef QMCPLUSPLUS_VIRTUAL_PARTICLESET_H
+#define QMCPLUSPLUS_VIRTUAL_PARTICLESET_H
+
+#include <Particle/ParticleSet.h>
+
+namespace qmcplusplus
+{
+
+/** A ParticleSet of the virtual moves of a particle of a reference ParticleSet
+ *
+ * The positions R[k] are the trial positions of the refPtcl-th particle of refPS,
+ * e.g., the quadrature points of the non-local pseudopotentials.
+ * DistTables[i] is the table of refPS.DistTables[i]->origin() and the virtual particles
+ * so that an orbital can access the distances of all the virtual moves using
+ * the ID of its own table. The tables use the SoA storage:
+ * getDistRow(k) returns the distances of the k-th virtual particle to all the sources.
+ * The virtual moves do not change the state of refPS.
+ */
+class VirtualParticleSet: public ParticleSet
+{
+public:
+  ///reference ParticleSet
+  ParticleSet& refPS;
+  ///index of the particle of refPS which is moved virtually
+  int refPtcl;
+
+  /** constructor
+   * @param p reference ParticleSet
+   * @param nptcl number of the virtual moves
+   */
+  VirtualParticleSet(ParticleSet& p, int nptcl);
+
+  /** set the virtual positions and evaluate the distance tables
+   * @param iat particle of refPS
+   * @param deltaV displacements of the virtual moves from refPS.R[iat]
+   */
+  void makeMoves(int iat, const vector<SingleParticlePos_t>& deltaV);
+
+  ///return true if the tables match those of refPS
+  inline bool isValid(const ParticleSet& p) const
+  {
+    return &p == &refPS && DistTables.size() == refPS.DistTables.size();
+  }
+};
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
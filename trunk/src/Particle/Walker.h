@@ -18,6 +18,7 @@
 
 #include "OhmmsPETE/OhmmsMatrix.h"
 #include "Utilities/PooledData.h"
+#include "Particle/WalkerResource.h"
 #ifdef QMC_CUDA
 #include "Utilities/PointerPool.h"
 #include "CUDA/gpu_vector.h"
@@ -56,6 +57,7 @@ enum {LOGPSI=0,       /*!< log(fabs(psi)) instead of square of the many-body wav
  * - Multiplicity : multiplicity for branching. Probably can be removed.
  * - Properties  : 2D container. RealTypehe first index corresponds to the H/Psi index and second index >=NUMPROPERTIES.
  * - DataSet : anonymous container.
+ * - Resources : data owned by the walker for the objects bound to it.
  */
 template<typename t_traits, typename p_traits>
 struct Walker
@@ -120,6 +122,13 @@ struct Walker
   //analytical derivatives during linear optimization, e.g. MultiDeterminants
   Buffer_t DataSetForDerivatives;
 
+  /** data which the objects, e.g., trial wavefunctions, keep in this walker
+   *
+   * The resources are not packed by putMessage and are cleared by
+   * getMessage. The owners recreate them when they are empty.
+   */
+  WalkerResourceSet Resources;
+
   /// Data for GPU-vectorized versions
 #ifdef QMC_CUDA
   static int cuda_DataSize;
@@ -274,6 +283,7 @@ struct Walker
     //Drift = a.Drift;
     Properties.copy(a.Properties);
     DataSet=a.DataSet;
+    Resources=a.Resources;
     if (PropertyHistory.size()!=a.PropertyHistory.size())
       PropertyHistory.resize(a.PropertyHistory.size());
     for (int i=0; i<PropertyHistory.size(); i++)
@@ -471,6 +481,7 @@ struct Walker
 #endif
     m.Unpack(Properties.data(),Properties.size());
     m.Unpack(DataSet.data(),DataSet.size());
+    Resources.clear();
     //Properties.getMessage(m);
     //DataSet.getMessage(m);
     for (int iat=0; iat<PropertyHistory.size(); iat++)
@@ -0,0 +1,132 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file WalkerResource.h
+ * @brief Declaration of WalkerResource and WalkerResourceSet
+ */
+#ifndef QMCPLUSPLUS_WALKER_RESOURCE_H
+#define QMCPLUSPLUS_WALKER_RESOURCE_H
+#include <vector>
+#include <typeinfo>
+
+namespace qmcplusplus
+{
+
+/** abstract base class of the data owned by a walker on behalf of an object
+ *
+ * An object, e.g., a component of a trial wavefunction, binds itself to
+ * the data of the walker being moved instead of copying them from Walker::DataSet.
+ */
+struct WalkerResource
+{
+  virtual ~WalkerResource() {}
+  ///return a deep copy
+  virtual WalkerResource* makeClone() const=0;
+  ///copy the content of a of the same type in place
+  virtual void copyFrom(const WalkerResource& a)=0;
+};
+
+/** container of WalkerResource with deep-copy semantics
+ *
+ * A copy reuses the storage of the existing elements of the same type,
+ * so that a recycled walker is overwritten in place.
+ */
+struct WalkerResourceSet: public WalkerResource
+{
+  std::vector<WalkerResource*> Data;
+
+  inline WalkerResourceSet() { }
+
+  inline WalkerResourceSet(const WalkerResourceSet& a)
+  {
+    copyFrom(a);
+  }
+
+  inline ~WalkerResourceSet()
+  {
+    clear();
+  }
+
+  inline WalkerResourceSet& operator=(const WalkerResourceSet& a)
+  {
+    if(this != &a)
+      copyFrom(a);
+    return *this;
+  }
+
+  inline bool empty() const
+  {
+    return Data.empty();
+  }
+
+  inline int size() const
+  {
+    return Data.size();
+  }
+
+  inline WalkerResource& operator[](int i)
+  {
+    return *Data[i];
+  }
+
+  ///add a resource, owned by this object
+  inline void push_back(WalkerResource* r)
+  {
+    Data.push_back(r);
+  }
+
+  ///delete the resources
+  inline void clear()
+  {
+    for(int i=0; i<Data.size(); ++i)
+      delete Data[i];
+    Data.clear();
+  }
+
+  WalkerResource* makeClone() const
+  {
+    return new WalkerResourceSet(*this);
+  }
+
+  void copyFrom(const WalkerResource& r)
+  {
+    const WalkerResourceSet& a(static_cast<const WalkerResourceSet&>(r));
+    if(Data.size() != a.Data.size())
+      clear();
+    if(Data.empty())
+    {
+      for(int i=0; i<a.Data.size(); ++i)
+        Data.push_back(a.Data[i]->makeClone());
+      return;
+    }
+    for(int i=0; i<Data.size(); ++i)
+    {
+      if(typeid(*Data[i]) == typeid(*a.Data[i]))
+        Data[i]->copyFrom(*a.Data[i]);
+      else
+      {
+        delete Data[i];
+        Data[i]=a.Data[i]->makeClone();
+      }
+    }
+  }
+};
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -125,6 +125,14 @@ public:
     nGhosts = 0;
   }
 
+  //! exchange the content with a without copying the elements
+  inline void swap(ParticleAttrib<T>& a)
+  {
+    std::swap(nLocal,a.nLocal);
+    std::swap(nGhosts,a.nGhosts);
+    X.swap(a.X);
+  }
+
   //! remove ghost elements
   inline void clearGhosts()
   {
@@ -27,6 +27,7 @@
 #endif
 #include "QMCWaveFunctions/OrbitalBuilderBase.h"
 #include "Utilities/ProgressReportEngine.h"
+#include "Utilities/SimpleParser.h"
 #include "OhmmsData/AttributeSet.h"
 #include "QMCApp/InitMolecularSystem.h"
 
@@ -129,6 +130,9 @@ bool ParticleSetPool::put(xmlNodePtr cur)
   string role("none");
   string randomR("no");
   string randomsrc;
+  string useSoA("no");
+  string useCellList("no");
+  double rcutCellList=0.0;
   OhmmsAttributeSet pAttrib;
   pAttrib.add(id,"id");
   pAttrib.add(id,"name");
@@ -136,6 +140,9 @@ bool ParticleSetPool::put(xmlNodePtr cur)
   pAttrib.add(randomR,"random");
   pAttrib.add(randomsrc,"randomsrc");
   pAttrib.add(randomsrc,"random_source");
+  pAttrib.add(useSoA,"soa");
+  pAttrib.add(useCellList,"celllist");
+  pAttrib.add(rcutCellList,"celllist_rcut");
   pAttrib.put(cur);
   //backward compatibility
   if(id == "e" && role=="none")
@@ -166,6 +173,25 @@ bool ParticleSetPool::put(xmlNodePtr cur)
       randomize_nodes.push_back(anode);
     }
     pTemp->setName(id);
+    //distance tables with the SoA storage: soa="yes" or soa="e ion0"
+    if(useSoA != "no")
+    {
+      parsewords(useSoA.c_str(),pTemp->SoASources);
+      app_log() << "  Distance tables with the SoA storage for the sources = " << useSoA << endl;
+    }
+    //distance tables with the cell lists: celllist="yes" or celllist="e ion0" with celllist_rcut
+    if(useCellList != "no")
+    {
+      if(rcutCellList>0.0)
+      {
+        parsewords(useCellList.c_str(),pTemp->CellListSources);
+        pTemp->CellListCutoff=rcutCellList;
+        app_log() << "  Distance tables with the cell lists for the sources = " << useCellList
+                  << " cutoff = " << rcutCellList << endl;
+      }
+      else
+        app_warning() << "  celllist needs a positive celllist_rcut. Ignored." << endl;
+    }
     app_log() << pTemp->getName() <<endl;
     return success;
   }
@@ -23,6 +23,7 @@
 #include "QMCWaveFunctions/TrialWaveFunction.h"
 #include "QMCDrivers/VMC/VMCFactory.h"
 #include "QMCDrivers/DMC/DMCFactory.h"
+#include "QMCDrivers/RMC/RMCSingleOMP.h"
 #include "QMCDrivers/QMCOptimize.h"
 #include "QMCDrivers/QMCFixedSampleLinearOptimize.h"
 #include "QMCDrivers/QMCCorrelatedSamplingLinearOptimize.h"
@@ -142,6 +143,10 @@ bool QMCDriverFactory::setQMCDriver(int curSeries, xmlNodePtr cur)
     {
       newRunType=DMC_RUN;
     }
+    else if(qmc_mode.find("rmc")<nchars)
+    {
+      newRunType=RMC_RUN;
+    }
   }
   unsigned long newQmcMode=WhatToDo.to_ulong();
   //initialize to 0
@@ -267,6 +272,10 @@ void QMCDriverFactory::createQMCDriver(xmlNodePtr cur)
                    curQmcModeBits[GPU_MODE], cur);
     qmcDriver = fac.create(*qmcSystem,*primaryPsi,*primaryH,*hamPool,*psiPool);
   }
+  else if(curRunType == RMC_RUN)
+  {
+    qmcDriver = new RMCSingleOMP(*qmcSystem,*primaryPsi,*primaryH,*hamPool,*psiPool);
+  }
   else if(curRunType == OPTIMIZE_RUN)
   {
     QMCOptimize *opt = new QMCOptimize(*qmcSystem,*primaryPsi,*primaryH,*hamPool,*psiPool);
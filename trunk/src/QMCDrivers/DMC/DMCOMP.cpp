@@ -24,6 +24,7 @@
 #include "Utilities/Timer.h"
 #include "OhmmsApp/RandomNumberControl.h"
 #include "Utilities/ProgressReportEngine.h"
+#include "qmc_common.h"
 
 namespace qmcplusplus
 {
@@ -211,6 +212,7 @@ bool DMCOMP::run()
   Timer myclock;
   IndexType block = 0;
   IndexType updatePeriod=(QMCDriverMode[QMC_UPDATE_MODE])?Period4CheckProperties:(nBlocks+1)*nSteps;
+  branchEngine->setOverlapSwap(qmc_common.overlap_swap);
   do // block
   {
     Estimators->startBlock(nSteps);
@@ -223,20 +225,17 @@ bool DMCOMP::run()
 //           ForwardWalkingHistory.storeConfigsForForwardWalking(W);
 //           W.resetWalkerParents();
 //         }
-      #pragma omp parallel
+      advanceWalkers(wPerNode,true,updatePeriod);
+      //advance the walkers which arrived while the local walkers were advanced
+      int nw_local=W.getActiveWalkers();
+      if(branchEngine->completeSwap(W))
       {
-        int ip=omp_get_thread_num();
-        int now=CurrentStep;
-        MCWalkerConfiguration::iterator
-        wit(W.begin()+wPerNode[ip]), wit_end(W.begin()+wPerNode[ip+1]);
-        for(int interval = 0; interval<BranchInterval-1; ++interval,++now)
-          Movers[ip]->advanceWalkers(wit,wit_end,false);
-        wClones[ip]->resetCollectables();
-        Movers[ip]->advanceWalkers(wit,wit_end,false);
-        Movers[ip]->setMultiplicity(wit,wit_end);
-        if(QMCDriverMode[QMC_UPDATE_MODE] && now%updatePeriod == 0)
-          Movers[ip]->updateWalkers(wit, wit_end);
-      }//#pragma omp parallel
+        vector<int> wpart;
+        FairDivideLow(W.getActiveWalkers()-nw_local,NumThreads,wpart);
+        for(int ip=0; ip<=NumThreads; ++ip)
+          wpart[ip]+=nw_local;
+        advanceWalkers(wpart,false,updatePeriod);
+      }
       //Collectables are weighted but not yet normalized
       if(W.Collectables.size())
       {
@@ -245,6 +244,9 @@ bool DMCOMP::run()
           W.Collectables += wClones[ip]->Collectables;
       }
       branchEngine->branch(CurrentStep, W, branchClones);
+      //all the walkers are local at the end of a block
+      if(step+1 == nSteps)
+        branchEngine->completeSwap(W);
 //         if(storeConfigs && (CurrentStep%storeConfigs == 0)) {
 //           ForwardWalkingHistory.storeConfigsForForwardWalking(W);
 //           W.resetWalkerParents();
@@ -263,6 +265,7 @@ bool DMCOMP::run()
     recordBlock(block);
   }
   while(block<nBlocks && myclock.elapsed()<MaxCPUSecs);
+  branchEngine->setOverlapSwap(false);
   //for(int ip=0; ip<NumThreads; ip++) Movers[ip]->stopRun();
   for(int ip=0; ip<NumThreads; ip++)
     *(RandomNumberControl::Children[ip])=*(Rng[ip]);
@@ -270,6 +273,25 @@ bool DMCOMP::run()
   return finalize(block);
 }
 
+void DMCOMP::advanceWalkers(const vector<int>& wpart, bool resetCollectables, IndexType updatePeriod)
+{
+  #pragma omp parallel
+  {
+    int ip=omp_get_thread_num();
+    int now=CurrentStep;
+    MCWalkerConfiguration::iterator
+    wit(W.begin()+wpart[ip]), wit_end(W.begin()+wpart[ip+1]);
+    for(int interval = 0; interval<BranchInterval-1; ++interval,++now)
+      Movers[ip]->advanceWalkers(wit,wit_end,false);
+    if(resetCollectables)
+      wClones[ip]->resetCollectables();
+    Movers[ip]->advanceWalkers(wit,wit_end,false);
+    Movers[ip]->setMultiplicity(wit,wit_end);
+    if(QMCDriverMode[QMC_UPDATE_MODE] && now%updatePeriod == 0)
+      Movers[ip]->updateWalkers(wit, wit_end);
+  }//#pragma omp parallel
+}
+
 void DMCOMP::benchMark()
 {
   //set the collection mode for the estimator
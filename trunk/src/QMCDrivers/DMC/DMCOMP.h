@@ -68,6 +68,12 @@ private:
 
 
   void resetUpdateEngines();
+  /** advance the walkers [wpart[ip],wpart[ip+1]) of the ip-th thread for BranchInterval steps
+   * @param wpart partition of the walkers
+   * @param resetCollectables if true, reset the collectables of the clones
+   * @param updatePeriod interval to update the walker buffers
+   */
+  void advanceWalkers(const vector<int>& wpart, bool resetCollectables, IndexType updatePeriod);
   void benchMark();
   /// Copy Constructor (disabled)
   DMCOMP(const DMCOMP& a): QMCDriver(a), CloneManager(a) { }
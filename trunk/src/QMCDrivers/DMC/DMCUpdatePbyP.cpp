@@ -54,6 +54,7 @@ void DMCUpdatePbyPWithRejection::advanceWalkers(WalkerIter_t it, WalkerIter_t it
     bool measure)
 {
   myTimers[0]->start();
+  const bool resident=useResources();
   for(; it != it_end; ++it)
   {
     //MCWalkerConfiguration::WalkerData_t& w_buffer = *(W.DataSet[iwalker]);
@@ -63,7 +64,15 @@ void DMCUpdatePbyPWithRejection::advanceWalkers(WalkerIter_t it, WalkerIter_t it
     //W.R = thisWalker.R;
     //w_buffer.rewind();
     //W.copyFromBuffer(w_buffer);
-    Psi.copyFromBuffer(W,w_buffer);
+    if(resident)
+    {
+      //new walkers and the walkers received from other tasks have no resources
+      if(thisWalker.Resources.empty())
+        Psi.registerResources(W,thisWalker.Resources);
+      Psi.bindResources(W,thisWalker.Resources);
+    }
+    else
+      Psi.copyFromBuffer(W,w_buffer);
     //create a 3N-Dimensional Gaussian with variance=1
     makeGaussRandomWithEngine(deltaR,RandomGen);
     int nAcceptTemp(0);
@@ -154,7 +163,7 @@ void DMCUpdatePbyPWithRejection::advanceWalkers(WalkerIter_t it, WalkerIter_t it
       nodecorr=getNodeCorrection(W.G,drift);
       //w_buffer.rewind();
       //W.copyToBuffer(w_buffer);
-      RealType logpsi = Psi.evaluateLog(W,w_buffer);
+      RealType logpsi = resident? Psi.storeResources(W,thisWalker.Resources): Psi.evaluateLog(W,w_buffer);
       W.saveWalker(thisWalker);
       myTimers[2]->stop();
       myTimers[3]->start();
@@ -197,7 +206,7 @@ void DMCUpdatePbyPWithRejection::advanceWalkers(WalkerIter_t it, WalkerIter_t it
         //thisWalker.R[iat]=W.R[iat];
         //w_buffer.rewind();
         //W.copyToBuffer(w_buffer);
-        RealType logpsi = Psi.evaluateLog(W,w_buffer);
+        RealType logpsi = resident? Psi.storeResources(W,thisWalker.Resources): Psi.evaluateLog(W,w_buffer);
         W.saveWalker(thisWalker);
         ++NonLocalMoveAccepted;
         myTimers[2]->stop();
@@ -215,6 +224,8 @@ void DMCUpdatePbyPWithRejection::advanceWalkers(WalkerIter_t it, WalkerIter_t it
     //thisWalker.Weight *= branchEngine->branchWeight(enew,eold,nodecorr,nodecorr_oldi,odd);
     nAccept += nAcceptTemp;
     nReject += nRejectTemp;
+    if(resident)
+      Psi.releaseResources(W,thisWalker.Resources);
   }
   myTimers[0]->stop();
 }
@@ -36,6 +36,13 @@ public:
 
   void advanceWalkers(WalkerIter_t it, WalkerIter_t it_end, bool measure);
 
+protected:
+  ///the walkers keep the trial wavefunction in the resources if residentState="yes"
+  bool useResources() const
+  {
+    return ResidentState == "yes";
+  }
+
 private:
   vector<NewTimer*> myTimers;
 };
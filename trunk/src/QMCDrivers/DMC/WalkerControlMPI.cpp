@@ -47,6 +47,7 @@ namespace qmcplusplus
  * set SwapMode
  */
 WalkerControlMPI::WalkerControlMPI(Communicate* c): WalkerControlBase(c)
+  , WalkerByteSize(0), NumSends(0), NumRecvs(0), SwapPending(false)
 {
   SwapMode=1;
   Cur_min=0;
@@ -64,6 +65,12 @@ WalkerControlMPI::WalkerControlMPI(Communicate* c): WalkerControlBase(c)
   TimerManager.addTimer(myTimers[2]);
 }
 
+WalkerControlMPI::~WalkerControlMPI()
+{
+  delete_iter(SendBuffers.begin(),SendBuffers.end());
+  delete_iter(RecvBuffers.begin(),RecvBuffers.end());
+}
+
 int
 WalkerControlMPI::branch(int iter, MCWalkerConfiguration& W, RealType trigger)
 {
@@ -101,7 +108,13 @@ WalkerControlMPI::branch(int iter, MCWalkerConfiguration& W, RealType trigger)
   }
   myTimers[1]->stop();
   myTimers[2]->start();
-  if(qmc_common.async_swap)
+  //with OverlapSwap, the exchange is started by startSwap after the
+  //estimators are accumulated on the population of this branch
+  if(OverlapSwap)
+    SwapPending=true;
+  else if(qmc_common.overlap_swap)
+    swapWalkersOverlap(W);
+  else if(qmc_common.async_swap)
     swapWalkersAsync(W);
   else
     swapWalkersSimple(W);
@@ -131,7 +144,16 @@ WalkerControlMPI::branch(int iter, MCWalkerConfiguration& W, RealType trigger)
   }
   //update the global number of walkers and offsets
   W.setGlobalNumWalkers(Cur_pop);
-  W.setWalkerOffsets(FairOffSet);
+  if(SwapPending)
+  {
+    //the walkers stay on this node until startSwap
+    OffSet[0]=0;
+    for(int i=0; i<NumContexts; i++)
+      OffSet[i+1]=OffSet[i]+NumPerNode[i];
+    W.setWalkerOffsets(OffSet);
+  }
+  else
+    W.setWalkerOffsets(FairOffSet);
   DMC_BRANCH_STOP(bTime[2],localTimer.elapsed());
   DMC_BRANCH_DUMP(iter,bTime[0],bTime[1],bTime[2]);
   myTimers[0]->stop();
@@ -203,7 +225,7 @@ void WalkerControlMPI::swapWalkersSimple(MCWalkerConfiguration& W)
     {
       OOMPI_Packed recvBuffer(wRef.byteSize(),myComm->getComm());
       myComm->getComm()[plus[ic]].Recv(recvBuffer);
-      Walker_t *awalker= new Walker_t(wRef);
+      Walker_t *awalker= newWalker(wRef,false);
       awalker->getMessage(recvBuffer);
       newW.push_back(awalker);
     }
@@ -213,7 +235,7 @@ void WalkerControlMPI::swapWalkersSimple(MCWalkerConfiguration& W)
   if(nsend)
   {
     nsend=NumPerNode[MyContext]-nsend;
-    W.destroyWalkers(W.begin()+nsend, W.end());
+    recycleWalkers(W,nsend);
   }
   //add walkers from other node
   if(newW.size())
@@ -327,7 +349,7 @@ void WalkerControlMPI::swapWalkersAsync(MCWalkerConfiguration& W)
       requests[ip].Wait();
       for(int cs = 0; cs < sendCounts[ip]; ++cs)
       {
-        Walker_t *awalker= new Walker_t(wRef);
+        Walker_t *awalker= newWalker(wRef,false);
         awalker->getMessage(*(recvBuffers[ip]));
         newW.push_back(awalker);
       }
@@ -349,13 +371,151 @@ void WalkerControlMPI::swapWalkersAsync(MCWalkerConfiguration& W)
   if(nsend)
   {
     nsend=NumPerNode[MyContext]-nsend;
-    W.destroyWalkers(W.begin()+nsend, W.end());
+    recycleWalkers(W,nsend);
   }
   //add walkers from other node
   if(newW.size())
     W.insert(W.end(),newW.begin(),newW.end());
 }
 
+OOMPI_Packed* WalkerControlMPI::getBuffer(vector<OOMPI_Packed*>& bufs, vector<int>& caps, int i, int nw)
+{
+  if(i>=bufs.size())
+  {
+    bufs.push_back(0);
+    caps.push_back(0);
+  }
+  if(caps[i]<nw)
+  {
+    delete bufs[i];
+    bufs[i]=new OOMPI_Packed(nw*WalkerByteSize,myComm->getComm());
+    caps[i]=nw;
+  }
+  //a packed message is sent as a whole: keep the memory but send nw walkers
+  bufs[i]->Set_size(nw*WalkerByteSize);
+  bufs[i]->Reset();
+  return bufs[i];
+}
+
+void WalkerControlMPI::swapWalkersOverlap(MCWalkerConfiguration& W)
+{
+  //complete any exchange left by a driver which does not call completeSwap
+  completeSwap(W);
+  FairDivideLow(Cur_pop,NumContexts,FairOffSet);
+  vector<int> minus, plus;
+  for(int ip=0; ip<NumContexts; ip++)
+  {
+    int dn=NumPerNode[ip]-(FairOffSet[ip+1]-FairOffSet[ip]);
+    if(dn>0)
+      plus.insert(plus.end(),dn,ip);
+    else
+      if(dn<0)
+        minus.insert(minus.end(),-dn,ip);
+  }
+  int nswap=std::min(plus.size(), minus.size());
+  if(nswap==0)
+  {
+    NumWalkersSent=0;
+    W.setWalkerOffsets(FairOffSet);
+    return;
+  }
+  Walker_t& wRef(*W[0]);
+  if(WalkerByteSize != wRef.byteSize())
+  {
+    //the walker size has changed: drop the buffers
+    delete_iter(SendBuffers.begin(),SendBuffers.end());
+    delete_iter(RecvBuffers.begin(),RecvBuffers.end());
+    SendBuffers.clear();
+    RecvBuffers.clear();
+    SendCapacity.clear();
+    RecvCapacity.clear();
+    WalkerByteSize=wRef.byteSize();
+  }
+  int last=W.getActiveWalkers()-1;
+  int nsend=0;
+  int countSend=1;
+  for(int ic=0; ic<nswap; ic++)
+  {
+    //group the walkers of the same (plus,minus) pair into a message
+    if((ic < nswap - 1) && (plus[ic] == plus[ic+1]) && (minus[ic] == minus[ic+1]))
+    {
+      countSend++;
+      continue;
+    }
+    if(plus[ic]==MyContext)
+    {
+      OOMPI_Packed* sendBuffer=getBuffer(SendBuffers,SendCapacity,NumSends,countSend);
+      for(int cs = 0; cs < countSend; ++cs)
+      {
+        W[last]->putMessage(*sendBuffer);
+        --last;
+      }
+      if(NumSends>=SendRequests.size())
+        SendRequests.resize(NumSends+1);
+      SendRequests[NumSends++]=myComm->getComm()[minus[ic]].Isend(*sendBuffer, plus[ic]);
+      nsend += countSend;
+    }
+    if(minus[ic]==MyContext)
+    {
+      OOMPI_Packed* recvBuffer=getBuffer(RecvBuffers,RecvCapacity,NumRecvs,countSend);
+      if(NumRecvs>=RecvRequests.size())
+      {
+        RecvRequests.resize(NumRecvs+1);
+        RecvCounts.resize(NumRecvs+1);
+      }
+      RecvCounts[NumRecvs]=countSend;
+      RecvRequests[NumRecvs++]=myComm->getComm()[plus[ic]].Irecv(*recvBuffer, plus[ic]);
+    }
+    countSend=1;
+  }
+  //save the number of walkers sent
+  NumWalkersSent=nsend;
+  //the sent walkers are packed in the buffers
+  if(nsend)
+    recycleWalkers(W,NumPerNode[MyContext]-nsend);
+  if(!OverlapSwap)
+    completeSwap(W);
+  else
+    if(NumSends+NumRecvs == 0)
+      W.setWalkerOffsets(FairOffSet);
+}
+
+void WalkerControlMPI::startSwap(MCWalkerConfiguration& W)
+{
+  if(!SwapPending)
+    return;
+  SwapPending=false;
+  swapWalkersOverlap(W);
+}
+
+int WalkerControlMPI::completeSwap(MCWalkerConfiguration& W)
+{
+  //a swap left pending by a driver which does not call startSwap
+  startSwap(W);
+  if(NumSends+NumRecvs == 0)
+    return 0;
+  vector<Walker_t*> newW;
+  for(int i=0; i<NumRecvs; ++i)
+  {
+    RecvRequests[i].Wait();
+    for(int cs = 0; cs < RecvCounts[i]; ++cs)
+    {
+      Walker_t *awalker= newWalker(*W[0],false);
+      awalker->getMessage(*RecvBuffers[i]);
+      awalker->Weight=1.0;
+      awalker->Multiplicity=1.0;
+      newW.push_back(awalker);
+    }
+  }
+  for(int i=0; i<NumSends; ++i)
+    SendRequests[i].Wait();
+  NumSends=NumRecvs=0;
+  if(newW.size())
+    W.insert(W.end(),newW.begin(),newW.end());
+  W.setWalkerOffsets(FairOffSet);
+  return newW.size();
+}
+
 /** swap Walkers with Recv/Send
  *
  * The algorithm ensures that the load per node can differ only by one walker.
@@ -384,7 +544,7 @@ void WalkerControlMPI::swapWalkersBlocked(MCWalkerConfiguration& W)
     myComm->getComm()[MyContext-1].Recv(recvBuffer);
     while(dn)
     {
-      Walker_t *awalker= new Walker_t(wRef);
+      Walker_t *awalker= newWalker(wRef,false);
       awalker->getMessage(recvBuffer);
       newW.push_back(awalker);
       --dn;
@@ -434,17 +594,14 @@ void WalkerControlMPI::swapWalkersBlocked(MCWalkerConfiguration& W)
       int dn=toRight;
       while(dn)
       {
-        Walker_t *awalker= new Walker_t(wRef);
+        Walker_t *awalker= newWalker(wRef,false);
         awalker->getMessage(recvBuffer);
         newW.push_back(awalker);
         --dn;
       }
     }
-  while(num_deleted>0)
-  {
-    W.pop_back();
-    --num_deleted;
-  }
+  if(num_deleted>0)
+    recycleWalkers(W,W.getActiveWalkers()-num_deleted);
   if(newW.size())
     W.insert(W.end(),newW.begin(),newW.end());
 }
@@ -519,7 +676,7 @@ void WalkerControlMPI::swapWalkersMap(MCWalkerConfiguration& W)
       int last = W.getActiveWalkers();
       while(dnw)
       {
-        Walker_t *awalker= new Walker_t(wRef);
+        Walker_t *awalker= newWalker(wRef,false);
         awalker->getMessage(recvBuffer);
         W.push_back(awalker);
         --dnw;
@@ -547,7 +704,7 @@ void WalkerControlMPI::swapWalkersMap(MCWalkerConfiguration& W)
       //  --dnw_save; --last;
       //}
       //destroyWalkers(WalkerList.begin()+nsub[MyContext], WalkerList.end());
-      W.destroyWalkers(W.begin()+nw_R, W.end());
+      recycleWalkers(W,nw_R);
     }
   }
   /* not used yet
@@ -36,17 +36,54 @@ struct WalkerControlMPI: public WalkerControlBase
   int Cur_max;
   int Cur_min;
   vector<NewTimer*> myTimers;
+  ///size of a walker message in bytes
+  int WalkerByteSize;
+  ///persistent buffers for swapWalkersOverlap, reused over the steps
+  vector<OOMPI_Packed*> SendBuffers, RecvBuffers;
+  ///capacities of SendBuffers and RecvBuffers in the number of walkers
+  vector<int> SendCapacity, RecvCapacity;
+  ///requests of the messages in flight
+  vector<OOMPI_Request> SendRequests, RecvRequests;
+  ///number of walkers of the receives in flight
+  vector<int> RecvCounts;
+  ///number of the sends and receives in flight
+  int NumSends, NumRecvs;
+  ///true, if branch has left the exchange to startSwap
+  bool SwapPending;
+
   /** default constructor
    *
    * Set the SwapMode to zero so that instantiation can be done
    */
   WalkerControlMPI(Communicate* c=0);
 
+  ///destructor
+  ~WalkerControlMPI();
+
   /** perform branch and swap walkers as required */
   int branch(int iter, MCWalkerConfiguration& W, RealType trigger);
 
+  /** start the exchange left pending by branch with OverlapSwap */
+  void startSwap(MCWalkerConfiguration& W);
+
+  /** wait for the walkers in flight and add them to W */
+  int completeSwap(MCWalkerConfiguration& W);
+
   void swapWalkersSimple(MCWalkerConfiguration& W);
 
+  /** swap walkers with Isend/Irecv using the persistent buffers
+   *
+   * The walkers to send are packed and removed from W. The walkers to receive
+   * are added by completeSwap, which is called here unless OverlapSwap is set.
+   * With OverlapSwap, branch only marks the exchange pending and startSwap
+   * calls this after the estimators have been accumulated, so that every
+   * walker of the step is counted once on the node which owns it.
+   */
+  void swapWalkersOverlap(MCWalkerConfiguration& W);
+
+  ///return a buffer for nw walkers, reallocated only when it is too small
+  OOMPI_Packed* getBuffer(vector<OOMPI_Packed*>& bufs, vector<int>& caps, int i, int nw);
+
   //old implementations
   void swapWalkersAsync(MCWalkerConfiguration& W);
   void swapWalkersBlocked(MCWalkerConfiguration& W);
@@ -249,6 +249,7 @@ void QMCDriver::recordBlock(int block)
 bool QMCDriver::finalize(int block, bool dumpwalkers)
 {
   TimerManager.print(myComm);
+  TimerManager.write(myComm,RootName,QMCType);
   TimerManager.reset();
   if(DumpConfig && dumpwalkers)
     wOut->dump(W);
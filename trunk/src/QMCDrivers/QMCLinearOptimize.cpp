@@ -117,6 +117,7 @@ void QMCLinearOptimize::finish()
   MyCounter++;
   app_log() << "  Execution time = " << t1.elapsed() << endl;
   TimerManager.print(myComm);
+  TimerManager.write(myComm,RootName,QMCType);
   TimerManager.reset();
   app_log() << "  </log>" << endl;
   optTarget->reportParameters();
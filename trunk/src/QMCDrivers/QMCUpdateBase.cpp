@@ -60,6 +60,10 @@ void QMCUpdateBase::setDefaults()
   MaxAge=10;
   m_r2max=-1;
   myParams.add(m_r2max,"maxDisplSq","double"); //maximum displacement
+  ResidentState="no";
+  myParams.add(ResidentState,"residentState","string");
+  IncrementalEnergy="no";
+  myParams.add(IncrementalEnergy,"incrementalEnergy","string");
 
   //store 1/mass per species
   SpeciesSet tspecies(W.getSpeciesSet());
@@ -81,6 +85,8 @@ bool QMCUpdateBase::put(xmlNodePtr cur)
   //nonlocal operator is very light
   UseTMove = nonLocalOps.put(cur);
   bool s=myParams.put(cur);
+  if(ResidentState == "yes" && !useResources())
+    app_warning() << "  residentState=\"yes\" is not supported by this update. Using the walker buffers." << endl;
   if (branchEngine)
     branchEngine->put(cur);
   return s;
@@ -174,6 +180,7 @@ void QMCUpdateBase::initWalkers(WalkerIter_t it, WalkerIter_t it_end)
 void QMCUpdateBase::initWalkersForPbyP(WalkerIter_t it, WalkerIter_t it_end)
 {
   UpdatePbyP=true;
+  const bool resident=useResources();
   for (; it != it_end; ++it)
   {
     Walker_t& awalker(**it);
@@ -183,11 +190,26 @@ void QMCUpdateBase::initWalkersForPbyP(WalkerIter_t it, WalkerIter_t it_end)
     if (awalker.DataSet.size())
       awalker.DataSet.clear();
     awalker.DataSet.rewind();
+    awalker.Resources.clear();
+    if(resident)
+    {
+      //the walker keeps its state in the resources and no DataSet
+      Psi.registerResources(W,awalker.Resources);
+      Psi.bindResources(W,awalker.Resources);
+      awalker.G=W.G;
+      awalker.L=W.L;
+      randomize(awalker);
+      Psi.releaseResources(W,awalker.Resources);
+      continue;
+    }
     RealType logpsi=Psi.registerData(W,awalker.DataSet);
     RealType logpsi2=Psi.updateBuffer(W,awalker.DataSet,false);
     awalker.G=W.G;
     awalker.L=W.L;
     randomize(awalker);
+    //the incremental components of H follow the trial wavefunction
+    if(IncrementalEnergy == "yes")
+      H.registerIncremental(W,awalker.DataSet);
   }
 }
 
@@ -245,7 +267,8 @@ void QMCUpdateBase::randomize(Walker_t& awalker)
   awalker.R=W.R;
   awalker.G=W.G;
   awalker.L=W.L;
-  RealType logpsi = Psi.updateBuffer(W,awalker.DataSet,false);
+  RealType logpsi = useResources()? Psi.updateResources(W,awalker.Resources,false)
+                    : Psi.updateBuffer(W,awalker.DataSet,false);
   W.saveWalker(awalker);
   RealType eloc=H.evaluate(W);
   BadState |= isnan(eloc);
@@ -270,16 +293,48 @@ QMCUpdateBase::getNodeCorrection(const ParticleSet::ParticleGradient_t& g, Parti
 
 void QMCUpdateBase::updateWalkers(WalkerIter_t it, WalkerIter_t it_end)
 {
+  const bool resident=useResources();
   for (; it != it_end; ++it)
   {
     Walker_t& thisWalker(**it);
+    if(resident)
+    {
+      W.loadWalker(thisWalker,UpdatePbyP);
+      //new walkers and the walkers received from other tasks have no resources
+      if(thisWalker.Resources.empty())
+        Psi.registerResources(W,thisWalker.Resources);
+      Psi.bindResources(W,thisWalker.Resources);
+      //recompute the state in the storage of the walker
+      Psi.updateResources(W,thisWalker.Resources,true);
+      Psi.releaseResources(W,thisWalker.Resources);
+      W.saveWalker(thisWalker);
+      continue;
+    }
     W.loadWalker(thisWalker,UpdatePbyP);
     Walker_t::Buffer_t& w_buffer((*it)->DataSet);
     RealType logpsi=Psi.updateBuffer(W,w_buffer,true);
+    //the incremental components of H follow the trial wavefunction
+    if(IncrementalEnergy == "yes")
+      H.updateIncremental(W,w_buffer);
     W.saveWalker(thisWalker);
   }
 }
 
+void QMCUpdateBase::updateIncremental(WalkerIter_t it, WalkerIter_t it_end)
+{
+  if(IncrementalEnergy != "yes")
+    return;
+  for (; it != it_end; ++it)
+  {
+    Walker_t& thisWalker(**it);
+    W.loadWalker(thisWalker,true);
+    Walker_t::Buffer_t& w_buffer(thisWalker.DataSet);
+    //skip the data of the trial wavefunction
+    Psi.copyFromBuffer(W,w_buffer);
+    H.updateIncremental(W,w_buffer);
+  }
+}
+
 void QMCUpdateBase::setReleasedNodeMultiplicity(WalkerIter_t it, WalkerIter_t it_end)
 {
   for (; it != it_end; ++it)
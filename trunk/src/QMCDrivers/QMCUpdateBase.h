@@ -154,6 +154,13 @@ public:
    */
   void updateWalkers(WalkerIter_t it, WalkerIter_t it_end);
 
+  /** recompute the INCREMENTAL components of H in the Walker buffers
+   *
+   * Does nothing unless incrementalEnergy="yes". updateWalkers does the same
+   * together with the trial wavefunction.
+   */
+  void updateIncremental(WalkerIter_t it, WalkerIter_t it_end);
+
   /** simple routine to test the performance
    */
   void benchMark(WalkerIter_t it, WalkerIter_t it_end, int ip);
@@ -224,10 +231,29 @@ public:
   }
 
 protected:
+  /** return true if the state of the trial wavefunction is kept in Walker::Resources
+   *
+   * The walkers of such an update have no DataSet. Default is false.
+   */
+  virtual bool useResources() const
+  {
+    return false;
+  }
+
   ///update particle-by-particle
   bool UpdatePbyP;
   ///use T-moves
   bool UseTMove;
+  /** if "yes", the trial wavefunction keeps its state in Walker::Resources instead of Walker::DataSet
+   *
+   * Used by the updates whose useResources returns true.
+   */
+  string ResidentState;
+  /** if "yes", the INCREMENTAL components of H are updated by the accepted moves
+   *
+   * Used by VMCUpdatePbyP. It pays off when the energy is measured at every step, i.e., substeps=1.
+   */
+  string IncrementalEnergy;
   ///number of particles
   IndexType NumPtcl;
   ///Time-step factor \f$ 1/(2\Tau)\f$
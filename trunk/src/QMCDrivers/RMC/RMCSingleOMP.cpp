@@ -0,0 +1,147 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+#include "QMCDrivers/RMC/RMCSingleOMP.h"
+#include "QMCDrivers/RMC/RMCUpdatePbyP.h"
+#include "OhmmsApp/RandomNumberControl.h"
+#include "Message/OpenMP.h"
+#include "Message/CommOperators.h"
+
+namespace qmcplusplus
+{
+
+/// Constructor.
+RMCSingleOMP::RMCSingleOMP(MCWalkerConfiguration& w, TrialWaveFunction& psi, QMCHamiltonian& h,
+                           HamiltonianPool& hpool, WaveFunctionPool& ppool):
+  QMCDriver(w,psi,h,ppool),  CloneManager(hpool),
+  nBeads(32), nCenterBeads(1)
+{
+  RootName = "rmc";
+  QMCType ="RMCSingleOMP";
+  QMCDriverMode.set(QMC_UPDATE_MODE,1);
+  QMCDriverMode.set(QMC_WARMUP,0);
+  m_param.add(nBeads,"beads","int");
+  m_param.add(nCenterBeads,"centerBeads","int");
+  m_param.add(nCenterBeads,"centerbeads","int");
+}
+
+bool RMCSingleOMP::run()
+{
+  resetRun();
+  //start the main estimator
+  Estimators->start(nBlocks);
+  for (int ip=0; ip<NumThreads; ++ip)
+    Movers[ip]->startRun(nBlocks,false);
+  for (int block=0; block<nBlocks; ++block)
+  {
+    #pragma omp parallel
+    {
+      int ip=omp_get_thread_num();
+      MCWalkerConfiguration::iterator wit(W.begin()+wPerNode[ip]), wit_end(W.begin()+wPerNode[ip+1]);
+      Movers[ip]->startBlock(nSteps);
+      for (int step=0; step<nSteps; ++step)
+      {
+        //the collectables are of the beads at the center
+        rmcMovers[ip]->advanceWalkers(wit,wit_end,false);
+        rmcMovers[ip]->accumulateCenter(nCenterBeads);
+      }
+      Movers[ip]->stopBlock(false);
+    }//end-of-parallel for
+    CurrentStep+=nSteps;
+    Estimators->stopBlock(estimatorClones);
+    if(storeConfigs)
+      recordBlock(block);
+  }//block
+  Estimators->stop(estimatorClones);
+  //copy back the random states
+  for (int ip=0; ip<NumThreads; ++ip)
+    *(RandomNumberControl::Children[ip])=*(Rng[ip]);
+  IndexType nacc=0, nbounce=0;
+  for (int ip=0; ip<NumThreads; ++ip)
+  {
+    nacc+=rmcMovers[ip]->nAcceptHead;
+    nbounce+=rmcMovers[ip]->nBounce;
+  }
+  app_log() << "  Reptile acceptance ratio = "
+            << static_cast<RealType>(nacc)/static_cast<RealType>(nacc+nbounce) << endl;
+  //finalize a qmc section
+  return finalize(nBlocks);
+}
+
+void RMCSingleOMP::resetRun()
+{
+  if(nBeads<3)
+  {
+    app_warning() << "  RMCSingleOMP needs at least 3 beads. Using beads=3" << endl;
+    nBeads=3;
+  }
+  nCenterBeads=std::max(1,std::min(nCenterBeads,nBeads));
+  //a reptile of beads+1 walkers per thread
+  addWalkers(NumThreads*(nBeads+1)-W.getActiveWalkers());
+  makeClones(W,Psi,H);
+  FairDivideLow(W.getActiveWalkers(),NumThreads,wPerNode);
+  app_log() << "  Reptiles of " << nBeads << " beads, one per thread" << endl;
+  app_log() << "  Number of the beads at the center to measure = " << nCenterBeads << endl;
+  if(nWarmupSteps*nSubSteps<nBeads)
+    app_warning() << "  The number of warmup moves is smaller than the beads. The initial reptiles are not renewed." << endl;
+  if (Movers.empty())
+  {
+    Movers.resize(NumThreads,0);
+    rmcMovers.resize(NumThreads,0);
+    branchClones.resize(NumThreads,0);
+    estimatorClones.resize(NumThreads,0);
+    Rng.resize(NumThreads,0);
+#if !defined(BGP_BUG)
+    #pragma omp parallel for
+#endif
+    for(int ip=0; ip<NumThreads; ++ip)
+    {
+      estimatorClones[ip]= new EstimatorManager(*Estimators);
+      estimatorClones[ip]->resetTargetParticleSet(*wClones[ip]);
+      estimatorClones[ip]->setCollectionMode(false);
+      Rng[ip]=new RandomGenerator_t(*(RandomNumberControl::Children[ip]));
+      hClones[ip]->setRandomGenerator(Rng[ip]);
+      branchClones[ip] = new BranchEngineType(*branchEngine);
+      rmcMovers[ip]=new RMCUpdatePbyPWithDrift(*wClones[ip],*psiClones[ip],*hClones[ip],*Rng[ip]);
+      Movers[ip]=rmcMovers[ip];
+      Movers[ip]->nSubSteps=nSubSteps;
+    }
+  }
+#if !defined(BGP_BUG)
+  #pragma omp parallel for
+#endif
+  for(int ip=0; ip<NumThreads; ++ip)
+  {
+    Movers[ip]->put(qmcNode);
+    Movers[ip]->resetRun(branchClones[ip],estimatorClones[ip]);
+    rmcMovers[ip]->initReptile(W.begin()+wPerNode[ip],W.begin()+wPerNode[ip+1]);
+    for (int prestep=0; prestep<nWarmupSteps; ++prestep)
+      rmcMovers[ip]->advanceWalkers(W.begin()+wPerNode[ip],W.begin()+wPerNode[ip+1],true);
+  }
+  nWarmupSteps=0;
+}
+
+bool
+RMCSingleOMP::put(xmlNodePtr q)
+{
+  return true;
+}
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+#ifndef QMCPLUSPLUS_RMCSINGLE_OMP_H
+#define QMCPLUSPLUS_RMCSINGLE_OMP_H
+#include "QMCDrivers/QMCDriver.h"
+#include "QMCDrivers/CloneManager.h"
+namespace qmcplusplus
+{
+
+class RMCUpdatePbyPWithDrift;
+
+/** @ingroup QMCDrivers  ParticleByParticle
+ * @brief Implements a reptation MC using particle-by-particle move. Threaded execution.
+ *
+ * Each thread moves a reptile of beads+1 walkers with RMCUpdatePbyPWithDrift.
+ * The estimators are accumulated with the centerBeads beads at the center of
+ * the reptiles which sample the pure distribution when the reptile is long enough
+ * and so are the collectables.
+ */
+class RMCSingleOMP: public QMCDriver, public CloneManager
+{
+public:
+  /// Constructor.
+  RMCSingleOMP(MCWalkerConfiguration& w, TrialWaveFunction& psi, QMCHamiltonian& h,
+               HamiltonianPool& hpool, WaveFunctionPool& ppool);
+  bool run();
+  bool put(xmlNodePtr cur);
+private:
+  ///number of the beads of a reptile
+  int nBeads;
+  ///number of the beads at the center to measure
+  int nCenterBeads;
+  ///Movers as RMCUpdatePbyPWithDrift
+  vector<RMCUpdatePbyPWithDrift*> rmcMovers;
+  ///check the run-time environments
+  void resetRun();
+  ///copy constructor
+  RMCSingleOMP(const RMCSingleOMP& a): QMCDriver(a),CloneManager(a) { }
+  /// Copy operator (disabled).
+  RMCSingleOMP& operator=(const RMCSingleOMP&)
+  {
+    return *this;
+  }
+};
+}
+
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,189 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+#include "QMCDrivers/RMC/RMCUpdatePbyP.h"
+#include "QMCDrivers/DriftOperators.h"
+
+namespace qmcplusplus
+{
+
+/// Constructor.
+RMCUpdatePbyPWithDrift::RMCUpdatePbyPWithDrift(MCWalkerConfiguration& w,
+    TrialWaveFunction& psi, QMCHamiltonian& h, RandomGenerator_t& rg):
+  QMCUpdateBase(w,psi,h,rg), nAcceptHead(0), nBounce(0), Polymer(0)
+{
+  myTimers.push_back(new NewTimer("RMCUpdatePbyP::advance")); //timer for the reptile moves
+  myTimers.push_back(new NewTimer("RMCUpdatePbyP::movePbyP")); //timer for MC, ratio etc
+  myTimers.push_back(new NewTimer("RMCUpdatePbyP::updateMBO")); //timer for measurements
+  myTimers.push_back(new NewTimer("RMCUpdatePbyP::energy")); //timer for measurements
+  for (int i=0; i<myTimers.size(); ++i)
+    TimerManager.addTimer(myTimers[i]);
+}
+
+/// destructor
+RMCUpdatePbyPWithDrift::~RMCUpdatePbyPWithDrift()
+{
+  delete Polymer;
+}
+
+void RMCUpdatePbyPWithDrift::initReptile(WalkerIter_t it, WalkerIter_t it_end)
+{
+  delete Polymer;
+  Polymer=new Reptile(it,it_end);
+  initWalkersForPbyP(it,it_end);
+  for(; it != it_end; ++it)
+    (*it)->Weight=1.0;
+  //a path from the head: every bead is evaluated with H and its collectables
+  for(int i=1; i<=Polymer->size(); ++i)
+  {
+    moveHead();
+    Polymer->grow();
+  }
+  nAcceptHead=0;
+  nBounce=0;
+}
+
+RMCUpdatePbyPWithDrift::RealType RMCUpdatePbyPWithDrift::moveHead()
+{
+  Walker_t& head(Polymer->getHead());
+  Walker_t& trial(Polymer->getTrial());
+  W.loadWalker(head,true);
+  Psi.copyFromBuffer(W,head.DataSet);
+  //create a 3N-Dimensional Gaussian with variance=1
+  makeGaussRandomWithEngine(deltaR,RandomGen);
+  int nAcceptTemp(0);
+  RealType rr_proposed=0.0;
+  RealType rr_accepted=0.0;
+  myTimers[1]->start();
+  for(int ig=0; ig<W.groups(); ++ig) //loop over species
+  {
+    RealType tauovermass = Tau*MassInvS[ig];
+    RealType oneover2tau = 0.5/(tauovermass);
+    RealType sqrttau = std::sqrt(tauovermass);
+    for (int iat=W.first(ig); iat<W.last(ig); ++iat)
+    {
+      GradType grad_iat=Psi.evalGrad(W,iat);
+      PosType dr;
+      getScaledDrift(tauovermass, grad_iat, dr);
+      dr += sqrttau * deltaR[iat];
+      RealType rr=tauovermass*dot(deltaR[iat],deltaR[iat]);
+      rr_proposed+=rr;
+      if(rr>m_r2max)
+      {
+        ++nReject;
+        continue;
+      }
+      if(!W.makeMoveAndCheck(iat,dr))
+      {
+        ++nReject;
+        continue;
+      }
+      PosType newpos(W.R[iat]);
+      RealType ratio = Psi.ratioGrad(W,iat,grad_iat);
+      //node is crossed reject the move
+      if (branchEngine->phaseChanged(Psi.getPhaseDiff()))
+      {
+        ++nReject;
+        ++nNodeCrossing;
+        W.rejectMove(iat);
+        Psi.rejectMove(iat);
+        continue;
+      }
+      RealType logGf = -0.5*dot(deltaR[iat],deltaR[iat]);
+      getScaledDrift(tauovermass, grad_iat, dr);
+      dr = head.R[iat] - newpos - dr;
+      RealType logGb = -oneover2tau*dot(dr,dr);
+      RealType prob = ratio*ratio*std::exp(logGb-logGf);
+      if(RandomGen() < prob)
+      {
+        ++nAcceptTemp;
+        ++nAccept;
+        W.acceptMove(iat);
+        Psi.acceptMove(W,iat);
+        rr_accepted+=rr;
+      }
+      else
+      {
+        ++nReject;
+        W.rejectMove(iat);
+        Psi.rejectMove(iat);
+      }
+    }
+  }
+  myTimers[1]->stop();
+  if(nAcceptTemp==0)
+    ++nAllRejected;
+  //the new head is stored in the trial bead, the head is not modified
+  myTimers[2]->start();
+  trial.R = W.R;
+  RealType logpsi = Psi.updateBuffer(W,trial.DataSet,false);
+  W.saveWalker(trial);
+  myTimers[2]->stop();
+  myTimers[3]->start();
+  //the collectables of the trial are accumulated by H
+  W.resetCollectables();
+  RealType enew= H.evaluate(W);
+  myTimers[3]->stop();
+  trial.resetProperty(logpsi,Psi.getPhase(),enew,rr_accepted,rr_proposed,1.0);
+  trial.Weight=1.0;
+  H.auxHevaluate(W,trial);
+  H.saveProperty(trial.getPropertyBase());
+  if(W.Collectables.size())
+    Polymer->getTrialCollectables()=W.Collectables;
+  return enew;
+}
+
+void RMCUpdatePbyPWithDrift::advanceWalkers(WalkerIter_t it, WalkerIter_t it_end, bool measure)
+{
+  myTimers[0]->start();
+  for(int iter=0; iter<nSubSteps; ++iter)
+  {
+    RealType enew=moveHead();
+    //change of the action by adding the new link at the head and removing the link at the tail
+    RealType ds=0.5*Tau*(enew+Polymer->getHead().Properties(LOCALENERGY)
+                         -Polymer->getTail().Properties(LOCALENERGY)-Polymer->getNext().Properties(LOCALENERGY));
+    if(RandomGen() < std::exp(-ds))
+    {
+      Polymer->grow();
+      ++nAcceptHead;
+    }
+    else
+    {
+      Polymer->flip();
+      ++nBounce;
+    }
+  }
+  myTimers[0]->stop();
+}
+
+void RMCUpdatePbyPWithDrift::accumulateCenter(int n)
+{
+  Polymer->getCenter(n,Center);
+  //the collectables of the beads at the center, normalized as those of the walkers
+  if(W.Collectables.size())
+  {
+    Polymer->sumCenter(n,W.Collectables);
+    W.Collectables *= 1.0/static_cast<RealType>(n);
+  }
+  Estimators->accumulate(W,Center.begin(),Center.end());
+}
+
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,90 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+#ifndef QMCPLUSPLUS_RMC_UPDATE_PARTICLEBYPARTICLE_H
+#define QMCPLUSPLUS_RMC_UPDATE_PARTICLEBYPARTICLE_H
+#include "QMCDrivers/QMCUpdateBase.h"
+#include "Particle/Reptile.h"
+
+namespace qmcplusplus
+{
+
+/** @ingroup QMCDrivers  ParticleByParticle
+ * @brief Implements the reptation MC using particle-by-particle moves with the drift.
+ *
+ * A new head is proposed from the head by the drift-diffusion moves of the
+ * particles, each accepted with the Metropolis test of DMCUpdatePbyPWithRejectionFast,
+ * and the wavefunction is updated from the buffer of the head. The move of the
+ * reptile is accepted with the change of the action
+ * \f$\tau/2(E_{new}+E_{head})-\tau/2(E_{tail}+E_{next})\f$ or the reptile bounces.
+ */
+class RMCUpdatePbyPWithDrift: public QMCUpdateBase
+{
+public:
+  /// Constructor.
+  RMCUpdatePbyPWithDrift(MCWalkerConfiguration& w, TrialWaveFunction& psi,
+                         QMCHamiltonian& h, RandomGenerator_t& rg);
+  ///destructor
+  ~RMCUpdatePbyPWithDrift();
+
+  /** make a reptile of the walkers [it,it_end) and initialize their buffers
+   *
+   * The beads are replaced by a path of the moves from the head, which are
+   * all accepted, and every bead is evaluated with H.
+   */
+  void initReptile(WalkerIter_t it, WalkerIter_t it_end);
+
+  /** move the head of the reptile nSubSteps times
+   *
+   * [it,it_end) are the walkers of initReptile.
+   */
+  void advanceWalkers(WalkerIter_t it, WalkerIter_t it_end, bool measure);
+
+  /** accumulate the estimators and the collectables with the beads at the center
+   * @param n number of the beads
+   */
+  void accumulateCenter(int n);
+
+  ///return the reptile
+  inline const Reptile& getReptile() const
+  {
+    return *Polymer;
+  }
+
+  ///number of the accepted moves of the reptile
+  IndexType nAcceptHead;
+  ///number of the bounces of the reptile
+  IndexType nBounce;
+
+private:
+  ///reptile
+  Reptile* Polymer;
+  ///beads to measure
+  vector<Walker_t*> Center;
+  vector<NewTimer*> myTimers;
+
+  /** propose a new head from the head in the trial bead
+   * @return the local energy of the trial
+   */
+  RealType moveHead();
+};
+}
+
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
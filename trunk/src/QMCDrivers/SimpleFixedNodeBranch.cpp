@@ -301,6 +301,8 @@ void SimpleFixedNodeBranch::branch(int iter, MCWalkerConfiguration& walkers)
   RealType wgt_inv=WalkerController->NumContexts/WalkerController->EnsembleProperty.Weight;
   walkers.Collectables *= wgt_inv;
   MyEstimator->accumulate(walkers);
+  //the walkers leave this node only after they have been accumulated
+  WalkerController->startSwap(walkers);
 }
 
 /** perform branching
@@ -318,6 +320,17 @@ void SimpleFixedNodeBranch::branch(int iter, MCWalkerConfiguration& walkers, vec
       clones[i]->BranchMode=BranchMode;
 }
 
+void SimpleFixedNodeBranch::setOverlapSwap(bool overlap)
+{
+  if(WalkerController)
+    WalkerController->OverlapSwap=overlap;
+}
+
+int SimpleFixedNodeBranch::completeSwap(MCWalkerConfiguration& w)
+{
+  return (WalkerController)? WalkerController->completeSwap(w):0;
+}
+
 void SimpleFixedNodeBranch::reset()
 {
   //use effective time step of BranchInterval*Tau
@@ -327,6 +327,17 @@ struct SimpleFixedNodeBranch: public QMCTraits
    */
   void branch(int iter, MCWalkerConfiguration& w, vector<ThisType*>& clones);
 
+  /** enable the walker exchange overlapped with the propagation
+   * @param overlap if true, the driver has to call completeSwap after advancing the walkers
+   */
+  void setOverlapSwap(bool overlap);
+
+  /** complete the walker exchange started by branch
+   * @param w the walker ensemble
+   * @return the number of walkers added to w
+   */
+  int completeSwap(MCWalkerConfiguration& w);
+
   /** restart averaging
    * @param counter Counter to determine the cummulative average will be reset.
    */
@@ -80,6 +80,9 @@ bool VMCSingleOMP::run()
 //           if(storeConfigs && (now_loc%storeConfigs == 0))
 //             ForwardWalkingHistory.storeConfigsForForwardWalking(*wClones[ip]);
       }
+      //remove the round-off of the incremental energy once per block
+      if(QMCDriverMode[QMC_UPDATE_MODE])
+        Movers[ip]->updateIncremental(wit,wit_end);
 
       Movers[ip]->stopBlock(false);
     }//end-of-parallel for
@@ -47,6 +47,7 @@ VMCUpdatePbyP::~VMCUpdatePbyP()
 
 void VMCUpdatePbyP::advanceWalkers(WalkerIter_t it, WalkerIter_t it_end, bool measure)
 {
+  const bool incremental=(IncrementalEnergy == "yes");
   myTimers[0]->start();
   for (; it != it_end; ++it)
   {
@@ -54,6 +55,8 @@ void VMCUpdatePbyP::advanceWalkers(WalkerIter_t it, WalkerIter_t it_end, bool me
     W.loadWalker(thisWalker,true);
     Walker_t::Buffer_t& w_buffer(thisWalker.DataSet);
     Psi.copyFromBuffer(W,w_buffer);
+    if(incremental)
+      H.copyFromIncremental(W,w_buffer);
     myTimers[1]->start();
     for (int iter=0; iter<nSubSteps; ++iter)
     {
@@ -76,8 +79,13 @@ void VMCUpdatePbyP::advanceWalkers(WalkerIter_t it, WalkerIter_t it_end, bool me
             {
               stucked=false;
               ++nAccept;
+              //the incremental components use the old distances and eikr
+              if(incremental)
+                H.evaluatePbyPIncremental(W,iat);
               W.acceptMove(iat);
               Psi.acceptMove(W,iat);
+              if(incremental)
+                H.acceptMoveIncremental(iat);
             }
             else
             {
@@ -109,7 +117,7 @@ void VMCUpdatePbyP::advanceWalkers(WalkerIter_t it, WalkerIter_t it_end, bool me
     //RealType logpsi = Psi.evaluate(W,w_buffer);
     myTimers[2]->stop();
     myTimers[3]->start();
-    RealType eloc=H.evaluate(W);
+    RealType eloc=incremental?H.evaluateIncremental(W,w_buffer):H.evaluate(W);
     myTimers[3]->stop();
     thisWalker.resetProperty(logpsi,Psi.getPhase(),eloc);
     H.auxHevaluate(W,thisWalker);
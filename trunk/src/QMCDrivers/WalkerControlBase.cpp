@@ -25,7 +25,7 @@ WalkerControlBase::WalkerControlBase(Communicate* c, bool rn)
   : MPIObjectBase(c), SwapMode(0), Nmin(1), Nmax(10)
   , MaxCopy(2), NumWalkersCreated(0), NumWalkersSent(0)
   , targetEnergyBound(10), targetVar(2), targetSigma(10)
-  , dmcStream(0), WriteRN(rn)
+  , dmcStream(0), WriteRN(rn), OverlapSwap(false)
 {
   NumContexts=myComm->size();
   MyContext=myComm->rank();
@@ -40,6 +40,7 @@ WalkerControlBase::~WalkerControlBase()
 {
   if(dmcStream)
     delete dmcStream;
+  trimWalkerPool(0);
 }
 
 
@@ -367,9 +368,8 @@ int WalkerControlBase::sortWalkers(MCWalkerConfiguration& W)
   //W.EnsembleProperty.Energy=(esum/=wsum);
   //W.EnsembleProperty.Variance=(e2sum/wsum-esum*esum);
   //W.EnsembleProperty.Variance=(e2sum*wsum-esum*esum)/(wsum*wsum-w2sum);
-  //remove bad walkers empty the container
-  for(int i=0; i<bad.size(); i++)
-    delete bad[i];
+  //remove bad walkers empty the container: keep them for the copies
+  FreeWalkers.insert(FreeWalkers.end(),bad.begin(),bad.end());
   if (!WriteRN)
   {
     if(good_w.empty())
@@ -441,7 +441,7 @@ int WalkerControlBase::copyWalkers(MCWalkerConfiguration& W)
   {
     for(int j=0; j<ncopy_w[i]; j++, cur_walker++)
     {
-      Walker_t* awalker=new Walker_t(*(good_w[i]));
+      Walker_t* awalker=newWalker(*(good_w[i]));
       awalker->ID=(++NumWalkersCreated)*NumContexts+MyContext;
       awalker->ParentID=good_w[i]->ParentID;
       W.push_back(awalker);
@@ -450,9 +450,71 @@ int WalkerControlBase::copyWalkers(MCWalkerConfiguration& W)
   //clear good_w and ncopy_w for the next branch
   good_w.clear();
   ncopy_w.clear();
+  //the population and the pool are bounded by Nmax
+  trimWalkerPool(Nmax-W.getActiveWalkers());
   return W.getActiveWalkers();
 }
 
+/** return true if a message of b can be unpacked by a */
+inline bool same_layout(const WalkerControlBase::Walker_t& a, const WalkerControlBase::Walker_t& b)
+{
+  if(a.R.size()!=b.R.size() || a.Properties.size()!=b.Properties.size()
+      || a.DataSet.size()!=b.DataSet.size()
+      || a.PropertyHistory.size()!=b.PropertyHistory.size() || a.PHindex.size()!=b.PHindex.size())
+    return false;
+  for(int i=0; i<a.PropertyHistory.size(); ++i)
+    if(a.PropertyHistory[i].size()!=b.PropertyHistory[i].size())
+      return false;
+  return true;
+}
+
+WalkerControlBase::Walker_t*
+WalkerControlBase::newWalker(const Walker_t& a, bool copy)
+{
+  if(FreeWalkers.empty())
+    return new Walker_t(a);
+  Walker_t* awalker=FreeWalkers.back();
+  FreeWalkers.pop_back();
+  if(copy || !same_layout(*awalker,a))
+    awalker->makeCopy(a);
+  else
+  {
+    //everything but the particle arrays and DataSet, which getMessage overwrites
+    awalker->ID=a.ID;
+    awalker->ParentID=a.ParentID;
+    awalker->Generation=a.Generation;
+    awalker->Age=a.Age;
+    awalker->Weight=a.Weight;
+    awalker->Multiplicity=a.Multiplicity;
+    awalker->ReleasedNodeWeight=a.ReleasedNodeWeight;
+    awalker->ReleasedNodeAge=a.ReleasedNodeAge;
+    awalker->Properties.copy(a.Properties);
+    for(int i=0; i<a.PropertyHistory.size(); ++i)
+      awalker->PropertyHistory[i]=a.PropertyHistory[i];
+    awalker->PHindex=a.PHindex;
+    awalker->Resources.clear();
+  }
+  //not copied by makeCopy
+  awalker->DataSetForDerivatives=a.DataSetForDerivatives;
+  return awalker;
+}
+
+void WalkerControlBase::recycleWalkers(MCWalkerConfiguration& W, int first)
+{
+  FreeWalkers.insert(FreeWalkers.end(),W.begin()+first,W.end());
+  W.erase(W.begin()+first,W.end());
+}
+
+void WalkerControlBase::trimWalkerPool(int n)
+{
+  n=std::max(n,0);
+  while(FreeWalkers.size()>n)
+  {
+    delete FreeWalkers.back();
+    FreeWalkers.pop_back();
+  }
+}
+
 bool WalkerControlBase::put(xmlNodePtr cur)
 {
   ParameterSet params;
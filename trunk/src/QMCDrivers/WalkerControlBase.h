@@ -123,8 +123,12 @@ public:
   vector<Walker_t*> good_w;
   ///temporary storage for copy counters
   vector<int> ncopy_w;
+  ///walkers removed by the branch and the swaps, reused for the new walkers
+  vector<Walker_t*> FreeWalkers;
   ///Add released-node fields to .dmc.dat file
   bool WriteRN;
+  ///true, if the walkers in flight are added by completeSwap called by the driver
+  bool OverlapSwap;
 
   /** default constructor
    *
@@ -190,12 +194,51 @@ public:
    */
   int copyWalkers(MCWalkerConfiguration& W);
 
+  /** return a walker from FreeWalkers or a new walker
+   * @param a reference walker
+   * @param copy if true, the content of a is copied
+   *
+   * A recycled walker keeps its buffers and the copy is done in place, so
+   * that the walker is the same as a new copy of a. With copy=false, R, G, L
+   * and DataSet are left to be overwritten, e.g., by getMessage, and the
+   * resources are cleared as getMessage does.
+   */
+  Walker_t* newWalker(const Walker_t& a, bool copy=true);
+
+  /** move the walkers of W from the first-th walker to the end to FreeWalkers
+   */
+  void recycleWalkers(MCWalkerConfiguration& W, int first);
+
+  /** delete the walkers of FreeWalkers in excess of n
+   */
+  void trimWalkerPool(int n);
+
   /** reset to accumulate data */
   virtual void reset();
 
   /** perform branch and swap walkers as required */
   virtual int branch(int iter, MCWalkerConfiguration& W, RealType trigger);
 
+  /** start the walker exchange of the last branch
+   *
+   * Only meaningful with OverlapSwap: branch leaves the exchange pending so
+   * that the estimators are accumulated on the population it has measured.
+   */
+  virtual void startSwap(MCWalkerConfiguration& W)
+  {
+  }
+
+  /** complete the walker exchange started by startSwap
+   * @return the number of walkers added to W
+   *
+   * Only meaningful with OverlapSwap: a driver advances the walkers which stay
+   * on this node while the exchange is in flight.
+   */
+  virtual int completeSwap(MCWalkerConfiguration& W)
+  {
+    return 0;
+  }
+
   virtual RealType getFeedBackParameter(int ngen, RealType tau)
   {
     return 1.0/(static_cast<RealType>(ngen)*tau);
@@ -23,15 +23,18 @@ namespace qmcplusplus
 
 CoulombPBCAA::CoulombPBCAA(ParticleSet& ref, bool active,
                                    bool computeForces) :
-  AA(0), myGrid(0), rVs(0),
+  AA(0), myGrid(0), rVs(0), SRSpline(0),
   is_active(active), FirstTime(true), myConst(0.0),
   ComputeForces(computeForces), ForceBase(ref,ref)
 {
   ReportEngine PRE("CoulombPBCAA","CoulombPBCAA");
   //create a distance table: just to get the table name
-  DistanceTableData *d_aa = DistanceTable::add(ref);
+  DistanceTableData *d_aa = ref.DistTables[ref.addTable(ref,-1,false)];
   PtclRefName=d_aa->Name;
   initBreakup(ref);
+#if !defined(USE_REAL_STRUCT_FACTOR)
+  UpdateMode.set(INCREMENTAL,!ComputeForces);
+#endif
   prefix="F_AA";
   app_log() << "  Maximum K shell " << AA->MaxKshell << endl;
   app_log() << "  Number of k vectors " << AA->Fk.size() << endl;
@@ -62,7 +65,10 @@ CoulombPBCAA::CoulombPBCAA(ParticleSet& ref, bool active,
             << "\n    Vtot     =" << Value << endl;
 }
 
-CoulombPBCAA:: ~CoulombPBCAA() { }
+CoulombPBCAA:: ~CoulombPBCAA()
+{
+  delete SRSpline;
+}
 
 void CoulombPBCAA::addObservables(PropertySetType& plist, BufferType& collectables)
 {
@@ -144,10 +150,14 @@ CoulombPBCAA::evaluateForPbyP(ParticleSet& P)
     const DistanceTableData *d_aa = P.DistTables[0];
     for(int iat=0; iat<NumCenters; iat++)
     {
+      const int n=d_aa->M[iat+1]-d_aa->M[iat];
+      if(n==0)
+        continue;
       Return_t z=0.5*Zat[iat];
-      for(int nn=d_aa->M[iat],jat=iat+1; nn<d_aa->M[iat+1]; ++nn,++jat)
+      SRSpline->evaluateV(n,d_aa->r_ptr(d_aa->M[iat]),SRtemp.data());
+      for(int k=0,jat=iat+1; k<n; ++k,++jat)
       {
-        Return_t e=z*Zat[jat]*d_aa->rinv(nn)*rVs->splint(d_aa->r(nn));
+        Return_t e=z*Zat[jat]*SRtemp[k];
         SR2(iat,jat)=e;
         SR2(jat,iat)=e;
         res+=e+e;
@@ -164,17 +174,15 @@ CoulombPBCAA::evaluatePbyP(ParticleSet& P, int active)
 {
   if(is_active)
   {
-    const std::vector<DistanceTableData::TempDistType> &temp(P.DistTables[0]->Temp);
     Return_t z=0.5*Zat[active];
     Return_t sr=0;
     const Return_t* restrict sr_ptr=SR2[active];
-    for(int iat=0; iat<NumCenters; ++iat,++sr_ptr)
-    {
-      if(iat==active)
-        dSR[active]=0.0;
-      else
-        sr+=dSR[iat]=(z*Zat[iat]*temp[iat].rinv1*rVs->splint(temp[iat].r1)- (*sr_ptr));
-    }
+    //the self pair has a zero distance and is set to zero by the spline
+    SRSpline->evaluateV(NumCenters,P.DistTables[0]->getTempDistances(SRtemp.data()),dSR.data());
+    for(int iat=0; iat<NumCenters; ++iat)
+      sr+=dSR[iat]=z*Zat[iat]*dSR[iat]-sr_ptr[iat];
+    sr-=dSR[active];
+    dSR[active]=0.0;
 #if defined(USE_REAL_STRUCT_FACTOR)
     APP_ABORT("CoulombPBCAA::evaluatePbyP");
 #else
@@ -248,10 +256,18 @@ void CoulombPBCAA::initBreakup(ParticleSet& P)
   //AA->initBreakup(*PtclRef);
   myConst=evalConsts();
   myRcut=AA->get_rc();//Basis.get_rc();
+  //the pairs beyond the cutoff of the cell lists are not evaluated
+  P.DistTables[0]->checkNeighborCutoff(myRcut,"CoulombPBCAA short-range");
   if(rVs==0)
   {
     rVs = LRCoulombSingleton::createSpline4RbyVs(AA,myRcut,myGrid);
   }
+  if(SRSpline==0)
+  {
+    SRSpline = new SRSplineType;
+    SRSpline->init(*rVs);
+  }
+  SRtemp.resize(NumCenters);
 }
 
 CoulombPBCAA::Return_t
@@ -261,13 +277,11 @@ CoulombPBCAA::evalSR(ParticleSet& P)
   RealType SR=0.0;
   for(int ipart=0; ipart<NumCenters; ipart++)
   {
-    RealType esum = 0.0;
-    for(int nn=d_aa.M[ipart],jpart=ipart+1; nn<d_aa.M[ipart+1]; nn++,jpart++)
-    {
-      //if(d_aa->r(nn)>=myRcut) continue;
-      //esum += Zat[jpart]*AA->evaluate(d_aa->r(nn),d_aa->rinv(nn));
-      esum += Zat[jpart]*d_aa.rinv(nn)*rVs->splint(d_aa.r(nn));
-    }
+    //the pairs (ipart,jpart>ipart) are contiguous
+    const int n=d_aa.M[ipart+1]-d_aa.M[ipart];
+    if(n==0)
+      continue;
+    RealType esum = SRSpline->sumV(n,d_aa.r_ptr(d_aa.M[ipart]),&Zat[ipart+1]);
     //Accumulate pair sums...species charge for atom i.
     SR += Zat[ipart]*esum;
   }
@@ -419,7 +433,13 @@ QMCHamiltonianBase* CoulombPBCAA::makeClone(ParticleSet& qp, TrialWaveFunction&
   if(is_active)
     return new CoulombPBCAA(qp,is_active,ComputeForces);
   else
-    return new CoulombPBCAA(*this);//nothing needs to be re-evaluated
+  {
+    CoulombPBCAA* myclone=new CoulombPBCAA(*this);//nothing needs to be re-evaluated
+    //each copy owns its spline, which is deleted by the destructor
+    if(SRSpline)
+      myclone->SRSpline=new SRSplineType(*SRSpline);
+    return myclone;
+  }
 }
 }
 
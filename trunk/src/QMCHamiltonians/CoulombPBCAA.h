@@ -34,9 +34,12 @@ struct CoulombPBCAA: public QMCHamiltonianBase, public ForceBase
   typedef LRCoulombSingleton::LRHandlerType LRHandlerType;
   typedef LRCoulombSingleton::GridType       GridType;
   typedef LRCoulombSingleton::RadFunctorType RadFunctorType;
+  typedef LRCoulombSingleton::SRSplineType   SRSplineType;
   LRHandlerType* AA;
   GridType* myGrid;
   RadFunctorType* rVs;
+  ///uniform B-spline of rVs for the rows of the distance table
+  SRSplineType* SRSpline;
 
   bool is_active;
   bool FirstTime;
@@ -53,6 +56,8 @@ struct CoulombPBCAA: public QMCHamiltonianBase, public ForceBase
 
   Matrix<RealType> SR2;
   Vector<RealType> dSR;
+  ///short-range potential of a row of pairs
+  Vector<RealType> SRtemp;
   Vector<ComplexType> del_eikr;
   /// Flag for whether to compute forces or not
   bool ComputeForces;
@@ -18,6 +18,8 @@
 #include "Particle/DistanceTableData.h"
 #include "Message/Communicate.h"
 #include "Utilities/ProgressReportEngine.h"
+#include "Utilities/IteratorUtility.h"
+#include <map>
 
 namespace qmcplusplus
 {
@@ -32,8 +34,11 @@ CoulombPBCAB::CoulombPBCAB(ParticleSet& ions, ParticleSet& elns,
   ReportEngine PRE("CoulombPBCAB","CoulombPBCAB");
   //Use singleton pattern
   //AB = new LRHandlerType(ions);
-  myTableIndex=elns.addTable(ions);
+  myTableIndex=elns.addTable(ions,-1,false);
   initBreakup(elns);
+#if !defined(USE_REAL_STRUCT_FACTOR)
+  UpdateMode.set(INCREMENTAL,!ComputeForces);
+#endif
   prefix="Flocal";
   app_log() << "  Maximum K shell " << AB->MaxKshell << endl;
   app_log() << "  Number of k vectors " << AB->Fk.size() << endl;
@@ -64,11 +69,36 @@ QMCHamiltonianBase* CoulombPBCAB::makeClone(ParticleSet& qp, TrialWaveFunction&
 CoulombPBCAB:: ~CoulombPBCAB()
 {
   //probably need to clean up
+  delete_iter(SRsplines.begin(),SRsplines.end());
+}
+
+/** create a SRSplineType for each distinct short-range functor of the ions
+ */
+void CoulombPBCAB::buildSRSplines()
+{
+  delete_iter(SRsplines.begin(),SRsplines.end());
+  SRsplines.clear();
+  SRat.resize(NptclA);
+  map<RadFunctorType*,SRSplineType*> splines;
+  for(int iat=0; iat<NptclA; ++iat)
+  {
+    map<RadFunctorType*,SRSplineType*>::iterator it(splines.find(Vat[iat]));
+    if(it == splines.end())
+    {
+      SRSplineType* aspline=new SRSplineType;
+      aspline->init(*Vat[iat]);
+      SRsplines.push_back(aspline);
+      it=splines.insert(make_pair(Vat[iat],aspline)).first;
+    }
+    SRat[iat]=(*it).second;
+  }
+  SRrow.resize(NptclB);
+  SRdist.resize(NptclA);
 }
 
 void CoulombPBCAB::resetTargetParticleSet(ParticleSet& P)
 {
-  int tid=P.addTable(PtclA);
+  int tid=P.addTable(PtclA,-1,false);
   if(tid != myTableIndex)
   {
     APP_ABORT("CoulombPBCAB::resetTargetParticleSet found inconsistent table index");
@@ -101,16 +131,12 @@ CoulombPBCAB::evalSR(ParticleSet& P)
 {
   const DistanceTableData &d_ab(*P.DistTables[myTableIndex]);
   RealType res=0.0;
+  if(SRat.size() != NptclA)
+    buildSRSplines();
   //Loop over distinct eln-ion pairs
   for(int iat=0; iat<NptclA; iat++)
   {
-    RealType esum = 0.0;
-    RadFunctorType* rVs=Vat[iat];
-    for(int nn=d_ab.M[iat], jat=0; nn<d_ab.M[iat+1]; ++nn,++jat)
-    {
-      // if(d_ab.r(nn)>=(myRcut-0.1)) continue;
-      esum += Qat[jat]*d_ab.rinv(nn)*rVs->splint(d_ab.r(nn));;
-    }
+    RealType esum = SRat[iat]->sumV(NptclB,d_ab.r_ptr(d_ab.M[iat]),&Qat[0]);
     //Accumulate pair sums...species charge for atom i.
     res += Zat[iat]*esum;
   }
@@ -228,6 +254,8 @@ void CoulombPBCAB::initBreakup(ParticleSet& P)
   AB = LRCoulombSingleton::getHandler(P);
   myConst=evalConsts();
   myRcut=AB->get_rc();//Basis.get_rc();
+  //the pairs beyond the cutoff of the cell lists are not evaluated
+  P.DistTables[myTableIndex]->checkNeighborCutoff(myRcut,"CoulombPBCAB short-range");
   // create the spline function for the short-range part assuming pure potential
   if(V0==0)
   {
@@ -280,6 +308,8 @@ void CoulombPBCAB::add(int groupID, RadFunctorType* ppot)
       if(PtclA.GroupID[iat]==groupID)
         Vat[iat]=rfunc;
     }
+    //rebuilt with the new functor by the next evaluation
+    SRat.clear();
   }
   if (ComputeForces)
   {
@@ -345,13 +375,15 @@ CoulombPBCAB::evaluateForPyP(ParticleSet& P)
 #else
   SRpart=0.0;
   const DistanceTableData* d_ab=P.DistTables[myTableIndex];
+  if(SRat.size() != NptclA)
+    buildSRSplines();
   for(int iat=0; iat<NptclA; ++iat)
   {
     RealType z=Zat[iat];
-    RadFunctorType* rVs=Vat[iat];
-    for(int nn=d_ab->M[iat], jat=0; nn<d_ab->M[iat+1]; nn++,jat++)
+    SRat[iat]->evaluateV(NptclB,d_ab->r_ptr(d_ab->M[iat]),SRrow.data());
+    for(int jat=0; jat<NptclB; ++jat)
     {
-      RealType e=z*Qat[jat]*d_ab->rinv(nn)*rVs->splint(d_ab->r(nn));
+      RealType e=z*Qat[jat]*SRrow[jat];
       SRpart[jat]+=e;
       res+=e;
     }
@@ -381,12 +413,14 @@ CoulombPBCAB::evaluatePbyP(ParticleSet& P, int active)
 #if defined(USE_REAL_STRUCT_FACTOR)
   APP_ABORT("CoulombPBCAB::evaluatePbyP(ParticleSet& P, int active)");
 #else
-  const std::vector<DistanceTableData::TempDistType> &temp(P.DistTables[myTableIndex]->Temp);
+  const RealType* restrict dist=P.DistTables[myTableIndex]->getTempDistances(SRdist.data());
   RealType q=Qat[active];
   SRtmp=0.0;
+  if(SRat.size() != NptclA)
+    buildSRSplines();
   for(int iat=0; iat<NptclA; ++iat)
   {
-    SRtmp+=Zat[iat]*q*temp[iat].rinv1*Vat[iat]->splint(temp[iat].r1);
+    SRtmp+=Zat[iat]*q*SRat[iat]->splint(dist[iat])/dist[iat];
   }
   LRtmp=0.0;
   const StructFact& RhoKA(*(PtclA.SK));
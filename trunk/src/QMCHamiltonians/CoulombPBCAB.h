@@ -37,6 +37,7 @@ struct CoulombPBCAB: public QMCHamiltonianBase, public ForceBase
   typedef LRCoulombSingleton::LRHandlerType LRHandlerType;
   typedef LRCoulombSingleton::GridType GridType;
   typedef LRCoulombSingleton::RadFunctorType RadFunctorType;
+  typedef LRCoulombSingleton::SRSplineType SRSplineType;
 
   ///source particle set
   ParticleSet& PtclA;
@@ -80,6 +81,14 @@ struct CoulombPBCAB: public QMCHamiltonianBase, public ForceBase
   vector<RadFunctorType*> Vat;
   ///Short-range potential for each species
   vector<RadFunctorType*> Vspec;
+  ///uniform B-spline of Vat[iat] for the rows of the distance table
+  vector<SRSplineType*> SRat;
+  ///B-splines of the distinct functors of Vat, owned by this object
+  vector<SRSplineType*> SRsplines;
+  ///short-range potential of a row of pairs
+  Vector<RealType> SRrow;
+  ///scratch for the distances of the proposed move
+  Vector<RealType> SRdist;
   /*@{
    * @brief temporary data for pbyp evaluation
    */
@@ -143,6 +152,8 @@ struct CoulombPBCAB: public QMCHamiltonianBase, public ForceBase
   Return_t evalConsts();
   Return_t evaluateForPyP(ParticleSet& P);
   void add(int groupID, RadFunctorType* ppot);
+  ///build SRat from Vat
+  void buildSRSplines();
 
   void addObservables(PropertySetType& plist, BufferType& collectables);
 
@@ -26,12 +26,14 @@ LocalECPotential::LocalECPotential(const ParticleSet& ions, ParticleSet& els):
   IonConfig(ions)
 {
   NumIons=ions.getTotalNum();
-  myTableIndex=els.addTable(ions);
+  myTableIndex=els.addTable(ions,-1,false);
+  PPdist.resize(NumIons);
   //allocate null
   PPset.resize(ions.getSpeciesSet().getTotalNum(),0);
   PP.resize(NumIons,0);
   Zeff.resize(NumIons,0.0);
   gZeff.resize(ions.getSpeciesSet().getTotalNum(),0);
+  UpdateMode.set(INCREMENTAL,1);
 }
 
 ///destructor
@@ -46,7 +48,7 @@ LocalECPotential::~LocalECPotential()
 
 void LocalECPotential::resetTargetParticleSet(ParticleSet& P)
 {
-  int tid=P.addTable(IonConfig);
+  int tid=P.addTable(IonConfig,-1,false);
   if(tid != myTableIndex)
   {
     APP_ABORT("  LocalECPotential::resetTargetParticleSet found a different distance table index.");
@@ -144,12 +146,12 @@ LocalECPotential::evaluateForPbyP(ParticleSet& P)
 LocalECPotential::Return_t
 LocalECPotential::evaluatePbyP(ParticleSet& P, int active)
 {
-  const std::vector<DistanceTableData::TempDistType> &temp(P.DistTables[myTableIndex]->Temp);
+  const RealType* restrict dist=P.DistTables[myTableIndex]->getTempDistances(&PPdist[0]);
   PPtmp=0.0;
   for(int iat=0; iat<NumIons; ++iat)
   {
     if(PP[iat])
-      PPtmp -= Zeff[iat]*PP[iat]->splint(temp[iat].r1)*temp[iat].rinv1;
+      PPtmp -= Zeff[iat]*PP[iat]->splint(dist[iat])/dist[iat];
   }
   return NewValue=Value+PPtmp-PPart[active];
 }
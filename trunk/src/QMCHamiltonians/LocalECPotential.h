@@ -53,6 +53,8 @@ struct LocalECPotential: public QMCHamiltonianBase
   vector<RealType> gZeff;
   ///energy per particle
   Vector<RealType> PPart;
+  ///scratch for the distances of the proposed move
+  vector<RealType> PPdist;
 
   LocalECPotential(const ParticleSet& ions, ParticleSet& els);
 
@@ -35,6 +35,8 @@ MomentumEstimator::MomentumEstimator(ParticleSet& elns, TrialWaveFunction& psi)
   kdotp.resize(elns.getTotalNum());
   phases.resize(elns.getTotalNum());
   twist=elns.getTwist();
+  //evaluate reads the Temp of the e-e table
+  elns.addTable(elns);
 }
 
 void MomentumEstimator::resetTargetParticleSet(ParticleSet& P)
@@ -15,24 +15,28 @@
 //////////////////////////////////////////////////////////////////
 // -*- C++ -*-
 #include "Particle/DistanceTableData.h"
+#include "Particle/VirtualParticleSet.h"
 #include "QMCHamiltonians/NonLocalECPComponent.h"
 
 namespace qmcplusplus
 {
 
 NonLocalECPComponent::NonLocalECPComponent():
-  lmax(0), nchannel(0), nknot(0), Rmax(-1), myRNG(&Random)
+  lmax(0), nchannel(0), nknot(0), Rmax(-1), myRNG(&Random), VP(0)
 { }
 
 NonLocalECPComponent::~NonLocalECPComponent()
 {
   for(int ip=0; ip<nlpp_m.size(); ip++)
     delete nlpp_m[ip];
+  if(VP)
+    delete VP;
 }
 
 NonLocalECPComponent* NonLocalECPComponent::makeClone()
 {
   NonLocalECPComponent* myclone=new NonLocalECPComponent(*this);
+  myclone->VP=0;
   for(int i=0; i<nlpp_m.size(); ++i)
     myclone->nlpp_m[i]=nlpp_m[i]->makeClone();
   return myclone;
@@ -86,6 +90,22 @@ void NonLocalECPComponent::print(std::ostream& os)
   for(int ik=0; ik<nknot; ik++)
     os << "       " << sgridxyz_m[ik] << setw(20) << sgridweight_m[ik] << endl;
 }
+
+void NonLocalECPComponent::evaluateRatios(ParticleSet& W, int iel, TrialWaveFunction& psi
+    , const vector<PosType>& deltarV)
+{
+  //(re)create VP when the tables of W have changed
+  if(VP == 0 || !VP->isValid(W))
+  {
+    delete VP;
+    VP=new VirtualParticleSet(W,nknot);
+  }
+  VP->makeMoves(iel,deltarV);
+  psi.evaluateRatios(*VP,psiratio);
+  for (int j=0; j < nknot ; j++)
+    psiratio[j]*=sgridweight_m[j];
+}
+
 /** evaluate the non-local potential of the iat-th ionic center
  * @param W electron configuration
  * @param iat ionic index
@@ -109,18 +129,8 @@ NonLocalECPComponent::evaluate(ParticleSet& W, int iat, TrialWaveFunction& psi)
     register PosType  dr(myTable->dr(nn));
     // Compute ratio of wave functions
     for (int j=0; j < nknot ; j++)
-    {
-      PosType deltar(r*rrotsgrid_m[j]-dr);
-      W.makeMoveOnSphere(iel,deltar);
-#if defined(QMC_COMPLEX)
-      psiratio[j]=psi.ratio(W,iel)*sgridweight_m[j]*std::cos(psi.getPhaseDiff());
-#else
-      psiratio[j]=psi.ratio(W,iel)*sgridweight_m[j];
-#endif
-      W.rejectMove(iel);
-      psi.resetPhaseDiff();
-      //psi.rejectMove(iel);
-    }
+      deltarV[j]=r*rrotsgrid_m[j]-dr;
+    evaluateRatios(W,iel,psi,deltarV);
     // Compute radial potential
     //int k;
     //RealType rfrac;
@@ -551,6 +561,7 @@ NonLocalECPComponent::RealType
 NonLocalECPComponent::evaluate(ParticleSet& W, TrialWaveFunction& psi,int iat, vector<NonLocalData>& Txy)
 {
   RealType esum=0.0;
+  vector<PosType> deltarV(nknot);
   //int iel=0;
   for(int nn=myTable->M[iat],iel=0; nn<myTable->M[iat+1]; nn++,iel++)
   {
@@ -562,20 +573,11 @@ NonLocalECPComponent::evaluate(ParticleSet& W, TrialWaveFunction& psi,int iat, v
     int txyCounter=Txy.size();
     // Compute ratio of wave functions
     for (int j=0; j < nknot ; j++)
-    {
-      PosType deltar(r*rrotsgrid_m[j]-dr);
-      W.makeMoveOnSphere(iel,deltar);
-#if defined(QMC_COMPLEX)
-      psiratio[j]=psi.ratio(W,iel)*sgridweight_m[j]*std::cos(psi.getPhaseDiff());
-#else
-      psiratio[j]=psi.ratio(W,iel)*sgridweight_m[j];
-#endif
-      W.rejectMove(iel);
-      psi.resetPhaseDiff();
-      //psi.rejectMove(iel);
-      //first, add a new NonLocalData with ratio
-      Txy.push_back(NonLocalData(iel,psiratio[j],deltar));
-    }
+      deltarV[j]=r*rrotsgrid_m[j]-dr;
+    evaluateRatios(W,iel,psi,deltarV);
+    //first, add a new NonLocalData with ratio
+    for (int j=0; j < nknot ; j++)
+      Txy.push_back(NonLocalData(iel,psiratio[j],deltarV[j]));
     // Compute radial potential
     for(int ip=0; ip< nchannel; ip++)
     {
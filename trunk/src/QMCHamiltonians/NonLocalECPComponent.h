@@ -86,6 +86,9 @@ struct NonLocalECPComponent: public QMCTraits
 
   DistanceTableData* myTable;
 
+  ///virtual particles for the quadrature points
+  VirtualParticleSet* VP;
+
   NonLocalECPComponent();
 
   ///destructor
@@ -96,6 +99,16 @@ struct NonLocalECPComponent: public QMCTraits
   ///add a new Non Local component
   void add(int l, RadialPotentialType* pp);
 
+  /** evaluate psiratio of the quadrature points of an electron
+   * @param W electron configuration
+   * @param iel electron index
+   * @param psi trial wavefunction
+   * @param deltarV displacements of the quadrature points
+   *
+   * psiratio[j] is the ratio multiplied by the weight of the j-th knot.
+   */
+  void evaluateRatios(ParticleSet& W, int iel, TrialWaveFunction& psi, const vector<PosType>& deltarV);
+
   ///add knots to the spherical grid
   void addknot(const PosType& xyz, RealType weight)
   {
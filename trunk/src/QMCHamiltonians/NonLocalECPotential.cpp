@@ -23,7 +23,7 @@ namespace qmcplusplus
 
 void NonLocalECPotential::resetTargetParticleSet(ParticleSet& P)
 {
-  d_table = DistanceTable::add(IonConfig,P);
+  d_table = P.DistTables[P.addTable(IonConfig,-1,false)];
 }
 
 /** constructor
@@ -37,7 +37,7 @@ NonLocalECPotential::NonLocalECPotential(ParticleSet& ions, ParticleSet& els,
   IonConfig(ions), d_table(0), Psi(psi),
   ComputeForces(computeForces), ForceBase(ions,els)
 {
-  d_table = DistanceTable::add(ions,els);
+  d_table = els.DistTables[els.addTable(ions,-1,false)];
   NumIons=ions.getTotalNum();
   //els.resizeSphere(NumIons);
   PP.resize(NumIons,0);
@@ -123,6 +123,7 @@ NonLocalECPotential::add(int groupID, NonLocalECPComponent* ppot)
   //  }
   //  PPset[groupID]=ppot;
   //}
+  d_table->checkNeighborCutoff(ppot->Rmax,"NonLocalECPotential");
   ppot->myTable=d_table;
   for(int iat=0; iat<PP.size(); iat++)
     if(IonConfig.GroupID[iat]==groupID)
@@ -54,6 +54,8 @@ PairCorrEstimator::PairCorrEstimator(ParticleSet& elns, string& sources)
       pair_map[i*num_species+j]=npairs;
     }
   const DistanceTableData&  dii(*elns.DistTables[0]);
+  //the pairs up to Dmax have to be kept by the particle-by-particle moves
+  dii.checkNeighborCutoff(Dmax,"PairCorrEstimator");
   pair_ids.resize(dii.getTotNadj());
   for(int iat=0; iat<dii.centers(); ++iat)
   {
@@ -88,6 +90,7 @@ PairCorrEstimator::PairCorrEstimator(ParticleSet& elns, string& sources)
   for(int k=0; k<other_ids.size(); ++k)
   {
     const DistanceTableData& t(*elns.DistTables[other_ids[k]]);
+    t.checkNeighborCutoff(Dmax,"PairCorrEstimator");
     app_log() << "  GOFR for " << t.getName() << " starts at " << toff << endl;
     other_offsets[k]=toff;
     const SpeciesSet& species(t.origin().getSpeciesSet());
@@ -402,6 +402,86 @@ void QMCHamiltonian::rejectMove(int active)
     H[i]->rejectMove(active);
 }
 
+QMCHamiltonian::Return_t QMCHamiltonian::registerIncremental(ParticleSet& P, BufferType& buffer)
+{
+  Return_t e=0.0;
+  for(int i=0; i<H.size(); ++i)
+    if(H[i]->getMode(QMCHamiltonianBase::INCREMENTAL))
+      e+=H[i]->registerData(P,buffer);
+  return e;
+}
+
+QMCHamiltonian::Return_t QMCHamiltonian::updateIncremental(ParticleSet& P, BufferType& buffer)
+{
+  Return_t e=0.0;
+  for(int i=0; i<H.size(); ++i)
+    if(H[i]->getMode(QMCHamiltonianBase::INCREMENTAL))
+      e+=H[i]->updateBuffer(P,buffer);
+  return e;
+}
+
+void QMCHamiltonian::copyFromIncremental(ParticleSet& P, BufferType& buffer)
+{
+  for(int i=0; i<H.size(); ++i)
+    if(H[i]->getMode(QMCHamiltonianBase::INCREMENTAL))
+      H[i]->copyFromBuffer(P,buffer);
+}
+
+void QMCHamiltonian::evaluatePbyPIncremental(ParticleSet& P, int active)
+{
+  for(int i=0; i<H.size(); ++i)
+    if(H[i]->getMode(QMCHamiltonianBase::INCREMENTAL))
+      H[i]->evaluatePbyP(P,active);
+}
+
+void QMCHamiltonian::acceptMoveIncremental(int active)
+{
+  for(int i=0; i<H.size(); ++i)
+    if(H[i]->getMode(QMCHamiltonianBase::INCREMENTAL))
+      H[i]->acceptMove(active);
+}
+
+/** evaluate the local energy with the values of the INCREMENTAL components
+ *@param P input configuration
+ *@param buffer walker buffer positioned after the data of the trial wavefunction
+ *@return the local energy
+ *
+ * Identical to evaluate(P) except that the INCREMENTAL components use their
+ * current values and save them in buffer. With PRINT_DEBUG, the values are
+ * checked against evaluate of the components.
+ */
+QMCHamiltonian::Return_t
+QMCHamiltonian::evaluateIncremental(ParticleSet& P, BufferType& buffer)
+{
+  LocalEnergy = 0.0;
+  for(int i=0; i<H.size(); ++i)
+  {
+    myTimers[i]->start();
+    if(H[i]->getMode(QMCHamiltonianBase::INCREMENTAL))
+    {
+#if defined(PRINT_DEBUG)
+      Return_t v=H[i]->Value;
+      Return_t v_full=H[i]->evaluate(P);
+      if(std::abs(v-v_full)>1e-8*std::max(1.0,std::abs(v_full)))
+        app_warning() << "  QMCHamiltonian::evaluateIncremental " << H[i]->myName
+                      << " incremental = " << v << " full = " << v_full << endl;
+      H[i]->Value=v;
+#endif
+      LocalEnergy += H[i]->Value;
+      H[i]->copyToBuffer(P,buffer);
+    }
+    else
+      LocalEnergy += H[i]->evaluate(P);
+    H[i]->setObservables(Observables);
+    myTimers[i]->stop();
+    H[i]->setParticlePropertyList(P.PropertyList,myIndex);
+  }
+  KineticEnergy=H[0]->Value;
+  P.PropertyList[LOCALENERGY]=LocalEnergy;
+  P.PropertyList[LOCALPOTENTIAL]=LocalEnergy-KineticEnergy;
+  return LocalEnergy;
+}
+
 
 #ifdef QMC_CUDA
 void
@@ -227,6 +227,24 @@ public:
   void rejectMove(int active);
   /*@}*/
 
+  /*@{*/
+  /** @brief functions for the incremental local energy of particle-by-particle moves
+   *
+   * Only the components with the INCREMENTAL mode keep their data in the walker
+   * buffer, after the data of the trial wavefunction. Their values are updated by
+   * evaluatePbyPIncremental before ParticleSet::acceptMove and acceptMoveIncremental
+   * after it. evaluateIncremental sums the values and evaluates the other
+   * components from scratch. updateIncremental recomputes the values from
+   * scratch to remove the round-off accumulated by the updates.
+   */
+  Return_t registerIncremental(ParticleSet& P, BufferType& buf);
+  Return_t updateIncremental(ParticleSet& P, BufferType& buf);
+  void copyFromIncremental(ParticleSet& P, BufferType& buf);
+  void evaluatePbyPIncremental(ParticleSet& P, int active);
+  void acceptMoveIncremental(int active);
+  Return_t evaluateIncremental(ParticleSet& P, BufferType& buf);
+  /*@}*/
+
   /** return an average value of the LocalEnergy
    *
    * Introduced to get a collective value
@@ -67,8 +67,13 @@ struct QMCHamiltonianBase: public QMCTraits
   ///typedef for the walker
   typedef ParticleSet::Walker_t  Walker_t;
 
-  ///enum for UpdateMode
-  enum {PRIMARY, OPTIMIZABLE, RATIOUPDATE, PHYSICAL, COLLECTABLE};
+  /** enum for UpdateMode
+   *
+   * INCREMENTAL is set by a component whose Value is kept up to date by
+   * evaluatePbyP and acceptMove of the accepted moves, with its per-particle
+   * data in the walker buffer.
+   */
+  enum {PRIMARY, OPTIMIZABLE, RATIOUPDATE, PHYSICAL, COLLECTABLE, INCREMENTAL};
   ///set the current update mode
   bitset<8> UpdateMode;
   ///starting index of this object
@@ -100,7 +105,7 @@ struct QMCHamiltonianBase: public QMCTraits
   virtual ~QMCHamiltonianBase() { }
 
   /** return the mode i
-   * @param i index among PRIMARY, OPTIMIZABLE, RATIOUPDATE, PHYSICAL
+   * @param i index among PRIMARY, OPTIMIZABLE, RATIOUPDATE, PHYSICAL, COLLECTABLE, INCREMENTAL
    */
   inline bool getMode(int i)
   {
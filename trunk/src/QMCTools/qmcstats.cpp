@@ -0,0 +1,472 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/** @file qmcstats.cpp
+ * @brief statistics of scalar.dat, dmc.dat and stat.h5 files
+ *
+ * Each file is read once by a thread. For every column of the text files and
+ * every element of the observables in stat.h5, the mean after the equilibration,
+ * the reblocked error and the autocorrelation time are evaluated with
+ * reblock_accumulator. The columns are weighted by the Weight column of
+ * dmc.dat and the BlockWeight column of scalar.dat. The results of the files
+ * of the same kind, e.g., of the twists or of the ranks, are merged: by default
+ * with the total weights of the files, which pools the samples of the ranks
+ * of a run, and with --twist-average with equal weights, which averages
+ * the twists of a uniform grid regardless of their numbers of the samples.
+ */
+#include <vector>
+#include <string>
+#include <map>
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <cstdlib>
+#include <cmath>
+#include <io/hdf_archive.h>
+#include <QMCHamiltonians/observable_helper.h>
+#include <Estimators/reblock_accumulator.h>
+using namespace qmcplusplus;
+using namespace std;
+
+int print_help()
+{
+  cerr << "Usage: qmcstats [--first n] [--merge-only] [--twist-average] list-of-files " << endl;
+  cerr << "  --first n       : number of the blocks (steps for dmc.dat) to skip, default 20" << endl;
+  cerr << "  --merge-only    : print only the results merged over the files of the same kind" << endl;
+  cerr << "  --twist-average : merge the files, e.g., of the twists, with equal weights" << endl;
+  cerr << "                    instead of their total weights, e.g., of the ranks" << endl;
+  cerr << " Example: qmcstats --first 50 qmc.g*.s002.scalar.dat qmc.g*.s002.dmc.dat" << endl;
+  return 1;
+}
+
+///statistics of a series
+struct series_stat
+{
+  string name;
+  long count;
+  double weight;
+  double mean;
+  double error;
+  double variance;
+  double kappa;
+  bool converged;
+};
+
+struct StatFile
+{
+  enum {SCALAR_DAT=0, DMC_DAT, STAT_H5};
+  ///file name
+  string fname;
+  ///kind of the file
+  int kind;
+  ///number of the samples to skip
+  int first;
+  ///number of the samples after the equilibration
+  long nsamples;
+  ///statistics of the series
+  vector<series_stat> results;
+
+  StatFile(const string& a, int f);
+  bool analyze();
+  bool analyze_text();
+  bool analyze_hdf();
+  void add(const string& name, const reblock_accumulator<double>& acc);
+};
+
+/** merge the statistics of the files
+ * @param files files of the same kind
+ * @param merged statistics of the series common to all the files
+ * @param equal_weights if true, the files have the same weight, otherwise the total weights of the series
+ *
+ * With the weights w_i of the files, the mean is m=sum_i w_i m_i/W, the errors
+ * are added in quadrature as sqrt(sum_i w_i^2 e_i^2)/W and the variance
+ * includes that between the files, sum_i w_i (v_i+(m_i-m)^2)/W.
+ */
+void merge(const vector<StatFile*>& files, vector<series_stat>& merged, bool equal_weights);
+void print(ostream& os, const vector<series_stat>& results);
+
+int main(int argc, char** argv)
+{
+  if(argc<2)
+    return print_help();
+  int first=20;
+  bool merge_only=false;
+  bool twist_average=false;
+  vector<string> fnames;
+  int iargc=1;
+  while(iargc<argc)
+  {
+    string c(argv[iargc]);
+    if(c.find("--")!=0)
+    {
+      fnames.push_back(c);
+    }
+    else
+      if(c.find("first")<c.size() && iargc+1<argc)
+      {
+        first=atoi(argv[++iargc]);
+      }
+      else
+        if(c.find("merge")<c.size())
+        {
+          merge_only=true;
+        }
+        else
+          if(c.find("twist")<c.size())
+          {
+            twist_average=true;
+          }
+          else
+          {
+            return print_help();
+          }
+    ++iargc;
+  }
+  if(fnames.empty())
+    return print_help();
+  vector<StatFile*> files(fnames.size());
+  vector<int> status(fnames.size());
+  for(int i=0; i<fnames.size(); ++i)
+    files[i]=new StatFile(fnames[i],first);
+  //a thread per file
+  #pragma omp parallel for schedule(dynamic,1)
+  for(int i=0; i<files.size(); ++i)
+    status[i]=files[i]->analyze();
+  vector<vector<StatFile*> > kinds(3);
+  for(int i=0; i<files.size(); ++i)
+  {
+    if(!status[i])
+    {
+      cerr << "  Failed to read " << files[i]->fname << endl;
+      continue;
+    }
+    if(!merge_only)
+    {
+      cout << "# " << files[i]->fname << " samples = " << files[i]->nsamples
+           << " after skipping " << files[i]->first << endl;
+      print(cout,files[i]->results);
+    }
+    kinds[files[i]->kind].push_back(files[i]);
+  }
+  const char* kind_names[]= {"scalar.dat","dmc.dat","stat.h5"};
+  for(int k=0; k<kinds.size(); ++k)
+  {
+    if(kinds[k].size()<2 && !merge_only)
+      continue;
+    if(kinds[k].empty())
+      continue;
+    vector<series_stat> merged;
+    merge(kinds[k],merged,twist_average);
+    cout << "# merged " << kinds[k].size() << " " << kind_names[k] << " files"
+         << (twist_average? " with equal weights":" with their total weights") << endl;
+    print(cout,merged);
+  }
+  for(int i=0; i<files.size(); ++i)
+    delete files[i];
+  return 0;
+}
+
+StatFile::StatFile(const string& a, int f)
+  : fname(a), kind(SCALAR_DAT), first(std::max(f,0)), nsamples(0)
+{
+  if(fname.find(".h5")<fname.size())
+    kind=STAT_H5;
+  else
+    if(fname.find("dmc.dat")<fname.size())
+      kind=DMC_DAT;
+}
+
+bool StatFile::analyze()
+{
+  return (kind==STAT_H5)? analyze_hdf():analyze_text();
+}
+
+void StatFile::add(const string& name, const reblock_accumulator<double>& acc)
+{
+  series_stat s;
+  s.name=name;
+  s.count=acc.count();
+  s.weight=acc.weight();
+  s.mean=acc.mean();
+  s.variance=acc.variance();
+  s.kappa=1.0;
+  s.error=0.0;
+  s.converged=false;
+  if(acc.levels())
+  {
+    int k=acc.optimal_level(s.converged);
+    s.error=acc.error(k);
+    double e0=acc.error(0);
+    if(e0>0 && s.error>0)
+      s.kappa=s.error*s.error/(e0*e0);
+  }
+  results.push_back(s);
+}
+
+/** read a text file line by line
+ *
+ * The column names are given by the first line starting with #.
+ */
+bool StatFile::analyze_text()
+{
+  ifstream fin(fname.c_str());
+  if(!fin)
+    return false;
+  string line;
+  vector<string> names;
+  while(names.empty() && getline(fin,line))
+  {
+    if(line.empty() || line[0]!='#')
+      continue;
+    istringstream is(line.substr(1));
+    string a;
+    while(is>>a)
+      names.push_back(a);
+  }
+  const int ncols=names.size();
+  if(ncols<2)
+    return false;
+  //the first column is the index, the weight column is unweighted
+  int iw=-1;
+  for(int c=1; c<ncols; ++c)
+    if(names[c]=="Weight" || names[c]=="BlockWeight")
+      iw=c;
+  vector<reblock_accumulator<double> > acc(ncols);
+  vector<double> row(ncols);
+  long nread=0;
+  while(getline(fin,line))
+  {
+    if(line.empty() || line[0]=='#')
+      continue;
+    const char* p=line.c_str();
+    int c=0;
+    for(; c<ncols; ++c)
+    {
+      char* e;
+      row[c]=strtod(p,&e);
+      if(e==p)
+        break;
+      p=e;
+    }
+    if(c<ncols || nread++<first)
+      continue;
+    double w=(iw<0)? 1.0:row[iw];
+    for(c=1; c<ncols; ++c)
+      acc[c](row[c],(c==iw)? 1.0:w);
+  }
+  nsamples=std::max(nread-first,0L);
+  for(int c=1; c<ncols; ++c)
+    add(names[c],acc[c]);
+  return true;
+}
+
+///list of the groups with the value dataset
+struct h5_group_list
+{
+  string path;
+  vector<string>* groups;
+};
+
+static herr_t h5_collect_groups(hid_t gid, const char* name, void* op_data)
+{
+  h5_group_list* p=static_cast<h5_group_list*>(op_data);
+  H5G_stat_t info;
+  if(H5Gget_objinfo(gid,name,0,&info)<0)
+    return 0;
+  if(info.type==H5G_GROUP)
+  {
+    h5_group_list sub;
+    sub.path=p->path+"/"+name;
+    sub.groups=p->groups;
+    H5Giterate(gid,name,NULL,h5_collect_groups,&sub);
+  }
+  else
+    if(info.type==H5G_DATASET && string(name)=="value" && !p->path.empty())
+      p->groups->push_back(p->path);
+  return 0;
+}
+
+/** read the value datasets of a stat.h5 file
+ *
+ * The values of an observable, [blocks][dims...], are read by chunks of rows
+ * and each element is accumulated as a series. HDF5 calls are serialized.
+ */
+bool StatFile::analyze_hdf()
+{
+  hdf_archive* hin=0;
+  vector<string> groups;
+  bool good=false;
+  #pragma omp critical (hdf5_io)
+  {
+    hin=new hdf_archive;
+    good=hin->open(fname,H5F_ACC_RDONLY);
+    if(good)
+    {
+      h5_group_list top;
+      top.groups=&groups;
+      H5Giterate(hin->file_id,"/",NULL,h5_collect_groups,&top);
+    }
+  }
+  vector<double> buffer;
+  for(int ig=0; good && ig<groups.size(); ++ig)
+  {
+    hid_t dataset, dataspace;
+    int rank=0;
+    vector<hsize_t> dims(8,0);
+    #pragma omp critical (hdf5_io)
+    {
+      dataset=H5Dopen(hin->file_id,(groups[ig]+"/value").c_str());
+      dataspace=H5Dget_space(dataset);
+      rank=H5Sget_simple_extent_ndims(dataspace);
+      if(rank>0 && rank<=dims.size())
+        H5Sget_simple_extent_dims(dataspace,&dims[0],NULL);
+    }
+    hsize_t nelem=1;
+    for(int i=1; i<rank; ++i)
+      nelem*=dims[i];
+    const hsize_t nblocks=dims[0];
+    if(rank>0 && rank<=dims.size() && nelem>0)
+    {
+      vector<reblock_accumulator<double> > acc(nelem);
+      const hsize_t nrows=std::max(static_cast<hsize_t>(1),static_cast<hsize_t>(65536)/nelem);
+      buffer.resize(nrows*nelem);
+      vector<hsize_t> offset(rank,0), count(dims.begin(),dims.begin()+rank);
+      for(hsize_t r=first; r<nblocks; r+=nrows)
+      {
+        offset[0]=r;
+        count[0]=std::min(nrows,nblocks-r);
+        #pragma omp critical (hdf5_io)
+        {
+          H5Sselect_hyperslab(dataspace,H5S_SELECT_SET,&offset[0],NULL,&count[0],NULL);
+          hid_t memspace=H5Screate_simple(rank,&count[0],NULL);
+          H5Dread(dataset,h5_observable_type,memspace,dataspace,H5P_DEFAULT,&buffer[0]);
+          H5Sclose(memspace);
+        }
+        const double* v=&buffer[0];
+        for(hsize_t i=0; i<count[0]; ++i, v+=nelem)
+          for(hsize_t e=0; e<nelem; ++e)
+            acc[e](v[e]);
+      }
+      nsamples=std::max(nsamples,static_cast<long>(nblocks)-first);
+      string name=groups[ig].substr(1);
+      if(rank==1)
+        add(name,acc[0]);
+      else
+        for(hsize_t e=0; e<nelem; ++e)
+        {
+          ostringstream o;
+          o << name << "_" << e;
+          add(o.str(),acc[e]);
+        }
+    }
+    #pragma omp critical (hdf5_io)
+    {
+      H5Sclose(dataspace);
+      H5Dclose(dataset);
+    }
+  }
+  #pragma omp critical (hdf5_io)
+  {
+    delete hin;
+  }
+  return good;
+}
+
+void merge(const vector<StatFile*>& files, vector<series_stat>& merged, bool equal_weights)
+{
+  //the series of the files by the names of the first
+  map<string,int> index;
+  const vector<series_stat>& res0(files[0]->results);
+  for(int i=0; i<res0.size(); ++i)
+    index[res0[i].name]=i;
+  vector<vector<const series_stat*> > series(res0.size());
+  for(int f=0; f<files.size(); ++f)
+  {
+    const vector<series_stat>& res(files[f]->results);
+    for(int j=0; j<res.size(); ++j)
+    {
+      map<string,int>::iterator it=index.find(res[j].name);
+      if(it != index.end())
+        series[(*it).second].push_back(&res[j]);
+    }
+  }
+  merged.clear();
+  for(int i=0; i<series.size(); ++i)
+  {
+    const vector<const series_stat*>& t(series[i]);
+    if(t.size()<files.size())
+      continue;
+    series_stat s(*t[0]);
+    s.count=0;
+    s.weight=0.0;
+    s.mean=0.0;
+    s.variance=0.0;
+    s.kappa=0.0;
+    s.error=0.0;
+    s.converged=true;
+    vector<double> w(t.size());
+    double wtot=0.0;
+    for(int k=0; k<t.size(); ++k)
+    {
+      w[k]=equal_weights? 1.0:t[k]->weight;
+      wtot+=w[k];
+    }
+    if(wtot<=0)
+      continue;
+    const double wnorm=1.0/wtot;
+    for(int k=0; k<t.size(); ++k)
+      s.mean+=w[k]*t[k]->mean;
+    s.mean*=wnorm;
+    for(int k=0; k<t.size(); ++k)
+    {
+      const double dm=t[k]->mean-s.mean;
+      s.count+=t[k]->count;
+      s.weight+=t[k]->weight;
+      s.variance+=w[k]*(t[k]->variance+dm*dm);
+      s.kappa+=w[k]*t[k]->kappa;
+      s.error+=w[k]*w[k]*t[k]->error*t[k]->error;
+      s.converged=s.converged && t[k]->converged;
+    }
+    s.variance*=wnorm;
+    s.kappa*=wnorm;
+    s.error=std::sqrt(s.error)*wnorm;
+    merged.push_back(s);
+  }
+}
+
+void print(ostream& os, const vector<series_stat>& results)
+{
+  os << "#" << setw(29) << "name" << setw(20) << "mean" << setw(16) << "error"
+     << setw(16) << "variance" << setw(10) << "kappa" << setw(10) << "samples" << endl;
+  os.setf(ios::right);
+  for(int i=0; i<results.size(); ++i)
+  {
+    const series_stat& s(results[i]);
+    os << setw(30) << s.name
+       << setw(20) << setprecision(10) << s.mean
+       << setw(16) << setprecision(4) << s.error
+       << setw(16) << setprecision(6) << s.variance
+       << setw(10) << setprecision(3) << s.kappa
+       << setw(10) << s.count
+       << (s.converged? "":" *") << endl;
+  }
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
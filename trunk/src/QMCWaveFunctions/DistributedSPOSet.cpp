@@ -14,283 +14,438 @@
 //////////////////////////////////////////////////////////////////
 // -*- C++ -*-
 #include "QMCWaveFunctions/DistributedSPOSet.h"
-//this will go into cmake
-#define MAX_NUM_SHARED_NODES 8
-#define PSI_DIM 5
+#include "Message/CommOperators.h"
+#include "Utilities/UtilityFunctions.h"
 
 namespace qmcplusplus
 {
 
 ///constructor
-DistributedSPOSet::DistributedSPOSet(int norbs=0)
+DistributedSPOSet::DistributedSPOSet()
+  : Transport(SHM_TRANSPORT), GroupComm(0), NodeShm(0), MultiSpline(0)
 {
-  setOrbitalSetSize(norbs);
+  className="DistributedSPOSet";
+  is_complex=false;
+  AdoptorName="DistributedSPOSet";
+  KeyWord="R2R";
 }
 
 DistributedSPOSet::~DistributedSPOSet()
 {
-  delete_iter(SendBuffer.begin(),SendBuffer.end());
-  delete_iter(RecvBuffer.begin(),RecvBuffer.end());
 }
 
-void DistributedSPOSet::setCommunicator(Communicate* c)
+SPOSetBase* DistributedSPOSet::makeClone() const
 {
-  if(myComm && myComm == c)
-  {
-    app_log() << "  Identical communicator. Nothing to be done in ScalarEstimatorManager::setCommunicator." << endl;
-    return;
-  }
-  if(c)
-    myComm=c;
-  else
-    myComm = OHMMS::Controller;
-  int ncontexts=myComm->ncontexts();
-  Rnow.resize(OrbitalSetSize);
-  //divide orbitals among the processors
-  OrbitalCount.resize(ncontexts);
-  OrbitalOffset.resize(ncontexts+1);
-  FairDivideLow(OrbitalSetSize,ncontexts,OrbitalOffSet);
-  for(int i=0; i<ncontexts; i++)
-    OrbitalCount[i]=OrbitalOffset[i+1]-OrbitalOffset[i];
-  NumRemoteNodes=ncontexts-1;
-  if(RemoteNodes.empty())//cannot do it again
-  {
-    RemoteNodes.resize(NumRemoteNodes);
-    SendBuffer.resize(ncontexts,0);
-    RecvBuffer.resize(ncontexts,0);
-    for(int i=0, r=0; i<=NumRemoteNodes; i++)
-    {
-      if(i == myNodeID)
-      {
-        SendBuffer[i]=new BufferType;
-        RecvBuffer[i]=new BufferType;
-      }
-      else
-      {
-        RemonteNodes[r++]=i;
-        SendBuffer[i]=new BufferType(OrbitalCount[i]*OrbitalSetSize*PSI_DIM);
-        RecvBuffer[i]=new BufferType(OrbitalCount[i]*OrbitalSetSize*PSI_DIM);
-      }
-    }
-  }
+  return new DistributedSPOSet(*this);
 }
 
 void DistributedSPOSet::setOrbitalSetSize(int norbs)
 {
-  if(norbs == OrbitalSetSize )
-    return;
   OrbitalSetSize=norbs;
   BasisSetSize=norbs;
+  first_spo=0;
+  last_spo=norbs;
 }
 
-void DistributedSPOSet::resetParameters(VarRegistry<RealType>& optVariables)
+void DistributedSPOSet::resizeStorage(int n, int nv)
 {
-  Phi->resetParameters(optVariables);
+  init_base(n);
 }
 
-void DistributedSPOSet::resetTargetParticleSet(ParticleSet& P)
+void DistributedSPOSet::setCommunicator(Communicate* c, int transport, int groupsize)
 {
-  Phi->resetTargetParticleSet(P);
+  Transport=transport;
+#if defined(HAVE_MPI)
+  if(Transport == SHM_TRANSPORT)
+  {
+    NodeShm=new NodeSharedMemory(c);
+    GroupComm=NodeShm->NodeComm;
+  }
+  else
+  {
+    int np=c->size();
+    if(groupsize<=0 || groupsize>np)
+      groupsize=np;
+    GroupComm=new Communicate(*c,np/groupsize);
+  }
+#else
+  GroupComm=c;
+#endif
+  int ng=GroupComm->size();
+  OrbitalOffset.resize(ng+1);
+  FairDivideLow(OrbitalSetSize,ng,OrbitalOffset);
+  Coefs.resize(ng,0);
+  BandStride.resize(ng,0);
 }
 
-void
-DistributedSPOSet::evaluate(const ParticleSet& P, int iat, ValueVector_t& psi)
+void DistributedSPOSet::create_spline(Ugrid* xyz_grid, BCType* xyz_bc)
 {
-  CommunicatorTraits::mpi_request_type sendPos[MAX_NUM_SHARED_NODES];
-  CommunicatorTraits::mpi_request_type recvPsi[MAX_NUM_SHARED_NODES];
-  CommunicatorTraits::mpi_request_type sendPsi[MAX_NUM_SHARED_NODES];
-  CommunicatorTraits::mpi_status_type statusPos[MAX_NUM_SHARED_NODES];
-  CommunicatorTraits::mpi_status_type statusPsi[MAX_NUM_SHARED_NODES];
-  PosType pos(P[iat]);
-  //send the current position and start recv
-  for(int p=0; p<NumRemoteNodes; p++)
-  {
-    int target=RemoteNodes[p];
-    MPI_Isend(pos.begin(), OHMMS_DIM, MPI_DOUBLE, target, PosTag, myComm->getMPI(), &(sendPos[p]));
-    MPI_Irecv(RecvBuffer[target]->data(), OrbitalCount[target], target, PsiTag, myComm->getMPI(),&(recvPsi[p]));
-  }
-  ValueVector_t psiL(OrbitalCount[myNodeID]);
-  //do the local calculation
-  Phi->evaluate(pos,psiL);
-  std::copy(psiL.begin(),psiL.end(),psi.begin()+OrbitalOffset[myNodeID]);
-  //can make waitsome
-  int err=MPI_Waitall(NumRemoteNodes, sendPos,statusPos);
-  //do the calculation with the positions recv and send back the orbitals
-  for(int p=0; p<NumRemoteNodes; p++)
+  GGt=dot(transpose(PrimLattice.G),PrimLattice.G);
+  for(int d=0; d<3; ++d)
+    Grid[d]=xyz_grid[d];
+  const int me=GroupComm->rank();
+  if(numBands())
   {
-    int target=RemoteNodes[p];
-    //matching recv with MPI_Isend
-    MPI_recv(Rnow[p].data(), OHMMS_DIM, MPI_DOUBLE, target, PosTag, myNodeID,myComm->getMPI(),&(statusPos[p]));
-    //calculate with a position
-    Phi->evaluate(Rnow[p],psiL);
-    //pack the message
-    SendBuffer[p]->rewind();
-    SendBuffer[p]->put(psiL.begin(),psiL.end());
-    //send the wavefunction matching ready-send with MPI_Irecv
-    MPI_Irsend(SendBuffer[p]->data(), OrbitalCount[myNodeID], MPI_DOUBLE, target, PsiTag, myComm->getMPI(), &(sendPsi[p]));
+    MultiSpline=einspline::create(MultiSpline,xyz_grid,xyz_bc,numBands());
+    //einspline sets delta_inv
+    Grid[0]=MultiSpline->x_grid;
+    Grid[1]=MultiSpline->y_grid;
+    Grid[2]=MultiSpline->z_grid;
+    BandStride[me]=MultiSpline->z_stride;
   }
-  int nm=NumRemoteNodes;
-  while(nm)
+  else
+    for(int d=0; d<3; ++d)
+      Grid[d].delta_inv=Grid[d].num/(Grid[d].end-Grid[d].start);
+  GroupComm->allreduce(BandStride);
+  Coefs[me]=MultiSpline?MultiSpline->coefs:0;
+  if(Transport == SHM_TRANSPORT && NodeShm && NodeShm->isShared())
   {
-    int count =0;
-    int err=MPI_Testsome(NumRemoteNodes,recvPsi,&count,statusPsi);
-    for(int m=0; m<count; m++)
+    //every task creates the segment of its table and maps the others
+    const size_t ngrid=size_t(Grid[0].num+3)*size_t(Grid[1].num+3)*size_t(Grid[2].num+3);
+    for(int p=0; p<GroupComm->size(); ++p)
     {
-      int source=statusPsi[m].MPI_SOURCE;
-      RecvBuffer[source]->rewind();
-      for(int t=OrbitalOffset[source]; t<OrbitalOffset[source+1]; t++)
-        RecvBuffer[source]->get(psi[t]);
+      if(BandStride[p] == 0)
+        continue;
+      void* ptr=NodeShm->allocate(ngrid*BandStride[p]*sizeof(double),p);
+      if(ptr==0)
+      {
+        Transport=RMA_TRANSPORT;
+        break;
+      }
+      if(p == me)
+      {
+        free(MultiSpline->coefs);
+        MultiSpline->coefs=static_cast<double*>(ptr);
+      }
+      Coefs[p]=static_cast<const double*>(ptr);
     }
-    nm-=count;
   }
-  err=MPI_Waitall(NumRemoteNodes, sendPsi,statusPsi);
+  if(Transport == RMA_TRANSPORT)
+  {
+    std::fill(Coefs.begin(),Coefs.end(),static_cast<const double*>(0));
+    Coefs[me]=MultiSpline?MultiSpline->coefs:0;
+  }
 }
 
-void
-DistributedSPOSet::evaluate(const ParticleSet& P, int iat,
-                            ValueVector_t& psi, GradVector_t& dpsi, ValueVector_t& d2psi)
+void DistributedSPOSet::set_spline(double* restrict psi_r, int ispline)
 {
-  CommunicatorTraits::mpi_request_type sendPos[MAX_NUM_SHARED_NODES];
-  CommunicatorTraits::mpi_request_type recvPsi[MAX_NUM_SHARED_NODES];
-  CommunicatorTraits::mpi_request_type sendPsi[MAX_NUM_SHARED_NODES];
-  CommunicatorTraits::mpi_status_type statusPos[MAX_NUM_SHARED_NODES];
-  CommunicatorTraits::mpi_status_type statusPsi[MAX_NUM_SHARED_NODES];
-  PosType pos(P[iat]);
-  //send the current position and start recv
-  for(int p=0; p<NumRemoteNodes; p++)
-  {
-    int target=RemoteNodes[p];
-    MPI_Isend(pos.data(), OHMMS_DIM, MPI_DOUBLE, target, PosTag, myComm->getMPI(), &(sendPos[p]));
-    MPI_Irecv(RecvBuffer[target]->data(), PSI_DIM*OrbitalCount[target], target, PsiTag, myComm->getMPI(),&(recvPsi[p]));
-  }
-  ValueVector_t psiL(OrbitalCount[myNodeID]);
-  GradVector_t dpsiL(OrbitalCount[myNodeID]);
-  ValueVector_t p2siL(OrbitalCount[myNodeID]);
-  //do the local calculation
-  Phi->evaluate(pos,psiL,dpsiL,d2psiL);
-  std::copy(psiL.begin(),psiL.end(),psi.begin()+OrbitalOffset[myNoodeID]);
-  std::copy(dpsiL.begin(),dpsiL.end(),dpsi.begin()+OrbitalOffset[myNoodeID]);
-  std::copy(d2psiL.begin(),d2psiL.end(),d2psi.begin()+OrbitalOffset[myNoodeID]);
-  int err=MPI_Waitall(NumRemoteNodes, sendPos,statusPos);
-  int ngd=OrbitalCount[myNodeID]*OHMMS_DIM;
-  //do the calculation with the positions recv and send back the orbitals
-  for(int p=0; p<NumRemoteNodes; p++)
+  int ib=ispline-firstBand();
+  if(ib>=0 && ib<numBands())
+    einspline::set(MultiSpline,ib,psi_r);
+}
+
+void DistributedSPOSet::finalizeTables()
+{
+#if defined(HAVE_MPI)
+  //a task alone in its group has no remote table to fetch
+  if(Transport == RMA_TRANSPORT && GroupComm->size()>1)
   {
-    int target=RemoteNodes[p];
-    //matching recv with MPI_Isend
-    MPI_recv(Rnow[p].data(), OHMMS_DIM, MPI_DOUBLE, target, PosTag, myNodeID,myComm->getMPI(),&(statusPos[p]));
-    //do the local calculation
-    Phi->evaluate(Rnow[p],psiL,dpsiL,d2psiL);
-    //pack the message
-    SendBuffer[p]->rewind();
-    for(int i=0; i<OrbitalCount[target]; i++)
+    const int ng=GroupComm->size();
+    MPI_Aint nbytes=MultiSpline?MultiSpline->coefs_size*sizeof(double):0;
+    MPI_Win_create(MultiSpline?MultiSpline->coefs:0,nbytes,sizeof(double)
+                   ,MPI_INFO_NULL,GroupComm->getMPI(),&Window);
+    //a block is 4x4 runs of four grid points along z
+    BlockType.resize(ng,MPI_DATATYPE_NULL);
+    for(int p=0; p<ng; ++p)
     {
-      SendBuffer[p]->put(psiL[i]);
-      SendBuffer[p]->put(dpsiL[i].begin(),dpsiL[i].end());
-      SendBuffer[p]->put(d2dpsiL[i]);
+      if(Coefs[p] || BandStride[p]==0)
+        continue;
+      intptr_t zs=BandStride[p];
+      intptr_t ys=(Grid[2].num+3)*zs;
+      intptr_t xs=(Grid[1].num+3)*ys;
+      MPI_Datatype yz;
+      MPI_Type_vector(4,4*zs,ys,MPI_DOUBLE,&yz);
+      MPI_Type_create_hvector(4,1,xs*sizeof(double),yz,&BlockType[p]);
+      MPI_Type_commit(&BlockType[p]);
+      MPI_Type_free(&yz);
     }
-    //send the wavefunction matching ready-send with MPI_Irecv
-    MPI_Irsend(SendBuffer[p]->data(), PSI_DIM*OrbitalCount[target], MPI_DOUBLE, target, PsiTag, myComm->getMPI(), &(sendPsi[p]));
   }
-  int nm=NumRemoteNodes,count;
-  while(nm)
+#endif
+  GroupComm->barrier();
+  app_log() << "  DistributedSPOSet " << OrbitalSetSize << " bands over " << GroupComm->size()
+            << " tasks using " << ((Transport==SHM_TRANSPORT)?"shared memory":"one-sided MPI") << endl;
+  app_log() << "    bands of a task = " << numBands()
+            << " table in MB = " << ((MultiSpline)?(MultiSpline->coefs_size*sizeof(double))>>20:0) << endl;
+}
+
+void DistributedSPOSet::locate(int n, const PosType* pos)
+{
+  Points.resize(n);
+  for(int k=0; k<n; ++k)
   {
-    int err=MPI_Testsome(NumRemoteNodes,recvPsi,&count,statusPsi);
-    for(int m=0; m<count; m++)
+    GridPoint& g(Points[k]);
+    PointType ru=PrimLattice.toUnit(pos[k]);
+    g.sign=0;
+    for(int d=0; d<3; ++d)
     {
-      int source=statusPsi[m].MPI_SOURCE;
-      RecvBuffer[source]->rewind();
-      for(int t=OrbitalOffset[source]; t<OrbitalOffset[source+1]; t++)
-      {
-        RecvBuffer[source]->get(psi[t]);
-        RecvBuffer[source]->get(dpsi[t].begin(),dpsi[t].end());
-        RecvBuffer[source]->get(d2psi[t]);
-      }
+      double img=std::floor(ru[d]);
+      g.sign += HalfG[d]*static_cast<int>(img);
+      double u=(ru[d]-img-Grid[d].start)*Grid[d].delta_inv;
+      int i=static_cast<int>(u);
+      i=(i<Grid[d].num)?i:Grid[d].num-1;
+      g.i[d]=i;
+      double t=u-i;
+      double t2=t*t;
+      double s=1.0-t;
+      double* restrict w=g.w[d];
+      w[0]=s*s*s/6.0;
+      w[1]=(3.0*t2*t-6.0*t2+4.0)/6.0;
+      w[2]=(-3.0*t2*t+3.0*t2+3.0*t+1.0)/6.0;
+      w[3]=t2*t/6.0;
+      const double dinv=Grid[d].delta_inv;
+      w[4]=-0.5*s*s*dinv;
+      w[5]=(1.5*t2-2.0*t)*dinv;
+      w[6]=(-1.5*t2+t+0.5)*dinv;
+      w[7]=0.5*t2*dinv;
+      const double dinv2=dinv*dinv;
+      w[8]=s*dinv2;
+      w[9]=(3.0*t-2.0)*dinv2;
+      w[10]=(1.0-3.0*t)*dinv2;
+      w[11]=t*dinv2;
     }
-    nm-=count;
   }
-  err=MPI_Waitall(NumRemoteNodes, sendPsi,statusPsi);
 }
 
-void DistributedSPOSet::evaluate_notranspose(const ParticleSet& P, int first, int last,
-    ValueMatrix_t& logdet, GradMatrix_t& dlogdet, ValueMatrix_t& d2logdet)
+const double* DistributedSPOSet::block(int p, int k, intptr_t& xs, intptr_t& ys) const
 {
-  CommunicatorTraits::mpi_request_type sendPos[MAX_NUM_SHARED_NODES];
-  CommunicatorTraits::mpi_request_type recvPsi[MAX_NUM_SHARED_NODES];
-  CommunicatorTraits::mpi_request_type sendPsi[MAX_NUM_SHARED_NODES];
-  CommunicatorTraits::mpi_status_type statusPos[MAX_NUM_SHARED_NODES];
-  CommunicatorTraits::mpi_status_type statusPsi[MAX_NUM_SHARED_NODES];
-  int nat=last-first;
-  vector<PosType> pos(nat);
-  for(int iat=first,i=0; iat<last; iat++,i++)
-    pos[i]=P.R[iat];
-  //send the current position and start recv
-  for(int p=0; p<NumRemoteNodes; p++)
+  const intptr_t zs=BandStride[p];
+  if(Coefs[p])
   {
-    int target=RemoteNodes[p];
-    MPI_Isend(&(pos[0][0]), nat*OHMMS_DIM, MPI_DOUBLE, target, PosTag, myComm->getMPI(), &(sendPos[p]));
-    MPI_Irecv(RecvBuffer[target]->data(), nat*PSI_DIM*OrbitalCount[target], target, PsiTag, myComm->getMPI(),&(recvPsi[p]));
+    const GridPoint& g(Points[k]);
+    ys=(Grid[2].num+3)*zs;
+    xs=(Grid[1].num+3)*ys;
+    return Coefs[p]+g.i[0]*xs+g.i[1]*ys+g.i[2]*zs;
   }
-  ValueVector_t psiL(OrbitalCount[myNodeID]);
-  GradVector_t dpsiL(OrbitalCount[myNodeID]);
-  ValueVector_t p2siL(OrbitalCount[myNodeID]);
-  for(int i=0; i<nat; i++)
+  ys=4*zs;
+  xs=16*zs;
+  return &Blocks[k*64*zs];
+}
+
+void DistributedSPOSet::fetchBlocks(int p)
+{
+#if defined(HAVE_MPI)
+  const intptr_t zs=BandStride[p];
+  const intptr_t ys=(Grid[2].num+3)*zs;
+  const intptr_t xs=(Grid[1].num+3)*ys;
+  const int bsize=64*zs;
+  Blocks.resize(Points.size()*bsize);
+  //MPI is not initialized for concurrent calls by the threads
+  #pragma omp critical (distributed_spo_rma)
   {
-    //do the local calculation
-    Phi->evaluate_notranspose(pos[i],psiL,dpsiL,d2psiL);
-    //use std::copy
-    for(int jc=0,j=OrbitalOffset[myNoodeID]; jc<OrbitalCount[myNodeID]; jc++,j++)
+    MPI_Win_lock(MPI_LOCK_SHARED,p,0,Window);
+    for(int k=0; k<Points.size(); ++k)
     {
-      //logdet(j,i)=psiL[jc];
-      logdet(i,j)=psiL[jc];
-      dlogdet(i,j)=dpsiL[jc];
-      d2logdet(i,j)=d2psiL[jc];
+      const GridPoint& g(Points[k]);
+      MPI_Aint disp=g.i[0]*xs+g.i[1]*ys+g.i[2]*zs;
+      MPI_Get(&Blocks[k*bsize],bsize,MPI_DOUBLE,p,disp,1,BlockType[p],Window);
     }
+    MPI_Win_unlock(p,Window);
   }
-  int err=MPI_Waitall(NumRemoteNodes, sendPos,statusPos);
-  //do the calculation with the positions recv and send back the orbitals
-  for(int p=0; p<NumRemoteNodes; p++)
+#endif
+}
+
+void DistributedSPOSet::evaluate_rows(ValueType* const* psi, GradType* const* dpsi
+                                      , ValueType* const* d2psi, HessType* const* hess)
+{
+  const int np=GroupComm->size();
+  const int me=GroupComm->rank();
+  const int n=Points.size();
+  const Tensor<double,3>& G(PrimLattice.G);
+  for(int q=0; q<np; ++q)
   {
-    int target=RemoteNodes[p];
-    //matching recv with MPI_Isend
-    MPI_recv(Rnow[0].data(), nat*OHMMS_DIM, MPI_DOUBLE, target, PosTag, myComm->getMPI(),&(statusPos[p]));
-    //evaluate for the target node
-    SendBuffer[p]->rewind();
-    for(int i=0; i<nat; i++)
+    //own table first
+    const int p=(me+q)%np;
+    const int first=OrbitalOffset[p];
+    const int nb=OrbitalOffset[p+1]-first;
+    if(nb==0)
+      continue;
+    if(Coefs[p]==0)
+      fetchBlocks(p);
+    const intptr_t zs=BandStride[p];
+    Work.resize(10*zs);
+    for(int k=0; k<n; ++k)
     {
-      Phi->evaluate_notranspose(Rnow[i],psiL,dpsiL,d2psiL);
-      for(int j=0; j<OrbitalCount[target]; j++)
+      const GridPoint& g(Points[k]);
+      intptr_t xs, ys;
+      const double* restrict c=block(p,k,xs,ys);
+      const double sgn=(g.sign&1)?-1.0:1.0;
+      double* restrict v=&Work[0];
+      if(dpsi==0)
       {
-        SendBuffer[p]->put(psiL[j]);
-        SendBuffer[p]->put(dpsiL[j].begin(),dpsiL[j].end());
-        SendBuffer[p]->put(d2dpsiL[j]);
+        std::fill(v,v+nb,0.0);
+        for(int i=0; i<4; ++i)
+          for(int j=0; j<4; ++j)
+          {
+            const double* restrict cij=c+i*xs+j*ys;
+            const double wij=g.w[0][i]*g.w[1][j];
+            for(int l=0; l<4; ++l)
+            {
+              const double* restrict cl=cij+l*zs;
+              const double w=wij*g.w[2][l];
+              for(int b=0; b<nb; ++b)
+                v[b]+=w*cl[b];
+            }
+          }
+        ValueType* restrict out=psi[k]+first;
+        for(int b=0; b<nb; ++b)
+          out[b]=sgn*v[b];
+        continue;
       }
-    }
-    //send the wavefunction matching ready-send with MPI_Irecv
-    MPI_Irsend(SendBuffer[p]->data(), nat*PSI_DIM*OrbitalCount[target], MPI_DOUBLE, target, PsiTag, myComm->getMPI(), &(sendPsi[p]));
-  }
-  int nm=NumRemoteNodes,count;
-  while(nm)
-  {
-    int err=MPI_Testsome(NumRemoteNodes,recvPsi,&count,statusPsi);
-    for(int m=0; m<count; m++)
-    {
-      int source=statusPsi[m].MPI_SOURCE;
-      RecvBuffer[source]->rewind();
-      for(int i=0; i<nat; i++)
+      double* restrict gx=v+zs;
+      double* restrict gy=v+2*zs;
+      double* restrict gz=v+3*zs;
+      double* restrict hxx=v+4*zs;
+      double* restrict hxy=v+5*zs;
+      double* restrict hxz=v+6*zs;
+      double* restrict hyy=v+7*zs;
+      double* restrict hyz=v+8*zs;
+      double* restrict hzz=v+9*zs;
+      std::fill(v,v+10*zs,0.0);
+      const double* restrict a=g.w[0];
+      const double* restrict b=g.w[1];
+      const double* restrict cw=g.w[2];
+      for(int i=0; i<4; ++i)
+        for(int j=0; j<4; ++j)
+        {
+          const double* restrict cij=c+i*xs+j*ys;
+          const double ab=a[i]*b[j], dab=a[4+i]*b[j], adb=a[i]*b[4+j];
+          const double d2ab=a[8+i]*b[j], dadb=a[4+i]*b[4+j], ad2b=a[i]*b[8+j];
+          for(int l=0; l<4; ++l)
+          {
+            const double* restrict cl=cij+l*zs;
+            const double w_v=ab*cw[l], w_x=dab*cw[l], w_y=adb*cw[l], w_z=ab*cw[4+l];
+            const double w_xx=d2ab*cw[l], w_xy=dadb*cw[l], w_xz=dab*cw[4+l];
+            const double w_yy=ad2b*cw[l], w_yz=adb*cw[4+l], w_zz=ab*cw[8+l];
+            for(int m=0; m<nb; ++m)
+            {
+              const double cm=cl[m];
+              v[m]+=w_v*cm;
+              gx[m]+=w_x*cm;
+              gy[m]+=w_y*cm;
+              gz[m]+=w_z*cm;
+              hxx[m]+=w_xx*cm;
+              hxy[m]+=w_xy*cm;
+              hxz[m]+=w_xz*cm;
+              hyy[m]+=w_yy*cm;
+              hyz[m]+=w_yz*cm;
+              hzz[m]+=w_zz*cm;
+            }
+          }
+        }
+      for(int m=0, jm=first; m<nb; ++m, ++jm)
       {
-        for(int t=OrbitalOffset[source]; t<OrbitalOffset[source+1]; t++)
+        psi[k][jm]=sgn*v[m];
+        TinyVector<double,3> gu(gx[m],gy[m],gz[m]);
+        Tensor<double,3> hu(hxx[m],hxy[m],hxz[m],hxy[m],hyy[m],hyz[m],hxz[m],hyz[m],hzz[m]);
+        TinyVector<double,3> gc=dot(G,gu);
+        for(int x=0; x<3; ++x)
+          dpsi[k][jm][x]=sgn*gc[x];
+        if(d2psi)
+          d2psi[k][jm]=sgn*trace(hu,GGt);
+        if(hess)
         {
-          RecvBuffer[source]->get(logdet(i,t));
-          //RecvBuffer[source]->get(logdet(t,i));
-          RecvBuffer[source]->get(dlogdet(i,t).begin(),dlogdet(i,t).end());
-          RecvBuffer[source]->get(d2logdet(i,t));
+          Tensor<double,3> hc=dot(dot(G,hu),transpose(G));
+          for(int x=0; x<3; ++x)
+            for(int y=0; y<3; ++y)
+              hess[k][jm](x,y)=sgn*hc(x,y);
         }
       }
     }
-    nm-=count;
   }
-  err=MPI_Waitall(NumRemoteNodes, sendPsi,statusPsi);
+}
+
+void DistributedSPOSet::evaluate(const ParticleSet& P, int iat, ValueVector_t& psi)
+{
+  locate(1,P.R.first_address()+iat);
+  ValueType* v=psi.data();
+  evaluate_rows(&v,0,0,0);
+}
+
+void DistributedSPOSet::evaluate(const ParticleSet& P, int iat,
+                                 ValueVector_t& psi, GradVector_t& dpsi, ValueVector_t& d2psi)
+{
+  locate(1,P.R.first_address()+iat);
+  ValueType* v=psi.data();
+  GradType* g=dpsi.data();
+  ValueType* l=d2psi.data();
+  evaluate_rows(&v,&g,&l,0);
+}
+
+void DistributedSPOSet::evaluate(const ParticleSet& P, int iat,
+                                 ValueVector_t& psi, GradVector_t& dpsi, HessVector_t& grad_grad_psi)
+{
+  locate(1,P.R.first_address()+iat);
+  ValueType* v=psi.data();
+  GradType* g=dpsi.data();
+  HessType* h=grad_grad_psi.data();
+  evaluate_rows(&v,&g,0,&h);
+}
+
+void DistributedSPOSet::evaluateValues(const VirtualParticleSet& VP, ValueMatrix_t& psiM)
+{
+  const int n=VP.getTotalNum();
+  locate(n,VP.R.first_address());
+  vector<ValueType*> v(n);
+  for(int k=0; k<n; ++k)
+    v[k]=psiM[k];
+  evaluate_rows(&v[0],0,0,0);
+}
+
+/** the positions of the walkers are evaluated together
+ *
+ * The clones share the tables, so that the blocks are fetched by this for all the walkers.
+ */
+void DistributedSPOSet::mw_evaluate(const vector<SPOSetBase*>& spo_list, const vector<ParticleSet*>& P_list, int iat,
+                                    const vector<ValueVector_t*>& psi_v_list,
+                                    const vector<GradVector_t*>& dpsi_v_list,
+                                    const vector<ValueVector_t*>& d2psi_v_list)
+{
+  const int nw=P_list.size();
+  vector<PosType> pos(nw);
+  vector<ValueType*> v(nw), l(nw);
+  vector<GradType*> g(nw);
+  for(int iw=0; iw<nw; ++iw)
+  {
+    pos[iw]=P_list[iw]->R[iat];
+    v[iw]=psi_v_list[iw]->data();
+    g[iw]=dpsi_v_list[iw]->data();
+    l[iw]=d2psi_v_list[iw]->data();
+  }
+  locate(nw,&pos[0]);
+  evaluate_rows(&v[0],&g[0],&l[0],0);
+}
+
+void DistributedSPOSet::evaluate_notranspose(const ParticleSet& P, int first, int last,
+    ValueMatrix_t& logdet, GradMatrix_t& dlogdet, ValueMatrix_t& d2logdet)
+{
+  const int n=last-first;
+  locate(n,P.R.first_address()+first);
+  vector<ValueType*> v(n), l(n);
+  vector<GradType*> g(n);
+  for(int i=0; i<n; ++i)
+  {
+    v[i]=logdet[i];
+    g[i]=dlogdet[i];
+    l[i]=d2logdet[i];
+  }
+  evaluate_rows(&v[0],&g[0],&l[0],0);
+}
+
+void DistributedSPOSet::evaluate_notranspose(const ParticleSet& P, int first, int last
+    , ValueMatrix_t& logdet, GradMatrix_t& dlogdet, HessMatrix_t& grad_grad_logdet)
+{
+  const int n=last-first;
+  locate(n,P.R.first_address()+first);
+  vector<ValueType*> v(n);
+  vector<GradType*> g(n);
+  vector<HessType*> h(n);
+  for(int i=0; i<n; ++i)
+  {
+    v[i]=logdet[i];
+    g[i]=dlogdet[i];
+    h[i]=grad_grad_logdet[i];
+  }
+  evaluate_rows(&v[0],&g[0],0,&h[0]);
 }
 }
 /***************************************************************************
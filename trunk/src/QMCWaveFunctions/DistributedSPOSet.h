@@ -19,69 +19,138 @@
  * @brief Declaration of distributed single-particle orbital set class
  */
 #include "QMCWaveFunctions/SPOSetBase.h"
-#include "Utilities/PooledData.h"
+#include "simd/simd.hpp"
+#include "QMCWaveFunctions/EinsplineAdoptor.h"
+#include "Message/NodeSharedMemory.h"
 
 namespace qmcplusplus
 {
 
 /** class specialized for small-memory distributed machines
  *
- * Limitations: Only valid for the same number of walkers per node.
+ * The B-spline table of real orbitals is divided by the bands among the tasks
+ * of a group, GroupComm. The task p owns the bands [OrbitalOffset[p],OrbitalOffset[p+1])
+ * and the 4x4x4 blocks of the other tables are read for the positions of a call.
+ * - SHM_TRANSPORT : the group is the tasks on a node and every table is in
+ *   a node-level shared segment, read in place by the other tasks. The whole
+ *   table is still held by each node.
+ * - RMA_TRANSPORT : the group is any set of tasks and the blocks are fetched
+ *   by MPI_Get from the window of the owner without its participation. Only
+ *   a group spanning several nodes holds a table larger than a node.
+ *
+ * The calls are not synchronized among the tasks, so that each task moves its
+ * own walkers. The positions of a call, i.e., the particles of evaluate_notranspose,
+ * the virtual particles of evaluateValues or the walkers of mw_evaluate, are
+ * fetched from a task in a single access epoch.
  */
-struct DistributedSPOSet: public SPOSetBase
+struct DistributedSPOSet: public SPOSetBase, public SplineAdoptorBase<double,3>
 {
+  typedef multi_UBspline_3d_d SplineType;
+  typedef BCtype_d            BCType;
+  typedef SplineAdoptorBase<double,3>::PointType PointType;
+
+  enum {SHM_TRANSPORT=0, RMA_TRANSPORT};
 
-  ///use orthogonal and non-truncated orbitals
-  typedef TricubicBsplineSPOSet<ValueType,true,false> BspilneSetType;
-  typedef PooledBuffer<RealType> BufferType;
-
-  BspineSetType* Phi;
-  ///wavefunction
-  //SPOSetBase* Phi;
-  ///index map
-  vector<int> OrbitalIndex;
-  ///communicator for a mpi group sharing the wavefunctions
-  Communicate* myComm;
-  ///node id for the remote nodes
-  vector<int> RemoteNodes;
-  ///current position
-  vector<PosType> Rnow;
-  ///orbital indices
-  vector<int> OrbitalCount;
-  ///orbital indices
+  ///transport of the remote blocks
+  int Transport;
+  ///communicator of the tasks sharing the orbitals
+  Communicate* GroupComm;
+  ///node-level shared memory for SHM_TRANSPORT
+  NodeSharedMemory* NodeShm;
+  ///spline table of the bands owned by this task
+  SplineType* MultiSpline;
+  ///grid of the tables
+  Ugrid Grid[3];
+  ///first band of each task of the group, OrbitalOffset[GroupComm->size()]=OrbitalSetSize
   vector<int> OrbitalOffset;
-  ///send buffer : maybe better using local variables
-  vector<BufferType*> SendBuffer;
-  ///recv buffer : maybe better using local variables
-  vector<BufferType*> RecvBuffer;
+  ///band stride of each table, the number of the bands as padded by einspline
+  vector<int> BandStride;
+  ///coefficients of each table, 0 if the blocks are fetched
+  vector<const double*> Coefs;
+  ///blocks fetched by RMA_TRANSPORT
+  vector<double> Blocks;
+  ///values, gradients and hessians in the lattice unit of the bands of a table
+  vector<double> Work;
+#if defined(HAVE_MPI)
+  ///window exposing MultiSpline->coefs for RMA_TRANSPORT
+  MPI_Win Window;
+  ///datatype of a 4x4x4 block of each table
+  vector<MPI_Datatype> BlockType;
+#endif
 
   ///constructor
-  DistributedSPOSet(int norbs=0);
-  ///destructor
+  DistributedSPOSet();
+  ///destructor, the tables and the window are shared by the clones and are not released
   ~DistributedSPOSet();
 
-  ///set the communicate
-  void setCommunicator(Communicate* c);
+  SPOSetBase* makeClone() const;
 
-  void setOrbitalSetSize(int norbs);
+  /** divide the bands among the tasks of a group
+   * @param c communicator to be grouped
+   * @param transport SHM_TRANSPORT or RMA_TRANSPORT
+   * @param groupsize number of the tasks of a group for RMA_TRANSPORT, 0 for c
+   *
+   * Collective over c. SHM_TRANSPORT groups the tasks on a node.
+   */
+  void setCommunicator(Communicate* c, int transport, int groupsize);
+
+  ///return the first band owned by this task
+  inline int firstBand() const
+  {
+    return OrbitalOffset[GroupComm->rank()];
+  }
+
+  ///return the number of the bands owned by this task
+  inline int numBands() const
+  {
+    return OrbitalOffset[GroupComm->rank()+1]-OrbitalOffset[GroupComm->rank()];
+  }
+
+  /** create the table of the bands owned by this task
+   *
+   * Collective over GroupComm. The table is filled by set_spline
+   * and published by the collective finalizeTables.
+   */
+  void create_spline(Ugrid* xyz_grid, BCType* xyz_bc);
+
+  /** set the ispline-th band of the group
+   * @param psi_r values on the grid
+   * @param ispline band index, ignored if not owned by this task
+   */
+  void set_spline(double* restrict psi_r, int ispline);
+
+  ///expose the tables to the group, collective over GroupComm
+  void finalizeTables();
+
+  ///required by BsplineReaderBase::check_twists
+  void resizeStorage(int n, int nv);
 
-  void resetParameters(VarRegistry<RealType>& optVariables);
+  void resetParameters(const opt_variables_type& active) { }
 
-  void resetTargetParticleSet(ParticleSet& P);
+  void resetTargetParticleSet(ParticleSet& e) { }
+
+  void setOrbitalSetSize(int norbs);
 
   void evaluate(const ParticleSet& P, int iat, ValueVector_t& psi);
 
   void evaluate(const ParticleSet& P, int iat,
                 ValueVector_t& psi, GradVector_t& dpsi, ValueVector_t& d2psi);
 
+  void evaluate(const ParticleSet& P, int iat,
+                ValueVector_t& psi, GradVector_t& dpsi, HessVector_t& grad_grad_psi);
+
+  void evaluateValues(const VirtualParticleSet& VP, ValueMatrix_t& psiM);
+
+  void mw_evaluate(const vector<SPOSetBase*>& spo_list, const vector<ParticleSet*>& P_list, int iat,
+                   const vector<ValueVector_t*>& psi_v_list,
+                   const vector<GradVector_t*>& dpsi_v_list,
+                   const vector<ValueVector_t*>& d2psi_v_list);
+
   void evaluate_notranspose(const ParticleSet& P, int first, int last,
                             ValueMatrix_t& logdet, GradMatrix_t& dlogdet, ValueMatrix_t& d2logdet);
 
   void evaluate_notranspose(const ParticleSet& P, int first, int last
-                            , ValueMatrix_t& logdet, GradMatrix_t& dlogdet, HessMatrix_t& grad_grad_logdet)
-  {
-    APP_ABORT("Need specialization of DistributedSPOSet::evaluate_notranspose() for grad_grad_logdet. \n");
-  }
+                            , ValueMatrix_t& logdet, GradMatrix_t& dlogdet, HessMatrix_t& grad_grad_logdet);
 
   void evaluate_notranspose(const ParticleSet& P, int first, int last
                             , ValueMatrix_t& logdet, GradMatrix_t& dlogdet, HessMatrix_t& grad_grad_logdet, GGGMatrix_t& grad_grad_grad_logdet)
@@ -89,6 +158,42 @@ struct DistributedSPOSet: public SPOSetBase
     APP_ABORT("Need specialization of DistributedSPOSet::evaluate_notranspose() for grad_grad_grad_logdet. \n");
   }
 
+private:
+  /** grid point and the B-spline weights of a position
+   *
+   * w[d][0..3] are the weights of the four grid points along the d-th direction,
+   * w[d][4..7] the first and w[d][8..11] the second derivatives.
+   */
+  struct GridPoint
+  {
+    int i[3];
+    int sign;
+    double w[3][12];
+  };
+  ///grid points of the positions of a call
+  vector<GridPoint> Points;
+
+  ///set Points for n positions
+  void locate(int n, const PosType* pos);
+
+  /** evaluate the orbitals at Points
+   * @param psi psi[k] is the row of the k-th position
+   * @param dpsi gradients, 0 for the values only
+   * @param d2psi laplacians, 0 if not needed
+   * @param hess hessians, 0 if not needed
+   */
+  void evaluate_rows(ValueType* const* psi, GradType* const* dpsi, ValueType* const* d2psi, HessType* const* hess);
+
+  /** return the first coefficient of the block of the k-th position
+   * @param p task owning the table
+   * @param k index of the position
+   * @param xs x stride of the block
+   * @param ys y stride of the block
+   */
+  const double* block(int p, int k, intptr_t& xs, intptr_t& ys) const;
+
+  ///fetch the blocks of Points from the task p with RMA_TRANSPORT
+  void fetchBlocks(int p);
 };
 }
 #endif
@@ -0,0 +1,79 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim and Ken Esler           //
+//////////////////////////////////////////////////////////////////
+/** @file DistributedSPOSetReader.h
+ */
+#ifndef QMCPLUSPLUS_DISTRIBUTED_SPOSET_READER_H
+#define QMCPLUSPLUS_DISTRIBUTED_SPOSET_READER_H
+#include "QMCWaveFunctions/DistributedSPOSet.h"
+
+namespace qmcplusplus
+{
+
+/** reader for DistributedSPOSet
+ *
+ * psi_g of every band is broadcast as SplineAdoptorReader does and
+ * only the owner of a band performs the FFT and the spline.
+ * The tables are not cached since each task holds a part of them.
+ */
+struct DistributedSPOSetReader: public BsplineReaderBase
+{
+  ///DistributedSPOSet::SHM_TRANSPORT or DistributedSPOSet::RMA_TRANSPORT
+  int Transport;
+  ///number of the tasks of a group for RMA_TRANSPORT
+  int GroupSize;
+
+  DistributedSPOSetReader(EinsplineSetBuilder* e, int transport, int groupsize)
+    : BsplineReaderBase(e), Transport(transport), GroupSize(groupsize)
+  {}
+
+  SPOSetBase* create_spline_set(int spin, EinsplineSet* orbitalSet)
+  {
+    ReportEngine PRE("DistributedSPOSetReader","create_spline_set(int, EinsplineSet*)");
+    DistributedSPOSet* bspline=new DistributedSPOSet;
+    check_twists(orbitalSet,bspline);
+    int norbs=bspline->getOrbitalSetSize();
+    if(mybuilder->NumDistinctOrbitals<norbs)
+    {
+      APP_ABORT("DistributedSPOSetReader needs real orbitals without the copies of the bands");
+    }
+    Ugrid xyz_grid[3];
+    DistributedSPOSet::BCType xyz_bc[3];
+    bool havePsig=set_grid(bspline->HalfG,xyz_grid, xyz_bc);
+    if(!havePsig)
+    {
+      APP_ABORT("DistributedSPOSetReader needs psi_g. Set precision=\"double\".");
+    }
+    bspline->setCommunicator(myComm,Transport,GroupSize);
+    bspline->create_spline(xyz_grid,xyz_bc);
+    int nx=mybuilder->MeshSize[0];
+    int ny=mybuilder->MeshSize[1];
+    int nz=mybuilder->MeshSize[2];
+    Array<double,3> splineData_r(nx,ny,nz);
+    Array<complex<double>,3> FFTbox(nx,ny,nz);
+    fftw_plan FFTplan = fftw_plan_dft_3d(nx, ny, nz,
+                                         reinterpret_cast<fftw_complex*>(FFTbox.data()),
+                                         reinterpret_cast<fftw_complex*>(FFTbox.data()),
+                                         +1, FFTW_ESTIMATE);
+    Vector<complex<double> > cG(mybuilder->MaxNumGvecs);
+    const std::vector<BandInfo>& SortBands(mybuilder->SortBands);
+    const int first=bspline->firstBand();
+    const int last=first+bspline->numBands();
+    for(int iorb=0; iorb<norbs; ++iorb)
+    {
+      int ti=SortBands[iorb].TwistIndex;
+      get_psi_g(ti,spin,SortBands[iorb].BandIndex,cG);
+      if(iorb<first || iorb>=last)
+        continue;
+      unpack4fftw(cG,mybuilder->Gvecs[0],mybuilder->MeshSize,FFTbox);
+      fftw_execute (FFTplan);
+      fix_phase_rotate_c2r(FFTbox,splineData_r, mybuilder->TwistAngles[ti]);
+      bspline->set_spline(splineData_r.data(),iorb);
+    }
+    fftw_destroy_plan(FFTplan);
+    bspline->finalizeTables();
+    return bspline;
+  }
+};
+}
+#endif
@@ -225,12 +225,36 @@ struct BsplineSet: public SPOSetBase, public SplineAdoptor
   {
     SplineAdoptor::evaluate_vgl(P.R[iat],psi,dpsi,d2psi);
   }
+
+  void evaluateValues(const VirtualParticleSet& VP, ValueMatrix_t& psiM)
+  {
+    typedef ValueMatrix_t::value_type value_type;
+    for(int k=0; k<VP.getTotalNum(); ++k)
+    {
+      VectorViewer<value_type> v(psiM[k],OrbitalSetSize);
+      SplineAdoptor::evaluate_v(VP.R[k],v);
+    }
+  }
   inline void evaluate(const ParticleSet& P, int iat,
                        ValueVector_t& psi, GradVector_t& dpsi, HessVector_t& grad_grad_psi)
   {
     SplineAdoptor::evaluate_vgh(P.R[iat],psi,dpsi,grad_grad_psi);
   }
 
+  /** evaluate the crowd with this adoptor
+   *
+   * The clones share the spline table, so that the positions of all the
+   * walkers are evaluated back to back while the table is in cache.
+   */
+  void mw_evaluate(const vector<SPOSetBase*>& spo_list, const vector<ParticleSet*>& P_list, int iat,
+                   const vector<ValueVector_t*>& psi_v_list,
+                   const vector<GradVector_t*>& dpsi_v_list,
+                   const vector<ValueVector_t*>& d2psi_v_list)
+  {
+    for(int iw=0; iw<P_list.size(); ++iw)
+      SplineAdoptor::evaluate_vgl(P_list[iw]->R[iat],*psi_v_list[iw],*dpsi_v_list[iw],*d2psi_v_list[iw]);
+  }
+
   void resetParameters(const opt_variables_type& active)
   { }
 
@@ -334,6 +334,17 @@ public:
     NumCoreOrbs    = ncores;
   }
 
+  ///evaluate directly at the virtual positions: the orbitals depend only on R[k]
+  void evaluateValues(const VirtualParticleSet& VP, ValueMatrix_t& psiM)
+  {
+    ValueVector_t psi(psiM.cols());
+    for(int k=0; k<VP.getTotalNum(); ++k)
+    {
+      evaluate(VP,k,psi);
+      std::copy(psi.begin(),psi.end(),psiM[k]);
+    }
+  }
+
   // Real return values
   void evaluate(const ParticleSet& P, int iat, RealValueVector_t& psi);
   void evaluate(const ParticleSet& P, int iat, RealValueVector_t& psi,
@@ -205,6 +205,13 @@ public:
    */
   bool ReadGvectors_ESHDF();
 
+  /** reopen H5FileID of the root read-only before all the tasks open the file
+   *
+   * ReadOrbitalInfo opens the file for writing, which locks it against the
+   * other tasks. Collective over myComm.
+   */
+  void ShareOrbitalFile();
+
   /** set tiling properties of oset
    * @param oset spline-orbital engine to be initialized
    * @param numOrbs number of orbitals that belong to oset
@@ -89,6 +89,19 @@ EinsplineSetBuilder::CheckLattice()
   return true;
 }
 
+void
+EinsplineSetBuilder::ShareOrbitalFile()
+{
+  if(myComm->size() == 1)
+    return;
+  if(myComm->rank() == 0 && H5FileID>=0)
+  {
+    H5Fclose(H5FileID);
+    H5FileID = H5Fopen(H5FileName.c_str(),H5F_ACC_RDONLY,H5P_DEFAULT);
+  }
+  myComm->barrier();
+}
+
 void
 EinsplineSetBuilder::BroadcastOrbitalInfo()
 {
@@ -17,6 +17,8 @@
 #include "Message/CommOperators.h"
 #include <fftw3.h>
 #include <QMCWaveFunctions/einspline_helper.hpp>
+#include <spline/einspline_util.hpp>
+#include "Utilities/UtilityFunctions.h"
 
 namespace qmcplusplus
 {
@@ -24,8 +26,8 @@ namespace qmcplusplus
 void EinsplineSetBuilder::ReadBands_ESHDF(int spin, EinsplineSetExtended<complex<double > >* orbitalSet)
 {
   ReportEngine PRE("EinsplineSetBuilder","ReadBands_ESHDF(EinsplineSetExtended<complex<double > >*");
-  Timer c_prep, c_unpack,c_fft, c_phase, c_spline, c_newphase, c_h5, c_init;
-  double t_prep=0.0, t_unpack=0.0, t_fft=0.0, t_phase=0.0, t_spline=0.0, t_newphase=0.0, t_h5=0.0, t_init=0.0;
+  Timer c_prep, c_unpack,c_fft, c_phase, c_spline, c_newphase, c_h5, c_init, c_comm;
+  double t_prep=0.0, t_unpack=0.0, t_fft=0.0, t_phase=0.0, t_spline=0.0, t_newphase=0.0, t_h5=0.0, t_init=0.0, t_comm=0.0;
   c_prep.restart();
   bool root = myComm->rank()==0;
   // bcast other stuff
@@ -145,31 +147,27 @@ void EinsplineSetBuilder::ReadBands_ESHDF(int spin, EinsplineSetExtended<complex
                          reinterpret_cast<fftw_complex*>(FFTbox.data()),
                          reinterpret_cast<fftw_complex*>(FFTbox.data()),
                          +1, FFTW_ESTIMATE);
-    Vector<complex<double> > cG(MaxNumGvecs);
-    //this will be parallelized with OpenMP
-    for(int iorb=0,ival=0; iorb<N; ++iorb, ++ival)
+    //each task reads, transforms and splines its own group of bands
+    vector<int> OrbGroups;
+    FairDivideLow(N,myComm->size(),OrbGroups);
+    int iorb_first=OrbGroups[myComm->rank()];
+    int iorb_last =OrbGroups[myComm->rank()+1];
+    //the entries of the other groups are filled by the reduction
+    std::fill(orbitalSet->MultiSpline->coefs
+              ,orbitalSet->MultiSpline->coefs+orbitalSet->MultiSpline->coefs_size,complex<double>());
+    ShareOrbitalFile();
+    hdf_archive h5f(myComm,false);
+    bool foundit=h5f.open(H5FileName,H5F_ACC_RDONLY);
+    Vector<complex<double> > cG(Gvecs[0].size());
+    for(int iorb=iorb_first; iorb<iorb_last && foundit; ++iorb)
     {
-      //Vector<complex<double> > cG;
-      int ncg=0;
       int ti=SortBands[iorb].TwistIndex;
       c_h5.restart();
-      if(root)
-      {
-        ostringstream path;
-        path << "/electrons/kpoint_" << SortBands[iorb].TwistIndex
-             << "/spin_" << spin << "/state_" << SortBands[iorb].BandIndex << "/psi_g";
-        HDFAttribIO<Vector<complex<double> > >  h_cG(cG);
-        h_cG.read (H5FileID, path.str().c_str());
-        ncg=cG.size();
-      }
-      myComm->bcast(ncg);
-      if(ncg != Gvecs[0].size())
-      {
-        APP_ABORT("Failed : ncg != Gvecs[0].size()");
-      }
-      if(!root)
-        cG.resize(ncg);
-      myComm->bcast(cG);
+      ostringstream path;
+      path << "/electrons/kpoint_" << SortBands[iorb].TwistIndex
+           << "/spin_" << spin << "/state_" << SortBands[iorb].BandIndex << "/psi_g";
+      foundit &= h5f.read(cG,path.str());
+      foundit &= (cG.size() == Gvecs[0].size());
       t_h5 += c_h5.elapsed();
       c_unpack.restart();
       unpack4fftw(cG,Gvecs[0],MeshSize,FFTbox);
@@ -181,9 +179,19 @@ void EinsplineSetBuilder::ReadBands_ESHDF(int spin, EinsplineSetExtended<complex
       fix_phase_rotate_c2c(FFTbox,splineData,TwistAngles[ti]);
       t_phase+= c_phase.elapsed();
       c_spline.restart();
-      set_multi_UBspline_3d_z(orbitalSet->MultiSpline, ival, splineData.data());
+      set_multi_UBspline_3d_z(orbitalSet->MultiSpline, iorb, splineData.data());
       t_spline+= c_spline.elapsed();
     }
+    h5f.close();
+    int nfailed=!foundit;
+    myComm->allreduce(nfailed);
+    if(nfailed)
+    {
+      APP_ABORT("EinsplineSetBuilder::ReadBands_ESHDF Failed to read psi_g");
+    }
+    c_comm.restart();
+    chunked_reduce(myComm,orbitalSet->MultiSpline);
+    t_comm+= c_comm.elapsed();
     fftw_destroy_plan(FFTplan);
     t_init+=c_init.elapsed();
   }
@@ -212,6 +220,7 @@ void EinsplineSetBuilder::ReadBands_ESHDF(int spin, EinsplineSetExtended<complex
   app_log() << "    READBANDS::FFT    = " << t_fft << endl;
   app_log() << "    READBANDS::PHASE  = " << t_phase << endl;
   app_log() << "    READBANDS::SPLINE = " << t_spline << endl;
+  app_log() << "    READBANDS::COMM   = " << t_comm << endl;
   app_log() << "    READBANDS::SUM    = " << t_init << endl;
   //now localized orbitals
   for(int iorb=0,ival=0; iorb<N; ++iorb, ++ival)
@@ -288,6 +297,9 @@ void EinsplineSetBuilder::ReadBands_ESHDF(int spin, EinsplineSetExtended<complex
 void EinsplineSetBuilder::ReadBands_ESHDF(int spin, EinsplineSetExtended<double>* orbitalSet)
 {
   ReportEngine PRE("EinsplineSetBuilder","ReadBands_ESHDF(EinsplineSetExtended<double>*");
+  Timer c_prep, c_unpack,c_fft, c_phase, c_spline, c_h5, c_init, c_comm;
+  double t_prep=0.0, t_unpack=0.0, t_fft=0.0, t_phase=0.0, t_spline=0.0, t_h5=0.0, t_init=0.0, t_comm=0.0;
+  c_prep.restart();
   vector<AtomicOrbital<double> > realOrbs(AtomicOrbitals.size());
   for (int iat=0; iat<realOrbs.size(); iat++)
   {
@@ -437,6 +449,7 @@ void EinsplineSetBuilder::ReadBands_ESHDF(int spin, EinsplineSetExtended<double>
   {
     APP_ABORT("Core states not supported by ES-HDF yet.");
   }
+  t_prep += c_prep.elapsed();
   //this is common
   Array<double,3> splineData(nx,ny,nz);
   if(havePsir)
@@ -482,6 +495,7 @@ void EinsplineSetBuilder::ReadBands_ESHDF(int spin, EinsplineSetExtended<double>
   }
   else
   {
+    c_init.restart();
     Array<ComplexType,3> FFTbox;
     FFTbox.resize(MeshSize[0], MeshSize[1], MeshSize[2]);
     fftw_plan FFTplan = fftw_plan_dft_3d
@@ -489,35 +503,62 @@ void EinsplineSetBuilder::ReadBands_ESHDF(int spin, EinsplineSetExtended<double>
                          reinterpret_cast<fftw_complex*>(FFTbox.data()),
                          reinterpret_cast<fftw_complex*>(FFTbox.data()),
                          +1, FFTW_ESTIMATE);
-    for(int iorb=0,ival=0; iorb<N; ++iorb, ++ival)
+    //each task reads, transforms and splines its own group of bands
+    vector<int> OrbGroups;
+    FairDivideLow(N,myComm->size(),OrbGroups);
+    int iorb_first=OrbGroups[myComm->rank()];
+    int iorb_last =OrbGroups[myComm->rank()+1];
+    //the entries of the other groups are filled by the reduction
+    std::fill(orbitalSet->MultiSpline->coefs
+              ,orbitalSet->MultiSpline->coefs+orbitalSet->MultiSpline->coefs_size,0.0);
+    ShareOrbitalFile();
+    hdf_archive h5f(myComm,false);
+    bool foundit=h5f.open(H5FileName,H5F_ACC_RDONLY);
+    Vector<complex<double> > cG(Gvecs[0].size());
+    for(int iorb=iorb_first; iorb<iorb_last && foundit; ++iorb)
     {
-      Vector<complex<double> > cG;
-      int ncg=0;
       int ti=SortBands[iorb].TwistIndex;
-      if(root)
-      {
-        ostringstream path;
-        path << "/electrons/kpoint_" << SortBands[iorb].TwistIndex
-             << "/spin_" << spin << "/state_" << SortBands[iorb].BandIndex << "/psi_g";
-        HDFAttribIO<Vector<complex<double> > >  h_cG(cG);
-        h_cG.read (H5FileID, path.str().c_str());
-        ncg=cG.size();
-      }
-      myComm->bcast(ncg);
-      if(ncg != Gvecs[0].size())
-      {
-        APP_ABORT("Failed : ncg != Gvecs[0].size()");
-      }
-      if(!root)
-        cG.resize(ncg);
-      myComm->bcast(cG);
+      c_h5.restart();
+      ostringstream path;
+      path << "/electrons/kpoint_" << SortBands[iorb].TwistIndex
+           << "/spin_" << spin << "/state_" << SortBands[iorb].BandIndex << "/psi_g";
+      foundit &= h5f.read(cG,path.str());
+      foundit &= (cG.size() == Gvecs[0].size());
+      t_h5 += c_h5.elapsed();
+      c_unpack.restart();
       unpack4fftw(cG,Gvecs[0],MeshSize,FFTbox);
+      t_unpack+= c_unpack.elapsed();
+      c_fft.restart();
       fftw_execute (FFTplan);
+      t_fft+= c_fft.elapsed();
+      c_phase.restart();
       fix_phase_rotate_c2r(FFTbox,splineData,TwistAngles[ti]);
-      set_multi_UBspline_3d_d (orbitalSet->MultiSpline, ival, splineData.data());
+      t_phase+= c_phase.elapsed();
+      c_spline.restart();
+      set_multi_UBspline_3d_d (orbitalSet->MultiSpline, iorb, splineData.data());
+      t_spline+= c_spline.elapsed();
+    }
+    h5f.close();
+    int nfailed=!foundit;
+    myComm->allreduce(nfailed);
+    if(nfailed)
+    {
+      APP_ABORT("EinsplineSetBuilder::ReadBands_ESHDF Failed to read psi_g");
     }
+    c_comm.restart();
+    chunked_reduce(myComm,orbitalSet->MultiSpline);
+    t_comm+= c_comm.elapsed();
     fftw_destroy_plan(FFTplan);
+    t_init+=c_init.elapsed();
   }
+  app_log() << "    READBANDS::PREP   = " << t_prep << endl;
+  app_log() << "    READBANDS::H5     = " << t_h5 << endl;
+  app_log() << "    READBANDS::UNPACK = " << t_unpack << endl;
+  app_log() << "    READBANDS::FFT    = " << t_fft << endl;
+  app_log() << "    READBANDS::PHASE  = " << t_phase << endl;
+  app_log() << "    READBANDS::SPLINE = " << t_spline << endl;
+  app_log() << "    READBANDS::COMM   = " << t_comm << endl;
+  app_log() << "    READBANDS::SUM    = " << t_init << endl;
   for(int iorb=0,ival=0; iorb<N; ++iorb, ++ival)
   {
     // Read atomic orbital information
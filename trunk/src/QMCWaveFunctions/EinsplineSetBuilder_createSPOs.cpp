@@ -30,6 +30,7 @@
 #include "QMCWaveFunctions/SplineAdoptorReader.h"
 #include "QMCWaveFunctions/SplineMixedAdoptor.h"
 #include "QMCWaveFunctions/SplineMixedAdoptorReader.h"
+#include "QMCWaveFunctions/DistributedSPOSetReader.h"
 
 namespace qmcplusplus
 {
@@ -46,6 +47,9 @@ EinsplineSetBuilder::createSPOSet(xmlNodePtr cur)
   string sourceName;
   string spo_prec("double");
   string truncate("no");
+  string distribute("no");
+  string transport("shm");
+  int groupsize=0;
 #if defined(QMC_CUDA)
   string useGPU="yes";
 #else
@@ -63,6 +67,9 @@ EinsplineSetBuilder::createSPOSet(xmlNodePtr cur)
   attribs.add (useGPU,     "gpu");
   attribs.add (spo_prec,   "precision");
   attribs.add (truncate,   "truncate");
+  attribs.add (distribute, "distribute");
+  attribs.add (transport,  "transport");
+  attribs.add (groupsize,  "groupsize");
   attribs.add (BufferLayer, "buffer");
   attribs.put (XMLRoot);
   attribs.add (numOrbs,    "size");
@@ -235,35 +242,41 @@ EinsplineSetBuilder::createSPOSet(xmlNodePtr cur)
       OccupyBands(spinSet, sortBands);
       //check if a matching BsplineReaderBase exists
       BsplineReaderBase* spline_reader=0;
-      //if(TargetPtcl.Lattice.SuperCellEnum != SUPERCELL_BULK && truncate=="yes")
-      if(truncate=="yes")
+      if(distribute=="yes")
       {
-        if(use_single)
+        int tr=(transport=="rma")?DistributedSPOSet::RMA_TRANSPORT:DistributedSPOSet::SHM_TRANSPORT;
+        spline_reader= new DistributedSPOSetReader(this,tr,groupsize);
+      }
+      else
+        //if(TargetPtcl.Lattice.SuperCellEnum != SUPERCELL_BULK && truncate=="yes")
+        if(truncate=="yes")
         {
-          if(TargetPtcl.Lattice.SuperCellEnum == SUPERCELL_OPEN)
-            spline_reader= new SplineMixedAdoptorReader<SplineOpenAdoptor<float,double,3> >(this);
+          if(use_single)
+          {
+            if(TargetPtcl.Lattice.SuperCellEnum == SUPERCELL_OPEN)
+              spline_reader= new SplineMixedAdoptorReader<SplineOpenAdoptor<float,double,3> >(this);
+            else
+              if(TargetPtcl.Lattice.SuperCellEnum == SUPERCELL_SLAB)
+                spline_reader= new SplineMixedAdoptorReader<SplineMixedAdoptor<float,double,3> >(this);
+              else
+                spline_reader= new SplineAdoptorReader<SplineR2RAdoptor<float,double,3> >(this);
+          }
           else
-            if(TargetPtcl.Lattice.SuperCellEnum == SUPERCELL_SLAB)
-              spline_reader= new SplineMixedAdoptorReader<SplineMixedAdoptor<float,double,3> >(this);
+          {
+            if(TargetPtcl.Lattice.SuperCellEnum == SUPERCELL_OPEN)
+              spline_reader= new SplineMixedAdoptorReader<SplineOpenAdoptor<double,double,3> >(this);
             else
-              spline_reader= new SplineAdoptorReader<SplineR2RAdoptor<float,double,3> >(this);
+              if(TargetPtcl.Lattice.SuperCellEnum == SUPERCELL_SLAB)
+                spline_reader= new SplineMixedAdoptorReader<SplineMixedAdoptor<double,double,3> >(this);
+              else
+                spline_reader= new SplineAdoptorReader<SplineR2RAdoptor<double,double,3> >(this);
+          }
         }
         else
         {
-          if(TargetPtcl.Lattice.SuperCellEnum == SUPERCELL_OPEN)
-            spline_reader= new SplineMixedAdoptorReader<SplineOpenAdoptor<double,double,3> >(this);
-          else
-            if(TargetPtcl.Lattice.SuperCellEnum == SUPERCELL_SLAB)
-              spline_reader= new SplineMixedAdoptorReader<SplineMixedAdoptor<double,double,3> >(this);
-            else
-              spline_reader= new SplineAdoptorReader<SplineR2RAdoptor<double,double,3> >(this);
+          if(use_single)
+            spline_reader= new SplineAdoptorReader<SplineR2RAdoptor<float,double,3> >(this);
         }
-      }
-      else
-      {
-        if(use_single)
-          spline_reader= new SplineAdoptorReader<SplineR2RAdoptor<float,double,3> >(this);
-      }
       if(spline_reader)
       {
         HasCoreOrbs=bcastSortBands(NumDistinctOrbitals,myComm->rank()==0);
@@ -292,6 +305,10 @@ EinsplineSetBuilder::createSPOSet(xmlNodePtr cur)
       {
         app_log() << "  Truncated orbitals with multiple kpoints are not supported yet!" << endl;
       }
+      if(distribute == "yes")
+      {
+        app_log() << "  Distributed orbitals with multiple kpoints are not supported yet!" << endl;
+      }
       if(use_single)
       {
 #if defined(QMC_COMPLEX)
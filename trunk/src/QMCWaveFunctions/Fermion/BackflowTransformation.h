@@ -167,6 +167,8 @@ public:
     targetPtcl(els),QP(els),cutOff(0.0)
   {
     myTable = DistanceTable::add(els);
+    //the moves read Temp of the moved particle and of all the others
+    myTable->checkNeighborCutoff(-1.0,"BackflowTransformation");
     NumTargets=els.getTotalNum();
     Bmat.resize(NumTargets);
     Bmat_full.resize(NumTargets,NumTargets);
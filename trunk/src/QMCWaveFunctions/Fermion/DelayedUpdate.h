@@ -0,0 +1,194 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file DelayedUpdate.h
+ * @brief Delayed rank-k update of the inverse of a Slater matrix
+ */
+#ifndef QMCPLUSPLUS_DELAYED_UPDATE_H
+#define QMCPLUSPLUS_DELAYED_UPDATE_H
+
+#include <OhmmsPETE/OhmmsVector.h>
+#include <OhmmsPETE/OhmmsMatrix.h>
+#include <Numerics/OhmmsBlas.h>
+#include <simd/simd.hpp>
+
+namespace qmcplusplus
+{
+
+/** engine to accumulate accepted rows and update the inverse with BLAS-3
+ *
+ * Minv follows the convention of DiracDeterminantBase::psiM: the ratio for
+ * replacing the orbitals of the i-th particle by v is Minv[i]*v.
+ * After k accepted moves of the particles p_0..p_{k-1} with new orbital rows
+ * u_0..u_{k-1}, the current inverse is given by the Woodbury formula
+ * \f[
+ *   Minv' = Minv - (Minv U^T - E) K^{-1} R, \quad K=R U^T
+ * \f]
+ * where the rows of R are the rows of the stale Minv for p_j and E(i,j)=\delta_{i,p_j}.
+ * Minv is not touched until updateInvMat is called or the delay is full.
+ */
+template<typename T>
+struct DelayedUpdate
+{
+  ///maximum number of delayed rows
+  int MaxDelay;
+  ///number of pending rows
+  int Delay;
+  ///number of orbitals
+  int Norb;
+  ///particle index (row) of the pending updates
+  vector<int> DelayList;
+  ///new orbital rows u_j, MaxDelay x Norb
+  Matrix<T> U;
+  ///stale inverse rows Minv[p_j], MaxDelay x Norb
+  Matrix<T> R;
+  ///inverse of K=R U^T, MaxDelay x MaxDelay
+  Matrix<T> Kinv;
+  ///work space for the BLAS-3 update, Norb x MaxDelay
+  Matrix<T> tempA, tempB;
+  ///work space of MaxDelay
+  Vector<T> a, b, ka, kb;
+
+  DelayedUpdate(): MaxDelay(0), Delay(0), Norb(0) {}
+
+  /** resize the work space
+   * @param norb number of orbitals
+   * @param delay maximum number of delayed rows
+   */
+  inline void resize(int norb, int delay)
+  {
+    Norb=norb;
+    MaxDelay=delay;
+    Delay=0;
+    DelayList.resize(delay);
+    U.resize(delay,norb);
+    R.resize(delay,norb);
+    Kinv.resize(delay,delay);
+    tempA.resize(norb,delay);
+    tempB.resize(norb,delay);
+    a.resize(delay);
+    b.resize(delay);
+    ka.resize(delay);
+    kb.resize(delay);
+  }
+
+  ///discard the pending updates, e.g. when Minv is recomputed
+  inline void reset()
+  {
+    Delay=0;
+  }
+
+  ///return true if the row is already pending
+  inline bool isPending(int rowchanged) const
+  {
+    for(int j=0; j<Delay; ++j)
+      if(DelayList[j]==rowchanged)
+        return true;
+    return false;
+  }
+
+  /** compute the current inverse row including the pending updates
+   * @param Minv stale inverse
+   * @param rowchanged row index
+   * @param invRow Norb output
+   */
+  inline void getInvRow(const Matrix<T>& Minv, int rowchanged, T* restrict invRow)
+  {
+    simd::copy(invRow,Minv[rowchanged],Norb);
+    if(Delay==0)
+      return;
+    //b_j = u_j*Minv[rowchanged] - \delta_{rowchanged,p_j}
+    BLAS::gemv('T',Norb,Delay,T(1),U.data(),Norb,invRow,1,T(0),b.data(),1);
+    for(int j=0; j<Delay; ++j)
+      if(DelayList[j]==rowchanged)
+        b[j]-=T(1);
+    //kb = b K^{-1}
+    BLAS::gemv('N',Delay,Delay,T(1),Kinv.data(),MaxDelay,b.data(),1,T(0),kb.data(),1);
+    //invRow -= kb R
+    BLAS::gemv('N',Norb,Delay,T(-1),R.data(),Norb,kb.data(),1,T(1),invRow,1);
+  }
+
+  /** add an accepted row
+   * @param Minv stale inverse
+   * @param rowchanged row index
+   * @param psiV new orbital row
+   *
+   * K^{-1} is extended by the Schur complement of the new row and column.
+   * The update is applied to Minv when MaxDelay rows are accumulated.
+   * A particle moved twice within a delay window triggers the update first.
+   */
+  inline void acceptRow(Matrix<T>& Minv, int rowchanged, const T* restrict psiV)
+  {
+    if(isPending(rowchanged))
+      updateInvMat(Minv);
+    const T* restrict minv_row=Minv[rowchanged];
+    const int k=Delay;
+    T s=simd::dot(minv_row,psiV,Norb);
+    if(k)
+    {
+      //a_j = R[j]*psiV, b_j = Minv[rowchanged]*u_j
+      BLAS::gemv('T',Norb,k,T(1),R.data(),Norb,psiV,1,T(0),a.data(),1);
+      BLAS::gemv('T',Norb,k,T(1),U.data(),Norb,minv_row,1,T(0),b.data(),1);
+      //ka = K^{-1} a, kb = b K^{-1}
+      BLAS::gemv('T',k,k,T(1),Kinv.data(),MaxDelay,a.data(),1,T(0),ka.data(),1);
+      BLAS::gemv('N',k,k,T(1),Kinv.data(),MaxDelay,b.data(),1,T(0),kb.data(),1);
+      s-=simd::dot(b.data(),ka.data(),k);
+    }
+    const T sinv=T(1)/s;
+    for(int i=0; i<k; ++i)
+    {
+      T* restrict kinv_row=Kinv[i];
+      const T t=ka[i]*sinv;
+      for(int j=0; j<k; ++j)
+        kinv_row[j]+=t*kb[j];
+      kinv_row[k]=-t;
+    }
+    T* restrict kinv_row=Kinv[k];
+    for(int j=0; j<k; ++j)
+      kinv_row[j]=-kb[j]*sinv;
+    kinv_row[k]=sinv;
+    simd::copy(R[k],minv_row,Norb);
+    simd::copy(U[k],psiV,Norb);
+    DelayList[k]=rowchanged;
+    if(++Delay==MaxDelay)
+      updateInvMat(Minv);
+  }
+
+  /** apply the pending updates to Minv with three gemm calls
+   * @param Minv in/out inverse
+   */
+  inline void updateInvMat(Matrix<T>& Minv)
+  {
+    if(Delay==0)
+      return;
+    //tempA = Minv U^T - E
+    BLAS::gemm('T','N',Delay,Norb,Norb,T(1),U.data(),Norb,Minv.data(),Norb,T(0),tempA.data(),MaxDelay);
+    for(int j=0; j<Delay; ++j)
+      tempA(DelayList[j],j)-=T(1);
+    //tempB = tempA K^{-1}
+    BLAS::gemm('N','N',Delay,Norb,Delay,T(1),Kinv.data(),MaxDelay,tempA.data(),MaxDelay,T(0),tempB.data(),MaxDelay);
+    //Minv -= tempB R
+    BLAS::gemm('N','N',Norb,Norb,Delay,T(-1),R.data(),Norb,tempB.data(),MaxDelay,T(1),Minv.data(),Norb);
+    Delay=0;
+  }
+};
+
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
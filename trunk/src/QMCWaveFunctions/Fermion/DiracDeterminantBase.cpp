@@ -20,6 +20,7 @@
 #include "Numerics/OhmmsBlas.h"
 #include "Numerics/MatrixOperators.h"
 #include "simd/simd.hpp"
+#include <typeinfo>
 
 namespace qmcplusplus
 {
@@ -41,6 +42,9 @@ DiracDeterminantBase::DiracDeterminantBase(SPOSetBasePtr const &spos, int first)
   if(Phi->Optimizable)
     Optimizable=true;
   OrbitalName="DiracDeterminantBase";
+  DelayRank=0;
+  InvRowIndex=-1;
+  TempInSync=false;
   registerTimers();
 }
 
@@ -92,6 +96,24 @@ void DiracDeterminantBase::resize(int nel, int morb)
   grad_phi_Minv.resize(nel,norb);
   lapl_phi_Minv.resize(nel,norb);
   grad_phi_alpha_Minv.resize(nel,norb);
+  if(DelayRank)
+  {
+    invRow.resize(norb);
+    DelayEngine.resize(norb,std::min(DelayRank,norb));
+  }
+  InvRowIndex=-1;
+  TempInSync=false;
+}
+
+void DiracDeterminantBase::setDelayRank(int delay)
+{
+  DelayRank=(delay>1)?delay:0;
+  if(DelayRank && NumOrbitals)
+  {
+    invRow.resize(NumOrbitals);
+    DelayEngine.resize(NumOrbitals,std::min(DelayRank,NumOrbitals));
+  }
+  InvRowIndex=-1;
 }
 
 DiracDeterminantBase::RealType
@@ -135,65 +157,72 @@ DiracDeterminantBase::registerData(ParticleSet& P, PooledData<RealType>& buf)
 DiracDeterminantBase::RealType DiracDeterminantBase::updateBuffer(ParticleSet& P,
     PooledData<RealType>& buf, bool fromscratch)
 {
-  //myG=0.0;
-  //myL=0.0;
+  updateAfterSweep(P,fromscratch);
+  BufferTimer.start();
+  //copy psiM to psiM_temp
+  //psiM_temp=psiM;
+  simd::copy(psiM_temp.data(),psiM.data(),psiM.size());
+  TempInSync=false;
+  buf.put(psiM.first_address(),psiM.last_address());
+  buf.put(FirstAddressOfdV,LastAddressOfdV);
+  buf.put(d2psiM.first_address(),d2psiM.last_address());
+  buf.put(myL.first_address(), myL.last_address());
+  buf.put(FirstAddressOfG,LastAddressOfG);
+  buf.put(LogValue);
+  buf.put(PhaseValue);
+  BufferTimer.stop();
+  return LogValue;
+}
+
+void DiracDeterminantBase::updateAfterSweep(ParticleSet& P, bool fromscratch)
+{
   if(fromscratch)
   {
-    LogValue=evaluateLog(P,myG,myL);
-    UpdateTimer.start();
+    //myG and myL are evaluated below with the new inverse
+    myG_temp=0.0;
+    myL_temp=0.0;
+    LogValue=evaluateLog(P,myG_temp,myL_temp);
   }
   else
   {
+    completeUpdates();
     if(UpdateMode == ORB_PBYP_RATIO)
     {
       SPOVGLTimer.start();
       Phi->evaluate(P, FirstIndex, LastIndex, psiM_temp,dpsiM, d2psiM);
       SPOVGLTimer.stop();
     }
-    UpdateTimer.start();
-    if(NumPtcls==1)
-    {
-      // ValueType y=1.0/psiM_temp(0,0);
-      // psiM(0,0)=y;
-      // GradType rv = y*dpsiM(0,0);
-      // myG(FirstIndex) += rv;
-      // myL(FirstIndex) += y*d2psiM(0,0) - dot(rv,rv);
-      ValueType y = psiM(0,0);
-      GradType rv = y*dpsiM(0,0);
-      P.G[FirstIndex]+=(myG[FirstIndex]=rv);
-      P.L[FirstIndex]+=(myL[FirstIndex]=y*d2psiM(0,0)-dot(rv,rv));
-      //myG(FirstIndex) += rv;
-      //myL(FirstIndex) += y*d2psiM(0,0) - dot(rv,rv);
-      //P.G += myG;
-      //P.L += myL;
-    }
-    else
+  }
+  UpdateTimer.start();
+  if(NumPtcls==1)
+  {
+    // ValueType y=1.0/psiM_temp(0,0);
+    // psiM(0,0)=y;
+    // GradType rv = y*dpsiM(0,0);
+    // myG(FirstIndex) += rv;
+    // myL(FirstIndex) += y*d2psiM(0,0) - dot(rv,rv);
+    ValueType y = psiM(0,0);
+    GradType rv = y*dpsiM(0,0);
+    P.G[FirstIndex]+=(myG[FirstIndex]=rv);
+    P.L[FirstIndex]+=(myL[FirstIndex]=y*d2psiM(0,0)-dot(rv,rv));
+    //myG(FirstIndex) += rv;
+    //myL(FirstIndex) += y*d2psiM(0,0) - dot(rv,rv);
+    //P.G += myG;
+    //P.L += myL;
+  }
+  else
+  {
+    for(int i=0,iat=FirstIndex; i<NumPtcls; ++i,++iat)
     {
-      for(int i=0,iat=FirstIndex; i<NumPtcls; ++i,++iat)
-      {
-        myG[iat]=simd::dot(psiM[i],dpsiM[i],NumOrbitals);
-        myL[iat]=simd::dot(psiM[i],d2psiM[i],NumOrbitals)-dot(myG[iat],myG[iat]);
-      }
-      for(int iat=FirstIndex; iat<LastIndex; ++iat)
-        P.G[iat] += myG[iat];
-      for(int iat=FirstIndex; iat<LastIndex; ++iat)
-        P.L[iat] += myL[iat];
+      myG[iat]=simd::dot(psiM[i],dpsiM[i],NumOrbitals);
+      myL[iat]=simd::dot(psiM[i],d2psiM[i],NumOrbitals)-dot(myG[iat],myG[iat]);
     }
+    for(int iat=FirstIndex; iat<LastIndex; ++iat)
+      P.G[iat] += myG[iat];
+    for(int iat=FirstIndex; iat<LastIndex; ++iat)
+      P.L[iat] += myL[iat];
   }
   UpdateTimer.stop();
-  BufferTimer.start();
-  //copy psiM to psiM_temp
-  //psiM_temp=psiM;
-  simd::copy(psiM_temp.data(),psiM.data(),psiM.size());
-  buf.put(psiM.first_address(),psiM.last_address());
-  buf.put(FirstAddressOfdV,LastAddressOfdV);
-  buf.put(d2psiM.first_address(),d2psiM.last_address());
-  buf.put(myL.first_address(), myL.last_address());
-  buf.put(FirstAddressOfG,LastAddressOfG);
-  buf.put(LogValue);
-  buf.put(PhaseValue);
-  BufferTimer.stop();
-  return LogValue;
 }
 
 void DiracDeterminantBase::copyFromBuffer(ParticleSet& P, PooledData<RealType>& buf)
@@ -206,6 +235,8 @@ void DiracDeterminantBase::copyFromBuffer(ParticleSet& P, PooledData<RealType>&
   buf.get(FirstAddressOfG,LastAddressOfG);
   buf.get(LogValue);
   buf.get(PhaseValue);
+  DelayEngine.reset();
+  InvRowIndex=-1;
   //re-evaluate it for testing
   //Phi.evaluate(P, FirstIndex, LastIndex, psiM, dpsiM, d2psiM);
   //CurrentDet = Invert(psiM.data(),NumPtcls,NumOrbitals);
@@ -216,9 +247,94 @@ void DiracDeterminantBase::copyFromBuffer(ParticleSet& P, PooledData<RealType>&
   simd::copy(psiM_temp.data(),  psiM.data(),  psiM.size());
   simd::copy(dpsiM_temp.data(), dpsiM.data(), dpsiM.size());
   simd::copy(d2psiM_temp.data(),d2psiM.data(),d2psiM.size());
+  TempInSync=true;
+  BufferTimer.stop();
+}
+
+WalkerResource* DiracDeterminantBase::makeResource(ParticleSet& P)
+{
+  if(typeid(*this)!=typeid(DiracDeterminantBase))
+    return OrbitalBase::makeResource(P);
+  PooledData<RealType> buf;
+  registerData(P,buf);
+  WalkerState* res=new WalkerState;
+  res->psiM=psiM;
+  res->dpsiM=dpsiM;
+  res->d2psiM=d2psiM;
+  //ParticleAttrib does not resize on assignment
+  res->myG.resize(myG.size());
+  res->myL.resize(myL.size());
+  res->myG=myG;
+  res->myL=myL;
+  res->LogValue=LogValue;
+  res->PhaseValue=PhaseValue;
+  return res;
+}
+
+void DiracDeterminantBase::bindResource(ParticleSet& P, WalkerResource& r)
+{
+  if(typeid(*this)!=typeid(DiracDeterminantBase))
+  {
+    OrbitalBase::bindResource(P,r);
+    return;
+  }
+  BufferTimer.start();
+  WalkerState& res(static_cast<WalkerState&>(r));
+  psiM.swap(res.psiM);
+  dpsiM.swap(res.dpsiM);
+  d2psiM.swap(res.d2psiM);
+  myG.swap(res.myG);
+  myL.swap(res.myL);
+  LogValue=res.LogValue;
+  PhaseValue=res.PhaseValue;
+  DelayEngine.reset();
+  InvRowIndex=-1;
+  //the temporaries for ORB_PBYP_ALL are copied by the first ratio(P,iat,dG,dL) using them
+  TempInSync=false;
   BufferTimer.stop();
 }
 
+DiracDeterminantBase::RealType
+DiracDeterminantBase::storeResource(ParticleSet& P, WalkerResource& r)
+{
+  if(typeid(*this)!=typeid(DiracDeterminantBase))
+    return OrbitalBase::storeResource(P,r);
+  completeUpdates();
+  WalkerState& res(static_cast<WalkerState&>(r));
+  res.LogValue=LogValue;
+  res.PhaseValue=PhaseValue;
+  return LogValue;
+}
+
+DiracDeterminantBase::RealType
+DiracDeterminantBase::updateResource(ParticleSet& P, WalkerResource& r, bool fromscratch)
+{
+  if(typeid(*this)!=typeid(DiracDeterminantBase))
+    return OrbitalBase::updateResource(P,r,fromscratch);
+  //the inverse of the walker is bound to psiM
+  updateAfterSweep(P,fromscratch);
+  TempInSync=false;
+  WalkerState& res(static_cast<WalkerState&>(r));
+  res.LogValue=LogValue;
+  res.PhaseValue=PhaseValue;
+  return LogValue;
+}
+
+void DiracDeterminantBase::releaseResource(ParticleSet& P, WalkerResource& r)
+{
+  if(typeid(*this)!=typeid(DiracDeterminantBase))
+    return;
+  DelayEngine.reset();
+  InvRowIndex=-1;
+  TempInSync=false;
+  WalkerState& res(static_cast<WalkerState&>(r));
+  psiM.swap(res.psiM);
+  dpsiM.swap(res.dpsiM);
+  d2psiM.swap(res.d2psiM);
+  myG.swap(res.myG);
+  myL.swap(res.myL);
+}
+
 /** dump the inverse to the buffer
 */
 void DiracDeterminantBase::dumpToBuffer(ParticleSet& P, PooledData<RealType>& buf)
@@ -247,7 +363,7 @@ DiracDeterminantBase::ValueType DiracDeterminantBase::ratio(ParticleSet& P, int
   Phi->evaluate(P, iat, psiV);
   SPOVTimer.stop();
   RatioTimer.start();
-  curRatio = DetRatioByRow(psiM, psiV,WorkingIndex);
+  curRatio=simd::dot(getInvRow(WorkingIndex),psiV.data(),NumOrbitals);
   RatioTimer.stop();
   return curRatio;
 }
@@ -257,16 +373,93 @@ void DiracDeterminantBase::get_ratios(ParticleSet& P, vector<ValueType>& ratios)
   SPOVTimer.start();
   Phi->evaluate(P, 0, psiV);
   SPOVTimer.stop();
+  completeUpdates();
   MatrixOperators::product(psiM,psiV.data(),&ratios[FirstIndex]);
 }
 
+void DiracDeterminantBase::evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios)
+{
+  const int nv=VP.getTotalNum();
+  if (psiVirtual.rows() != nv)
+    psiVirtual.resize(nv,NumOrbitals);
+  SPOVTimer.start();
+  Phi->evaluateValues(VP,psiVirtual);
+  SPOVTimer.stop();
+  RatioTimer.start();
+  MatrixOperators::product(psiVirtual,getInvRow(VP.refPtcl-FirstIndex),&ratios[0]);
+  RatioTimer.stop();
+}
+
+void DiracDeterminantBase::mw_ratio(const vector<OrbitalBase*>& wfc_list,
+                                    const vector<ParticleSet*>& P_list, int iat, vector<ValueType>& ratios)
+{
+  if(typeid(*this)!=typeid(DiracDeterminantBase))
+  {
+    OrbitalBase::mw_ratio(wfc_list,P_list,iat,ratios);
+    return;
+  }
+  const int nw=wfc_list.size();
+  SPOVTimer.start();
+  for(int iw=0; iw<nw; ++iw)
+  {
+    DiracDeterminantBase& det(static_cast<DiracDeterminantBase&>(*wfc_list[iw]));
+    det.Phi->evaluate(*P_list[iw],iat,det.psiV);
+  }
+  SPOVTimer.stop();
+  RatioTimer.start();
+  for(int iw=0; iw<nw; ++iw)
+  {
+    DiracDeterminantBase& det(static_cast<DiracDeterminantBase&>(*wfc_list[iw]));
+    det.UpdateMode=ORB_PBYP_RATIO;
+    det.WorkingIndex=iat-FirstIndex;
+    ratios[iw]=det.curRatio=simd::dot(det.getInvRow(det.WorkingIndex),det.psiV.data(),NumOrbitals);
+  }
+  RatioTimer.stop();
+}
+
+void DiracDeterminantBase::mw_ratioGrad(const vector<OrbitalBase*>& wfc_list,
+                                        const vector<ParticleSet*>& P_list, int iat,
+                                        vector<ValueType>& ratios, vector<GradType>& grad_new)
+{
+  if(typeid(*this)!=typeid(DiracDeterminantBase))
+  {
+    OrbitalBase::mw_ratioGrad(wfc_list,P_list,iat,ratios,grad_new);
+    return;
+  }
+  const int nw=wfc_list.size();
+  vector<SPOSetBase*> phi_list(nw);
+  vector<ValueVector_t*> psi_v_list(nw), d2psi_v_list(nw);
+  vector<GradVector_t*> dpsi_v_list(nw);
+  for(int iw=0; iw<nw; ++iw)
+  {
+    DiracDeterminantBase& det(static_cast<DiracDeterminantBase&>(*wfc_list[iw]));
+    phi_list[iw]=&(*det.Phi);
+    psi_v_list[iw]=&det.psiV;
+    dpsi_v_list[iw]=&det.dpsiV;
+    d2psi_v_list[iw]=&det.d2psiV;
+  }
+  SPOVGLTimer.start();
+  Phi->mw_evaluate(phi_list,P_list,iat,psi_v_list,dpsi_v_list,d2psi_v_list);
+  SPOVGLTimer.stop();
+  RatioTimer.start();
+  for(int iw=0; iw<nw; ++iw)
+  {
+    DiracDeterminantBase& det(static_cast<DiracDeterminantBase&>(*wfc_list[iw]));
+    det.UpdateMode=ORB_PBYP_PARTIAL;
+    det.WorkingIndex=iat-FirstIndex;
+    const ValueType* restrict inv_row=det.getInvRow(det.WorkingIndex);
+    ratios[iw]=det.curRatio=simd::dot(inv_row,det.psiV.data(),NumOrbitals);
+    grad_new[iw] += (1.0/det.curRatio) * simd::dot(inv_row,det.dpsiV.data(),NumOrbitals);
+  }
+  RatioTimer.stop();
+}
 
 DiracDeterminantBase::GradType
 DiracDeterminantBase::evalGrad(ParticleSet& P, int iat)
 {
   WorkingIndex = iat-FirstIndex;
   RatioTimer.start();
-  DiracDeterminantBase::GradType g = simd::dot(psiM[WorkingIndex],dpsiM[WorkingIndex],NumOrbitals);
+  DiracDeterminantBase::GradType g = simd::dot(getInvRow(WorkingIndex),dpsiM[WorkingIndex],NumOrbitals);
   RatioTimer.stop();
   return g;
 }
@@ -275,6 +468,7 @@ DiracDeterminantBase::GradType
 DiracDeterminantBase::evalGradSource(ParticleSet& P, ParticleSet& source,
                                      int iat)
 {
+  completeUpdates();
   Phi->evaluateGradSource (P, FirstIndex, LastIndex, source, iat, grad_source_psiM);
 //     Phi->evaluate(P, FirstIndex, LastIndex, psiM, dpsiM, d2psiM);
 //     LogValue=InvertWithLog(psiM.data(),NumPtcls,NumOrbitals,WorkSpace.data(),Pivot.data(),PhaseValue);
@@ -296,6 +490,7 @@ DiracDeterminantBase::evalGradSourcep
  TinyVector<ParticleSet::ParticleGradient_t, OHMMS_DIM> &grad_grad,
  TinyVector<ParticleSet::ParticleLaplacian_t,OHMMS_DIM> &lapl_grad)
 {
+  completeUpdates();
   Phi->evaluateGradSource (P, FirstIndex, LastIndex, source, iat,
                            grad_source_psiM, grad_grad_source_psiM,
                            grad_lapl_source_psiM);
@@ -304,6 +499,7 @@ DiracDeterminantBase::evalGradSourcep
   LogValue=InvertWithLog(psiM.data(),NumPtcls,NumOrbitals,
                          WorkSpace.data(),Pivot.data(),PhaseValue);
   InverseTimer.stop();
+  TempInSync=false;
   GradMatrix_t &Phi_alpha(grad_source_psiM);
   GradMatrix_t &Grad_phi(dpsiM);
   ValueMatrix_t &Grad2_phi(d2psiM);
@@ -395,6 +591,7 @@ DiracDeterminantBase::evalGradSource
  TinyVector<ParticleSet::ParticleGradient_t, OHMMS_DIM> &grad_grad,
  TinyVector<ParticleSet::ParticleLaplacian_t,OHMMS_DIM> &lapl_grad)
 {
+  completeUpdates();
   Phi->evaluateGradSource (P, FirstIndex, LastIndex, source, iat,
                            grad_source_psiM, grad_grad_source_psiM,
                            grad_lapl_source_psiM);
@@ -495,8 +692,9 @@ DiracDeterminantBase::ratioGrad(ParticleSet& P, int iat, GradType& grad_iat)
   RatioTimer.start();
   WorkingIndex = iat-FirstIndex;
   UpdateMode=ORB_PBYP_PARTIAL;
-  curRatio=simd::dot(psiM[WorkingIndex],psiV.data(),NumOrbitals);
-  GradType rv=simd::dot(psiM[WorkingIndex],dpsiV.data(),NumOrbitals);
+  const ValueType* restrict inv_row=getInvRow(WorkingIndex);
+  curRatio=simd::dot(inv_row,psiV.data(),NumOrbitals);
+  GradType rv=simd::dot(inv_row,dpsiV.data(),NumOrbitals);
   grad_iat += (1.0/curRatio) * rv;
   RatioTimer.stop();
   return curRatio;
@@ -541,6 +739,16 @@ DiracDeterminantBase::ValueType DiracDeterminantBase::ratio(ParticleSet& P, int
     ParticleSet::ParticleLaplacian_t& dL)
 {
   UpdateMode=ORB_PBYP_ALL;
+  if(DelayEngine.Delay)
+    completeUpdates();
+  if(!TempInSync)
+  {
+    //*_temp have to be in sync with psiM, dpsiM and d2psiM
+    simd::copy(psiM_temp.data(),  psiM.data(),  psiM.size());
+    simd::copy(dpsiM_temp.data(), dpsiM.data(), dpsiM.size());
+    simd::copy(d2psiM_temp.data(),d2psiM.data(),d2psiM.size());
+    TempInSync=true;
+  }
   SPOVGLTimer.start();
   Phi->evaluate(P, iat, psiV, dpsiV, d2psiV);
   SPOVGLTimer.stop();
@@ -600,14 +808,22 @@ void DiracDeterminantBase::acceptMove(ParticleSet& P, int iat)
   switch(UpdateMode)
   {
   case ORB_PBYP_RATIO:
-    InverseUpdateByRow(psiM,psiV,workV1,workV2,WorkingIndex,curRatio);
+    if(DelayRank)
+      DelayEngine.acceptRow(psiM,WorkingIndex,psiV.data());
+    else
+      InverseUpdateByRow(psiM,psiV,workV1,workV2,WorkingIndex,curRatio);
+    TempInSync=false;
     break;
   case ORB_PBYP_PARTIAL:
-    InverseUpdateByRow(psiM,psiV,workV1,workV2,WorkingIndex,curRatio);
+    if(DelayRank)
+      DelayEngine.acceptRow(psiM,WorkingIndex,psiV.data());
+    else
+      InverseUpdateByRow(psiM,psiV,workV1,workV2,WorkingIndex,curRatio);
     //std::copy(dpsiV.begin(),dpsiV.end(),dpsiM[WorkingIndex]);
     //std::copy(d2psiV.begin(),d2psiV.end(),d2psiM[WorkingIndex]);
     simd::copy(dpsiM[WorkingIndex],  dpsiV.data(),  NumOrbitals);
     simd::copy(d2psiM[WorkingIndex], d2psiV.data(), NumOrbitals);
+    TempInSync=false;
     //////////////////////////////////////
     ////THIS WILL BE REMOVED. ONLY FOR DEBUG DUE TO WAVEFUNCTIONTEST
     //myG = myG_temp;
@@ -626,6 +842,7 @@ void DiracDeterminantBase::acceptMove(ParticleSet& P, int iat)
     break;
   }
   UpdateTimer.stop();
+  InvRowIndex=-1;
   curRatio=1.0;
 }
 
@@ -650,6 +867,7 @@ void DiracDeterminantBase::update(ParticleSet& P,
                                   ParticleSet::ParticleLaplacian_t& dL,
                                   int iat)
 {
+  completeUpdates();
   UpdateTimer.start();
   InverseUpdateByRow(psiM,psiV,workV1,workV2,WorkingIndex,curRatio);
   //for(int j=0; j<NumOrbitals; j++) {
@@ -680,6 +898,7 @@ void DiracDeterminantBase::update(ParticleSet& P,
 DiracDeterminantBase::RealType
 DiracDeterminantBase::evaluateLog(ParticleSet& P, PooledData<RealType>& buf)
 {
+  completeUpdates();
   buf.put(psiM.first_address(),psiM.last_address());
   buf.put(FirstAddressOfdV,LastAddressOfdV);
   buf.put(d2psiM.first_address(),d2psiM.last_address());
@@ -713,6 +932,7 @@ void DiracDeterminantBase::registerDataForDerivatives(ParticleSet& P, PooledData
 
 void DiracDeterminantBase::copyToDerivativeBuffer(ParticleSet& P, PooledData<RealType>& buf)
 {
+  completeUpdates();
   if(DerivStorageType==0)
   {
     buf.put(psiM.first_address(),psiM.last_address());
@@ -745,6 +965,8 @@ void DiracDeterminantBase::copyFromDerivativeBuffer(ParticleSet& P, PooledData<R
   {
     buf.get(psiM.first_address(),psiM.last_address());
   }
+  DelayEngine.reset();
+  InvRowIndex=-1;
   P.G += myG;
   P.L += myL;
 }
@@ -799,6 +1021,8 @@ DiracDeterminantBase::evaluateLog(ParticleSet& P,
                                   ParticleSet::ParticleLaplacian_t& L)
 {
   //      cerr<<"I'm calling evaluate log"<<endl;
+  DelayEngine.reset();
+  InvRowIndex=-1;
   SPOVGLTimer.start();
   Phi->evaluate(P, FirstIndex, LastIndex, psiM,dpsiM, d2psiM);
   SPOVGLTimer.stop();
@@ -829,6 +1053,7 @@ DiracDeterminantBase::evaluateLog(ParticleSet& P,
     RatioTimer.stop();
   }
   psiM_temp = psiM;
+  TempInSync=false;
   return LogValue;
 }
 
@@ -851,6 +1076,7 @@ DiracDeterminantBase* DiracDeterminantBase::makeCopy(SPOSetBasePtr spo) const
 {
   DiracDeterminantBase* dclone= new DiracDeterminantBase(spo);
   dclone->set(FirstIndex,LastIndex-FirstIndex);
+  dclone->setDelayRank(DelayRank);
   return dclone;
 }
 
@@ -862,6 +1088,7 @@ DiracDeterminantBase::DiracDeterminantBase(const DiracDeterminantBase& s)
   ,BufferTimer(s.BufferTimer)
   ,SPOVTimer(s.SPOVTimer)
   ,SPOVGLTimer(s.SPOVGLTimer)
+  ,DelayRank(s.DelayRank), InvRowIndex(-1)
 {
   registerTimers();
   this->resize(s.NumPtcls,s.NumOrbitals);
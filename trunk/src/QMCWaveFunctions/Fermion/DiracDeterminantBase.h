@@ -23,6 +23,7 @@
 #include "QMCWaveFunctions/SPOSetBase.h"
 #include "Utilities/NewTimer.h"
 #include "QMCWaveFunctions/Fermion/BackflowTransformation.h"
+#include "QMCWaveFunctions/Fermion/DelayedUpdate.h"
 
 namespace qmcplusplus
 {
@@ -154,6 +155,40 @@ public:
   ///reset the size: with the number of particles and number of orbtials
   virtual void resize(int nel, int morb);
 
+  /** set the number of accepted moves to delay the inverse update
+   * @param delay maximum number of delayed rows, delay<=1 uses the Sherman-Morrison update
+   */
+  void setDelayRank(int delay);
+
+  ///apply the pending delayed updates to psiM
+  inline void completeUpdates()
+  {
+    if(DelayEngine.Delay)
+    {
+      UpdateTimer.start();
+      DelayEngine.updateInvMat(psiM);
+      UpdateTimer.stop();
+      InvRowIndex=-1;
+    }
+  }
+
+  /** return the row of the current inverse for the i-th particle of this determinant
+   *
+   * psiM is returned as it is without delayed updates. Otherwise, the row is
+   * evaluated with the pending updates and kept until psiM changes.
+   */
+  inline const ValueType* getInvRow(int i)
+  {
+    if(DelayRank==0)
+      return psiM[i];
+    if(InvRowIndex!=i)
+    {
+      DelayEngine.getInvRow(psiM,i,invRow.data());
+      InvRowIndex=i;
+    }
+    return invRow.data();
+  }
+
   virtual RealType registerData(ParticleSet& P, PooledData<RealType>& buf);
 
   virtual void registerDataForDerivatives(ParticleSet& P, PooledData<RealType>& buf, int storageType=0);
@@ -175,8 +210,52 @@ public:
 
   virtual RealType updateBuffer(ParticleSet& P, PooledData<RealType>& buf, bool fromscratch=false);
 
+  /** complete the inverse and add myG and myL to P.G and P.L at the end of a sweep
+   * @param fromscratch if true, evaluate the determinant from scratch
+   *
+   * The part of updateBuffer which does not touch the buffer.
+   */
+  void updateAfterSweep(ParticleSet& P, bool fromscratch);
+
   virtual void copyFromBuffer(ParticleSet& P, PooledData<RealType>& buf);
 
+  /** state of a walker: the inverse, the derivatives of the orbitals and myG, myL
+   */
+  struct WalkerState: public WalkerResource
+  {
+    ValueMatrix_t psiM, d2psiM;
+    GradMatrix_t dpsiM;
+    ParticleSet::ParticleGradient_t myG;
+    ParticleSet::ParticleLaplacian_t myL;
+    RealType LogValue, PhaseValue;
+    WalkerResource* makeClone() const
+    {
+      return new WalkerState(*this);
+    }
+    void copyFrom(const WalkerResource& a)
+    {
+      *this=static_cast<const WalkerState&>(a);
+    }
+  };
+
+  /** create a WalkerState
+   *
+   * Derived classes with their own data use the buffer of OrbitalBase.
+   */
+  virtual WalkerResource* makeResource(ParticleSet& P);
+
+  /** exchange the data with a WalkerState without copying them
+   */
+  virtual void bindResource(ParticleSet& P, WalkerResource& res);
+
+  virtual RealType storeResource(ParticleSet& P, WalkerResource& res);
+
+  /** update the bound WalkerState in place as updateBuffer
+   */
+  virtual RealType updateResource(ParticleSet& P, WalkerResource& res, bool fromscratch);
+
+  virtual void releaseResource(ParticleSet& P, WalkerResource& res);
+
   /** dump the inverse to the buffer
    */
   void dumpToBuffer(ParticleSet& P, PooledData<RealType>& buf);
@@ -269,6 +348,24 @@ public:
 //       virtual DiracDeterminantBase* makeCopy(ParticleSet& tqp, SPOSetBase* spo) const {return makeCopy(spo); };
 
   virtual void get_ratios(ParticleSet& P, vector<ValueType>& ratios);
+
+  /** evaluate the ratios of the virtual moves of VP.refPtcl
+   *
+   * The orbitals at all the virtual positions are evaluated by one call to Phi
+   * and the ratios are computed by a matrix-vector product with the row of the inverse.
+   */
+  virtual void evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios);
+
+  /** evaluate the ratios of a crowd with one call to Phi->mw_evaluate
+   *
+   * Derived classes with their own ratio use the single-walker functions.
+   */
+  virtual void mw_ratio(const vector<OrbitalBase*>& wfc_list,
+                        const vector<ParticleSet*>& P_list, int iat, vector<ValueType>& ratios);
+
+  virtual void mw_ratioGrad(const vector<OrbitalBase*>& wfc_list,
+                            const vector<ParticleSet*>& P_list, int iat,
+                            vector<ValueType>& ratios, vector<GradType>& grad_new);
   ///total number of particles
   int NP;
   ///number of single-particle orbitals which belong to this Dirac determinant
@@ -310,11 +407,24 @@ public:
   GradVector_t dpsiV;
   ValueVector_t d2psiV;
   ValueVector_t workV1, workV2;
+  /// values of the orbitals at the virtual positions for evaluateRatios
+  ValueMatrix_t psiVirtual;
   GradVector_t workG;
 
   Vector<ValueType> WorkSpace;
   Vector<IndexType> Pivot;
 
+  ///maximum number of delayed rows, 0 for the Sherman-Morrison update
+  int DelayRank;
+  ///index of the row stored in invRow, -1 if invalid
+  int InvRowIndex;
+  ///row of the current inverse including the pending updates
+  ValueVector_t invRow;
+  ///engine for the delayed rank-k update of psiM
+  DelayedUpdate<ValueType> DelayEngine;
+  ///true if psiM_temp, dpsiM_temp and d2psiM_temp are copies of psiM, dpsiM and d2psiM
+  bool TempInSync;
+
   ValueType curRatio,cumRatio;
   ValueType *FirstAddressOfG;
   ValueType *LastAddressOfG;
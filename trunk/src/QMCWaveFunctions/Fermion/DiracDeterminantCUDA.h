@@ -131,6 +131,15 @@ public:
     return DiracDeterminantBase::ratio (P, iat);
   }
 
+  /** evaluate the ratios of the virtual moves by the per-point ratio
+   *
+   * The batched DiracDeterminantBase::evaluateRatios does not apply to the GPU determinants.
+   */
+  void evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios)
+  {
+    OrbitalBase::evaluateRatios(VP,ratios);
+  }
+
   ValueType ratio(ParticleSet& P, int iat,
                   ParticleSet::ParticleGradient_t& dG,
                   ParticleSet::ParticleLaplacian_t& dL)
@@ -0,0 +1,345 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+
+#include "QMCWaveFunctions/Fermion/DiracDeterminantMixed.h"
+#include "Numerics/DeterminantOperators.h"
+#include "simd/simd.hpp"
+
+namespace qmcplusplus
+{
+
+/** dot product of a single-precision row and a full-precision row
+ *
+ * The sum is accumulated in the full precision.
+ */
+template<typename T1, typename T2>
+inline T2 dot_mixed(const T1* restrict a, const T2* restrict b, int n)
+{
+  T2 res=T2();
+  for(int i=0; i<n; ++i)
+    res += static_cast<T2>(a[i])*b[i];
+  return res;
+}
+
+template<typename T1, typename T2, unsigned D>
+inline TinyVector<T2,D> dot_mixed(const T1* restrict a, const TinyVector<T2,D>* restrict b, int n)
+{
+  TinyVector<T2,D> res;
+  for(int i=0; i<n; ++i)
+    res += static_cast<T2>(a[i])*b[i];
+  return res;
+}
+
+DiracDeterminantMixed::DiracDeterminantMixed(SPOSetBasePtr const &spos, int first)
+  : DiracDeterminantBase(spos,first)
+  , RecomputeInterval(10), StepsSinceRecompute(0)
+  , NumRecomputes(0), MaxDrift(0.0), SumDrift(0.0)
+{
+  OrbitalName="DiracDeterminantMixed";
+}
+
+DiracDeterminantMixed::~DiracDeterminantMixed()
+{
+  if(NumRecomputes)
+    reportStatus(app_log());
+}
+
+void DiracDeterminantMixed::setRecomputeInterval(int n)
+{
+  RecomputeInterval=(n>0)?n:0;
+}
+
+void DiracDeterminantMixed::resize(int nel, int morb)
+{
+  DiracDeterminantBase::resize(nel,morb);
+  psiMf.resize(psiM.rows(),psiM.cols());
+  psiVf.resize(NumOrbitals);
+  workV1f.resize(NumOrbitals);
+  workV2f.resize(NumOrbitals);
+}
+
+void DiracDeterminantMixed::reportStatus(ostream& os)
+{
+  os << "  DiracDeterminantMixed first=" << FirstIndex << " recompute=" << RecomputeInterval
+     << " drift of log|Psi| over " << NumRecomputes << " recomputes: max="
+     << MaxDrift << " mean=" << (NumRecomputes?SumDrift/NumRecomputes:0.0) << endl;
+}
+
+/** evaluate the determinant from scratch and add the walker data to the buffer
+ *
+ * The buffer holds psiMf, packed in the elements of the buffer, instead of
+ * psiM and the count of the steps since the last recompute. The layout of the
+ * base class is made in a scratch buffer.
+ */
+DiracDeterminantMixed::RealType
+DiracDeterminantMixed::registerData(ParticleSet& P, PooledData<RealType>& buf)
+{
+  PooledData<RealType> scratch;
+  DiracDeterminantBase::registerData(P,scratch);
+  StepsSinceRecompute=0;
+  buf.add_bytes(psiMf.data(),psiMf.size()*sizeof(mValueType));
+  buf.add(FirstAddressOfdV,LastAddressOfdV);
+  buf.add(d2psiM.first_address(),d2psiM.last_address());
+  buf.add(myL.first_address(), myL.last_address());
+  buf.add(FirstAddressOfG,LastAddressOfG);
+  buf.add(LogValue);
+  buf.add(PhaseValue);
+  buf.add(StepsSinceRecompute);
+  return LogValue;
+}
+
+/** update the buffer and recompute the inverse in double precision when it is due
+ *
+ * The recompute evaluates the orbitals and inverts the matrix from scratch.
+ * The gradients and laplacians are then handled as the particle-by-particle
+ * case of DiracDeterminantBase::updateBuffer.
+ */
+DiracDeterminantMixed::RealType
+DiracDeterminantMixed::updateBuffer(ParticleSet& P, PooledData<RealType>& buf, bool fromscratch)
+{
+  ++StepsSinceRecompute;
+  if(fromscratch || (RecomputeInterval && StepsSinceRecompute>=RecomputeInterval))
+  {
+    RealType logpsi=LogValue;
+    myG_temp=0.0;
+    myL_temp=0.0;
+    evaluateLog(P,myG_temp,myL_temp);
+    RealType drift=std::abs(LogValue-logpsi);
+    MaxDrift=std::max(MaxDrift,drift);
+    SumDrift+=drift;
+    ++NumRecomputes;
+    //orbitals are up to date
+    UpdateMode=ORB_PBYP_PARTIAL;
+  }
+  else
+    syncInverse();
+  updateAfterSweep(P,false);
+  BufferTimer.start();
+  TempInSync=false;
+  putBuffer(buf);
+  BufferTimer.stop();
+  return LogValue;
+}
+
+/** copy the walker data from the buffer
+ *
+ * psiM is not restored: the functions using it copy psiMf first.
+ */
+void DiracDeterminantMixed::copyFromBuffer(ParticleSet& P, PooledData<RealType>& buf)
+{
+  BufferTimer.start();
+  buf.get_bytes(psiMf.data(),psiMf.size()*sizeof(mValueType));
+  buf.get(FirstAddressOfdV,LastAddressOfdV);
+  buf.get(d2psiM.first_address(),d2psiM.last_address());
+  buf.get(myL.first_address(), myL.last_address());
+  buf.get(FirstAddressOfG,LastAddressOfG);
+  buf.get(LogValue);
+  buf.get(PhaseValue);
+  buf.get(StepsSinceRecompute);
+  TempInSync=false;
+  BufferTimer.stop();
+}
+
+DiracDeterminantMixed::RealType
+DiracDeterminantMixed::evaluateLog(ParticleSet& P, PooledData<RealType>& buf)
+{
+  putBuffer(buf);
+  return LogValue;
+}
+
+void DiracDeterminantMixed::putBuffer(PooledData<RealType>& buf)
+{
+  buf.put_bytes(psiMf.data(),psiMf.size()*sizeof(mValueType));
+  buf.put(FirstAddressOfdV,LastAddressOfdV);
+  buf.put(d2psiM.first_address(),d2psiM.last_address());
+  buf.put(myL.first_address(), myL.last_address());
+  buf.put(FirstAddressOfG,LastAddressOfG);
+  buf.put(LogValue);
+  buf.put(PhaseValue);
+  buf.put(StepsSinceRecompute);
+}
+
+void DiracDeterminantMixed::copyToDerivativeBuffer(ParticleSet& P, PooledData<RealType>& buf)
+{
+  syncInverse();
+  DiracDeterminantBase::copyToDerivativeBuffer(P,buf);
+}
+
+void DiracDeterminantMixed::copyFromDerivativeBuffer(ParticleSet& P, PooledData<RealType>& buf)
+{
+  DiracDeterminantBase::copyFromDerivativeBuffer(P,buf);
+  simd::copy(psiMf.data(),psiM.data(),psiM.size());
+}
+
+DiracDeterminantMixed::ValueType DiracDeterminantMixed::ratio(ParticleSet& P, int iat)
+{
+  UpdateMode=ORB_PBYP_RATIO;
+  WorkingIndex = iat-FirstIndex;
+  SPOVTimer.start();
+  Phi->evaluate(P, iat, psiV);
+  SPOVTimer.stop();
+  RatioTimer.start();
+  curRatio=dot_mixed(psiMf[WorkingIndex],psiV.data(),NumOrbitals);
+  RatioTimer.stop();
+  return curRatio;
+}
+
+/** the full-matrix update uses psiM_temp in double precision
+ *
+ * psiM_temp, dpsiM_temp and d2psiM_temp are copied by the base class from
+ * psiM, which is synchronized with psiMf first, dpsiM and d2psiM.
+ */
+DiracDeterminantMixed::ValueType DiracDeterminantMixed::ratio(ParticleSet& P, int iat,
+    ParticleSet::ParticleGradient_t& dG,
+    ParticleSet::ParticleLaplacian_t& dL)
+{
+  if(!TempInSync)
+    syncInverse();
+  return DiracDeterminantBase::ratio(P,iat,dG,dL);
+}
+
+DiracDeterminantMixed::ValueType
+DiracDeterminantMixed::ratioGrad(ParticleSet& P, int iat, GradType& grad_iat)
+{
+  SPOVGLTimer.start();
+  Phi->evaluate(P, iat, psiV, dpsiV, d2psiV);
+  SPOVGLTimer.stop();
+  RatioTimer.start();
+  WorkingIndex = iat-FirstIndex;
+  UpdateMode=ORB_PBYP_PARTIAL;
+  const mValueType* restrict inv_row=psiMf[WorkingIndex];
+  curRatio=dot_mixed(inv_row,psiV.data(),NumOrbitals);
+  GradType rv=dot_mixed(inv_row,dpsiV.data(),NumOrbitals);
+  grad_iat += (1.0/curRatio) * rv;
+  RatioTimer.stop();
+  return curRatio;
+}
+
+DiracDeterminantMixed::GradType
+DiracDeterminantMixed::evalGrad(ParticleSet& P, int iat)
+{
+  WorkingIndex = iat-FirstIndex;
+  RatioTimer.start();
+  GradType g=dot_mixed(psiMf[WorkingIndex],dpsiM[WorkingIndex],NumOrbitals);
+  RatioTimer.stop();
+  return g;
+}
+
+DiracDeterminantMixed::GradType
+DiracDeterminantMixed::evalGradSource(ParticleSet& P, ParticleSet& source, int iat)
+{
+  syncInverse();
+  return DiracDeterminantBase::evalGradSource(P,source,iat);
+}
+
+DiracDeterminantMixed::GradType
+DiracDeterminantMixed::evalGradSource(ParticleSet& P, ParticleSet& source, int iat,
+                                      TinyVector<ParticleSet::ParticleGradient_t, OHMMS_DIM> &grad_grad,
+                                      TinyVector<ParticleSet::ParticleLaplacian_t,OHMMS_DIM> &lapl_grad)
+{
+  syncInverse();
+  return DiracDeterminantBase::evalGradSource(P,source,iat,grad_grad,lapl_grad);
+}
+
+/** move was accepted, update the single-precision inverse
+ */
+void DiracDeterminantMixed::acceptMove(ParticleSet& P, int iat)
+{
+  if(UpdateMode == ORB_PBYP_ALL)
+  {
+    DiracDeterminantBase::acceptMove(P,iat);
+    simd::copy(psiMf.data(),psiM.data(),psiM.size());
+    return;
+  }
+  PhaseValue += evaluatePhase(curRatio);
+  LogValue +=std::log(std::abs(curRatio));
+  UpdateTimer.start();
+  simd::copy(psiVf.data(),psiV.data(),NumOrbitals);
+  InverseUpdateByRow(psiMf,psiVf,workV1f,workV2f,WorkingIndex,static_cast<mValueType>(curRatio));
+  if(UpdateMode == ORB_PBYP_PARTIAL)
+  {
+    simd::copy(dpsiM[WorkingIndex],  dpsiV.data(),  NumOrbitals);
+    simd::copy(d2psiM[WorkingIndex], d2psiV.data(), NumOrbitals);
+  }
+  //psiM and the temporaries are behind psiMf
+  TempInSync=false;
+  UpdateTimer.stop();
+  curRatio=1.0;
+}
+
+void DiracDeterminantMixed::update(ParticleSet& P,
+                                   ParticleSet::ParticleGradient_t& dG,
+                                   ParticleSet::ParticleLaplacian_t& dL,
+                                   int iat)
+{
+  syncInverse();
+  DiracDeterminantBase::update(P,dG,dL,iat);
+  simd::copy(psiMf.data(),psiM.data(),psiM.size());
+}
+
+/** evaluate the determinant and the inverse in double precision
+ *
+ * psiMf is reset to the new inverse.
+ */
+DiracDeterminantMixed::RealType
+DiracDeterminantMixed::evaluateLog(ParticleSet& P,
+                                   ParticleSet::ParticleGradient_t& G,
+                                   ParticleSet::ParticleLaplacian_t& L)
+{
+  DiracDeterminantBase::evaluateLog(P,G,L);
+  simd::copy(psiMf.data(),psiM.data(),psiM.size());
+  StepsSinceRecompute=0;
+  return LogValue;
+}
+
+void DiracDeterminantMixed::get_ratios(ParticleSet& P, vector<ValueType>& ratios)
+{
+  SPOVTimer.start();
+  Phi->evaluate(P, 0, psiV);
+  SPOVTimer.stop();
+  for(int i=0; i<NumPtcls; ++i)
+    ratios[FirstIndex+i]=dot_mixed(psiMf[i],psiV.data(),NumOrbitals);
+}
+
+void DiracDeterminantMixed::evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios)
+{
+  const int nv=VP.getTotalNum();
+  if (psiVirtual.rows() != nv)
+    psiVirtual.resize(nv,NumOrbitals);
+  SPOVTimer.start();
+  Phi->evaluateValues(VP,psiVirtual);
+  SPOVTimer.stop();
+  RatioTimer.start();
+  const mValueType* restrict inv_row=psiMf[VP.refPtcl-FirstIndex];
+  for(int j=0; j<nv; ++j)
+    ratios[j]=dot_mixed(inv_row,psiVirtual[j],NumOrbitals);
+  RatioTimer.stop();
+}
+
+DiracDeterminantBase* DiracDeterminantMixed::makeCopy(SPOSetBasePtr spo) const
+{
+  DiracDeterminantMixed* dclone= new DiracDeterminantMixed(spo);
+  dclone->set(FirstIndex,LastIndex-FirstIndex);
+  dclone->setRecomputeInterval(RecomputeInterval);
+  return dclone;
+}
+
+}
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,148 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file DiracDeterminantMixed.h
+ * @brief Declaration of DiracDeterminantMixed with a single-precision inverse
+ */
+#ifndef QMCPLUSPLUS_DIRACDETERMINANT_MIXED_H
+#define QMCPLUSPLUS_DIRACDETERMINANT_MIXED_H
+#include "QMCWaveFunctions/Fermion/DiracDeterminantBase.h"
+
+namespace qmcplusplus
+{
+
+/** DiracDeterminantBase with the inverse kept in single precision
+ *
+ * The ratios, gradients and the Sherman-Morrison updates of the
+ * particle-by-particle moves use psiMf, a single-precision copy of psiM.
+ * The orbitals and their derivatives are evaluated in the full precision.
+ * The inverse is recomputed in double precision by updateBuffer after
+ * RecomputeInterval calls since the last recompute of a walker, or
+ * whenever updateBuffer is called with fromscratch=true.
+ *
+ * The walker buffer holds psiMf instead of psiM, packed in half of the
+ * elements of psiM, so that the inverse of a walker is stored and copied
+ * in single precision too.
+ *
+ * At each recompute, the drift |log|Psi| accumulated by the ratios - log|Psi| recomputed|
+ * is recorded and summarized by reportStatus.
+ */
+class DiracDeterminantMixed: public DiracDeterminantBase
+{
+public:
+#if defined(QMC_COMPLEX)
+  typedef std::complex<float> mValueType;
+#else
+  typedef float mValueType;
+#endif
+  typedef Vector<mValueType> mValueVector_t;
+  typedef Matrix<mValueType> mValueMatrix_t;
+
+  ///number of updateBuffer calls between the double-precision recomputes, 0 to disable
+  int RecomputeInterval;
+  ///number of updateBuffer calls since the last recompute of the current walker
+  int StepsSinceRecompute;
+  ///number of recomputes with a drift measurement
+  int NumRecomputes;
+  ///maximum drift of log|Psi|
+  RealType MaxDrift;
+  ///sum of the drift of log|Psi|
+  RealType SumDrift;
+
+  ///single-precision inverse
+  mValueMatrix_t psiMf;
+  ///single-precision copy of psiV and the work space for the update
+  mValueVector_t psiVf, workV1f, workV2f;
+
+  /** constructor
+   *@param spos the single-particle orbital set
+   *@param first index of the first particle
+   */
+  DiracDeterminantMixed(SPOSetBasePtr const &spos, int first=0);
+
+  ~DiracDeterminantMixed();
+
+  /** set the number of updateBuffer calls between the double-precision recomputes
+   * @param n interval, n<=0 recomputes only when requested by the drivers
+   */
+  void setRecomputeInterval(int n);
+
+  void resize(int nel, int morb);
+
+  void reportStatus(ostream& os);
+
+  RealType registerData(ParticleSet& P, PooledData<RealType>& buf);
+
+  RealType updateBuffer(ParticleSet& P, PooledData<RealType>& buf, bool fromscratch=false);
+
+  void copyFromBuffer(ParticleSet& P, PooledData<RealType>& buf);
+
+  RealType evaluateLog(ParticleSet& P, PooledData<RealType>& buf);
+
+  void copyToDerivativeBuffer(ParticleSet& P, PooledData<RealType>& buf);
+
+  void copyFromDerivativeBuffer(ParticleSet& P, PooledData<RealType>& buf);
+
+  ValueType ratio(ParticleSet& P, int iat);
+
+  ValueType ratio(ParticleSet& P, int iat,
+                  ParticleSet::ParticleGradient_t& dG,
+                  ParticleSet::ParticleLaplacian_t& dL);
+
+  ValueType ratioGrad(ParticleSet& P, int iat, GradType& grad_iat);
+
+  GradType evalGrad(ParticleSet& P, int iat);
+
+  GradType evalGradSource(ParticleSet &P, ParticleSet &source, int iat);
+
+  GradType evalGradSource(ParticleSet& P, ParticleSet& source, int iat,
+                          TinyVector<ParticleSet::ParticleGradient_t, OHMMS_DIM> &grad_grad,
+                          TinyVector<ParticleSet::ParticleLaplacian_t,OHMMS_DIM> &lapl_grad);
+
+  void acceptMove(ParticleSet& P, int iat);
+
+  void update(ParticleSet& P,
+              ParticleSet::ParticleGradient_t& dG,
+              ParticleSet::ParticleLaplacian_t& dL,
+              int iat);
+
+  RealType evaluateLog(ParticleSet& P,
+                       ParticleSet::ParticleGradient_t& G,
+                       ParticleSet::ParticleLaplacian_t& L);
+
+  DiracDeterminantBase* makeCopy(SPOSetBase* spo) const;
+
+  void get_ratios(ParticleSet& P, vector<ValueType>& ratios);
+
+  void evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios);
+
+private:
+  ///put the walker data to the buffer in the order of registerData
+  void putBuffer(PooledData<RealType>& buf);
+
+  ///copy the single-precision inverse to psiM for the double-precision functions
+  inline void syncInverse()
+  {
+    simd::copy(psiM.data(),psiMf.data(),psiM.size());
+  }
+};
+
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
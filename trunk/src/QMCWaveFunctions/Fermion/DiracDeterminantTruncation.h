@@ -60,6 +60,15 @@ public:
   DiracDeterminantBase::ValueType ratio(ParticleSet& P, int iat);
   DiracDeterminantBase::ValueType ratio(ParticleSet& P, int iat,ParticleSet::ParticleGradient_t& dG, ParticleSet::ParticleLaplacian_t& dL);
 
+  /** evaluate the ratios of the virtual moves by the per-point ratio
+   *
+   * The batched DiracDeterminantBase::evaluateRatios does not apply to the truncated ratio.
+   */
+  void evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios)
+  {
+    OrbitalBase::evaluateRatios(VP,ratios);
+  }
+
   void resize(int nel, int morb);
 
   //   void set_iterative(int first,int nel, double &temp_cutoff);
@@ -39,6 +39,8 @@ DiracDeterminantWithBackflow::DiracDeterminantWithBackflow(ParticleSet &ptcl, SP
   BFTrans=BF;
   NumParticles = ptcl.getTotalNum();
   NP=0;
+  MaxRankUpdate=0;
+  DelayedInverse=false;
 }
 
 ///default destructor
@@ -79,6 +81,13 @@ void DiracDeterminantWithBackflow::resize(int nel, int morb)
   psiMinv_temp.resize(NumPtcls,norb);
   psiV.resize(norb);
   psiM_temp.resize(NumPtcls,norb);
+  //the rank-k update costs O(N^2 k) and the full inversion O(N^3)
+  MaxRankUpdate=std::max(1,nel/4);
+  MovedQP.reserve(nel);
+  psiQP.resize(MaxRankUpdate,norb);
+  Sinv.resize(MaxRankUpdate,MaxRankUpdate);
+  workQP.resize(2*MaxRankUpdate);
+  DelayedInverse=false;
   // For forces
   /*  not used
   grad_source_psiM.resize(nel,norb);
@@ -189,9 +198,8 @@ void DiracDeterminantWithBackflow::copyFromBuffer(ParticleSet& P, PooledData<Rea
  */
 DiracDeterminantWithBackflow::ValueType DiracDeterminantWithBackflow::ratio(ParticleSet& P, int iat)
 {
-  // FIX FIX FIX : code Woodbury formula
   psiM_temp=psiM;
-  // either code Woodbury or do multiple single particle updates
+  MovedQP.clear();
   UpdateMode=ORB_PBYP_RATIO;
   vector<int>::iterator it = BFTrans->indexQP.begin();
   vector<int>::iterator it_end = BFTrans->indexQP.end();
@@ -203,6 +211,7 @@ DiracDeterminantWithBackflow::ValueType DiracDeterminantWithBackflow::ratio(Part
       continue;
     }
     int jat = *it-FirstIndex;
+    MovedQP.push_back(jat);
     PosType dr = BFTrans->newQP[*it] - BFTrans->QP.R[*it];
     BFTrans->QP.makeMoveAndCheck(*it,dr);
     Phi->evaluate(BFTrans->QP, *it, psiV);
@@ -211,13 +220,8 @@ DiracDeterminantWithBackflow::ValueType DiracDeterminantWithBackflow::ratio(Part
     BFTrans->QP.rejectMove(*it);
     it++;
   }
-  // FIX FIX FIX : code Woodbury formula
-  psiMinv_temp = psiM_temp;
-  // FIX FIX FIX : code Woodbury formula
-  InverseTimer.start();
   RealType NewPhase;
-  RealType NewLog=InvertWithLog(psiMinv_temp.data(),NumPtcls,NumOrbitals,WorkSpace.data(),Pivot.data(),NewPhase);
-  InverseTimer.stop();
+  RealType NewLog=invertTemp(NewPhase,false);
 #if defined(QMC_COMPLEX)
   RealType ratioMag = std::exp(NewLog-LogValue);
   return curRatio = std::complex<OHMMS_PRECISION>(std::cos(NewPhase-PhaseValue)*ratioMag,std::sin(NewPhase-PhaseValue)*ratioMag);
@@ -226,6 +230,85 @@ DiracDeterminantWithBackflow::ValueType DiracDeterminantWithBackflow::ratio(Part
 #endif
 }
 
+DiracDeterminantWithBackflow::RealType
+DiracDeterminantWithBackflow::invertTemp(RealType& NewPhase, bool newinv)
+{
+  const int k=MovedQP.size();
+  RealType NewLog;
+  InverseTimer.start();
+  if(k>MaxRankUpdate)
+  {
+    psiMinv_temp = psiM_temp;
+    NewLog=InvertWithLog(psiMinv_temp.data(),NumPtcls,NumOrbitals,WorkSpace.data(),Pivot.data(),NewPhase);
+    DelayedInverse=false;
+  }
+  else
+  {
+    RealType logS=0.0, phaseS=0.0;
+    if(k)
+    {
+      for(int b=0; b<k; ++b)
+      {
+        ValueType* restrict v=psiQP[b];
+        for(int orb=0; orb<NumOrbitals; ++orb)
+          v[orb]=psiM_temp(orb,MovedQP[b]);
+      }
+      //S is stored as a dense k x k matrix
+      ValueType* restrict smat=Sinv.data();
+      for(int a=0; a<k; ++a)
+        for(int b=0; b<k; ++b)
+          smat[a*k+b]=simd::dot(psiMinv[MovedQP[a]],psiQP[b],NumOrbitals);
+      logS=InvertWithLog(smat,k,k,WorkSpace.data(),Pivot.data(),phaseS);
+    }
+    NewLog=LogValue+logS;
+    NewPhase=PhaseValue+phaseS;
+    DelayedInverse=!newinv;
+    if(newinv)
+      updateInverseQP();
+  }
+  InverseTimer.stop();
+  return NewLog;
+}
+
+/** psiMinv_temp = psiMinv - psiMinv U Sinv psiMinv(MovedQP,:)
+ *
+ * U holds the changes of the columns MovedQP of psiM, so that
+ * (psiMinv U)(i,b) = psiMinv[i] . psiQP[b] - delta(i,MovedQP[b]).
+ */
+void DiracDeterminantWithBackflow::updateInverseQP()
+{
+  const int k=MovedQP.size();
+  psiMinv_temp = psiMinv;
+  DelayedInverse=false;
+  if(k==0)
+    return;
+  const ValueType* restrict smat=Sinv.data();
+  ValueType* restrict t=workQP.data();
+  ValueType* restrict w=t+k;
+  for(int i=0; i<NumPtcls; ++i)
+  {
+    for(int b=0; b<k; ++b)
+      t[b]=simd::dot(psiMinv[i],psiQP[b],NumOrbitals);
+    for(int b=0; b<k; ++b)
+      if(MovedQP[b]==i)
+        t[b] -= 1.0;
+    for(int a=0; a<k; ++a)
+    {
+      ValueType x(0.0);
+      for(int b=0; b<k; ++b)
+        x += t[b]*smat[b*k+a];
+      w[a]=x;
+    }
+    ValueType* restrict row=psiMinv_temp[i];
+    for(int a=0; a<k; ++a)
+    {
+      const ValueType* restrict r=psiMinv[MovedQP[a]];
+      for(int orb=0; orb<NumOrbitals; ++orb)
+        row[orb] -= w[a]*r[orb];
+    }
+  }
+}
+
 void DiracDeterminantWithBackflow::get_ratios(ParticleSet& P, vector<ValueType>& ratios)
 {
   APP_ABORT(" Need to implement DiracDeterminantWithBackflow::get_ratios(ParticleSet& P, int iat). \n");
@@ -275,9 +358,9 @@ DiracDeterminantWithBackflow::evalGradSource
 DiracDeterminantWithBackflow::ValueType
 DiracDeterminantWithBackflow::ratioGrad(ParticleSet& P, int iat, GradType& grad_iat)
 {
-  // FIX FIX FIX : code Woodbury formula
   psiM_temp=psiM;
   dpsiM_temp=dpsiM;
+  MovedQP.clear();
   UpdateMode=ORB_PBYP_PARTIAL;
   vector<int>::iterator it = BFTrans->indexQP.begin();
   vector<int>::iterator it_end = BFTrans->indexQP.end();
@@ -290,6 +373,7 @@ DiracDeterminantWithBackflow::ratioGrad(ParticleSet& P, int iat, GradType& grad_
       continue;
     }
     int jat = *it-FirstIndex;
+    MovedQP.push_back(jat);
     PosType dr = BFTrans->newQP[*it] - BFTrans->QP.R[*it];
     BFTrans->QP.makeMoveAndCheck(*it,dr);
     Phi->evaluate(BFTrans->QP, *it, psiV, dpsiV, d2psiV);
@@ -300,13 +384,8 @@ DiracDeterminantWithBackflow::ratioGrad(ParticleSet& P, int iat, GradType& grad_
     BFTrans->QP.rejectMove(*it);
     it++;
   }
-  // FIX FIX FIX : code Woodbury formula
-  psiMinv_temp = psiM_temp;
-  // FIX FIX FIX : code Woodbury formula
-  InverseTimer.start();
   RealType NewPhase;
-  RealType NewLog=InvertWithLog(psiMinv_temp.data(),NumPtcls,NumOrbitals,WorkSpace.data(),Pivot.data(),NewPhase);
-  InverseTimer.stop();
+  RealType NewLog=invertTemp(NewPhase,true);
   // update Fmatdiag_temp
   for(int j=0; j<NumPtcls; j++)
   {
@@ -334,10 +413,10 @@ DiracDeterminantWithBackflow::ValueType DiracDeterminantWithBackflow::ratio(Part
     ParticleSet::ParticleGradient_t& dG,
     ParticleSet::ParticleLaplacian_t& dL)
 {
-  // FIX FIX FIX : code Woodbury formula
   psiM_temp=psiM;
   dpsiM_temp=dpsiM;
   grad_grad_psiM_temp = grad_grad_psiM;
+  MovedQP.clear();
   UpdateMode=ORB_PBYP_ALL;
   vector<int>::iterator it = BFTrans->indexQP.begin();
   vector<int>::iterator it_end = BFTrans->indexQP.end();
@@ -349,6 +428,7 @@ DiracDeterminantWithBackflow::ValueType DiracDeterminantWithBackflow::ratio(Part
       continue;
     }
     int jat = *it-FirstIndex;
+    MovedQP.push_back(jat);
     PosType dr = BFTrans->newQP[*it] - BFTrans->QP.R[*it];
     BFTrans->QP.makeMoveAndCheck(*it,dr);
     Phi->evaluate(BFTrans->QP, *it, psiV, dpsiV, grad_gradV);
@@ -372,13 +452,8 @@ DiracDeterminantWithBackflow::ValueType DiracDeterminantWithBackflow::ratio(Part
       Phi->evaluate(BFTrans->QP, FirstIndex, LastIndex, psiM_temp,dpsiM_temp,grad_grad_psiM_temp);
       UpdateMode=ORB_PBYP_ALL;
   */
-  // FIX FIX FIX : code Woodbury formula
-  psiMinv_temp = psiM_temp;
-  // FIX FIX FIX : code Woodbury formula
-  InverseTimer.start();
   RealType NewPhase;
-  RealType NewLog=InvertWithLog(psiMinv_temp.data(),NumPtcls,NumOrbitals,WorkSpace.data(),Pivot.data(),NewPhase);
-  InverseTimer.stop();
+  RealType NewLog=invertTemp(NewPhase,true);
   for(int i=0; i<NumPtcls; i++)
   {
     for(int j=0; j<NumPtcls; j++)
@@ -775,6 +850,8 @@ void DiracDeterminantWithBackflow::acceptMove(ParticleSet& P, int iat)
   switch(UpdateMode)
   {
   case ORB_PBYP_RATIO:
+    if(DelayedInverse)
+      updateInverseQP();
     psiMinv = psiMinv_temp;
     psiM = psiM_temp;
     break;
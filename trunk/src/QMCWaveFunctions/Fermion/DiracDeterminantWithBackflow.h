@@ -115,6 +115,15 @@ public:
    */
   ValueType ratio(ParticleSet& P, int iat);
 
+  /** evaluate the ratios of the virtual moves by the per-point ratio
+   *
+   * The batched DiracDeterminantBase::evaluateRatios does not apply to the quasi-particle coordinates.
+   */
+  void evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios)
+  {
+    OrbitalBase::evaluateRatios(VP,ratios);
+  }
+
   void get_ratios(ParticleSet& P, vector<ValueType>& ratios);
 
   ValueType alternateRatio(ParticleSet& P)
@@ -225,6 +234,20 @@ public:
   GradVector_t Fmatdiag_temp;
 
   ValueMatrix_t psiMinv_temp;
+
+  ///maximum number of moved quasi-particles for the rank-k update
+  int MaxRankUpdate;
+  ///local indices of the quasi-particles moved by the current move
+  vector<int> MovedQP;
+  ///new orbital values of the moved quasi-particles
+  ValueMatrix_t psiQP;
+  ///inverse of the k x k matrix of the determinant lemma
+  ValueMatrix_t Sinv;
+  ///work space for the rank-k update of a row of the inverse
+  ValueVector_t workQP;
+  ///true, if psiMinv_temp has to be updated by acceptMove
+  bool DelayedInverse;
+
   ValueType *FirstAddressOfGGG;
   ValueType *LastAddressOfGGG;
   ValueType *FirstAddressOfFm;
@@ -238,6 +261,22 @@ public:
   void testL(ParticleSet& P);
   void dummyEvalLi(ValueType& L1, ValueType& L2, ValueType& L3);
 
+  /** evaluate log|det(psiM_temp)| and its phase for the columns MovedQP
+   * @param NewPhase phase of det(psiM_temp)
+   * @param newinv if true, psiMinv_temp is the inverse of psiM_temp on exit
+   * @return log|det(psiM_temp)|
+   *
+   * When at most MaxRankUpdate quasi-particles have moved, the ratio is
+   * obtained by the matrix determinant lemma, det(S) with
+   * \f$S_{ab}=\sum_o {\rm psiMinv}(a,o)\,{\rm psiM\_temp}(o,b)\f$ for a,b in MovedQP,
+   * and the inverse by the Woodbury formula at O(N^2 k).
+   * Otherwise, psiM_temp is inverted from scratch.
+   */
+  RealType invertTemp(RealType& NewPhase, bool newinv);
+
+  ///update psiMinv_temp by the Woodbury formula using Sinv
+  void updateInverseQP();
+
 };
 
 
@@ -16,6 +16,7 @@
 #include "QMCWaveFunctions/Fermion/MultiSlaterDeterminantFast.h"
 #include "QMCWaveFunctions/Fermion/MultiDiracDeterminantBase.h"
 #include "ParticleBase/ParticleAttribOps.h"
+#include "simd/simd.hpp"
 
 namespace qmcplusplus
 {
@@ -54,6 +55,7 @@ MultiSlaterDeterminantFast::MultiSlaterDeterminantFast(ParticleSet& targetPtcl,
       DetID[j]=i;
   usingBF=false;
   BFTrans=0;
+  ContractedCValid[0]=ContractedCValid[1]=false;
 }
 
 OrbitalBasePtr MultiSlaterDeterminantFast::makeClone(ParticleSet& tqp) const
@@ -161,6 +163,64 @@ void MultiSlaterDeterminantFast::testMSD(ParticleSet& P, int iat)
   APP_ABORT("After MultiSlaterDeterminantFast::testMSD()");
 }
 
+/** contract C with the values of the unique determinants of the other spin
+ * @param s spin of ContractedC[s]
+ * @param detValues_o values of the unique determinants of the other spin
+ */
+void MultiSlaterDeterminantFast::contractC(int s, const ValueVector_t& detValues_o)
+{
+  const vector<int>& node_s((s==0)?C2node_up:C2node_dn);
+  const vector<int>& node_o((s==0)?C2node_dn:C2node_up);
+  ValueVector_t& cs(ContractedC[s]);
+  if(cs.size() != Dets[s]->detValues.size())
+    cs.resize(Dets[s]->detValues.size());
+  cs=0.0;
+  for(int i=0; i<C.size(); i++)
+    cs[node_s[i]] += C[i]*detValues_o[node_o[i]];
+  ContractedCValid[s]=true;
+}
+
+/** evaluate psi and the unnormalized gradients and laplacians
+ * @return psi
+ *
+ * g and l are the sums of the gradients and laplacians of the unique
+ * determinants weighted by ContractedC, i.e., \f$\sum_n c_n \nabla_i S_n\f$
+ * and \f$\sum_n c_n \nabla^2_i S_n\f$. Both ContractedC are rebuilt
+ * from the determinants passed to this function.
+ */
+OrbitalBase::ValueType MultiSlaterDeterminantFast::contractAll(
+  ValueVector_t& detValues_up, ValueVector_t& detValues_dn,
+  GradMatrix_t& grads_up, GradMatrix_t& grads_dn,
+  ValueMatrix_t& lapls_up, ValueMatrix_t& lapls_dn,
+  ParticleSet::ParticleGradient_t& g, ParticleSet::ParticleLaplacian_t& l)
+{
+  contractC(0,detValues_dn);
+  contractC(1,detValues_up);
+  g=0.0;
+  l=0.0;
+  GradMatrix_t* grads[2]= {&grads_up,&grads_dn};
+  ValueMatrix_t* lapls[2]= {&lapls_up,&lapls_dn};
+  for(int s=0; s<2; s++)
+  {
+    const ValueVector_t& cs(ContractedC[s]);
+    const int first=Dets[s]->FirstIndex;
+    const int nptcl=Dets[s]->NumPtcls;
+    for(int u=0; u<cs.size(); u++)
+    {
+      if(cs[u]==0.0)
+        continue;
+      const GradType* restrict gptr=(*grads[s])[u];
+      const ValueType* restrict lptr=(*lapls[s])[u];
+      for(int k=0,n=first; k<nptcl; k++,n++)
+      {
+        g[n] += cs[u]*gptr[k];
+        l[n] += cs[u]*lptr[k];
+      }
+    }
+  }
+  return simd::dot(ContractedC[0].data(),detValues_up.data(),detValues_up.size());
+}
+
 OrbitalBase::ValueType MultiSlaterDeterminantFast::evaluate(ParticleSet& P
     , ParticleSet::ParticleGradient_t& G, ParticleSet::ParticleLaplacian_t& L)
 {
@@ -169,39 +229,8 @@ OrbitalBase::ValueType MultiSlaterDeterminantFast::evaluate(ParticleSet& P
   //  Dets[i]->evaluateForWalkerMove(P);
   Dets[0]->evaluateForWalkerMove(P);
   Dets[1]->evaluateForWalkerMove(P);
-  // can this change over time??? I don't know yet
-  ValueVector_t& detValues_up = Dets[0]->detValues;
-  ValueVector_t& detValues_dn = Dets[1]->detValues;
-  GradMatrix_t& grads_up = Dets[0]->grads;
-  GradMatrix_t& grads_dn = Dets[1]->grads;
-  ValueMatrix_t& lapls_up = Dets[0]->lapls;
-  ValueMatrix_t& lapls_dn = Dets[1]->lapls;
-  int N1 = Dets[0]->FirstIndex;
-  int N2 = Dets[1]->FirstIndex;
-  int NP1 = Dets[0]->NumPtcls;
-  int NP2 = Dets[1]->NumPtcls;
-  psiCurrent=0.0;
-  myG=0.0;
-  myL=0.0;
-  vector<int>::iterator upC(C2node_up.begin()),dnC(C2node_dn.begin());
-  vector<RealType>::iterator it(C.begin()),last(C.end());
-  while(it != last)
-  {
-    psiCurrent += (*it)*detValues_up[*upC]*detValues_dn[*dnC];
-    for(int k=0,n=N1; k<NP1; k++,n++)
-    {
-      myG(n) += (*it)*grads_up(*upC,k)*detValues_dn[*dnC];
-      myL(n) += (*it)*lapls_up(*upC,k)*detValues_dn[*dnC];
-    }
-    for(int k=0,n=N2; k<NP2; k++,n++)
-    {
-      myG(n) += (*it)*grads_dn(*dnC,k)*detValues_up[*upC];
-      myL(n) += (*it)*lapls_dn(*dnC,k)*detValues_up[*upC];
-    }
-    it++;
-    upC++;
-    dnC++;
-  }
+  psiCurrent=contractAll(Dets[0]->detValues,Dets[1]->detValues
+                         ,Dets[0]->grads,Dets[1]->grads,Dets[0]->lapls,Dets[1]->lapls,myG,myL);
   ValueType psiinv = 1.0/psiCurrent;
   myG *= psiinv;
   myL *= psiinv;
@@ -237,39 +266,8 @@ OrbitalBase::RealType MultiSlaterDeterminantFast::evaluateLog(ParticleSet& P,
     Dets[0]->copyFromDerivativeBuffer(P,buf);
     Dets[1]->copyFromDerivativeBuffer(P,buf);
   }
-  // can this change over time??? I don't know yet
-  ValueVector_t& detValues_up = Dets[0]->detValues;
-  ValueVector_t& detValues_dn = Dets[1]->detValues;
-  GradMatrix_t& grads_up = Dets[0]->grads;
-  GradMatrix_t& grads_dn = Dets[1]->grads;
-  ValueMatrix_t& lapls_up = Dets[0]->lapls;
-  ValueMatrix_t& lapls_dn = Dets[1]->lapls;
-  int N1 = Dets[0]->FirstIndex;
-  int N2 = Dets[1]->FirstIndex;
-  int NP1 = Dets[0]->NumPtcls;
-  int NP2 = Dets[1]->NumPtcls;
-  psiCurrent=0.0;
-  myG=0.0;
-  myL=0.0;
-  vector<int>::iterator upC(C2node_up.begin()),dnC(C2node_dn.begin());
-  vector<RealType>::iterator it(C.begin()),last(C.end());
-  while(it != last)
-  {
-    psiCurrent += (*it)*detValues_up[*upC]*detValues_dn[*dnC];
-    for(int k=0,n=N1; k<NP1; k++,n++)
-    {
-      myG(n) += (*it)*grads_up(*upC,k)*detValues_dn[*dnC];
-      myL(n) += (*it)*lapls_up(*upC,k)*detValues_dn[*dnC];
-    }
-    for(int k=0,n=N2; k<NP2; k++,n++)
-    {
-      myG(n) += (*it)*grads_dn(*dnC,k)*detValues_up[*upC];
-      myL(n) += (*it)*lapls_dn(*dnC,k)*detValues_up[*upC];
-    }
-    it++;
-    upC++;
-    dnC++;
-  }
+  psiCurrent=contractAll(Dets[0]->detValues,Dets[1]->detValues
+                         ,Dets[0]->grads,Dets[1]->grads,Dets[0]->lapls,Dets[1]->lapls,myG,myL);
   ValueType psiinv = 1.0/psiCurrent;
   myG *= psiinv;
   myL *= psiinv;
@@ -286,49 +284,23 @@ OrbitalBase::GradType MultiSlaterDeterminantFast::evalGrad(ParticleSet& P, int i
   {
     APP_ABORT("Fast MSD+BF: evalGrad not implemented. \n");
   }
+  const int s=DetID[iat];
+  Dets[s]->evaluateGrads(P,iat);
+  if(!ContractedCValid[s])
+    contractC(s,Dets[1-s]->detValues);
+  const ValueVector_t& cs(ContractedC[s]);
+  ValueVector_t& detValues_s = Dets[s]->detValues;
+  GradMatrix_t& grads_s = Dets[s]->grads;
+  const int k=iat-Dets[s]->FirstIndex;
+  ValueType psi=0.0;
   GradType grad_iat;
-  if(DetID[iat] == 0)
+  for(int u=0; u<cs.size(); u++)
   {
-    Dets[0]->evaluateGrads(P,iat);
-    ValueVector_t& detValues_up = Dets[0]->detValues;
-    ValueVector_t& detValues_dn = Dets[1]->detValues;
-    GradMatrix_t& grads_up = Dets[0]->grads;
-    int N1 = Dets[0]->FirstIndex;
-    ValueType psi=0.0;
-    vector<int>::iterator upC(C2node_up.begin()),dnC(C2node_dn.begin());
-    vector<RealType>::iterator it(C.begin()),last(C.end());
-    while(it != last)
-    {
-      psi += (*it)*detValues_up[*upC]*detValues_dn[*dnC];
-      grad_iat += (*it)*grads_up(*upC,iat-N1)*detValues_dn[*dnC];
-      it++;
-      upC++;
-      dnC++;
-    }
-    grad_iat *= 1.0/psi;
-    return grad_iat;
-  }
-  else
-  {
-    Dets[1]->evaluateGrads(P,iat);
-    ValueType psi=0.0;
-    ValueVector_t& detValues_up = Dets[0]->detValues;
-    ValueVector_t& detValues_dn = Dets[1]->detValues;
-    GradMatrix_t& grads_dn = Dets[1]->grads;
-    int N2 = Dets[1]->FirstIndex;
-    vector<int>::iterator upC(C2node_up.begin()),dnC(C2node_dn.begin());
-    vector<RealType>::iterator it(C.begin()),last(C.end());
-    while(it != last)
-    {
-      psi += (*it)*detValues_up[*upC]*detValues_dn[*dnC];
-      grad_iat += (*it)*grads_dn(*dnC,iat-N2)*detValues_up[*upC];
-      it++;
-      upC++;
-      dnC++;
-    }
-    grad_iat *= 1.0/psi;
-    return grad_iat;
+    psi += cs[u]*detValues_s[u];
+    grad_iat += cs[u]*grads_s(u,k);
   }
+  grad_iat *= 1.0/psi;
+  return grad_iat;
 }
 
 OrbitalBase::ValueType MultiSlaterDeterminantFast::ratioGrad(ParticleSet& P
@@ -339,66 +311,31 @@ OrbitalBase::ValueType MultiSlaterDeterminantFast::ratioGrad(ParticleSet& P
     APP_ABORT("Fast MSD+BF: ratioGrad not implemented. \n");
   }
   UpdateMode=ORB_PBYP_PARTIAL;
-  if(DetID[iat] == 0)
-  {
-    RatioGradTimer.start();
-    Ratio1GradTimer.start();
-    Dets[0]->evaluateDetsAndGradsForPtclMove(P,iat);
-    Ratio1GradTimer.stop();
-    ValueVector_t& detValues_up = Dets[0]->new_detValues;
-    ValueVector_t& detValues_dn = Dets[1]->detValues;
-    GradMatrix_t& grads_up = Dets[0]->new_grads;
-    int N1 = Dets[0]->FirstIndex;
-    vector<int>::iterator upC(C2node_up.begin()),dnC(C2node_dn.begin());
-    vector<RealType>::iterator it(C.begin()),last(C.end());
-    ValueType psiNew=0.0;
-    GradType dummy;
-    it=C.begin();
-    last=C.end();
-    while(it != last)
-    {
-      psiNew += (*it)*detValues_up[*upC]*detValues_dn[*dnC];
-      dummy += (*it)*grads_up(*upC,iat-N1)*detValues_dn[*dnC];
-      it++;
-      upC++;
-      dnC++;
-    }
-    grad_iat+=dummy/psiNew;
-    curRatio = psiNew/psiCurrent;
-    RatioGradTimer.stop();
-    return curRatio;
-  }
-  else
-  {
-    RatioGradTimer.start();
-    Ratio1GradTimer.start();
-    Dets[1]->evaluateDetsAndGradsForPtclMove(P,iat);
-    Ratio1GradTimer.stop();
-    ValueVector_t& detValues_up = Dets[0]->detValues;
-    ValueVector_t& detValues_dn = Dets[1]->new_detValues;
-    GradMatrix_t& grads_dn = Dets[1]->new_grads;
-    int N2 = Dets[1]->FirstIndex;
-    vector<int>::iterator upC(C2node_up.begin()),dnC(C2node_dn.begin());
-    vector<RealType>::iterator it(C.begin()),last(C.end());
-    ValueType psiNew=0.0;
-    GradType dummy;
-    while(it != last)
-    {
-      psiNew += (*it)*detValues_up[*upC]*detValues_dn[*dnC];
-      dummy += (*it)*grads_dn(*dnC,iat-N2)*detValues_up[*upC];
-      it++;
-      upC++;
-      dnC++;
-    }
-    grad_iat+=dummy/psiNew;
-    curRatio = psiNew/psiCurrent;
-    RatioGradTimer.stop();
-    return curRatio;
-  }
+  const int s=DetID[iat];
+  RatioGradTimer.start();
+  Ratio1GradTimer.start();
+  Dets[s]->evaluateDetsAndGradsForPtclMove(P,iat);
+  Ratio1GradTimer.stop();
+  if(!ContractedCValid[s])
+    contractC(s,Dets[1-s]->detValues);
+  const ValueVector_t& cs(ContractedC[s]);
+  ValueVector_t& detValues_s = Dets[s]->new_detValues;
+  GradMatrix_t& grads_s = Dets[s]->new_grads;
+  const int k=iat-Dets[s]->FirstIndex;
+  ValueType psiNew=0.0;
+  GradType dummy;
+  for(int u=0; u<cs.size(); u++)
+  {
+    psiNew += cs[u]*detValues_s[u];
+    dummy += cs[u]*grads_s(u,k);
+  }
+  grad_iat+=dummy/psiNew;
+  curRatio = psiNew/psiCurrent;
+  RatioGradTimer.stop();
+  return curRatio;
 }
 
 
-// This routine need work, sloppy for now
 OrbitalBase::ValueType  MultiSlaterDeterminantFast::ratio(ParticleSet& P, int iat
     , ParticleSet::ParticleGradient_t& dG,ParticleSet::ParticleLaplacian_t& dL)
 {
@@ -407,116 +344,30 @@ OrbitalBase::ValueType  MultiSlaterDeterminantFast::ratio(ParticleSet& P, int ia
     APP_ABORT("Fast MSD+BF: ratio(P,dG,dL) not implemented. \n");
   }
   UpdateMode=ORB_PBYP_ALL;
-  if(DetID[iat] == 0)
-  {
-    RatioAllTimer.start();
-    /*
-          P.acceptMove(iat);
-          Dets[0]->evaluateForWalkerMove(P);
-          ValueVector_t& detValues_up = Dets[0]->detValues;
-          ValueVector_t& detValues_dn = Dets[1]->detValues;
-          GradMatrix_t& grads_up = Dets[0]->grads;
-          GradMatrix_t& grads_dn = Dets[1]->grads;
-          ValueMatrix_t& lapls_up = Dets[0]->lapls;
-          ValueMatrix_t& lapls_dn = Dets[1]->lapls;
-    */
-//*
-    Ratio1AllTimer.start();
-    Dets[0]->evaluateAllForPtclMove(P,iat);
-    Ratio1AllTimer.stop();
-    ValueVector_t& detValues_up = Dets[0]->new_detValues;
-    ValueVector_t& detValues_dn = Dets[1]->detValues;
-    GradMatrix_t& grads_up = Dets[0]->new_grads;
-    GradMatrix_t& grads_dn = Dets[1]->grads;
-    ValueMatrix_t& lapls_up = Dets[0]->new_lapls;
-    ValueMatrix_t& lapls_dn = Dets[1]->lapls;
-//*/
-    int N1 = Dets[0]->FirstIndex;
-    int N2 = Dets[1]->FirstIndex;
-    int NP1 = Dets[0]->NumPtcls;
-    int NP2 = Dets[1]->NumPtcls;
-    ValueType psiNew=0.0;
-    // myG,myL should contain current grad and lapl
-    vector<int>::iterator upC(C2node_up.begin()),dnC(C2node_dn.begin());
-    vector<RealType>::iterator it(C.begin()),last(C.end());
-    myG_temp=0.0;
-    myL_temp=0.0;
-    while(it != last)
-    {
-      psiNew += (*it)*detValues_up[*upC]*detValues_dn[*dnC];
-      for(int k=0,n=N1; k<NP1; k++,n++)
-      {
-        myG_temp(n) += (*it)*grads_up(*upC,k)*detValues_dn[*dnC];
-        myL_temp(n) += (*it)*lapls_up(*upC,k)*detValues_dn[*dnC];
-      }
-      for(int k=0,n=N2; k<NP2; k++,n++)
-      {
-        myG_temp(n) += (*it)*grads_dn(*dnC,k)*detValues_up[*upC];
-        myL_temp(n) += (*it)*lapls_dn(*dnC,k)*detValues_up[*upC];
-      }
-      it++;
-      upC++;
-      dnC++;
-    }
-    ValueType psiNinv=1.0/psiNew;
-    myG_temp *= psiNinv;
-    myL_temp *= psiNinv;
-    dG += myG_temp-myG;
-    for(int i=0; i<dL.size(); i++)
-      dL(i) += myL_temp[i] - myL[i] - dot(myG_temp[i],myG_temp[i]) + dot(myG[i],myG[i]);
-    curRatio = psiNew/psiCurrent;
-    RatioAllTimer.stop();
-    return curRatio;
-  }
+  const int s=DetID[iat];
+  RatioAllTimer.start();
+  Ratio1AllTimer.start();
+  Dets[s]->evaluateAllForPtclMove(P,iat);
+  Ratio1AllTimer.stop();
+  MultiDiracDeterminantBase& up(*Dets[0]);
+  MultiDiracDeterminantBase& dn(*Dets[1]);
+  ValueType psiNew;
+  // myG,myL should contain current grad and lapl
+  if(s == 0)
+    psiNew=contractAll(up.new_detValues,dn.detValues,up.new_grads,dn.grads,up.new_lapls,dn.lapls,myG_temp,myL_temp);
   else
-  {
-    RatioAllTimer.start();
-    Ratio1AllTimer.start();
-    Dets[1]->evaluateAllForPtclMove(P,iat);
-    Ratio1AllTimer.stop();
-    ValueVector_t& detValues_up = Dets[0]->detValues;
-    ValueVector_t& detValues_dn = Dets[1]->new_detValues;
-    GradMatrix_t& grads_up = Dets[0]->grads;
-    GradMatrix_t& grads_dn = Dets[1]->new_grads;
-    ValueMatrix_t& lapls_up = Dets[0]->lapls;
-    ValueMatrix_t& lapls_dn = Dets[1]->new_lapls;
-    int N1 = Dets[0]->FirstIndex;
-    int N2 = Dets[1]->FirstIndex;
-    int NP1 = Dets[0]->NumPtcls;
-    int NP2 = Dets[1]->NumPtcls;
-    ValueType psiNew=0.0;
-    // myG,myL should contain current grad and lapl
-    vector<int>::iterator upC(C2node_up.begin()),dnC(C2node_dn.begin());
-    vector<RealType>::iterator it(C.begin()),last(C.end());
-    myG_temp=0.0;
-    myL_temp=0.0;
-    while(it != last)
-    {
-      psiNew += (*it)*detValues_up[*upC]*detValues_dn[*dnC];
-      for(int k=0,n=N1; k<NP1; k++,n++)
-      {
-        myG_temp(n) += (*it)*grads_up(*upC,k)*detValues_dn[*dnC];
-        myL_temp(n) += (*it)*lapls_up(*upC,k)*detValues_dn[*dnC];
-      }
-      for(int k=0,n=N2; k<NP2; k++,n++)
-      {
-        myG_temp(n) += (*it)*grads_dn(*dnC,k)*detValues_up[*upC];
-        myL_temp(n) += (*it)*lapls_dn(*dnC,k)*detValues_up[*upC];
-      }
-      it++;
-      upC++;
-      dnC++;
-    }
-    ValueType psiNinv=1.0/psiNew;
-    myG_temp *= psiNinv;
-    myL_temp *= psiNinv;
-    dG += myG_temp-myG;
-    for(int i=0; i<dL.size(); i++)
-      dL(i) += myL_temp[i] - myL[i] - dot(myG_temp[i],myG_temp[i]) + dot(myG[i],myG[i]);
-    curRatio = psiNew/psiCurrent;
-    RatioAllTimer.stop();
-    return curRatio;
-  }
+    psiNew=contractAll(up.detValues,dn.new_detValues,up.grads,dn.new_grads,up.lapls,dn.new_lapls,myG_temp,myL_temp);
+  //contracted with the proposed determinants of the moved spin
+  ContractedCValid[1-s]=false;
+  ValueType psiNinv=1.0/psiNew;
+  myG_temp *= psiNinv;
+  myL_temp *= psiNinv;
+  dG += myG_temp-myG;
+  for(int i=0; i<dL.size(); i++)
+    dL(i) += myL_temp[i] - myL[i] - dot(myG_temp[i],myG_temp[i]) + dot(myG[i],myG[i]);
+  curRatio = psiNew/psiCurrent;
+  RatioAllTimer.stop();
+  return curRatio;
 }
 
 // use ci_node for this routine only
@@ -529,40 +380,18 @@ OrbitalBase::ValueType MultiSlaterDeterminantFast::ratio(ParticleSet& P, int iat
     APP_ABORT("Fast MSD+BF: ratio not implemented. \n");
   }
   UpdateMode=ORB_PBYP_RATIO;
-  if(DetID[iat] == 0)
-  {
-    RatioTimer.start();
-    Ratio1Timer.start();
-    Dets[0]->evaluateDetsForPtclMove(P,iat);
-    Ratio1Timer.stop();
-    ValueVector_t& detValues_up = Dets[0]->new_detValues;
-    ValueVector_t& detValues_dn = Dets[1]->detValues;
-    ValueType psiNew=0.0;
-    vector<int>::iterator upC(C2node_up.begin()),dnC(C2node_dn.begin());
-    vector<RealType>::iterator it(C.begin()),last(C.end());
-    while(it != last)
-      psiNew += (*(it++))*detValues_up[*(upC++)]*detValues_dn[*(dnC++)];
-    curRatio = psiNew/psiCurrent;
-    RatioTimer.stop();
-    return curRatio;
-  }
-  else
-  {
-    RatioTimer.start();
-    Ratio1Timer.start();
-    Dets[1]->evaluateDetsForPtclMove(P,iat);
-    Ratio1Timer.stop();
-    ValueVector_t& detValues_up = Dets[0]->detValues;
-    ValueVector_t& detValues_dn = Dets[1]->new_detValues;
-    ValueType psiNew=0.0;
-    vector<int>::iterator upC(C2node_up.begin()),dnC(C2node_dn.begin());
-    vector<RealType>::iterator it(C.begin()),last(C.end());
-    while(it != last)
-      psiNew += (*(it++))*detValues_up[*(upC++)]*detValues_dn[*(dnC++)];
-    curRatio = psiNew/psiCurrent;
-    RatioTimer.stop();
-    return curRatio;
-  }
+  const int s=DetID[iat];
+  RatioTimer.start();
+  Ratio1Timer.start();
+  Dets[s]->evaluateDetsForPtclMove(P,iat);
+  Ratio1Timer.stop();
+  if(!ContractedCValid[s])
+    contractC(s,Dets[1-s]->detValues);
+  ValueVector_t& detValues_s = Dets[s]->new_detValues;
+  ValueType psiNew=simd::dot(ContractedC[s].data(),detValues_s.data(),detValues_s.size());
+  curRatio = psiNew/psiCurrent;
+  RatioTimer.stop();
+  return curRatio;
 }
 
 void MultiSlaterDeterminantFast::acceptMove(ParticleSet& P, int iat)
@@ -578,6 +407,7 @@ void MultiSlaterDeterminantFast::acceptMove(ParticleSet& P, int iat)
   psiCurrent *= curRatio;
   curRatio=1.0;
   Dets[DetID[iat]]->acceptMove(P,iat);
+  ContractedCValid[1-DetID[iat]]=false;
   switch(UpdateMode)
   {
   case ORB_PBYP_ALL:
@@ -694,39 +524,8 @@ OrbitalBase::RealType MultiSlaterDeterminantFast::updateBuffer(ParticleSet& P, B
   Dets[1]->updateBuffer(P,buf,fromscratch);
   //Dets[0]->updateBuffer(P,buf,true);
   //Dets[1]->updateBuffer(P,buf,true);
-  // can this change over time??? I don't know yet
-  ValueVector_t& detValues_up = Dets[0]->detValues;
-  ValueVector_t& detValues_dn = Dets[1]->detValues;
-  GradMatrix_t& grads_up = Dets[0]->grads;
-  GradMatrix_t& grads_dn = Dets[1]->grads;
-  ValueMatrix_t& lapls_up = Dets[0]->lapls;
-  ValueMatrix_t& lapls_dn = Dets[1]->lapls;
-  int N1 = Dets[0]->FirstIndex;
-  int N2 = Dets[1]->FirstIndex;
-  int NP1 = Dets[0]->NumPtcls;
-  int NP2 = Dets[1]->NumPtcls;
-  psiCurrent=0.0;
-  myG=0.0;
-  myL=0.0;
-  vector<int>::iterator upC(C2node_up.begin()),dnC(C2node_dn.begin());
-  vector<RealType>::iterator it(C.begin()),last(C.end());
-  while(it != last)
-  {
-    psiCurrent += (*it)*detValues_up[*upC]*detValues_dn[*dnC];
-    for(int k=0,n=N1; k<NP1; k++,n++)
-    {
-      myG(n) += (*it)*grads_up(*upC,k)*detValues_dn[*dnC];
-      myL(n) += (*it)*lapls_up(*upC,k)*detValues_dn[*dnC];
-    }
-    for(int k=0,n=N2; k<NP2; k++,n++)
-    {
-      myG(n) += (*it)*grads_dn(*dnC,k)*detValues_up[*upC];
-      myL(n) += (*it)*lapls_dn(*dnC,k)*detValues_up[*upC];
-    }
-    it++;
-    upC++;
-    dnC++;
-  }
+  psiCurrent=contractAll(Dets[0]->detValues,Dets[1]->detValues
+                         ,Dets[0]->grads,Dets[1]->grads,Dets[0]->lapls,Dets[1]->lapls,myG,myL);
   ValueType psiinv = 1.0/psiCurrent;
   myG *= psiinv;
   myL *= psiinv;
@@ -751,6 +550,7 @@ void MultiSlaterDeterminantFast::copyFromBuffer(ParticleSet& P, BufferType& buf)
   buf.get(psiCurrent);
   buf.get(myL.first_address(), myL.last_address());
   buf.get(FirstAddressOfG,LastAddressOfG);
+  ContractedCValid[0]=ContractedCValid[1]=false;
 }
 
 
@@ -808,6 +608,7 @@ void MultiSlaterDeterminantFast::resetParameters(const opt_variables_type& activ
       }
       //for(int i=0; i<Dets.size(); i++) Dets[i]->resetParameters(active);
     }
+    ContractedCValid[0]=ContractedCValid[1]=false;
   }
 }
 void MultiSlaterDeterminantFast::reportStatus(ostream& os)
@@ -153,6 +153,18 @@ public:
 
   void testMSD(ParticleSet& P, int iat);
 
+  /** contract C over the determinants of the other spin
+   * @param s spin
+   * @param detValues_o values of the unique determinants of the spin 1-s
+   */
+  void contractC(int s, const ValueVector_t& detValues_o);
+
+  ///rebuild ContractedC and return psi with the unnormalized gradients and laplacians
+  ValueType contractAll(ValueVector_t& detValues_up, ValueVector_t& detValues_dn,
+                        GradMatrix_t& grads_up, GradMatrix_t& grads_dn,
+                        ValueMatrix_t& lapls_up, ValueMatrix_t& lapls_dn,
+                        ParticleSet::ParticleGradient_t& g, ParticleSet::ParticleLaplacian_t& l);
+
   int NP;
   int nels_up,nels_dn;
   int FirstIndex_up;
@@ -172,6 +184,16 @@ public:
 
   vector<RealType> C;
 
+  /** C contracted with the unique determinants of the other spin
+   *
+   * ContractedC[0][u]=\f$\sum_{I, up(I)=u} C_I D^{dn}_{dn(I)}\f$ and similarly for ContractedC[1].
+   * A move of a spin-s electron only changes the unique determinants of the spin s,
+   * so that psi and its gradient are sums over the unique determinants of the spin s.
+   */
+  ValueVector_t ContractedC[2];
+  ///true, if ContractedC[s] is consistent with the current determinants of the spin 1-s
+  bool ContractedCValid[2];
+
   ValueType curRatio;
   ValueType psiCurrent;
 
@@ -63,6 +63,15 @@ public:
    * @param iat the particle thas is being moved
    */
   ValueType ratio(ParticleSet& P, int iat);
+
+  /** evaluate the ratios of the virtual moves by the per-point ratio
+   *
+   * The batched DiracDeterminantBase::evaluateRatios does not apply to the released-node ratio.
+   */
+  void evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios)
+  {
+    OrbitalBase::evaluateRatios(VP,ratios);
+  }
   void restore(int iat);
   RealType getAlternatePhaseDiff()
   {
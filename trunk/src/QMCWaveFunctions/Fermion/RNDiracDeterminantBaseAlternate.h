@@ -65,6 +65,15 @@ public:
    */
   ValueType ratio(ParticleSet& P, int iat);
 
+  /** evaluate the ratios of the virtual moves by the per-point ratio
+   *
+   * The batched DiracDeterminantBase::evaluateRatios does not apply to the released-node ratio.
+   */
+  void evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios)
+  {
+    OrbitalBase::evaluateRatios(VP,ratios);
+  }
+
   ValueType alternateRatio(ParticleSet& P);
 
   /** return the ratio
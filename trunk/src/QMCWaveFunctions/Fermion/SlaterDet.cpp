@@ -18,6 +18,7 @@
 #include "QMCWaveFunctions/Fermion/RNDiracDeterminantBaseAlternate.h"
 #include "Message/Communicate.h"
 #include "Utilities/OhmmsInfo.h"
+#include <typeinfo>
 
 namespace qmcplusplus
 {
@@ -128,6 +129,55 @@ void SlaterDet::get_ratios(ParticleSet& P, vector<ValueType>& ratios)
     Dets[i]->get_ratios(P, ratios);
 }
 
+/** collect the determinants of the iat-th particle of the crowd
+ * @return false, if a derived class handles the moves by itself
+ */
+inline bool getDetList(const SlaterDet& sd, const vector<OrbitalBase*>& wfc_list, int iat
+                       , vector<OrbitalBase*>& det_list)
+{
+  if(typeid(sd)!=typeid(SlaterDet))
+    return false;
+  det_list.resize(wfc_list.size());
+  for (int iw=0; iw<wfc_list.size(); ++iw)
+  {
+    SlaterDet& w(static_cast<SlaterDet&>(*wfc_list[iw]));
+    det_list[iw]=w.Dets[w.DetID[iat]];
+  }
+  return true;
+}
+
+void SlaterDet::mw_ratio(const vector<OrbitalBase*>& wfc_list,
+                         const vector<ParticleSet*>& P_list, int iat, vector<ValueType>& ratios)
+{
+  vector<OrbitalBase*> det_list;
+  if(getDetList(*this,wfc_list,iat,det_list))
+    det_list[0]->mw_ratio(det_list,P_list,iat,ratios);
+  else
+    OrbitalBase::mw_ratio(wfc_list,P_list,iat,ratios);
+}
+
+void SlaterDet::mw_ratioGrad(const vector<OrbitalBase*>& wfc_list,
+                             const vector<ParticleSet*>& P_list, int iat,
+                             vector<ValueType>& ratios, vector<GradType>& grad_new)
+{
+  vector<OrbitalBase*> det_list;
+  if(getDetList(*this,wfc_list,iat,det_list))
+    det_list[0]->mw_ratioGrad(det_list,P_list,iat,ratios,grad_new);
+  else
+    OrbitalBase::mw_ratioGrad(wfc_list,P_list,iat,ratios,grad_new);
+}
+
+void SlaterDet::mw_acceptMove(const vector<OrbitalBase*>& wfc_list,
+                              const vector<ParticleSet*>& P_list, int iat,
+                              const vector<bool>& isAccepted)
+{
+  vector<OrbitalBase*> det_list;
+  if(getDetList(*this,wfc_list,iat,det_list))
+    det_list[0]->mw_acceptMove(det_list,P_list,iat,isAccepted);
+  else
+    OrbitalBase::mw_acceptMove(wfc_list,P_list,iat,isAccepted);
+}
+
 SlaterDet::ValueType SlaterDet::evaluate(ParticleSet& P,
     ParticleSet::ParticleGradient_t& G, ParticleSet::ParticleLaplacian_t& L)
 {
@@ -233,6 +283,73 @@ void SlaterDet::copyFromBuffer(ParticleSet& P, PooledData<RealType>& buf)
   DEBUG_PSIBUFFER(" SlaterDet::copyFromBuffer ",buf.current());
 }
 
+WalkerResource* SlaterDet::makeResource(ParticleSet& P)
+{
+  if(typeid(*this)!=typeid(SlaterDet))
+    return OrbitalBase::makeResource(P);
+  WalkerResourceSet* res=new WalkerResourceSet;
+  LogValue = 0.0;
+  PhaseValue = 0.0;
+  for (int i = 0; i < Dets.size(); ++i)
+  {
+    res->push_back(Dets[i]->makeResource(P));
+    LogValue += Dets[i]->LogValue;
+    PhaseValue += Dets[i]->PhaseValue;
+  }
+  return res;
+}
+
+void SlaterDet::bindResource(ParticleSet& P, WalkerResource& r)
+{
+  if(typeid(*this)!=typeid(SlaterDet))
+  {
+    OrbitalBase::bindResource(P,r);
+    return;
+  }
+  WalkerResourceSet& res(static_cast<WalkerResourceSet&>(r));
+  for (int i = 0; i < Dets.size(); ++i)
+    Dets[i]->bindResource(P,res[i]);
+}
+
+SlaterDet::RealType SlaterDet::storeResource(ParticleSet& P, WalkerResource& r)
+{
+  if(typeid(*this)!=typeid(SlaterDet))
+    return OrbitalBase::storeResource(P,r);
+  WalkerResourceSet& res(static_cast<WalkerResourceSet&>(r));
+  LogValue = 0.0;
+  PhaseValue = 0.0;
+  for (int i = 0; i < Dets.size(); ++i)
+  {
+    LogValue += Dets[i]->storeResource(P,res[i]);
+    PhaseValue += Dets[i]->PhaseValue;
+  }
+  return LogValue;
+}
+
+SlaterDet::RealType SlaterDet::updateResource(ParticleSet& P, WalkerResource& r, bool fromscratch)
+{
+  if(typeid(*this)!=typeid(SlaterDet))
+    return OrbitalBase::updateResource(P,r,fromscratch);
+  WalkerResourceSet& res(static_cast<WalkerResourceSet&>(r));
+  LogValue = 0.0;
+  PhaseValue = 0.0;
+  for (int i = 0; i < Dets.size(); ++i)
+  {
+    LogValue += Dets[i]->updateResource(P,res[i],fromscratch);
+    PhaseValue += Dets[i]->PhaseValue;
+  }
+  return LogValue;
+}
+
+void SlaterDet::releaseResource(ParticleSet& P, WalkerResource& r)
+{
+  if(typeid(*this)!=typeid(SlaterDet))
+    return;
+  WalkerResourceSet& res(static_cast<WalkerResourceSet&>(r));
+  for (int i = 0; i < Dets.size(); ++i)
+    Dets[i]->releaseResource(P,res[i]);
+}
+
 /** reimplements the virtual function
  *
  * The DiractDeterminants of SlaterDet need to save the inverse
@@ -126,6 +126,20 @@ public:
   virtual
   void copyFromBuffer(ParticleSet& P, PooledData<RealType>& buf);
 
+  /** create a WalkerResourceSet of the resources of Dets
+   *
+   * Derived classes with their own data use the buffer of OrbitalBase.
+   */
+  virtual WalkerResource* makeResource(ParticleSet& P);
+
+  virtual void bindResource(ParticleSet& P, WalkerResource& res);
+
+  virtual RealType storeResource(ParticleSet& P, WalkerResource& res);
+
+  virtual RealType updateResource(ParticleSet& P, WalkerResource& res, bool fromscratch);
+
+  virtual void releaseResource(ParticleSet& P, WalkerResource& res);
+
   virtual
   void dumpToBuffer(ParticleSet& P, PooledData<RealType>& buf);
 
@@ -227,6 +241,12 @@ public:
     return Dets[DetID[iat]]->ratio(P,iat);
   }
 
+  virtual
+  inline void evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios)
+  {
+    Dets[DetID[VP.refPtcl]]->evaluateRatios(VP,ratios);
+  }
+
   virtual
   inline ValueType alternateRatio(ParticleSet& P)
   {
@@ -264,6 +284,21 @@ public:
   virtual
   void get_ratios(ParticleSet& P, vector<ValueType>& ratios);
 
+  ///forward the crowd to the determinants of the iat-th particle
+  virtual
+  void mw_ratio(const vector<OrbitalBase*>& wfc_list,
+                const vector<ParticleSet*>& P_list, int iat, vector<ValueType>& ratios);
+
+  virtual
+  void mw_ratioGrad(const vector<OrbitalBase*>& wfc_list,
+                    const vector<ParticleSet*>& P_list, int iat,
+                    vector<ValueType>& ratios, vector<GradType>& grad_new);
+
+  virtual
+  void mw_acceptMove(const vector<OrbitalBase*>& wfc_list,
+                     const vector<ParticleSet*>& P_list, int iat,
+                     const vector<bool>& isAccepted);
+
   void evaluateDerivatives(ParticleSet& P,
                            const opt_variables_type& active,
                            vector<RealType>& dlogpsi,
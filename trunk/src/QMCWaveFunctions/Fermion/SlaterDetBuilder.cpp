@@ -45,6 +45,7 @@
 #include "QMCWaveFunctions/Fermion/SPOSetProxyForMSD.h"
 #include "QMCWaveFunctions/Fermion/DiracDeterminantOpt.h"
 #include "QMCWaveFunctions/Fermion/DiracDeterminantAFM.h"
+#include "QMCWaveFunctions/Fermion/DiracDeterminantMixed.h"
 
 #include <bitset>
 
@@ -355,12 +356,18 @@ bool SlaterDetBuilder::putDeterminant(xmlNodePtr cur, int spin_group)
   string s_radius("0.0");
   int s_smallnumber(-999999);
   int rntype(0);
+  int delay_rank(0);
+  string precision("double");
+  int recompute(10);
   aAttrib.add(s_cutoff,"Cutoff");
   aAttrib.add(s_radius,"Radius");
   aAttrib.add(s_smallnumber,"smallnumber");
   aAttrib.add(s_smallnumber,"eps");
   aAttrib.add(rntype,"primary");
   aAttrib.add(spin_group,"group");
+  aAttrib.add(delay_rank,"delay");
+  aAttrib.add(precision,"precision");
+  aAttrib.add(recompute,"recompute");
   aAttrib.put(cur);
 
   app_log() << "  Creating a determinant for " << spin_group << " group." << endl;
@@ -459,10 +466,34 @@ bool SlaterDetBuilder::putDeterminant(xmlNodePtr cur, int spin_group)
         if (psi->Optimizable)
           adet = new DiracDeterminantOpt(targetPtcl, psi, firstIndex);
         else
-          adet = new DiracDeterminantBase(psi,firstIndex);
+          if (precision=="mixed")
+          {
+            app_log() << "  Using the single-precision inverse with the double-precision recompute="
+                      << recompute << endl;
+            DiracDeterminantMixed* mdet=new DiracDeterminantMixed(psi,firstIndex);
+            mdet->setRecomputeInterval(recompute);
+            adet=mdet;
+            precision="double";
+          }
+          else
+          {
+            adet = new DiracDeterminantBase(psi,firstIndex);
+            if(delay_rank>1)
+            {
+              app_log() << "  Using delayed updates of the inverse with delay=" << delay_rank << endl;
+              adet->setDelayRank(delay_rank);
+            }
+            delay_rank=0;
+          }
 #endif
   }
   adet->set(firstIndex,lastIndex-firstIndex);
+  if(delay_rank>1)
+    app_warning() << "  Delayed updates are not supported by " << adet->OrbitalName
+                  << ". Ignoring delay=" << delay_rank << endl;
+  if(precision=="mixed")
+    app_warning() << "  The single-precision inverse is not supported by " << adet->OrbitalName
+                  << ". Ignoring precision=\"mixed\"" << endl;
   slaterdet_0->add(adet,spin_group);
   if (psi->Optimizable)
     slaterdet_0->Optimizable = true;
@@ -184,6 +184,12 @@ public:
     return ratio;
   }
 
+  /** a move changes the quasi-particles of all the determinants: use the per-point ratio */
+  inline void evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios)
+  {
+    OrbitalBase::evaluateRatios(VP,ratios);
+  }
+
   inline ValueType alternateRatio(ParticleSet& P)
   {
     APP_ABORT("Need to implement SlaterDetWithBackflow::alternateRatio() \n");
@@ -19,6 +19,7 @@
 #include "Utilities/ProgressReportEngine.h"
 #include "OhmmsData/AttributeSet.h"
 #include "Numerics/LinearFit.h"
+#include "QMCWaveFunctions/Jastrow/JastrowFunctorBatch.h"
 #include <cstdio>
 
 namespace qmcplusplus
@@ -185,6 +186,89 @@ struct BsplineFunctor: public OptimizableFunctorBase
   }
 
 
+  /** evaluate u(r) for n distances
+   *
+   * The distances beyond the cutoff are mapped to the first interval and
+   * masked so that the loop has no branch and can be vectorized.
+   */
+  inline void evaluateV(int n, const real_type* restrict r, real_type* restrict u)
+  {
+    const real_type* restrict coefs=&SplineCoefs[0];
+    const real_type rcut=cutoff_radius;
+    const real_type a0=A[ 0], a1=A[ 1], a2=A[ 2], a3=A[ 3];
+    const real_type a4=A[ 4], a5=A[ 5], a6=A[ 6], a7=A[ 7];
+    const real_type a8=A[ 8], a9=A[ 9], a10=A[10], a11=A[11];
+    const real_type a12=A[12], a13=A[13], a14=A[14], a15=A[15];
+    for(int j=0; j<n; ++j)
+    {
+      const bool inside=r[j]<rcut;
+      const real_type x=inside? r[j]*DeltaRInv:real_type(0);
+      const int i=static_cast<int>(x);
+      const real_type t=x-static_cast<real_type>(i);
+      const real_type t2=t*t;
+      const real_type t3=t2*t;
+      const real_type v=
+        coefs[i+0]*(a0 *t3 + a1 *t2 + a2 *t + a3 )+
+        coefs[i+1]*(a4 *t3 + a5 *t2 + a6 *t + a7 )+
+        coefs[i+2]*(a8 *t3 + a9 *t2 + a10*t + a11)+
+        coefs[i+3]*(a12*t3 + a13*t2 + a14*t + a15);
+      u[j]=inside? v:real_type(0);
+    }
+  }
+
+  /** evaluate u(r), du/dr and d2u/dr2 for n distances
+   *
+   * Same as evaluate(r,dudr,d2udr2) for each distance.
+   */
+  inline void evaluateVGL(int n, const real_type* restrict r, real_type* restrict u
+                          , real_type* restrict du, real_type* restrict d2u)
+  {
+    const real_type* restrict coefs=&SplineCoefs[0];
+    const real_type rcut=cutoff_radius;
+    const real_type dinv2=DeltaRInv*DeltaRInv;
+    const real_type a0=A[ 0], a1=A[ 1], a2=A[ 2], a3=A[ 3];
+    const real_type a4=A[ 4], a5=A[ 5], a6=A[ 6], a7=A[ 7];
+    const real_type a8=A[ 8], a9=A[ 9], a10=A[10], a11=A[11];
+    const real_type a12=A[12], a13=A[13], a14=A[14], a15=A[15];
+    const real_type da1=dA[ 1], da2=dA[ 2], da3=dA[ 3];
+    const real_type da5=dA[ 5], da6=dA[ 6], da7=dA[ 7];
+    const real_type da9=dA[ 9], da10=dA[10], da11=dA[11];
+    const real_type da13=dA[13], da14=dA[14], da15=dA[15];
+    const real_type d2a2=d2A[ 2], d2a3=d2A[ 3];
+    const real_type d2a6=d2A[ 6], d2a7=d2A[ 7];
+    const real_type d2a10=d2A[10], d2a11=d2A[11];
+    const real_type d2a14=d2A[14], d2a15=d2A[15];
+    for(int j=0; j<n; ++j)
+    {
+      const bool inside=r[j]<rcut;
+      const real_type x=inside? r[j]*DeltaRInv:real_type(0);
+      const int i=static_cast<int>(x);
+      const real_type t=x-static_cast<real_type>(i);
+      const real_type t2=t*t;
+      const real_type t3=t2*t;
+      const real_type c0=coefs[i+0], c1=coefs[i+1], c2=coefs[i+2], c3=coefs[i+3];
+      const real_type v=
+        c0*(a0 *t3 + a1 *t2 + a2 *t + a3 )+
+        c1*(a4 *t3 + a5 *t2 + a6 *t + a7 )+
+        c2*(a8 *t3 + a9 *t2 + a10*t + a11)+
+        c3*(a12*t3 + a13*t2 + a14*t + a15);
+      const real_type dv=DeltaRInv*(
+                           c0*(da1 *t2 + da2 *t + da3 )+
+                           c1*(da5 *t2 + da6 *t + da7 )+
+                           c2*(da9 *t2 + da10*t + da11)+
+                           c3*(da13*t2 + da14*t + da15));
+      const real_type d2v=dinv2*(
+                            c0*(d2a2 *t + d2a3 )+
+                            c1*(d2a6 *t + d2a7 )+
+                            c2*(d2a10*t + d2a11)+
+                            c3*(d2a14*t + d2a15));
+      u[j]=inside? v:real_type(0);
+      du[j]=inside? dv:real_type(0);
+      d2u[j]=inside? d2v:real_type(0);
+    }
+  }
+
+
   inline real_type
   evaluate(real_type r, real_type& dudr, real_type& d2udr2, real_type &d3udr3)
   {
@@ -531,6 +615,24 @@ struct BsplineFunctor: public OptimizableFunctorBase
     }
   }
 };
+
+///batched evaluation of u(r) using BsplineFunctor::evaluateV
+template<class T>
+inline void evaluateV(BsplineFunctor<T>& f, int n, const OptimizableFunctorBase::real_type* restrict r
+                      , OptimizableFunctorBase::real_type* restrict u)
+{
+  f.evaluateV(n,r,u);
+}
+
+///batched evaluation of u(r), du/dr and d2u/dr2 using BsplineFunctor::evaluateVGL
+template<class T>
+inline void evaluateVGL(BsplineFunctor<T>& f, int n, const OptimizableFunctorBase::real_type* restrict r
+                        , OptimizableFunctorBase::real_type* restrict u
+                        , OptimizableFunctorBase::real_type* restrict du
+                        , OptimizableFunctorBase::real_type* restrict d2u)
+{
+  f.evaluateVGL(n,r,u,du,d2u);
+}
 }
 #endif
 /***************************************************************************
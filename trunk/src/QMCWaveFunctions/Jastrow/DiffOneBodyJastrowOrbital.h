@@ -58,7 +58,7 @@ public:
     :CenterRef(centers),NumVars(0)
   {
     NumPtcls=els.getTotalNum();
-    d_table=DistanceTable::add(centers,els);
+    d_table=els.DistTables[els.addTable(centers,-1,false)];
   }
 
   ~DiffOneBodyJastrowOrbital()
@@ -132,7 +132,7 @@ public:
   ///reset the distance table
   void resetTargetParticleSet(ParticleSet& P)
   {
-    d_table = DistanceTable::add(CenterRef,P);
+    d_table = P.DistTables[P.addTable(CenterRef,-1,false)];
   }
 
   void evaluateDerivatives(ParticleSet& P,
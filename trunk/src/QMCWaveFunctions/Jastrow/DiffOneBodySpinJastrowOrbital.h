@@ -62,7 +62,7 @@ public:
     :Spin(false),CenterRef(centers),NumVars(0),VarOffset(0)
   {
     NumPtcls=els.getTotalNum();
-    d_table=DistanceTable::add(centers,els);
+    d_table=els.DistTables[els.addTable(centers,-1,false)];
     F.resize(CenterRef.groups(), els.groups());
     for(int i=0; i<F.size(); ++i)
       F(i)=0;
@@ -164,7 +164,7 @@ public:
   ///reset the distance table
   void resetTargetParticleSet(ParticleSet& P)
   {
-    d_table = DistanceTable::add(CenterRef,P);
+    d_table = P.DistTables[P.addTable(CenterRef,-1,false)];
   }
 
   void evaluateDerivatives(ParticleSet& P,
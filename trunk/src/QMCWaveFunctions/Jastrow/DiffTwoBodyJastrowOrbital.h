@@ -57,7 +57,7 @@ public:
   {
     NumPtcls=p.getTotalNum();
     NumGroups=p.groups();
-    d_table=DistanceTable::add(p);
+    d_table=p.DistTables[p.addTable(p,-1,false)];
     F.resize(NumGroups*NumGroups,0);
   }
 
@@ -104,7 +104,7 @@ public:
   ///reset the distance table
   void resetTargetParticleSet(ParticleSet& P)
   {
-    d_table = DistanceTable::add(P);
+    d_table = P.DistTables[P.addTable(P,-1,false)];
   }
 
   void checkOutVariables(const opt_variables_type& active)
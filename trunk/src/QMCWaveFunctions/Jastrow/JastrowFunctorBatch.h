@@ -0,0 +1,64 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file JastrowFunctorBatch.h
+ * @brief batched evaluation of the radial functors for contiguous distances
+ *
+ * The generic functions call the scalar evaluate functions of a functor.
+ * A functor with a vectorized implementation provides overloads,
+ * e.g., BsplineFunctor.h.
+ */
+#ifndef QMCPLUSPLUS_JASTROW_FUNCTOR_BATCH_H
+#define QMCPLUSPLUS_JASTROW_FUNCTOR_BATCH_H
+
+namespace qmcplusplus
+{
+
+/** evaluate u(r) for n distances
+ * @param f functor
+ * @param n number of distances
+ * @param r distances
+ * @param u values
+ */
+template<typename FT, typename T>
+inline void evaluateV(FT& f, int n, const T* restrict r, T* restrict u)
+{
+  for(int i=0; i<n; ++i)
+    u[i]=f.evaluate(r[i]);
+}
+
+/** evaluate u(r), du/dr and d2u/dr2 for n distances
+ * @param f functor
+ * @param n number of distances
+ * @param r distances
+ * @param u values
+ * @param du first derivatives
+ * @param d2u second derivatives
+ */
+template<typename FT, typename T>
+inline void evaluateVGL(FT& f, int n, const T* restrict r
+                        , T* restrict u, T* restrict du, T* restrict d2u)
+{
+  for(int i=0; i<n; ++i)
+    u[i]=f.evaluate(r[i],du[i],d2u[i]);
+}
+
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -173,18 +173,19 @@ LRTwoBodyJastrow::ratio(ParticleSet& P, int iat)
 #if defined(USE_REAL_STRUCT_FACTOR)
   APP_ABORT("LRTwoBodyJastrow::ratio(ParticleSet& P, int iat)");
 #else
-  const KContainer::VContainer_t& kpts(P.SK->KLists.kpts_cart);
+  //eikr for the proposed move evaluated by ParticleSet::makeMove
+  const ComplexType* restrict eikr_new_ptr(P.SK->eikr_temp.data());
   const ComplexType* restrict eikr_ptr(P.SK->eikr[iat]);
   const ComplexType* restrict rhok_ptr(Rhok.data());
-  PosType pos(P.R[iat]);
   curVal=0.0;
   int ki=0;
   for(int ks=0; ks<MaxKshell; ks++)
   {
-    RealType dd=0.0,s,c;
-    for(; ki<Kshell[ks+1]; ki++,eikr_ptr++,rhok_ptr++)
+    RealType dd=0.0;
+    for(; ki<Kshell[ks+1]; ki++,eikr_ptr++,rhok_ptr++,eikr_new_ptr++)
     {
-      sincos(dot(kpts[ki],pos),&s,&c);
+      const RealType c=(*eikr_new_ptr).real();
+      const RealType s=(*eikr_new_ptr).imag();
       dd += c*(c+(*rhok_ptr).real()-(*eikr_ptr).real())
             + s*(s+(*rhok_ptr).imag()-(*eikr_ptr).imag());
     }
@@ -215,15 +216,14 @@ LRTwoBodyJastrow::logRatio(ParticleSet& P, int iat,
   NeedToRestore=true;
   const KContainer::VContainer_t& kpts(P.SK->KLists.kpts_cart);
   {
+    //eikr for the proposed move evaluated by ParticleSet::makeMove
+    const ComplexType* restrict eikr_temp(P.SK->eikr_temp.data());
     ComplexType* restrict eikr1(eikr_new.data());
     ComplexType* restrict deikr(delta_eikr.data());
     const ComplexType* restrict eikr0(eikr[iat]);
-    PosType pos(P.R[iat]);
-    RealType c,s;
     for(int ki=0; ki<MaxK; ki++)
     {
-      sincos(dot(kpts[ki],pos),&s,&c);
-      (*eikr1)=ComplexType(c,s);
+      (*eikr1)=(*eikr_temp++);
       (*deikr++)=(*eikr1++)-(*eikr0++);
     }
   }
@@ -18,6 +18,7 @@
 #include "Configuration.h"
 #include "QMCWaveFunctions/OrbitalBase.h"
 #include "QMCWaveFunctions/Jastrow/DiffOneBodyJastrowOrbital.h"
+#include "QMCWaveFunctions/Jastrow/JastrowFunctorBatch.h"
 #include "Particle/DistanceTableData.h"
 #include "Particle/DistanceTable.h"
 
@@ -86,6 +87,78 @@ protected:
   vector<FT*> Fs;
   vector<FT*> Funique;
 
+  /** runs of the centers with the same functor
+   *
+   * RunF[k] is used for the centers [RunFirst[k],RunFirst[k]+RunSize[k]).
+   * The centers without a functor are not included.
+   */
+  vector<int> RunFirst, RunSize;
+  vector<FT*> RunF;
+  ///true if curGrad and curLap are valid for the proposed move
+  bool TempGradLapValid;
+  ///scratch for the batched evaluations of the size of the centers
+  DistanceTableData::aligned_vector_type DistBuf, uBuf, duBuf, d2uBuf;
+
+  ///return the distances of the iel-th target to all the centers
+  inline const RealType* getDistances(int iel)
+  {
+    if (d_table->DTType == DistanceTableData::DT_SOA)
+      return d_table->getDistRow(iel);
+    for (int i=0; i<d_table->size(SourceIndex); ++i)
+      DistBuf[i]=d_table->r(d_table->M[i]+iel);
+    return &DistBuf[0];
+  }
+
+  ///evaluate u, du/dr and d2u/dr2 of the distances to all the centers in uBuf, duBuf and d2uBuf
+  inline void evaluateVGL(const RealType* restrict dist)
+  {
+    for (int k=0; k<RunF.size(); ++k)
+    {
+      const int first=RunFirst[k];
+      qmcplusplus::evaluateVGL(*RunF[k],RunSize[k],dist+first,&uBuf[first],&duBuf[first],&d2uBuf[first]);
+    }
+  }
+
+  ///evaluate curVal, curGrad and curLap of the proposed move
+  inline void evaluateTempVGL()
+  {
+    curVal=0.0;
+    curLap=0.0;
+    curGrad=0.0;
+    if (d_table->DTType == DistanceTableData::DT_CELL)
+    {
+      //only the neighbors are within the cutoff
+      const vector<int>& nbrs(d_table->TempNeighbors);
+      for (int k=0; k<nbrs.size(); ++k)
+      {
+        const int i=nbrs[k];
+        if (Fs[i])
+        {
+          RealType du, d2u;
+          curVal += Fs[i]->evaluate(d_table->Temp[i].r1,du,d2u);
+          RealType dudr=du*d_table->Temp[i].rinv1;
+          curGrad -= dudr*d_table->Temp[i].dr1;
+          curLap -= d2u+2.0*dudr;
+        }
+      }
+      TempGradLapValid=true;
+      return;
+    }
+    const RealType* restrict dist=d_table->getTempDistances(&DistBuf[0]);
+    evaluateVGL(dist);
+    for (int k=0; k<RunF.size(); ++k)
+    {
+      for (int i=RunFirst[k]; i<RunFirst[k]+RunSize[k]; ++i)
+      {
+        RealType dudr=duBuf[i]/dist[i];
+        curVal += uBuf[i];
+        curGrad -= dudr*d_table->getTempDispl(i);
+        curLap -= d2uBuf[i]+2.0*dudr;
+      }
+    }
+    TempGradLapValid=true;
+  }
+
 public:
 
   typedef FT FuncType;
@@ -95,10 +168,15 @@ public:
     : CenterRef(centers), d_table(0), FirstAddressOfdU(0), LastAddressOfdU(0)
   {
     U.resize(els.getTotalNum());
-    d_table = DistanceTable::add(CenterRef,els);
+    d_table = els.DistTables[els.addTable(CenterRef,-1,false)];
     //allocate vector of proper size  and set them to 0
     Funique.resize(CenterRef.getSpeciesSet().getTotalNum(),0);
     Fs.resize(CenterRef.getTotalNum(),0);
+    DistBuf.resize(Fs.size());
+    uBuf.resize(Fs.size());
+    duBuf.resize(Fs.size());
+    d2uBuf.resize(Fs.size());
+    TempGradLapValid=false;
   }
 
   ~OneBodyJastrowOrbital() { }
@@ -106,17 +184,35 @@ public:
   //evaluate the distance table with P
   void resetTargetParticleSet(ParticleSet& P)
   {
-    d_table = DistanceTable::add(CenterRef,P);
+    d_table = P.DistTables[P.addTable(CenterRef,-1,false)];
     if (dPsi)
       dPsi->resetTargetParticleSet(P);
   }
 
   void addFunc(int source_type, FT* afunc, int target_type=-1)
   {
+    //a functor without cutoff_radius is taken as non-vanishing
+    d_table->checkNeighborCutoff(afunc->cutoff_radius>0.0? afunc->cutoff_radius:-1.0,"OneBodyJastrowOrbital");
     for (int i=0; i<Fs.size(); i++)
       if (CenterRef.GroupID[i] == source_type)
         Fs[i]=afunc;
     Funique[source_type]=afunc;
+    RunFirst.clear();
+    RunSize.clear();
+    RunF.clear();
+    for (int i=0; i<Fs.size(); i++)
+    {
+      if (Fs[i] == 0)
+        continue;
+      if (RunF.size() && RunF.back() == Fs[i] && RunFirst.back()+RunSize.back() == i)
+        RunSize.back()++;
+      else
+      {
+        RunFirst.push_back(i);
+        RunSize.push_back(1);
+        RunF.push_back(Fs[i]);
+      }
+    }
   }
 
   /** check in an optimizable parameter
@@ -197,22 +293,22 @@ public:
   {
     LogValue=0.0;
     U=0.0;
-    RealType dudr, d2udr2;
-    for (int i=0; i<d_table->size(SourceIndex); i++)
+    RealType dudr;
+    for (int j=0; j<d_table->size(VisitorIndex); ++j)
     {
-      FT* func=Fs[i];
-      if (func == 0)
-        continue;
-      for (int nn=d_table->M[i]; nn<d_table->M[i+1]; nn++)
+      evaluateVGL(getDistances(j));
+      for (int k=0; k<RunF.size(); ++k)
       {
-        int j = d_table->J[nn];
-        //ValueType uij= F[d_table->PairID[nn]]->evaluate(d_table->r(nn), dudr, d2udr2);
-        RealType uij= func->evaluate(d_table->r(nn), dudr, d2udr2);
-        LogValue -= uij;
-        U[j] += uij;
-        dudr *= d_table->rinv(nn);
-        G[j] -= dudr*d_table->dr(nn);
-        L[j] -= d2udr2+2.0*dudr;
+        for (int i=RunFirst[k]; i<RunFirst[k]+RunSize[k]; ++i)
+        {
+          int nn=d_table->M[i]+j;
+          RealType uij=uBuf[i];
+          LogValue -= uij;
+          U[j] += uij;
+          dudr = duBuf[i]*d_table->rinv(nn);
+          G[j] -= dudr*d_table->dr(nn);
+          L[j] -= d2uBuf[i]+2.0*dudr;
+        }
       }
     }
     return LogValue;
@@ -232,30 +328,56 @@ public:
   inline ValueType ratio(ParticleSet& P, int iat)
   {
     curVal=0.0;
-    for (int i=0; i<d_table->size(SourceIndex); ++i)
-      if (Fs[i])
-        curVal += Fs[i]->evaluate(d_table->Temp[i].r1);
+    if (d_table->DTType == DistanceTableData::DT_CELL)
+    {
+      const vector<int>& nbrs(d_table->TempNeighbors);
+      for (int k=0; k<nbrs.size(); ++k)
+        if (Fs[nbrs[k]])
+          curVal += Fs[nbrs[k]]->evaluate(d_table->Temp[nbrs[k]].r1);
+      TempGradLapValid=false;
+      return std::exp(U[iat]-curVal);
+    }
+    const RealType* restrict dist=d_table->getTempDistances(&DistBuf[0]);
+    for (int k=0; k<RunF.size(); ++k)
+    {
+      const int first=RunFirst[k];
+      evaluateV(*RunF[k],RunSize[k],dist+first,&uBuf[first]);
+      for (int i=first; i<first+RunSize[k]; ++i)
+        curVal += uBuf[i];
+    }
+    TempGradLapValid=false;
     return std::exp(U[iat]-curVal);
   }
 
 
   /** evaluate the ratio
+   *
+   * The value at the new position is common to all the targets and U holds the current values.
    */
   inline void get_ratios(ParticleSet& P, vector<ValueType>& ratios)
   {
-    std::fill(ratios.begin(),ratios.end(),0.0);
-    for (int i=0; i<d_table->size(SourceIndex); ++i)
+    ratio(P,0);
+    for(int i=0; i<ratios.size(); ++i)
+      ratios[i] = std::exp(U[i]-curVal);
+  }
+
+  /** evaluate the ratios of the virtual moves using the SoA table of VP */
+  void evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios)
+  {
+    const DistanceTableData* vt=VP.DistTables[d_table->ID];
+    for (int iv=0; iv<ratios.size(); ++iv)
     {
-      if (Fs[i])
+      const RealType* restrict dist=vt->getDistRow(iv);
+      RealType unew=0.0;
+      for (int k=0; k<RunF.size(); ++k)
       {
-        RealType up=Fs[i]->evaluate(d_table->Temp[i].r1);
-        for (int nn=d_table->M[i],j=0; nn<d_table->M[i+1]; ++nn,++j)
-          ratios[j]+=Fs[i]->evaluate(d_table->r(nn))-up;
-        //delta_u[d_table->J[nn]]+=Fs[i]->evaluate(d_table->r(nn))-u0;
+        const int first=RunFirst[k];
+        evaluateV(*RunF[k],RunSize[k],dist+first,&uBuf[first]);
+        for (int i=first; i<first+RunSize[k]; ++i)
+          unew += uBuf[i];
       }
+      ratios[iv]=std::exp(U[VP.refPtcl]-unew);
     }
-    for(int i=0; i<ratios.size(); ++i)
-      ratios[i] = std::exp(ratios[i]);
   }
 
 
@@ -295,16 +417,14 @@ public:
 
   inline GradType evalGrad(ParticleSet& P, int iat)
   {
-    int n=d_table->size(VisitorIndex);
     curGrad = 0.0;
-    RealType ur,dudr, d2udr2;
-    for (int i=0, nn=iat; i<d_table->size(SourceIndex); ++i,nn+= n)
+    evaluateVGL(getDistances(iat));
+    for (int k=0; k<RunF.size(); ++k)
     {
-      if (Fs[i])
+      for (int i=RunFirst[k]; i<RunFirst[k]+RunSize[k]; ++i)
       {
-        ur=Fs[i]->evaluate(d_table->r(nn),dudr,d2udr2);
-        dudr *= d_table->rinv(nn);
-        curGrad -= dudr*d_table->dr(nn);
+        int nn=d_table->M[i]+iat;
+        curGrad -= duBuf[i]*d_table->rinv(nn)*d_table->dr(nn);
       }
     }
     return curGrad;
@@ -363,19 +483,7 @@ public:
 
   inline ValueType ratioGrad(ParticleSet& P, int iat, GradType& grad_iat)
   {
-    int n=d_table->size(VisitorIndex);
-    curVal=0.0;
-    curGrad = 0.0;
-    RealType dudr, d2udr2;
-    for (int i=0; i<d_table->size(SourceIndex); ++i)
-    {
-      if (Fs[i])
-      {
-        curVal += Fs[i]->evaluate(d_table->Temp[i].r1,dudr,d2udr2);
-        dudr *= d_table->Temp[i].rinv1;
-        curGrad -= dudr*d_table->Temp[i].dr1;
-      }
-    }
+    evaluateTempVGL();
     grad_iat += curGrad;
     return std::exp(U[iat]-curVal);
   }
@@ -384,21 +492,7 @@ public:
                             ParticleSet::ParticleGradient_t& dG,
                             ParticleSet::ParticleLaplacian_t& dL)
   {
-    int n=d_table->size(VisitorIndex);
-    curVal=0.0;
-    curLap=0.0;
-    curGrad = 0.0;
-    RealType dudr, d2udr2;
-    for (int i=0, nn=iat; i<d_table->size(SourceIndex); i++,nn+= n)
-    {
-      if (Fs[i])
-      {
-        curVal += Fs[i]->evaluate(d_table->Temp[i].r1,dudr,d2udr2);
-        dudr *= d_table->Temp[i].rinv1;
-        curGrad -= dudr*d_table->Temp[i].dr1;
-        curLap  -= d2udr2+2.0*dudr;
-      }
-    }
+    evaluateTempVGL();
     dG[iat] += curGrad-dU[iat];
     dL[iat] += curLap-d2U[iat];
     return U[iat]-curVal;
@@ -408,6 +502,10 @@ public:
 
   void acceptMove(ParticleSet& P, int iat)
   {
+    //ratio(P,iat) evaluates only the value
+    if (!TempGradLapValid)
+      evaluateTempVGL();
+    TempGradLapValid=false;
     U[iat] = curVal;
     dU[iat]=curGrad;
     d2U[iat]=curLap;
@@ -434,25 +532,26 @@ public:
     U=0.0;
     dU=0.0;
     d2U=0.0;
-    RealType uij, dudr, d2udr2;
-    for (int i=0; i<d_table->size(SourceIndex); i++)
+    RealType uij, dudr, lap;
+    for (int j=0; j<d_table->size(VisitorIndex); ++j)
     {
-      FT* func=Fs[i];
-      if (func == 0)
-        continue;
-      for (int nn=d_table->M[i]; nn<d_table->M[i+1]; nn++)
+      evaluateVGL(getDistances(j));
+      for (int k=0; k<RunF.size(); ++k)
       {
-        int j = d_table->J[nn];
-        //uij = F[d_table->PairID[nn]]->evaluate(d_table->r(nn), dudr, d2udr2);
-        uij = func->evaluate(d_table->r(nn), dudr, d2udr2);
-        LogValue-=uij;
-        U[j]+=uij;
-        dudr *= d_table->rinv(nn);
-        dU[j] -= dudr*d_table->dr(nn);
-        d2U[j] -= d2udr2+2.0*dudr;
-        //add gradient and laplacian contribution
-        dG[j] -= dudr*d_table->dr(nn);
-        dL[j] -= d2udr2+2.0*dudr;
+        for (int i=RunFirst[k]; i<RunFirst[k]+RunSize[k]; ++i)
+        {
+          int nn=d_table->M[i]+j;
+          uij = uBuf[i];
+          LogValue-=uij;
+          U[j]+=uij;
+          dudr = duBuf[i]*d_table->rinv(nn);
+          lap = d2uBuf[i]+2.0*dudr;
+          dU[j] -= dudr*d_table->dr(nn);
+          d2U[j] -= lap;
+          //add gradient and laplacian contribution
+          dG[j] -= dudr*d_table->dr(nn);
+          dL[j] -= lap;
+        }
       }
     }
   }
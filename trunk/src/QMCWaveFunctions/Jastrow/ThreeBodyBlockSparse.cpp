@@ -33,6 +33,7 @@ ThreeBodyBlockSparse::ThreeBodyBlockSparse(const ParticleSet& ions, ParticleSet&
   CenterRef(ions), GeminalBasis(0), IndexOffSet(1), ID_Lambda("j3"), SameBlocksForGroup(true)
 {
   myTableIndex=els.addTable(ions);
+  els.DistTables[myTableIndex]->checkNeighborCutoff(-1.0,"ThreeBodyBlockSparse");
   //d_table = DistanceTable::add(ions,els);
   NumPtcls=els.getTotalNum();
   Optimizable=true;
@@ -32,6 +32,7 @@ ThreeBodyGeminal::ThreeBodyGeminal(const ParticleSet& ions, ParticleSet& els):
   CenterRef(ions), GeminalBasis(0), IndexOffSet(1), ID_Lambda("j3")
 {
   d_table = DistanceTable::add(ions,els);
+  d_table->checkNeighborCutoff(-1.0,"ThreeBodyGeminal");
   NumPtcls=els.getTotalNum();
   NormFac=1.0/static_cast<RealType>(NumPtcls*NumPtcls);
   Optimizable=true;
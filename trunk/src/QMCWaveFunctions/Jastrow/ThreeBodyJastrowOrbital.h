@@ -59,6 +59,8 @@ public:
       myTableIndex=0;
     else
       myTableIndex=els.addTable(ions);
+    els.DistTables[0]->checkNeighborCutoff(-1.0,"ThreeBodyJastrowOrbital");
+    els.DistTables[myTableIndex]->checkNeighborCutoff(-1.0,"ThreeBodyJastrowOrbital");
     NumCenters=ions.getTotalNum();
     NumPtcls=els.getTotalNum();
     C.resize(NumCenters,NumPtcls,NumPtcls);
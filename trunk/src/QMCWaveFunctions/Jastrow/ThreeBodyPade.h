@@ -97,6 +97,8 @@ public:
     U.resize(els.getTotalNum());
     ee_table = DistanceTable::add(els);
     d_table = DistanceTable::add(ions,els);
+    ee_table->checkNeighborCutoff(-1.0,"ThreeBodyPade");
+    d_table->checkNeighborCutoff(-1.0,"ThreeBodyPade");
     C.reserve(32); // need to reserve the memory...
     //InitC();
   }
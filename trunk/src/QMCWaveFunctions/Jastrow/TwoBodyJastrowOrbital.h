@@ -20,6 +20,7 @@
 #include  <numeric>
 #include "QMCWaveFunctions/OrbitalBase.h"
 #include "QMCWaveFunctions/Jastrow/DiffTwoBodyJastrowOrbital.h"
+#include "QMCWaveFunctions/Jastrow/JastrowFunctorBatch.h"
 #include "Particle/DistanceTableData.h"
 #include "Particle/DistanceTable.h"
 #include "LongRange/StructFact.h"
@@ -61,6 +62,17 @@ protected:
   bool FirstTime;
   RealType KEcorr;
 
+  /** runs of the particles of the same group
+   *
+   * [RunFirst[k],RunFirst[k+1]) is the k-th run. The functors are evaluated
+   * in batches over a run with evaluateV and evaluateVGL.
+   */
+  vector<int> RunFirst;
+  ///true if curGrad and curLap are valid for the proposed move
+  bool TempGradLapValid;
+  ///scratch for the batched evaluations
+  DistanceTableData::aligned_vector_type DistBuf, uBuf, duBuf, d2uBuf;
+
 public:
 
   typedef FT FuncType;
@@ -72,7 +84,7 @@ public:
     : TaskID(tid), KEcorr(0.0)
   {
     PtclRef = &p;
-    d_table=DistanceTable::add(p);
+    d_table=p.DistTables[p.addTable(p,-1,false)];
     init(p);
     FirstTime = true;
   }
@@ -105,10 +117,128 @@ public:
       for(int j=0; j<N; ++j)
         PairID(i,j) = p.GroupID[i]*nsp+p.GroupID[j];
     F.resize(nsp*nsp,0);
+    RunFirst.clear();
+    for(int i=0; i<N; ++i)
+      if(i==0 || p.GroupID[i]!=p.GroupID[i-1])
+        RunFirst.push_back(i);
+    RunFirst.push_back(N);
+    DistBuf.resize(N);
+    uBuf.resize(N);
+    duBuf.resize(N);
+    d2uBuf.resize(N);
+    TempGradLapValid=false;
+  }
+
+  /** evaluate u, du/dr and d2u/dr2 of the pairs (i,j>i) in uBuf, duBuf and d2uBuf
+   * @param i particle index
+   */
+  inline void evaluatePairsVGL(int i)
+  {
+    const RealType* restrict dist=&DistBuf[0];
+    if(d_table->DTType == DistanceTableData::DT_SOA)
+      dist=d_table->getDistRow(i);
+    else
+      for(int nn=d_table->M[i]; nn<d_table->M[i+1]; ++nn)
+        DistBuf[d_table->J[nn]]=d_table->r(nn);
+    for(int k=0; k+1<RunFirst.size(); ++k)
+    {
+      const int first=std::max(RunFirst[k],i+1);
+      const int n=RunFirst[k+1]-first;
+      if(n>0)
+        evaluateVGL(*F[PairID(i,first)],n,dist+first,&uBuf[first],&duBuf[first],&d2uBuf[first]);
+    }
+  }
+
+  /** evaluate curVal of the proposed move of the iat-th particle */
+  inline void evaluateTempV(int iat)
+  {
+    if(d_table->DTType == DistanceTableData::DT_CELL)
+    {
+      //only the neighbors are within the cutoff
+      const vector<int>& nbrs(d_table->TempNeighbors);
+      curVal=0.0;
+      for(int k=0; k<nbrs.size(); ++k)
+        curVal[nbrs[k]]=F[PairID(iat,nbrs[k])]->evaluate(d_table->Temp[nbrs[k]].r1);
+      curVal[iat]=0.0;
+      return;
+    }
+    const RealType* restrict dist=d_table->getTempDistances(&DistBuf[0]);
+    for(int k=0; k+1<RunFirst.size(); ++k)
+    {
+      const int first=RunFirst[k];
+      evaluateV(*F[PairID(iat,first)],RunFirst[k+1]-first,dist+first,&curVal[first]);
+    }
+    curVal[iat]=0.0;
+  }
+
+  /** evaluate curVal, curGrad and curLap of the proposed move of the iat-th particle
+   * @return the sum of curGrad
+   */
+  inline PosType evaluateTempVGL(int iat)
+  {
+    if(d_table->DTType == DistanceTableData::DT_CELL)
+      return evaluateNeighborsVGL(iat);
+    const RealType* restrict dist=d_table->getTempDistances(&DistBuf[0]);
+    for(int k=0; k+1<RunFirst.size(); ++k)
+    {
+      const int first=RunFirst[k];
+      evaluateVGL(*F[PairID(iat,first)],RunFirst[k+1]-first,dist+first
+                  ,&curVal[first],&duBuf[first],&d2uBuf[first]);
+    }
+    PosType gr;
+    for(int jat=0; jat<N; ++jat)
+    {
+      if(jat==iat)
+      {
+        curVal[jat]=0.0;
+        curGrad[jat]=0.0;
+        curLap[jat]=0.0;
+        continue;
+      }
+      RealType dudr=duBuf[jat]/dist[jat];
+      gr += curGrad[jat] = -dudr*d_table->getTempDispl(jat);
+      curLap[jat] = -(d2uBuf[jat]+(OHMMS_DIM-1.0)*dudr);
+    }
+    TempGradLapValid=true;
+    return gr;
+  }
+
+  /** evaluateTempVGL over TempNeighbors of a table with the cell lists */
+  inline PosType evaluateNeighborsVGL(int iat)
+  {
+    const vector<int>& nbrs(d_table->TempNeighbors);
+    curVal=0.0;
+    curGrad=0.0;
+    curLap=0.0;
+    PosType gr;
+    for(int k=0; k<nbrs.size(); ++k)
+    {
+      const int jat=nbrs[k];
+      if(jat==iat)
+        continue;
+      RealType du, d2u;
+      curVal[jat]=F[PairID(iat,jat)]->evaluate(d_table->Temp[jat].r1,du,d2u);
+      RealType dudr=du*d_table->Temp[jat].rinv1;
+      gr += curGrad[jat] = -dudr*d_table->Temp[jat].dr1;
+      curLap[jat] = -(d2u+(OHMMS_DIM-1.0)*dudr);
+    }
+    TempGradLapValid=true;
+    return gr;
+  }
+
+  ///return \f$\sum_j U_{iat,j}-u(|r'_{iat}-r_j|)\f$ using curVal
+  inline RealType tempDiffVal(int iat) const
+  {
+    RealType res=0.0;
+    for(int jat=0, ij=iat*N; jat<N; jat++,ij++)
+      res += U[ij]-curVal[jat];
+    return res-U[iat*N+iat];
   }
 
   void addFunc(int ia, int ib, FT* j)
   {
+    //a functor without cutoff_radius is taken as non-vanishing
+    d_table->checkNeighborCutoff(j->cutoff_radius>0.0? j->cutoff_radius:-1.0,"TwoBodyJastrowOrbital");
     if(ia==ib)
     {
       if(ia==0)//first time, assign everything
@@ -136,7 +266,7 @@ public:
   //evaluate the distance table with els
   void resetTargetParticleSet(ParticleSet& P)
   {
-    d_table = DistanceTable::add(P);
+    d_table = P.DistTables[P.addTable(P,-1,false)];
     PtclRef = &P;
     if(dPsi)
       dPsi->resetTargetParticleSet(P);
@@ -238,15 +368,16 @@ public:
       ChiesaKEcorrection();
     }
     LogValue=0.0;
-    RealType dudr, d2udr2;
+    RealType dudr;
     PosType gr;
     for(int i=0; i<d_table->size(SourceIndex); i++)
     {
+      evaluatePairsVGL(i);
       for(int nn=d_table->M[i]; nn<d_table->M[i+1]; nn++)
       {
         int j = d_table->J[nn];
-        //LogValue -= F[d_table->PairID[nn]]->evaluate(d_table->r(nn), dudr, d2udr2);
-        RealType uij = F[d_table->PairID[nn]]->evaluate(d_table->r(nn), dudr, d2udr2);
+        RealType uij = uBuf[j];
+        dudr = duBuf[j];
         LogValue -= uij;
         U[i*N+j]=uij;
         U[j*N+i]=uij; //save for the ratio
@@ -254,7 +385,7 @@ public:
         dudr *= d_table->rinv(nn);
         gr = dudr*d_table->dr(nn);
         //(d^2 u \over dr^2) + (2.0\over r)(du\over\dr)
-        RealType lap(d2udr2+(OHMMS_DIM-1.0)*dudr);
+        RealType lap(d2uBuf[j]+(OHMMS_DIM-1.0)*dudr);
         //multiply -1
         G[i] += gr;
         G[j] -= gr;
@@ -274,35 +405,63 @@ public:
 
   ValueType ratio(ParticleSet& P, int iat)
   {
-    DiffVal=0.0;
-    const int* pairid(PairID[iat]);
-    for(int jat=0, ij=iat*N; jat<N; jat++,ij++)
+    evaluateTempV(iat);
+    TempGradLapValid=false;
+    DiffVal=tempDiffVal(iat);
+    return std::exp(DiffVal);
+  }
+
+  /** evaluate the ratio
+   *
+   * The functors of a group of the moved particle are evaluated once in uBuf.
+   */
+  inline void get_ratios(ParticleSet& P, vector<ValueType>& ratios)
+  {
+    const RealType* restrict dist=d_table->getTempDistances(&DistBuf[0]);
+    for(int ig=0; ig+1<RunFirst.size(); ++ig)
     {
-      if(jat == iat)
+      const int ifirst=RunFirst[ig];
+      for(int k=0; k+1<RunFirst.size(); ++k)
       {
-        curVal[jat]=0.0;
+        const int first=RunFirst[k];
+        evaluateV(*F[PairID(ifirst,first)],RunFirst[k+1]-first,dist+first,&uBuf[first]);
       }
-      else
+      for(int i=ifirst; i<RunFirst[ig+1]; ++i)
       {
-        curVal[jat]=F[pairid[jat]]->evaluate(d_table->Temp[jat].r1);
-        DiffVal += U[ij]-curVal[jat];
-        //DiffVal += U[ij]-F[pairid[jat]]->evaluate(d_table->Temp[jat].r1);
+        const RealType* restrict u=&U[i*N];
+        RealType res=0.0;
+        for(int j=0; j<i; ++j)
+          res+=u[j]-uBuf[j];
+        for(int j=i+1; j<N; ++j)
+          res+=u[j]-uBuf[j];
+        ratios[i]=std::exp(res);
       }
     }
-    return std::exp(DiffVal);
   }
 
-  /** evaluate the ratio
-  */
-  inline void get_ratios(ParticleSet& P, vector<ValueType>& ratios)
+  /** evaluate the ratios of the virtual moves using the SoA table of VP */
+  void evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios)
   {
-    for (int i=0,ij=0; i<N; ++i)
+    const int iat=VP.refPtcl;
+    const DistanceTableData* vt=VP.DistTables[d_table->ID];
+    const RealType* restrict u=&U[iat*N];
+    RealType u0=0.0;
+    for(int j=0; j<N; ++j)
+      u0+=u[j];
+    u0-=u[iat];
+    for(int iv=0; iv<ratios.size(); ++iv)
     {
-      RealType res=0.0;
-      for(int j=0; j<N; ++j,++ij)
-        if(i!=j)
-          res+=U[ij]-F[PairID(ij)]->evaluate(d_table->Temp[j].r1);
-      ratios[i]=std::exp(res);
+      const RealType* restrict dist=vt->getDistRow(iv);
+      for(int k=0; k+1<RunFirst.size(); ++k)
+      {
+        const int first=RunFirst[k];
+        evaluateV(*F[PairID(iat,first)],RunFirst[k+1]-first,dist+first,&uBuf[first]);
+      }
+      uBuf[iat]=0.0;
+      RealType unew=0.0;
+      for(int j=0; j<N; ++j)
+        unew+=uBuf[j];
+      ratios[iv]=std::exp(u0-unew);
     }
   }
 
@@ -312,27 +471,8 @@ public:
                   ParticleSet::ParticleGradient_t& dG,
                   ParticleSet::ParticleLaplacian_t& dL)
   {
-    register RealType dudr, d2udr2,u;
-    register PosType gr;
-    DiffVal = 0.0;
-    const int* pairid = PairID[iat];
-    for(int jat=0, ij=iat*N; jat<N; jat++,ij++)
-    {
-      if(jat==iat)
-      {
-        curVal[jat] = 0.0;
-        curGrad[jat]=0.0;
-        curLap[jat]=0.0;
-      }
-      else
-      {
-        curVal[jat] = F[pairid[jat]]->evaluate(d_table->Temp[jat].r1, dudr, d2udr2);
-        dudr *= d_table->Temp[jat].rinv1;
-        curGrad[jat] = -dudr*d_table->Temp[jat].dr1;
-        curLap[jat] = -(d2udr2+(OHMMS_DIM-1.0)*dudr);
-        DiffVal += (U[ij]-curVal[jat]);
-      }
-    }
+    evaluateTempVGL(iat);
+    DiffVal=tempDiffVal(iat);
     PosType sumg,dg;
     sumg=0.0;
     RealType suml=0.0,dl;
@@ -360,27 +500,8 @@ public:
 
   ValueType ratioGrad(ParticleSet& P, int iat, GradType& grad_iat)
   {
-    RealType dudr, d2udr2,u;
-    PosType gr;
-    const int* pairid = PairID[iat];
-    DiffVal = 0.0;
-    for(int jat=0, ij=iat*N; jat<N; jat++,ij++)
-    {
-      if(jat==iat)
-      {
-        curVal[jat] = 0.0;
-        curGrad[jat]=0.0;
-        curLap[jat]=0.0;
-      }
-      else
-      {
-        curVal[jat] = F[pairid[jat]]->evaluate(d_table->Temp[jat].r1, dudr, d2udr2);
-        dudr *= d_table->Temp[jat].rinv1;
-        gr += curGrad[jat] = -dudr*d_table->Temp[jat].dr1;
-        curLap[jat] = -(d2udr2+(OHMMS_DIM-1.0)*dudr);
-        DiffVal += (U[ij]-curVal[jat]);
-      }
-    }
+    PosType gr=evaluateTempVGL(iat);
+    DiffVal=tempDiffVal(iat);
     grad_iat += gr;
     //curGrad0-=curGrad;
     //cout << "RATIOGRAD " << curGrad0 << endl;
@@ -423,6 +544,10 @@ public:
 
   void acceptMove(ParticleSet& P, int iat)
   {
+    //ratio(P,iat) evaluates only the values
+    if(!TempGradLapValid)
+      evaluateTempVGL(iat);
+    TempGradLapValid=false;
     DiffValSum += DiffVal;
     for(int jat=0,ij=iat*N,ji=iat; jat<N; jat++,ij++,ji+=N)
     {
@@ -489,20 +614,21 @@ public:
       FirstTime = false;
       ChiesaKEcorrection();
     }
-    RealType dudr, d2udr2,u;
+    RealType dudr,u;
     LogValue=0.0;
     GradType gr;
     for(int i=0; i<d_table->size(SourceIndex); i++)
     {
+      evaluatePairsVGL(i);
       for(int nn=d_table->M[i]; nn<d_table->M[i+1]; nn++)
       {
         int j = d_table->J[nn];
-        u = F[d_table->PairID[nn]]->evaluate(d_table->r(nn), dudr, d2udr2);
+        u = uBuf[j];
         LogValue -= u;
-        dudr *= d_table->rinv(nn);
+        dudr = duBuf[j]*d_table->rinv(nn);
         gr = dudr*d_table->dr(nn);
         //(d^2 u \over dr^2) + (2.0\over r)(du\over\dr)\f$
-        RealType lap = d2udr2+(OHMMS_DIM-1.0)*dudr;
+        RealType lap = d2uBuf[j]+(OHMMS_DIM-1.0)*dudr;
         int ij = i*N+j, ji=j*N+i;
         U[ij]=u;
         U[ji]=u;
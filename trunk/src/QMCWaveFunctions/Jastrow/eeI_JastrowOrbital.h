@@ -110,6 +110,8 @@ public:
     IRef = &ions;
     ee_table=DistanceTable::add(elecs);
     eI_table=DistanceTable::add(ions, elecs);
+    ee_table->checkNeighborCutoff(-1.0,"eeI_JastrowOrbital");
+    eI_table->checkNeighborCutoff(-1.0,"eeI_JastrowOrbital");
     init(elecs);
     FirstTime = true;
     NumVars=0;
@@ -17,6 +17,7 @@
 #define QMCPLUSPLUS_LINEARCOMIBINATIONORBITALSET_TEMP_H
 
 #include "QMCWaveFunctions/SPOSetBase.h"
+#include "Numerics/OhmmsBlas.h"
 #include <simd/simd.hpp>
 
 namespace qmcplusplus
@@ -183,6 +184,10 @@ public:
 
   ValueMatrix_t Temp;
   ValueMatrix_t Tempv;
+  ///basis functions of a group of particles
+  ValueMatrix_t BasisM;
+  ///orbitals of a group of particles, see evaluate_notranspose
+  ValueMatrix_t OrbM;
   /** constructor
    * @param bs pointer to the BasisSet
    * @param id identifier of this LCOrbitalSet
@@ -242,20 +247,45 @@ public:
     return (myBasisSet==0)? 0: myBasisSet->getBasisSetSize();
   }
 
+  /** psi=C*phi using the basis functions of the active centers
+   *
+   * Falls back to the dense product when no center is screened.
+   */
+  template<typename T>
+  inline void product(const T* restrict phi, T* restrict psi)
+  {
+    if(myBasisSet->NumActiveBasis == BasisSetSize)
+    {
+      simd::gemv(C,phi,psi);
+      return;
+    }
+    const vector<int>& blocks(myBasisSet->ActiveBlocks);
+    const int nb=blocks.size();
+    for(int j=0; j<OrbitalSetSize; j++)
+    {
+      const ValueType* restrict cj=C[j];
+      T res=T();
+      for(int k=0; k<nb; k+=2)
+        for(int b=blocks[k]; b<blocks[k+1]; ++b)
+          res += cj[b]*phi[b];
+      psi[j]=res;
+    }
+  }
+
   inline void
   evaluate(const ParticleSet& P, int iat, ValueVector_t& psi)
   {
     myBasisSet->evaluateForPtclMove(P,iat);
-    simd::gemv(C,myBasisSet->Phi.data(),psi.data());
+    product(myBasisSet->Phi.data(),psi.data());
   }
 
   inline void
   evaluate(const ParticleSet& P, int iat, ValueVector_t& psi, GradVector_t& dpsi, ValueVector_t& d2psi)
   {
     myBasisSet->evaluateAllForPtclMove(P,iat);
-    simd::gemv(C,myBasisSet->Phi.data(),psi.data());
-    simd::gemv(C,myBasisSet->dPhi.data(),dpsi.data());
-    simd::gemv(C,myBasisSet->d2Phi.data(),d2psi.data());
+    product(myBasisSet->Phi.data(),psi.data());
+    product(myBasisSet->dPhi.data(),dpsi.data());
+    product(myBasisSet->d2Phi.data(),d2psi.data());
   }
 
   inline void
@@ -264,9 +294,9 @@ public:
            HessVector_t& grad_grad_psi)
   {
     myBasisSet->evaluateForPtclMoveWithHessian(P,iat);
-    simd::gemv(C,myBasisSet->Phi.data(),psi.data());
-    simd::gemv(C,myBasisSet->dPhi.data(),dpsi.data());
-    simd::gemv(C,myBasisSet->grad_grad_Phi.data(),grad_grad_psi.data());
+    product(myBasisSet->Phi.data(),psi.data());
+    product(myBasisSet->dPhi.data(),dpsi.data());
+    product(myBasisSet->grad_grad_Phi.data(),grad_grad_psi.data());
 //#if defined(USE_BLAS2)
 //      MatrixOperators::product(C,myBasisSet->Phi.data(),psi.data());
 //      MatrixOperators::product(C,myBasisSet->dPhi.data(),dpsi.data());
@@ -295,23 +325,54 @@ public:
   void evaluate_notranspose(const ParticleSet& P, int first, int last,
                             ValueMatrix_t& logdet, GradMatrix_t& dlogdet, ValueMatrix_t& d2logdet)
   {
-    const ValueType* restrict cptr=C.data();
-#pragma ivdep
-    for(int i=0,ij=0, iat=first; iat<last; i++,iat++)
+    const int nptcl=last-first;
+    const int norb=C.rows();
+    //rows of a particle: value, laplacian and the components of the gradient
+    const int nrows=OHMMS_DIM+2;
+    if(BasisM.rows() != nrows*nptcl || BasisM.cols() != BasisSetSize)
+      BasisM.resize(nrows*nptcl,BasisSetSize);
+    if(OrbM.rows() != nrows*nptcl || OrbM.cols() != norb)
+      OrbM.resize(nrows*nptcl,norb);
+    myBasisSet->evaluateForWalkerMove(P,first,last,BasisM);
+    //OrbM(k,j) = sum_b BasisM(k,b) C(j,b)
+    BLAS::gemm('T','N',norb,nrows*nptcl,BasisSetSize,ValueType(1),C.data(),BasisSetSize
+               ,BasisM.data(),BasisSetSize,ValueType(0),OrbM.data(),norb);
+    for(int i=0; i<nptcl; i++)
     {
-      myBasisSet->evaluateForWalkerMove(P,iat);
-      MatrixOperators::product(C,myBasisSet->Phi,logdet[i]);
-      MatrixOperators::product(C,myBasisSet->d2Phi,d2logdet[i]);
-      const typename BS::GradType* restrict dptr=myBasisSet->dPhi.data();
-      for(int j=0,jk=0; j<OrbitalSetSize; j++)
-      {
-        register GradType dres;
-        for(int b=0; b<BasisSetSize; ++b)
-          dres +=  cptr[jk++]*dptr[b];
-        dlogdet(ij)=dres;
-        ++ij;
-      }
+      const ValueType* restrict vptr=OrbM[nrows*i];
+      const ValueType* restrict lptr=OrbM[nrows*i+1];
+      const ValueType* restrict gptr=OrbM[nrows*i+2];
+      std::copy(vptr,vptr+norb,logdet[i]);
+      std::copy(lptr,lptr+norb,d2logdet[i]);
+      GradType* restrict dptr=dlogdet[i];
+      for(int j=0; j<norb; j++)
+        for(int d=0; d<OHMMS_DIM; d++)
+          dptr[j][d]=gptr[d*norb+j];
+    }
+  }
+
+  /** evaluate the orbitals at the virtual positions
+   *
+   * The basis functions of all the positions are evaluated first and
+   * contracted with C by a single gemm.
+   */
+  void evaluateValues(const VirtualParticleSet& VP, ValueMatrix_t& psiM)
+  {
+    ParticleSet& P(VP.refPS);
+    const int iat=VP.refPtcl;
+    const int nv=VP.getTotalNum();
+    const int norb=C.rows();
+    if(BasisM.rows() != nv || BasisM.cols() != BasisSetSize)
+      BasisM.resize(nv,BasisSetSize);
+    for(int k=0; k<nv; ++k)
+    {
+      P.makeMoveOnSphere(iat,VP.R[k]-P.R[iat]);
+      myBasisSet->evaluateForPtclMove(P,iat);
+      P.rejectMove(iat);
+      std::copy(myBasisSet->Phi.data(),myBasisSet->Phi.data()+BasisSetSize,BasisM[k]);
     }
+    BLAS::gemm('T','N',norb,nv,BasisSetSize,ValueType(1),C.data(),BasisSetSize
+               ,BasisM.data(),BasisSetSize,ValueType(0),psiM.data(),psiM.cols());
   }
 
   void evaluate_notranspose(const ParticleSet& P, int first, int last,
@@ -61,6 +61,7 @@ struct LocalizedBasisSet: public BasisSetBase<typename COT::value_type>
   using BasisSetType::Y;
   using BasisSetType::dY;
   using BasisSetType::d2Y;
+  typedef typename BasisSetType::HessVector_t  HessVector_t;
   ///Reference to the center
   const ParticleSet& CenterSys;
   ///number of centers, e.g., ions
@@ -94,11 +95,25 @@ struct LocalizedBasisSet: public BasisSetBase<typename COT::value_type>
    */
   const DistanceTableData* myTable;
 
+  ///true, if the centers beyond the cutoff radii of their basis functions are skipped
+  bool UseCutoff;
+  ///cutoff radius of each center
+  vector<RealType> CenterCutoff;
+  /** ranges of the basis functions of the centers within the cutoff at the last evaluation
+   *
+   * [ActiveBlocks[2k],ActiveBlocks[2k+1]) is the k-th range.
+   * Consecutive centers are merged into a range.
+   */
+  vector<int> ActiveBlocks;
+  ///number of the basis functions in ActiveBlocks, BasisSetSize without the cutoff
+  int NumActiveBasis;
+
   /** constructor
    * @param ions ionic system
    * @param els electronic system
    */
-  LocalizedBasisSet(ParticleSet& ions, ParticleSet& els): CenterSys(ions), myTable(0)
+  LocalizedBasisSet(ParticleSet& ions, ParticleSet& els)
+    : CenterSys(ions), myTable(0), UseCutoff(false), NumActiveBasis(0)
   {
     myTable = DistanceTable::add(ions,els);
     NumCenters=CenterSys.getTotalNum();
@@ -145,9 +160,49 @@ struct LocalizedBasisSet: public BasisSetBase<typename COT::value_type>
     for(int c=0; c<NumCenters; c++)
       BasisOffset[c+1] = BasisOffset[c]+LOBasis[c]->getBasisSetSize();
     BasisSetSize = BasisOffset[NumCenters];
+    NumActiveBasis = BasisSetSize;
     this->resize(NumTargets);
   }
 
+  /** set the cutoff radii of the centers
+   * @param eps tolerance of the basis functions
+   * @param rlimit maximum radius of the search
+   * @param delta spacing of the search mesh
+   *
+   * A center contributes nothing to the single-particle evaluations beyond
+   * the radius where all of its basis functions fall below eps.
+   */
+  void setCutoff(RealType eps, RealType rlimit, RealType delta)
+  {
+    UseCutoff=(eps>0.0);
+    NumActiveBasis = BasisSetSize;
+    if(!UseCutoff)
+    {
+      //the basis functions do not vanish beyond the cells of the neighbor lists
+      myTable->checkNeighborCutoff(-1.0,"LocalizedBasisSet without cutoffTol");
+      return;
+    }
+    const SpeciesSet& species(CenterSys.getSpeciesSet());
+    for(int i=0; i<LOBasisSet.size(); i++)
+    {
+      if(LOBasisSet[i]==0)
+        continue;
+      RealType rc=LOBasisSet[i]->setCutoff(eps,rlimit,delta);
+      app_log() << "  Cutoff radius of the basis functions of " << species.speciesName[i]
+                << " = " << rc << " with tolerance " << eps << endl;
+      if(rc>rlimit-delta)
+        app_warning() << "  The basis functions of " << species.speciesName[i]
+                      << " exceed the tolerance at cutoffRmax = " << rlimit << endl;
+    }
+    CenterCutoff.resize(NumCenters);
+    for(int c=0; c<NumCenters; c++)
+    {
+      CenterCutoff[c]=LOBasis[c]->Rmax;
+      myTable->checkNeighborCutoff(CenterCutoff[c],"LocalizedBasisSet");
+    }
+    ActiveBlocks.reserve(2*NumCenters);
+  }
+
   void resetParameters(const opt_variables_type& active)
   {
     //reset each unique basis functions
@@ -167,8 +222,19 @@ struct LocalizedBasisSet: public BasisSetBase<typename COT::value_type>
   inline void
   evaluateWithHessian(const ParticleSet& P, int iat)
   {
+    if(UseCutoff)
+      resetActive();
     for(int c=0; c<NumCenters; c++)
-      LOBasis[c]->evaluateForWalkerMove(c,iat,BasisOffset[c],Phi,dPhi,grad_grad_Phi);
+    {
+      if(UseCutoff && screen(c,myTable->r(myTable->M[c]+iat)))
+      {
+        zeroBlock(Phi,c);
+        zeroBlock(dPhi,c);
+        zeroBlock(grad_grad_Phi,c);
+      }
+      else
+        LOBasis[c]->evaluateForWalkerMove(c,iat,BasisOffset[c],Phi,dPhi,grad_grad_Phi);
+    }
     Counter++; // increment a conter
   }
 
@@ -198,19 +264,64 @@ struct LocalizedBasisSet: public BasisSetBase<typename COT::value_type>
     Counter++; // increment a conter
   }
 
+  /** evaluate the basis functions of the particles [first,last)
+   * @param b matrix of (OHMMS_DIM+2)*(last-first) rows and BasisSetSize columns
+   *
+   * The OHMMS_DIM+2 rows of a particle are the values, laplacians and
+   * the components of the gradients.
+   */
+  inline void
+  evaluateForWalkerMove(const ParticleSet& P, int first, int last, ValueMatrix_t& b)
+  {
+    const int ld=b.cols();
+    for(int i=0, iat=first; iat<last; i++,iat++)
+    {
+      ValueType* restrict y=b[(OHMMS_DIM+2)*i];
+      for(int c=0; c<NumCenters; c++)
+      {
+        if(UseCutoff && myTable->r(myTable->M[c]+iat)>CenterCutoff[c])
+        {
+          for(int k=0; k<OHMMS_DIM+2; k++)
+            std::fill(y+k*ld+BasisOffset[c],y+k*ld+BasisOffset[c+1],ValueType());
+        }
+        else
+          LOBasis[c]->evaluateForWalkerMove(c,iat,BasisOffset[c],y,ld);
+      }
+    }
+    Counter++;
+  }
+
   inline void
   evaluateForWalkerMove(const ParticleSet& P, int iat)
   {
+    if(UseCutoff)
+      resetActive();
     for(int c=0; c<NumCenters; c++)
-      LOBasis[c]->evaluateForWalkerMove(c,iat,BasisOffset[c],Phi,dPhi,d2Phi);
+    {
+      if(UseCutoff && screen(c,myTable->r(myTable->M[c]+iat)))
+      {
+        zeroBlock(Phi,c);
+        zeroBlock(dPhi,c);
+        zeroBlock(d2Phi,c);
+      }
+      else
+        LOBasis[c]->evaluateForWalkerMove(c,iat,BasisOffset[c],Phi,dPhi,d2Phi);
+    }
     Counter++;
   }
 
   inline void
   evaluateForPtclMove(const ParticleSet& P, int iat)
   {
+    if(UseCutoff)
+      resetActive();
     for(int c=0; c<NumCenters; c++)
-      LOBasis[c]->evaluateForPtclMove(c,iat,BasisOffset[c],Phi);
+    {
+      if(UseCutoff && screen(c,myTable->Temp[c].r1))
+        zeroBlock(Phi,c);
+      else
+        LOBasis[c]->evaluateForPtclMove(c,iat,BasisOffset[c],Phi);
+    }
     Counter++;
     ActivePtcl=iat;
   }
@@ -218,8 +329,19 @@ struct LocalizedBasisSet: public BasisSetBase<typename COT::value_type>
   inline void
   evaluateAllForPtclMove(const ParticleSet& P, int iat)
   {
+    if(UseCutoff)
+      resetActive();
     for(int c=0; c<NumCenters; c++)
-      LOBasis[c]->evaluateAllForPtclMove(c,iat,BasisOffset[c],Phi,dPhi,d2Phi);
+    {
+      if(UseCutoff && screen(c,myTable->Temp[c].r1))
+      {
+        zeroBlock(Phi,c);
+        zeroBlock(dPhi,c);
+        zeroBlock(d2Phi,c);
+      }
+      else
+        LOBasis[c]->evaluateAllForPtclMove(c,iat,BasisOffset[c],Phi,dPhi,d2Phi);
+    }
     Counter++;
     ActivePtcl=iat;
   }
@@ -227,8 +349,19 @@ struct LocalizedBasisSet: public BasisSetBase<typename COT::value_type>
   inline void
   evaluateForPtclMoveWithHessian(const ParticleSet& P, int iat)
   {
+    if(UseCutoff)
+      resetActive();
     for(int c=0; c<NumCenters; c++)
-      LOBasis[c]->evaluateAllForPtclMove(c,iat,BasisOffset[c],Phi,dPhi,grad_grad_Phi);
+    {
+      if(UseCutoff && screen(c,myTable->Temp[c].r1))
+      {
+        zeroBlock(Phi,c);
+        zeroBlock(dPhi,c);
+        zeroBlock(grad_grad_Phi,c);
+      }
+      else
+        LOBasis[c]->evaluateAllForPtclMove(c,iat,BasisOffset[c],Phi,dPhi,grad_grad_Phi);
+    }
     Counter++;
     ActivePtcl=iat;
   }
@@ -247,6 +380,40 @@ struct LocalizedBasisSet: public BasisSetBase<typename COT::value_type>
         LOBasis[i]=aos;
     }
   }
+
+private:
+  ///clear ActiveBlocks before the centers are screened
+  inline void resetActive()
+  {
+    ActiveBlocks.clear();
+    NumActiveBasis=0;
+  }
+
+  /** return true, if the center c at distance r is beyond its cutoff
+   *
+   * A center within the cutoff is added to ActiveBlocks.
+   */
+  inline bool screen(int c, RealType r)
+  {
+    if(r>CenterCutoff[c])
+      return true;
+    if(ActiveBlocks.size() && ActiveBlocks.back()==BasisOffset[c])
+      ActiveBlocks.back()=BasisOffset[c+1];
+    else
+    {
+      ActiveBlocks.push_back(BasisOffset[c]);
+      ActiveBlocks.push_back(BasisOffset[c+1]);
+    }
+    NumActiveBasis += BasisOffset[c+1]-BasisOffset[c];
+    return false;
+  }
+
+  ///set the basis functions of the center c to zero
+  template<typename T>
+  inline void zeroBlock(Vector<T>& v, int c)
+  {
+    std::fill(v.data()+BasisOffset[c],v.data()+BasisOffset[c+1],T());
+  }
 };
 }
 #endif
@@ -60,6 +60,18 @@ public:
       return true;
     ReportEngine PRE(ClassName,"put(xmlNodePtr)");
     PRE.echo(cur);
+    //tolerance to screen the centers beyond the cutoff radii, disabled by default
+    RealType cutoffTol=0.0;
+    //maximum radius and spacing of the mesh on which the cutoff radii are searched
+    RealType cutoffRmax=100.0;
+    RealType cutoffDelta=0.01;
+    OhmmsAttributeSet bAttrib;
+    bAttrib.add(cutoffTol,"cutoffTolerance");
+    bAttrib.add(cutoffRmax,"cutoffRmax");
+    bAttrib.add(cutoffDelta,"cutoffDelta");
+    bAttrib.put(cur);
+    if(cutoffTol>0.0 && cutoffDelta<=0.0)
+      PRE.error("cutoffDelta has to be positive.",true);
     //create the BasisSetType
     thisBasisSet = new ThisBasisSetType(sourcePtcl,targetPtcl);
     //create the basis set
@@ -100,6 +112,7 @@ public:
     }
     //resize the basis set
     thisBasisSet->setBasisSetSize(-1);
+    thisBasisSet->setCutoff(cutoffTol,cutoffRmax,cutoffDelta);
     myBasisSet=thisBasisSet;
     return true;
   }
@@ -113,6 +113,81 @@ void OrbitalBase::get_ratios(ParticleSet& P, vector<ValueType>& ratios)
   o << "OrbitalBase::get_ratios is not implemented by " << OrbitalName;
   APP_ABORT(o);
 }
+
+void OrbitalBase::evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios)
+{
+  ParticleSet& P(VP.refPS);
+  const int iat=VP.refPtcl;
+  for (int k=0; k<ratios.size(); ++k)
+  {
+    P.makeMoveOnSphere(iat,VP.R[k]-P.R[iat]);
+    ratios[k]=ratio(P,iat);
+    P.rejectMove(iat);
+  }
+}
+
+void OrbitalBase::mw_evaluateLog(const vector<OrbitalBase*>& wfc_list,
+                                 const vector<ParticleSet*>& P_list, vector<RealType>& logs)
+{
+  for (int iw=0; iw<wfc_list.size(); ++iw)
+    logs[iw] += wfc_list[iw]->evaluateLog(*P_list[iw],P_list[iw]->G,P_list[iw]->L);
+}
+
+void OrbitalBase::mw_ratio(const vector<OrbitalBase*>& wfc_list,
+                           const vector<ParticleSet*>& P_list, int iat, vector<ValueType>& ratios)
+{
+  for (int iw=0; iw<wfc_list.size(); ++iw)
+    ratios[iw]=wfc_list[iw]->ratio(*P_list[iw],iat);
+}
+
+void OrbitalBase::mw_ratioGrad(const vector<OrbitalBase*>& wfc_list,
+                               const vector<ParticleSet*>& P_list, int iat,
+                               vector<ValueType>& ratios, vector<GradType>& grad_new)
+{
+  for (int iw=0; iw<wfc_list.size(); ++iw)
+    ratios[iw]=wfc_list[iw]->ratioGrad(*P_list[iw],iat,grad_new[iw]);
+}
+
+void OrbitalBase::mw_acceptMove(const vector<OrbitalBase*>& wfc_list,
+                                const vector<ParticleSet*>& P_list, int iat,
+                                const vector<bool>& isAccepted)
+{
+  for (int iw=0; iw<wfc_list.size(); ++iw)
+    if(isAccepted[iw])
+      wfc_list[iw]->acceptMove(*P_list[iw],iat);
+    else
+      wfc_list[iw]->restore(iat);
+}
+
+WalkerResource* OrbitalBase::makeResource(ParticleSet& P)
+{
+  BufferResource* res=new BufferResource;
+  LogValue=registerData(P,res->Buffer);
+  return res;
+}
+
+void OrbitalBase::bindResource(ParticleSet& P, WalkerResource& res)
+{
+  BufferType& buf(static_cast<BufferResource&>(res).Buffer);
+  buf.rewind();
+  copyFromBuffer(P,buf);
+}
+
+OrbitalBase::RealType
+OrbitalBase::storeResource(ParticleSet& P, WalkerResource& res)
+{
+  BufferType& buf(static_cast<BufferResource&>(res).Buffer);
+  buf.rewind();
+  return evaluateLog(P,buf);
+}
+
+OrbitalBase::RealType
+OrbitalBase::updateResource(ParticleSet& P, WalkerResource& res, bool fromscratch)
+{
+  BufferType& buf(static_cast<BufferResource&>(res).Buffer);
+  buf.rewind();
+  return updateBuffer(P,buf,fromscratch);
+}
 }
 /***************************************************************************
  * $RCSfile$   $Author: jnkim $
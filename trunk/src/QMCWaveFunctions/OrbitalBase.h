@@ -18,6 +18,7 @@
 #define QMCPLUSPLUS_ORBITALBASE_H
 #include "Configuration.h"
 #include "Particle/ParticleSet.h"
+#include "Particle/VirtualParticleSet.h"
 #include "Particle/DistanceTableData.h"
 #include "OhmmsData/RecordProperty.h"
 #include "QMCWaveFunctions/OrbitalSetTraits.h"
@@ -399,6 +400,70 @@ struct OrbitalBase: public QMCTraits
    */
   virtual void dumpFromBuffer(ParticleSet& P, BufferType& buf) {}
 
+  /** walker-resident state of a component which keeps its data in a buffer
+   *
+   * Used by the default implementations of makeResource, bindResource
+   * and storeResource.
+   */
+  struct BufferResource: public WalkerResource
+  {
+    BufferType Buffer;
+    WalkerResource* makeClone() const
+    {
+      return new BufferResource(*this);
+    }
+    void copyFrom(const WalkerResource& a)
+    {
+      Buffer=static_cast<const BufferResource&>(a).Buffer;
+    }
+  };
+
+  /** create the state of a walker owned by the walker
+   * @param P particle set of the walker
+   * @return a new resource with the state evaluated from scratch
+   *
+   * As registerData, P.G and P.L are added by the gradients and laplacians.
+   * The default keeps the data of registerData in a BufferResource.
+   */
+  virtual WalkerResource* makeResource(ParticleSet& P);
+
+  /** bind this object to the state of a walker
+   * @param P particle set of the walker
+   * @param res resource created by makeResource
+   *
+   * Replaces copyFromBuffer. A derived class exchanges its data with res
+   * without copying them. The default copies the data from the buffer.
+   */
+  virtual void bindResource(ParticleSet& P, WalkerResource& res);
+
+  /** store the current state to the resource bound by bindResource
+   * @param P particle set of the walker
+   * @param res resource passed to bindResource
+   * @return log|psi| as evaluateLog(P,buf)
+   *
+   * Replaces evaluateLog(P,buf) after the moves are accepted.
+   * This object remains bound to res.
+   */
+  virtual RealType storeResource(ParticleSet& P, WalkerResource& res);
+
+  /** update the state of the walker at the end of a sweep
+   * @param P particle set of the walker
+   * @param res resource passed to bindResource
+   * @param fromscratch if true, the state is recomputed from scratch
+   * @return log|psi| as updateBuffer
+   *
+   * Replaces updateBuffer: P.G and P.L are added by the gradients and
+   * laplacians. This object remains bound to res.
+   */
+  virtual RealType updateResource(ParticleSet& P, WalkerResource& res, bool fromscratch);
+
+  /** release the resource bound by bindResource
+   *
+   * If the state has been changed since bindResource, storeResource
+   * has to be called before releaseResource.
+   */
+  virtual void releaseResource(ParticleSet& P, WalkerResource& res) {}
+
   /** return a proxy orbital of itself
    */
   OrbitalBasePtr makeProxy(ParticleSet& tqp);
@@ -445,6 +510,53 @@ struct OrbitalBase: public QMCTraits
    */
   virtual void get_ratios(ParticleSet& P, vector<ValueType>& ratios);
 
+  /** evaluate the ratios of the virtual moves of a particle
+   * @param VP virtual particle set
+   * @param ratios ratios[k] for the move of VP.refPtcl to VP.R[k]
+   *
+   * The default implementation moves the particle of VP.refPS to each virtual position
+   * and calls ratio. The derived classes evaluate all the ratios at once using
+   * the distance tables of VP.
+   */
+  virtual void evaluateRatios(VirtualParticleSet& VP, vector<ValueType>& ratios);
+
+  /////////////////////////////////////////////////////
+  // Functions for a crowd of walkers on CPUs        //
+  /////////////////////////////////////////////////////
+  /** evaluate the log of the orbitals of a crowd of walkers
+   * @param wfc_list the components of the same kind, one per walker, this==wfc_list[0]
+   * @param P_list particle sets, one per walker
+   * @param logs logs[iw] is added by the log value of the iw-th walker
+   *
+   * wfc_list[iw] and P_list[iw] hold the state of the iw-th walker.
+   * The default implementations of the mw_ functions call the single-walker
+   * functions of each walker. A derived class overrides them to fuse
+   * the evaluations and updates of the walkers.
+   */
+  virtual void mw_evaluateLog(const vector<OrbitalBase*>& wfc_list,
+                              const vector<ParticleSet*>& P_list, vector<RealType>& logs);
+
+  /** evaluate the ratios of a crowd of walkers for the move of the iat-th particle
+   * @param ratios ratios[iw] of the iw-th walker
+   */
+  virtual void mw_ratio(const vector<OrbitalBase*>& wfc_list,
+                        const vector<ParticleSet*>& P_list, int iat, vector<ValueType>& ratios);
+
+  /** evaluate the ratios and the gradients at the new positions of a crowd of walkers
+   * @param ratios ratios[iw] of the iw-th walker
+   * @param grad_new grad_new[iw] is added by the gradient of the iw-th walker
+   */
+  virtual void mw_ratioGrad(const vector<OrbitalBase*>& wfc_list,
+                            const vector<ParticleSet*>& P_list, int iat,
+                            vector<ValueType>& ratios, vector<GradType>& grad_new);
+
+  /** accept or reject the moves of the iat-th particle of a crowd of walkers
+   * @param isAccepted isAccepted[iw]=true, if the move of the iw-th walker is accepted
+   */
+  virtual void mw_acceptMove(const vector<OrbitalBase*>& wfc_list,
+                             const vector<ParticleSet*>& P_list, int iat,
+                             const vector<bool>& isAccepted);
+
   ///** copy data members from old
   // * @param old existing OrbitalBase from which all the data members are copied.
   // *
@@ -78,6 +78,29 @@ void SPOSetBase::evaluate_notranspose(const ParticleSet& P, int first, int last,
 }
 
 
+void SPOSetBase::evaluateValues(const VirtualParticleSet& VP, ValueMatrix_t& psiM)
+{
+  ParticleSet& P(VP.refPS);
+  const int iat=VP.refPtcl;
+  ValueVector_t psi(psiM.cols());
+  for (int k=0; k<VP.getTotalNum(); ++k)
+  {
+    P.makeMoveOnSphere(iat,VP.R[k]-P.R[iat]);
+    evaluate(P,iat,psi);
+    P.rejectMove(iat);
+    std::copy(psi.begin(),psi.end(),psiM[k]);
+  }
+}
+
+void SPOSetBase::mw_evaluate(const vector<SPOSetBase*>& spo_list, const vector<ParticleSet*>& P_list, int iat,
+                             const vector<ValueVector_t*>& psi_v_list,
+                             const vector<GradVector_t*>& dpsi_v_list,
+                             const vector<ValueVector_t*>& d2psi_v_list)
+{
+  for (int iw=0; iw<spo_list.size(); ++iw)
+    spo_list[iw]->evaluate(*P_list[iw],iat,*psi_v_list[iw],*dpsi_v_list[iw],*d2psi_v_list[iw]);
+}
+
 SPOSetBase* SPOSetBase::makeClone() const
 {
   APP_ABORT("Missing  SPOSetBase::makeClone for "+className);
@@ -19,6 +19,7 @@
 
 #include "OhmmsPETE/OhmmsArray.h"
 #include "Particle/ParticleSet.h"
+#include "Particle/VirtualParticleSet.h"
 #include "QMCWaveFunctions/OrbitalSetTraits.h"
 #if defined(ENABLE_SMARTPOINTER)
 #include <boost/shared_ptr.hpp>
@@ -174,6 +175,30 @@ public:
   evaluate(const ParticleSet& P, int iat,
            ValueVector_t& psi, GradVector_t& dpsi, ValueVector_t& d2psi)=0;
 
+  /** evaluate the values of this single-particle orbital set at the virtual positions
+   * @param VP virtual particle set
+   * @param psiM values, psiM(k,j) for the j-th orbital at VP.R[k]
+   *
+   * The default implementation moves VP.refPtcl of VP.refPS to each position.
+   */
+  virtual void evaluateValues(const VirtualParticleSet& VP, ValueMatrix_t& psiM);
+
+  /** evaluate the values, gradients and laplacians of a crowd of walkers for the iat-th particle
+   * @param spo_list SPO sets, one per walker, this==spo_list[0]
+   * @param P_list particle sets, one per walker
+   * @param iat active particle
+   * @param psi_v_list values, one per walker
+   * @param dpsi_v_list gradients, one per walker
+   * @param d2psi_v_list laplacians, one per walker
+   *
+   * The default implementation calls evaluate of each SPO set.
+   * The SPO sets sharing the same tables can evaluate all the positions by this.
+   */
+  virtual void mw_evaluate(const vector<SPOSetBase*>& spo_list, const vector<ParticleSet*>& P_list, int iat,
+                           const vector<ValueVector_t*>& psi_v_list,
+                           const vector<GradVector_t*>& dpsi_v_list,
+                           const vector<ValueVector_t*>& d2psi_v_list);
+
   /** evaluate the values, gradients and hessians of this single-particle orbital set
    * @param P current ParticleSet
    * @param iat active particle
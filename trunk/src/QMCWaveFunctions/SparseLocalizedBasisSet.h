@@ -100,6 +100,7 @@ struct SparseLocalizedBasisSet: public BasisSetBase<typename COT::value_type>
     CenterRef(ions), myTable(0)
   {
     myTable = DistanceTable::add(ions,els);
+    myTable->checkNeighborCutoff(-1.0,"SparseLocalizedBasisSet");
     NumCenters=CenterRef.getTotalNum();
     NumTargets=els.getTotalNum();
     NumGroups=CenterRef.getSpeciesSet().getTotalNum();
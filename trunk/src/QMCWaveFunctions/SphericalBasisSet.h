@@ -82,9 +82,11 @@ struct SphericalBasisSet
   vector<ROT*> Rnl;
   ///container for the quantum-numbers
   vector<QuantumNumberType> RnlID;
+  ///radius beyond which all the basis functions are negligible, negative if not set
+  RealType Rmax;
 
   ///the constructor
-  explicit SphericalBasisSet(int lmax, bool addsignforM=false, bool useXYZ=false):Ylm(lmax,addsignforM),XYZ(lmax),useCartesian(useXYZ) {}
+  explicit SphericalBasisSet(int lmax, bool addsignforM=false, bool useXYZ=false):Ylm(lmax,addsignforM),XYZ(lmax),useCartesian(useXYZ),Rmax(-1.0) {}
 
   ~SphericalBasisSet() { }
 
@@ -153,6 +155,31 @@ struct SphericalBasisSet
     CurrentOffset=offset;
   }
 
+  /** set Rmax by a tolerance of the basis functions
+   * @param eps tolerance of \f$|R_{nl}(r)r^l|\f$
+   * @param rlimit maximum radius of the search
+   * @param delta spacing of the search mesh
+   * @return Rmax
+   *
+   * The radial functions are scanned outward on a uniform mesh. The factor
+   * \f$r^l\f$ of the solid harmonics is included to be safe with the diffuse
+   * functions of high angular momentum.
+   */
+  RealType setCutoff(RealType eps, RealType rlimit, RealType delta)
+  {
+    Rmax=0.0;
+    for(int nl=0; nl<Rnl.size(); nl++)
+    {
+      int l=(nl<RnlID.size())?RnlID[nl][q_l]:0;
+      for(RealType r=delta; r<rlimit; r+=delta)
+      {
+        if(std::abs(Rnl[nl]->evaluate(r,1.0/r)*std::pow(r,l))>eps)
+          Rmax=std::max(Rmax,r+delta);
+      }
+    }
+    return Rmax;
+  }
+
   inline void
   evaluateForWalkerMove(int c, int iat, int offset, ValueVector_t& psi, GradVector_t& dpsi, ValueVector_t& d2psi)
   {
@@ -705,6 +732,55 @@ struct SphericalBasisSet
     }
   }
 
+  /** evaluate the value, laplacian and gradient of basis functions for the iath-particle
+   * @param y starting address of the OHMMS_DIM+2 rows of the particle
+   * @param ld leading dimension of the rows
+   *
+   * The rows are the values, laplacians and the components of the gradients.
+   */
+  inline void
+  evaluateForWalkerMove(int c, int iat, int offset, ValueType* restrict y, int ld)
+  {
+    int nn = myTable->M[c]+iat;
+    RealType r(myTable->r(nn));
+    RealType rinv(myTable->rinv(nn));
+    PosType  dr(myTable->dr(nn));
+    if(useCartesian)
+    {
+      XYZ.evaluateAll(dr);
+    }
+    else
+    {
+      Ylm.evaluateAll(dr);
+    }
+    std::vector<RealType>& valueYlm = useCartesian?XYZ.XYZ:Ylm.Ylm;
+    std::vector<PosType>& gradYlm = useCartesian?XYZ.gradXYZ:Ylm.gradYlm;
+    std::vector<RealType>& laplYlm = useCartesian?XYZ.laplXYZ:Ylm.laplYlm;
+    typename vector<ROT*>::iterator rit(Rnl.begin()), rit_end(Rnl.end());
+    while(rit != rit_end)
+    {
+      (*rit++)->evaluateAll(r,rinv);
+    }
+    ValueType* restrict vptr=y+offset;
+    ValueType* restrict lptr=vptr+ld;
+    ValueType* restrict gptr=lptr+ld;
+    vector<int>::iterator nlit(NL.begin()),nlit_end(NL.end()),lmit(LM.begin());
+    for(int k=0; nlit != nlit_end; ++k)
+    {
+      int nl(*nlit++);
+      int lm(*lmit++);
+      const ROT& rnl(*Rnl[nl]);
+      RealType drnloverr(rinv*rnl.dY);
+      RealType ang(valueYlm[lm]);
+      PosType gr_rad(drnloverr*dr);
+      PosType gr_ang(gradYlm[lm]);
+      vptr[k] = ang*rnl.Y;
+      lptr[k] = ang*(2.0*drnloverr+rnl.d2Y) + 2.0*dot(gr_rad,gr_ang) + rnl.Y*laplYlm[lm];
+      for(int d=0; d<OHMMS_DIM; ++d)
+        gptr[d*ld+k] = ang*gr_rad[d]+rnl.Y*gr_ang[d];
+    }
+  }
+
   inline void
   evaluateForPtclMove(int source, int iat,  int offset, ValueVector_t& y)
   {
@@ -10,6 +10,7 @@
  */
 #ifndef QMCPLUSPLUS_EINSPLINE_BASE_ADOPTOR_READER_H
 #define QMCPLUSPLUS_EINSPLINE_BASE_ADOPTOR_READER_H
+#include <Message/NodeSharedMemory.h>
 namespace qmcplusplus
 {
 
@@ -163,6 +164,128 @@ struct BsplineReaderBase
     myComm->bcast(cG);
   }
 
+  /** return the key of the cached spline table
+   * @param spin spin index
+   * @param sizeD sizeof the data type of the table
+   * @param mesh mesh of the table
+   *
+   * The key combines the size and the modification time of the ESHDF file,
+   * a hash of the G vectors and of the twists, bands and eigenvalues of the
+   * orbitals, and the parameters which determine the table. These are at
+   * hand, so that the key does not read the file. A cached table is used
+   * only when the keys match.
+   */
+  string spline_cache_key(int spin, int sizeD, const TinyVector<int,3>& mesh)
+  {
+    struct stat fs;
+    if(stat(mybuilder->H5FileName.c_str(),&fs))
+      fs.st_size=fs.st_mtime=0;
+    const vector<TinyVector<int,3> >& gv(mybuilder->Gvecs[0]);
+    uint64_t h=hash_bytes(gv.empty()? 0:&gv[0],gv.size()*sizeof(TinyVector<int,3>));
+    const std::vector<BandInfo>& SortBands(mybuilder->SortBands);
+    for(int iorb=0; iorb<mybuilder->NumDistinctOrbitals; ++iorb)
+    {
+      h=hash_bytes(&SortBands[iorb].TwistIndex,sizeof(int),h);
+      h=hash_bytes(&SortBands[iorb].BandIndex,sizeof(int),h);
+      h=hash_bytes(&SortBands[iorb].Energy,sizeof(double),h);
+    }
+    ostringstream o;
+    o << "eshdf " << static_cast<long>(fs.st_size) << " " << static_cast<long>(fs.st_mtime)
+      << " bands " << std::hex << h << std::dec
+      << " spin " << spin << " twist " << mybuilder->TwistNum
+      << " " << mybuilder->TwistAngles[SortBands[0].TwistIndex]
+      << " tile " << mybuilder->TileMatrix
+      << " mesh " << mesh << " sizeof " << sizeD
+      << " orbitals " << mybuilder->NumDistinctOrbitals;
+    return o.str();
+  }
+
+  /** read the cached spline table
+   * @param splinefile file name
+   * @param key key of the table
+   * @param bspline spline set to be filled
+   * @return 1, if the table with the key is found and read
+   */
+  template<typename SPE>
+  int read_spline_cache(const string& splinefile, const string& key, SPE* bspline)
+  {
+    //hdf_archive::open creates a missing file
+    if(access(splinefile.c_str(),F_OK))
+      return 0;
+    hdf_archive h5f;
+    int foundspline=h5f.open(splinefile,H5F_ACC_RDONLY);
+    if(foundspline)
+    {
+      string aname("none");
+      foundspline = h5f.read(aname,"adoptor_name");
+      foundspline = (aname.find(bspline->KeyWord) != std::string::npos);
+    }
+    if(foundspline)
+    {
+      int sizeD=0;
+      foundspline=h5f.read(sizeD,"sizeof");
+      foundspline = (sizeD == sizeof(typename SPE::DataType));
+    }
+    if(foundspline)
+    {
+      string cached("none");
+      foundspline=h5f.read(cached,"cache_key");
+      foundspline = (cached == key);
+      if(!foundspline)
+        app_log() << "  Spline table in " << splinefile << " is out of date. Rebuilding." << endl;
+    }
+    if(foundspline)
+      foundspline=bspline->read_splines(h5f);
+    return foundspline;
+  }
+
+  /** write the spline table with the key
+   */
+  template<typename SPE>
+  void write_spline_cache(const string& splinefile, const string& key, SPE* bspline)
+  {
+    hdf_archive h5f;
+    if(!h5f.create(splinefile))
+    {
+      app_warning() << "  Cannot create " << splinefile << " to cache the spline table." << endl;
+      return;
+    }
+    h5f.write(bspline->AdoptorName,"adoptor_name");
+    int sizeD=sizeof(typename SPE::DataType);
+    h5f.write(sizeD,"sizeof");
+    //the string read drops the last character, the null of the ESHDF strings
+    string ckey(key);
+    ckey.push_back('\0');
+    h5f.write(ckey,"cache_key");
+    bspline->write_splines(h5f);
+  }
+
+  /** place the coefficients of a spline table in node-level shared memory
+   * @param shm node-level shared memory
+   * @param spline einspline table created with the private coefficients
+   * @return true, if the coefficients are shared by the tasks on the node
+   *
+   * Only the node leader may write to the shared coefficients.
+   */
+  template<typename SPT>
+  bool share_spline(NodeSharedMemory& shm, SPT* spline)
+  {
+    void* ptr=shm.allocate(spline->coefs_size*sizeof(spline->coefs[0]));
+    if(ptr==0)
+      return false;
+    void* old=spline->coefs;
+    spline->coefs=coefs_cast(ptr,spline->coefs[0]);
+    free(old);
+    return true;
+  }
+
+  ///cast to the type of the coefficients
+  template<typename T>
+  inline T* coefs_cast(void* ptr, const T&)
+  {
+    return static_cast<T*>(ptr);
+  }
+
   virtual ~BsplineReaderBase() {}
 
   /** create the actual spline sets
@@ -203,38 +326,45 @@ struct SplineAdoptorReader: public BsplineReaderBase
       APP_ABORT("EinsplineAdoptorReader needs psi_g. Set precision=\"double\".");
     }
     bspline->create_spline(xyz_grid,xyz_bc);
+    //the node leaders fill the shared table for the tasks on the node
+    NodeSharedMemory* nodeShm=0;
+    bool shared_table=false;
+    bool fill_table=true;
+    if(qmc_common.shared_splines)
+    {
+      nodeShm=new NodeSharedMemory(myComm);
+      shared_table=share_spline(*nodeShm,bspline->MultiSpline);
+      fill_table=(!shared_table || nodeShm->isLeader());
+      app_log() << "  Spline table shared by " << (shared_table?nodeShm->NodeComm->size():1)
+                << " tasks on a node" << endl;
+    }
     int TwistNum = mybuilder->TwistNum;
     string splinefile
     =make_spline_filename(mybuilder->H5FileName,mybuilder->TileMatrix
                           ,spin,TwistNum,mybuilder->MeshSize);
     bool root=(myComm->rank() == 0);
     int foundspline=0;
+    string cache_key;
     Timer now;
     if(root)
     {
-      hdf_archive h5f;
-      foundspline=h5f.open(splinefile,H5F_ACC_RDONLY);
-      if(foundspline)
-      {
-        string aname("none");
-        foundspline = h5f.read(aname,"adoptor_name");
-        foundspline = (aname.find(bspline->KeyWord) != std::string::npos);
-      }
-      if(foundspline)
-      {
-        int sizeD=0;
-        foundspline=h5f.read(sizeD,"sizeof");
-        foundspline = (sizeD == sizeof(typename adoptor_type::DataType));
-      }
-      if(foundspline)
-        bspline->read_splines(h5f);
+      cache_key=spline_cache_key(spin,sizeof(DataType),mybuilder->MeshSize);
+      foundspline=read_spline_cache(splinefile,cache_key,bspline);
     }
     myComm->bcast(foundspline);
     t_h5 = now.elapsed();
     if(foundspline)
     {
       app_log() << "Use existing bspline tables in " << splinefile << endl;
-      chunked_bcast(myComm, bspline->MultiSpline);
+      if(nodeShm)
+      {
+        if(nodeShm->isLeader())
+          chunked_bcast(nodeShm->LeaderComm, bspline->MultiSpline);
+        if(!shared_table)
+          chunked_bcast(nodeShm->NodeComm, bspline->MultiSpline);
+      }
+      else
+        chunked_bcast(myComm, bspline->MultiSpline);
       t_init+=now.elapsed();
     }
     else
@@ -265,6 +395,8 @@ struct SplineAdoptorReader: public BsplineReaderBase
         {
           int ti=SortBands[iorb].TwistIndex;
           get_psi_g(ti,spin,SortBands[iorb].BandIndex,cG);
+          if(!fill_table)
+            continue;
           c_unpack.restart();
           unpack4fftw(cG,mybuilder->Gvecs[0],mybuilder->MeshSize,FFTbox);
           t_unpack+= c_unpack.elapsed();
@@ -303,15 +435,13 @@ struct SplineAdoptorReader: public BsplineReaderBase
       //    bspline->set_spline(splineData_r.data(),splineData_i.data(),iorb);
       //  }
       //}
-      if(qmc_common.save_wfs && root)
-      {
-        hdf_archive h5f;
-        h5f.create(splinefile);
-        h5f.write(bspline->AdoptorName,"adoptor_name");
-        int sizeD=sizeof(typename adoptor_type::DataType);
-        h5f.write(sizeD,"sizeof");
-        bspline->write_splines(h5f);
-      }
+      if((qmc_common.save_wfs || qmc_common.spline_cache) && root)
+        write_spline_cache(splinefile,cache_key,bspline);
+    }
+    if(nodeShm)
+    {
+      nodeShm->fence();
+      delete nodeShm;
     }
     app_log() << "    READBANDS::PREP   = " << t_prep << endl;
     app_log() << "    READBANDS::H5     = " << t_h5 << endl;
@@ -32,6 +32,9 @@ struct SplineMixedAdoptorReader: public BsplineReaderBase
       app_log() << "  Using complex einspline table" << endl;
     else
       app_log() << "  Using real einspline table" << endl;
+    if(qmc_common.shared_splines)
+      app_warning() << "  --shared_splines is not supported with truncate=\"yes\". "
+                    << "Every task keeps its own spline tables." << endl;
     check_twists(orbitalSet,bspline);
     Ugrid xyz_grid[3];
     typename adoptor_type::BCType xyz_bc[3];
@@ -134,25 +137,15 @@ struct SplineMixedAdoptorReader: public BsplineReaderBase
     bspline->add_box(dense_r,lower,upper);
     int foundspline=0;
     string splinefile=make_spline_filename(mybuilder->H5FileName,spin,mybuilder->TwistNum,MeshSize);
+    string cache_key;
     Timer now;
     if(myComm->rank()==0)
     {
-      hdf_archive h5f;
-      foundspline=h5f.open(splinefile,H5F_ACC_RDONLY);
-      if(foundspline)
-      {
-        string aname("none");
-        foundspline = h5f.read(aname,"adoptor_name");
-        foundspline = (aname.find(bspline->KeyWord) != std::string::npos);
-      }
-      if(foundspline)
-      {
-        int sizeD=0;
-        foundspline=h5f.read(sizeD,"sizeof");
-        foundspline = (sizeD == sizeof(typename adoptor_type::DataType));
-      }
-      if(foundspline)
-        foundspline=bspline->read_splines(h5f);
+      ostringstream o;
+      o << spline_cache_key(spin,sizeof(typename adoptor_type::DataType),MeshSize)
+        << " coarse " << coarse_mesh << " lower " << lower << " upper " << upper;
+      cache_key=o.str();
+      foundspline=read_spline_cache(splinefile,cache_key,bspline);
     }
     myComm->bcast(foundspline);
     if(foundspline)
@@ -218,15 +211,8 @@ struct SplineMixedAdoptorReader: public BsplineReaderBase
         free(dense_i);
       }
       fftw_destroy_plan(FFTplan);
-      if(qmc_common.save_wfs && myComm->rank()==0)
-      {
-        hdf_archive h5f;
-        h5f.create(splinefile);
-        h5f.write(bspline->AdoptorName,"adoptor_name");
-        int sizeD=sizeof(typename adoptor_type::DataType);
-        h5f.write(sizeD,"sizeof");
-        bspline->write_splines(h5f);
-      }
+      if((qmc_common.save_wfs || qmc_common.spline_cache) && myComm->rank()==0)
+        write_spline_cache(splinefile,cache_key,bspline);
     }
     app_log() << "TIME READBANDS " << now.elapsed() << endl;
     return bspline;
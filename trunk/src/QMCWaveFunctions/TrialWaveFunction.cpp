@@ -567,6 +567,134 @@ void   TrialWaveFunction::acceptMove(ParticleSet& P,int iat)
 //  for(int i=0; i<Z.size(); i++) Z[i]->resizeByWalkers(nwalkers);
 //}
 
+void TrialWaveFunction::flex_evaluateLog(const vector<TrialWaveFunction*>& wf_list,
+    const vector<ParticleSet*>& P_list, vector<RealType>& logpsi_list)
+{
+  const int nw=wf_list.size();
+  if(nw==1)
+  {
+    logpsi_list[0]=wf_list[0]->evaluateLog(*P_list[0]);
+    return;
+  }
+  vector<OrbitalBase*> wfc_list(nw);
+  vector<RealType> logs(nw,0.0);
+  for (int iw=0; iw<nw; ++iw)
+  {
+    P_list[iw]->G=0.0;
+    P_list[iw]->L=0.0;
+    wf_list[iw]->PhaseValue=0.0;
+  }
+  for (int i=0; i<wf_list[0]->Z.size(); ++i)
+  {
+    for (int iw=0; iw<nw; ++iw)
+      wfc_list[iw]=wf_list[iw]->Z[i];
+    wfc_list[0]->mw_evaluateLog(wfc_list,P_list,logs);
+    for (int iw=0; iw<nw; ++iw)
+      wf_list[iw]->PhaseValue += wfc_list[iw]->PhaseValue;
+  }
+  for (int iw=0; iw<nw; ++iw)
+    logpsi_list[iw]=wf_list[iw]->LogValue=logs[iw];
+}
+
+void TrialWaveFunction::flex_ratio(const vector<TrialWaveFunction*>& wf_list,
+                                   const vector<ParticleSet*>& P_list, int iat, vector<RealType>& ratios)
+{
+  const int nw=wf_list.size();
+  if(nw==1)
+  {
+    ratios[0]=wf_list[0]->ratio(*P_list[0],iat);
+    return;
+  }
+  vector<OrbitalBase*> wfc_list(nw);
+  vector<ValueType> r(nw,1.0), ratios_z(nw);
+  for (int i=0; i<wf_list[0]->Z.size(); ++i)
+  {
+    for (int iw=0; iw<nw; ++iw)
+      wfc_list[iw]=wf_list[iw]->Z[i];
+    wfc_list[0]->mw_ratio(wfc_list,P_list,iat,ratios_z);
+    for (int iw=0; iw<nw; ++iw)
+      r[iw] *= ratios_z[iw];
+  }
+  for (int iw=0; iw<nw; ++iw)
+  {
+#if defined(QMC_COMPLEX)
+    ratios[iw]=std::exp(evaluateLogAndPhase(r[iw],wf_list[iw]->PhaseDiff));
+#else
+    if (r[iw]<0)
+      wf_list[iw]->PhaseDiff=M_PI;
+    ratios[iw]=r[iw];
+#endif
+  }
+}
+
+void TrialWaveFunction::flex_ratioGrad(const vector<TrialWaveFunction*>& wf_list,
+                                       const vector<ParticleSet*>& P_list, int iat,
+                                       vector<RealType>& ratios, vector<GradType>& grad_new)
+{
+  const int nw=wf_list.size();
+  if(nw==1)
+  {
+    ratios[0]=wf_list[0]->ratioGrad(*P_list[0],iat,grad_new[0]);
+    return;
+  }
+  vector<OrbitalBase*> wfc_list(nw);
+  vector<ValueType> r(nw,1.0), ratios_z(nw);
+  for (int iw=0; iw<nw; ++iw)
+    grad_new[iw]=0.0;
+  for (int i=0; i<wf_list[0]->Z.size(); ++i)
+  {
+    for (int iw=0; iw<nw; ++iw)
+      wfc_list[iw]=wf_list[iw]->Z[i];
+    wfc_list[0]->mw_ratioGrad(wfc_list,P_list,iat,ratios_z,grad_new);
+    for (int iw=0; iw<nw; ++iw)
+      r[iw] *= ratios_z[iw];
+  }
+  for (int iw=0; iw<nw; ++iw)
+  {
+#if defined(QMC_COMPLEX)
+    ratios[iw]=std::exp(evaluateLogAndPhase(r[iw],wf_list[iw]->PhaseDiff));
+#else
+    if (r[iw]<0)
+      wf_list[iw]->PhaseDiff=M_PI;
+    ratios[iw]=r[iw];
+#endif
+  }
+}
+
+void TrialWaveFunction::flex_acceptMove(const vector<TrialWaveFunction*>& wf_list,
+                                        const vector<ParticleSet*>& P_list, int iat,
+                                        const vector<bool>& isAccepted)
+{
+  const int nw=wf_list.size();
+  if(nw==1)
+  {
+    if(isAccepted[0])
+      wf_list[0]->acceptMove(*P_list[0],iat);
+    else
+      wf_list[0]->rejectMove(iat);
+    return;
+  }
+  vector<OrbitalBase*> wfc_list(nw);
+  for (int i=0; i<wf_list[0]->Z.size(); ++i)
+  {
+    for (int iw=0; iw<nw; ++iw)
+      wfc_list[iw]=wf_list[iw]->Z[i];
+    wfc_list[0]->mw_acceptMove(wfc_list,P_list,iat,isAccepted);
+  }
+  for (int iw=0; iw<nw; ++iw)
+  {
+    TrialWaveFunction& wf(*wf_list[iw]);
+    if(isAccepted[iw])
+    {
+      wf.PhaseValue += wf.PhaseDiff;
+      wf.LogValue=0;
+      for (int i=0; i<wf.Z.size(); i++)
+        wf.LogValue+= wf.Z[i]->LogValue;
+    }
+    wf.PhaseDiff=0.0;
+  }
+}
+
 void TrialWaveFunction::checkInVariables(opt_variables_type& active)
 {
   for (int i=0; i<Z.size(); i++)
@@ -695,6 +823,69 @@ void TrialWaveFunction::copyFromBuffer(ParticleSet& P, PooledData<RealType>& buf
   buf.get(&(P.L[0]), &(P.L[0])+NumPtcls);
 }
 
+TrialWaveFunction::RealType
+TrialWaveFunction::registerResources(ParticleSet& P, WalkerResourceSet& res)
+{
+  delta_G.resize(P.getTotalNum());
+  delta_L.resize(P.getTotalNum());
+  P.G = 0.0;
+  P.L = 0.0;
+  res.clear();
+  ValueType logpsi(0.0);
+  PhaseValue=0.0;
+  for (int i=0; i<Z.size(); i++)
+  {
+    res.push_back(Z[i]->makeResource(P));
+    logpsi += Z[i]->LogValue;
+    PhaseValue += Z[i]->PhaseValue;
+  }
+  convert(logpsi,LogValue);
+  NumPtcls = P.getTotalNum();
+  TotalDim = PosType::Size*NumPtcls;
+  return LogValue;
+}
+
+void TrialWaveFunction::bindResources(ParticleSet& P, WalkerResourceSet& res)
+{
+  for (int i=0; i<Z.size(); i++)
+    Z[i]->bindResource(P,res[i]);
+}
+
+TrialWaveFunction::RealType
+TrialWaveFunction::storeResources(ParticleSet& P, WalkerResourceSet& res)
+{
+  LogValue=0.0;
+  PhaseValue=0.0;
+  for (int i=0; i<Z.size(); i++)
+  {
+    LogValue += Z[i]->storeResource(P,res[i]);
+    PhaseValue += Z[i]->PhaseValue;
+  }
+  return LogValue;
+}
+
+TrialWaveFunction::RealType
+TrialWaveFunction::updateResources(ParticleSet& P, WalkerResourceSet& res, bool fromscratch)
+{
+  P.G = 0.0;
+  P.L = 0.0;
+  ValueType logpsi(0.0);
+  PhaseValue=0.0;
+  for (int i=0; i<Z.size(); i++)
+  {
+    logpsi += Z[i]->updateResource(P,res[i],fromscratch);
+    PhaseValue += Z[i]->PhaseValue;
+  }
+  convert(logpsi,LogValue);
+  return LogValue;
+}
+
+void TrialWaveFunction::releaseResources(ParticleSet& P, WalkerResourceSet& res)
+{
+  for (int i=0; i<Z.size(); i++)
+    Z[i]->releaseResource(P,res[i]);
+}
+
 /** Dump data that are required to evaluate ratios to the buffer
 * @param P active ParticleSet
 * @param buf anonymous buffer to which the data will be dumped.
@@ -744,8 +935,9 @@ TrialWaveFunction::evaluateLog(ParticleSet& P, PooledData<RealType>& buf)
   }
   buf.put(PhaseValue);
   buf.put(LogValue);
-  //buf.put(&(P.G[0][0]), &(P.G[0][0])+TotalDim);
-  //buf.put(&(P.L[0]), &(P.L[0])+NumPtcls);
+  //copyFromBuffer restores the gradients and laplacians of the moves
+  buf.put(&(P.G[0][0]), &(P.G[0][0])+TotalDim);
+  buf.put(&(P.L[0]), &(P.L[0])+NumPtcls);
   return LogValue;
 }
 
@@ -862,6 +1054,23 @@ TrialWaveFunction::KECorrection() const
   return sum;
 }
 
+void TrialWaveFunction::evaluateRatios(VirtualParticleSet& VP, vector<RealType>& ratios)
+{
+  vector<ValueType> r(ratios.size(),1.0), t(ratios.size());
+  for (int i=0; i<Z.size(); ++i)
+  {
+    Z[i]->evaluateRatios(VP,t);
+    for (int j=0; j<t.size(); ++j)
+      r[j]*=t[j];
+  }
+#if defined(QMC_COMPLEX)
+  for (int j=0; j<r.size(); ++j)
+    ratios[j]=std::real(r[j]);
+#else
+  std::copy(r.begin(),r.end(),ratios.begin());
+#endif
+}
+
 void TrialWaveFunction::get_ratios(ParticleSet& P, vector<ValueType>& ratios)
 {
   std::fill(ratios.begin(),ratios.end(),1.0);
@@ -272,6 +272,28 @@ public:
   void dumpToBuffer(ParticleSet& P, BufferType& buf);
   void dumpFromBuffer(ParticleSet& P, BufferType& buf);
 
+  /** @{ walker-resident state
+   *
+   * The state of a walker is kept by Walker::Resources, one resource per component.
+   * bindResources and storeResources replace copyFromBuffer and evaluateLog(P,buf).
+   * A component which supports it exchanges its data with the walker without copying.
+   */
+  /** create the resources of a walker from scratch
+   * @param P particle set of the walker
+   * @param res resources of the walker, cleared first
+   * @return log|psi|
+   */
+  RealType registerResources(ParticleSet& P, WalkerResourceSet& res);
+  /** bind the components to the resources of a walker */
+  void bindResources(ParticleSet& P, WalkerResourceSet& res);
+  /** store the state after the moves are accepted and return log|psi| */
+  RealType storeResources(ParticleSet& P, WalkerResourceSet& res);
+  /** update the bound resources at the end of a sweep as updateBuffer and return log|psi| */
+  RealType updateResources(ParticleSet& P, WalkerResourceSet& res, bool fromscratch=false);
+  /** release the resources of a walker */
+  void releaseResources(ParticleSet& P, WalkerResourceSet& res);
+  //@}
+
   RealType KECorrection() const;
 
   void evaluateDerivatives(ParticleSet& P,
@@ -304,6 +326,15 @@ public:
   }
 
   void get_ratios(ParticleSet& P, vector<ValueType>& ratios);
+
+  /** evaluate the ratios of the virtual moves of VP.refPtcl
+   * @param VP virtual particle set
+   * @param ratios ratios[k] for the move to VP.R[k]
+   *
+   * For complex wavefunctions, ratios[k] is the real part of the ratio.
+   * The state of the wavefunction is not changed.
+   */
+  void evaluateRatios(VirtualParticleSet& VP, vector<RealType>& ratios);
   void setTwist(vector<RealType> t)
   {
     myTwist=t;
@@ -313,6 +344,32 @@ public:
     return myTwist;
   }
 
+  /** @name functions for a crowd of walkers
+   *
+   * wf_list[iw] and P_list[iw] hold the state of the iw-th walker of a crowd.
+   * The components of the same index are handled together by the mw_ functions
+   * of OrbitalBase. A crowd of one walker uses the single-walker functions,
+   * which remain the reference implementation.
+   */
+  //@{
+  static void flex_evaluateLog(const vector<TrialWaveFunction*>& wf_list,
+                               const vector<ParticleSet*>& P_list, vector<RealType>& logpsi_list);
+
+  static void flex_ratio(const vector<TrialWaveFunction*>& wf_list,
+                         const vector<ParticleSet*>& P_list, int iat, vector<RealType>& ratios);
+
+  static void flex_ratioGrad(const vector<TrialWaveFunction*>& wf_list,
+                             const vector<ParticleSet*>& P_list, int iat,
+                             vector<RealType>& ratios, vector<GradType>& grad_new);
+
+  /** accept or reject the moves of the iat-th particle
+   * @param isAccepted isAccepted[iw]=true, if the move of the iw-th walker is accepted
+   */
+  static void flex_acceptMove(const vector<TrialWaveFunction*>& wf_list,
+                              const vector<ParticleSet*>& P_list, int iat,
+                              const vector<bool>& isAccepted);
+  //@}
+
   CoefficientHolder coefficientHistory;
 
   inline void setMassTerm(ParticleSet& P)
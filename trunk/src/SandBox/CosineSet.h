@@ -0,0 +1,118 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/** @file CosineSet.h
+ * @brief analytic orbitals for the checks of the determinants
+ */
+#ifndef QMCPLUSPLUS_SANDBOX_COSINESET_H
+#define QMCPLUSPLUS_SANDBOX_COSINESET_H
+#include "Utilities/RandomGenerator.h"
+#include "QMCWaveFunctions/SPOSetBase.h"
+
+namespace qmcplusplus
+{
+/** orbitals phi_j(r)=cos(k_j.r+a_j) with random k_j and a_j
+ */
+struct CosineSet: public SPOSetBase
+{
+  vector<PosType> K;
+  vector<RealType> Phase;
+
+  CosineSet(int norb): K(norb), Phase(norb)
+  {
+    OrbitalSetSize=BasisSetSize=norb;
+    Identity=true;
+    className="CosineSet";
+    t_logpsi.resize(norb,norb);
+    for(int j=0; j<norb; ++j)
+    {
+      for(int d=0; d<OHMMS_DIM; ++d)
+        K[j][d]=2.0*Random()-1.0;
+      Phase[j]=6.0*Random();
+    }
+  }
+
+  void resetParameters(const opt_variables_type& active) {}
+  void resetTargetParticleSet(ParticleSet& P) {}
+  void setOrbitalSetSize(int norbs) {}
+
+  SPOSetBase* makeClone() const
+  {
+    return new CosineSet(*this);
+  }
+
+  inline void evaluate_p(const PosType& r, ValueType* restrict psi, GradType* restrict dpsi, ValueType* restrict d2psi)
+  {
+    for(int j=0; j<OrbitalSetSize; ++j)
+    {
+      RealType s, c;
+      sincos(dot(K[j],r)+Phase[j],&s,&c);
+      psi[j]=c;
+      dpsi[j]=-s*K[j];
+      d2psi[j]=-dot(K[j],K[j])*c;
+    }
+  }
+
+  void evaluate(const ParticleSet& P, int iat, ValueVector_t& psi)
+  {
+    for(int j=0; j<OrbitalSetSize; ++j)
+      psi[j]=std::cos(dot(K[j],P.R[iat])+Phase[j]);
+  }
+
+  void evaluate(const ParticleSet& P, int iat, ValueVector_t& psi, GradVector_t& dpsi, ValueVector_t& d2psi)
+  {
+    evaluate_p(P.R[iat],psi.data(),dpsi.data(),d2psi.data());
+  }
+
+  void evaluate(const ParticleSet& P, int iat, ValueVector_t& psi, GradVector_t& dpsi, HessVector_t& grad_grad_psi)
+  {
+    for(int j=0; j<OrbitalSetSize; ++j)
+    {
+      RealType s, c;
+      sincos(dot(K[j],P.R[iat])+Phase[j],&s,&c);
+      psi[j]=c;
+      dpsi[j]=-s*K[j];
+      grad_grad_psi[j]=-c*outerProduct(K[j],K[j]);
+    }
+  }
+
+  void evaluate_notranspose(const ParticleSet& P, int first, int last
+                            , ValueMatrix_t& logdet, GradMatrix_t& dlogdet, ValueMatrix_t& d2logdet)
+  {
+    for(int i=0,iat=first; iat<last; ++i,++iat)
+      evaluate_p(P.R[iat],logdet[i],dlogdet[i],d2logdet[i]);
+  }
+
+  void evaluate_notranspose(const ParticleSet& P, int first, int last
+                            , ValueMatrix_t& logdet, GradMatrix_t& dlogdet, HessMatrix_t& grad_grad_logdet)
+  {
+    for(int i=0,iat=first; iat<last; ++i,++iat)
+      for(int j=0; j<OrbitalSetSize; ++j)
+      {
+        RealType s, c;
+        sincos(dot(K[j],P.R[iat])+Phase[j],&s,&c);
+        logdet(i,j)=c;
+        dlogdet(i,j)=-s*K[j];
+        grad_grad_logdet(i,j)=-c*outerProduct(K[j],K[j]);
+      }
+  }
+};
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,192 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file backflow_ratio.cpp
+ * @brief Check the rank-k updates of DiracDeterminantWithBackflow
+ *
+ * Electrons with a short-ranged e-e backflow are moved one at a time. A move
+ * changes the quasi-particles within the backflow cutoff, so the ratios are
+ * taken either by the rank-k update or by the full inversion. The ratios of
+ * ratio and ratioGrad are compared with those of a second wavefunction
+ * evaluated from scratch, the inverses are compared after the moves.
+ * Returns 1 if any difference exceeds eps.
+ *
+ * Usage: backflow_ratio [-n electrons-per-spin] [-m moves] [-r cutoff]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Utilities/RandomGenerator.h"
+#include "Message/Communicate.h"
+#include "Particle/ParticleSet.h"
+#include "QMCWaveFunctions/Fermion/SlaterDetWithBackflow.h"
+#include "QMCWaveFunctions/Fermion/DiracDeterminantWithBackflow.h"
+#include "QMCWaveFunctions/Fermion/BackflowTransformation.h"
+#include "QMCWaveFunctions/Fermion/Backflow_ee.h"
+#include "QMCWaveFunctions/Jastrow/BsplineFunctor.h"
+#include "SandBox/CosineSet.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef DiracDeterminantWithBackflow det_t;
+
+/** create electrons and the Slater determinants with the e-e backflow */
+SlaterDetWithBackflow* create_wfc(ParticleSet& P, int nup, double rcut, CosineSet& spo)
+{
+  P.setName("e");
+  vector<int> ng(2,nup);
+  P.create(ng);
+  SpeciesSet& species(P.getSpeciesSet());
+  species.addSpecies("u");
+  species.addSpecies("d");
+  P.resetGroups();
+  //open boundary conditions: every move is valid
+  P.setBoundBox(false);
+  BackflowTransformation* bf=new BackflowTransformation(P);
+  Backflow_ee<BsplineFunctor<double> >* bfee=new Backflow_ee<BsplineFunctor<double> >(P,P);
+  BsplineFunctor<double>* eta=new BsplineFunctor<double>;
+  eta->cutoff_radius=rcut;
+  eta->resize(4);
+  eta->Parameters[0]=0.3;
+  eta->Parameters[1]=0.2;
+  eta->Parameters[2]=0.1;
+  eta->Parameters[3]=0.05;
+  eta->reset();
+  bfee->addFunc(0,0,eta);
+  bf->bfFuns.push_back(bfee);
+  SlaterDetWithBackflow* sdet=new SlaterDetWithBackflow(P,bf);
+  for(int ig=0; ig<2; ++ig)
+  {
+    det_t* adet=new det_t(P,spo.makeClone(),bf,P.first(ig));
+    adet->set(P.first(ig),nup);
+    sdet->add(adet,ig);
+  }
+  sdet->resetTargetParticleSet(P);
+  return sdet;
+}
+
+/** return the sign and the log of the determinants of P evaluated from scratch */
+double log_from_scratch(ParticleSet& P, SlaterDetWithBackflow& sdet, double& sign)
+{
+  P.update();
+  double logpsi=sdet.evaluateLog(P,P.G,P.L);
+  sign=std::cos(sdet.PhaseValue);
+  return logpsi;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("backflow_ratio",OHMMS::Controller->rank());
+  int nup=16;
+  int nmoves=64;
+  double rcut=2.0;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      nup=atoi(argv[++ic]);
+    else
+      if(c=="-m")
+        nmoves=atoi(argv[++ic]);
+      else
+        if(c=="-r")
+          rcut=atof(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-8;
+  Random.init(0,1,11);
+  CosineSet spo(nup);
+  ParticleSet P, P_ref;
+  SlaterDetWithBackflow* sdet=create_wfc(P,nup,rcut,spo);
+  SlaterDetWithBackflow* sdet_ref=create_wfc(P_ref,nup,rcut,spo);
+  //a box in which a move changes a few quasi-particles or, at times, many
+  const double L=std::pow(2.0*nup,1.0/3.0)*1.6;
+  for(int iat=0; iat<P.getTotalNum(); ++iat)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      P.R[iat][d]=P_ref.R[iat][d]=L*Random();
+  P.update();
+  OrbitalBase::BufferType buf;
+  sdet->registerData(P,buf);
+  double sign_ref;
+  double log_ref=log_from_scratch(P_ref,*sdet_ref,sign_ref);
+  double err_ratio=0.0, err_inv=0.0;
+  int nrankk=0, nfull=0;
+  const int nel=P.getTotalNum();
+  for(int m=0; m<nmoves; ++m)
+  {
+    const int iat=m%nel;
+    OrbitalBase::PosType dr;
+    for(int d=0; d<OHMMS_DIM; ++d)
+      dr[d]=0.8*(Random()-0.5);
+    P.makeMoveAndCheck(iat,dr);
+    OrbitalBase::ValueType r;
+    if(m%2)
+      r=sdet->ratio(P,iat);
+    else
+    {
+      OrbitalBase::GradType g;
+      r=sdet->ratioGrad(P,iat,g);
+    }
+    const det_t& moved(static_cast<const det_t&>(*sdet->Dets[iat<nup?0:1]));
+    const det_t& other(static_cast<const det_t&>(*sdet->Dets[iat<nup?1:0]));
+    if(std::max(moved.MovedQP.size(),other.MovedQP.size())>moved.MaxRankUpdate)
+      ++nfull;
+    else
+      ++nrankk;
+    P_ref.R[iat]=P.R[iat];
+    double sign_new;
+    double log_new=log_from_scratch(P_ref,*sdet_ref,sign_new);
+    double r_ref=sign_new*sign_ref*std::exp(log_new-log_ref);
+    err_ratio=std::max(err_ratio,std::abs(r-r_ref)/std::abs(r_ref));
+    if(Random()<0.7)
+    {
+      P.acceptMove(iat);
+      sdet->acceptMove(P,iat);
+      log_ref=log_new;
+      sign_ref=sign_new;
+    }
+    else
+    {
+      P.rejectMove(iat);
+      sdet->restore(iat);
+      P_ref.R[iat]=P.R[iat];
+      log_ref=log_from_scratch(P_ref,*sdet_ref,sign_ref);
+    }
+  }
+  for(int i=0; i<2; ++i)
+  {
+    const det_t& d(static_cast<const det_t&>(*sdet->Dets[i]));
+    const det_t& d_ref(static_cast<const det_t&>(*sdet_ref->Dets[i]));
+    for(int j=0; j<d.psiMinv.size(); ++j)
+      err_inv=std::max(err_inv,std::abs(d.psiMinv(j)-d_ref.psiMinv(j))/std::max(1.0,std::abs(d_ref.psiMinv(j))));
+  }
+  cout << "electrons = " << nel << " moves = " << nmoves << " cutoff = " << rcut << endl;
+  cout << "  moves by the rank-k update = " << nrankk << " by the full inversion = " << nfull << endl;
+  cout << "  max relative error of the ratios = " << setw(12) << err_ratio << endl;
+  cout << "  max error of the final inverses  = " << setw(12) << err_inv << endl;
+  bool passed=(err_ratio<eps && err_inv<eps && nrankk>0 && nfull>0);
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
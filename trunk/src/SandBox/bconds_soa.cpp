@@ -0,0 +1,118 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file bconds_soa.cpp
+ * @brief Check apply_bc_soa against DTD_BConds::apply_bc
+ *
+ * Random positions up to a few cells away from the sources are reduced by
+ * compute_displ_soa for a skewed cell (PPPG), an orthorhombic cell (PPPO)
+ * and the open boundary conditions. The displacements and the distances are
+ * compared with those of apply_bc on each displacement vector.
+ * Returns 1 if any difference exceeds eps.
+ *
+ * Usage: bconds_soa [-n sources] [-m positions]
+ */
+#include "Utilities/RandomGenerator.h"
+#include "Lattice/ParticleBCondsSoA.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <vector>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef CrystalLattice<double,3> lattice_t;
+typedef TinyVector<double,3> pos_t;
+
+/** return the maximum difference of the SoA minimum images from apply_bc
+ * @param lat lattice, the positions are random within [-2,3) cells
+ * @param nsrc number of sources
+ * @param npos number of the positions
+ */
+template<int SC>
+double check_bconds(const lattice_t& lat, int nsrc, int npos)
+{
+  DTD_BConds<double,3,SC> bc(lat);
+  //padded as the distance tables of SoA
+  const int stride=((nsrc+7)/8)*8;
+  vector<double> pos(3*stride,0.0), dr(3*stride,0.0), r(stride,0.0);
+  vector<pos_t> src(nsrc);
+  for(int i=0; i<nsrc; ++i)
+  {
+    src[i]=lat.toCart(pos_t(Random(),Random(),Random()));
+    for(int d=0; d<3; ++d)
+      pos[d*stride+i]=src[i][d];
+  }
+  double err=0.0;
+  for(int m=0; m<npos; ++m)
+  {
+    pos_t rnew=lat.toCart(pos_t(5.0*Random()-2.0,5.0*Random()-2.0,5.0*Random()-2.0));
+    compute_displ_soa(bc,rnew,&pos[0],&dr[0],stride,&r[0],nsrc);
+    for(int i=0; i<nsrc; ++i)
+    {
+      pos_t displ=rnew-src[i];
+      double r_ref=std::sqrt(bc.apply_bc(displ));
+      err=std::max(err,std::abs(r[i]-r_ref));
+      for(int d=0; d<3; ++d)
+        err=std::max(err,std::abs(dr[d*stride+i]-displ[d]));
+    }
+  }
+  return err;
+}
+
+int main(int argc, char** argv)
+{
+  int nsrc=61;
+  int npos=200;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      nsrc=atoi(argv[++ic]);
+    else
+      if(c=="-m")
+        npos=atoi(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-10;
+  Random.init(0,1,11);
+  //a skewed cell whose reduced basis differs from the input vectors
+  Tensor<double,3> skewed(4.0,0.0,0.0, 3.1,3.3,0.0, -1.7,2.2,3.6);
+  Tensor<double,3> ortho(4.0,0.0,0.0, 0.0,5.0,0.0, 0.0,0.0,6.0);
+  lattice_t lat_g, lat_o, lat_n;
+  lat_g.BoxBConds=1;
+  lat_g.set(skewed);
+  lat_o.BoxBConds=1;
+  lat_o.set(ortho);
+  lat_n.BoxBConds=0;
+  lat_n.set(ortho);
+  double err_g=check_bconds<PPPG>(lat_g,nsrc,npos);
+  double err_o=check_bconds<PPPO>(lat_o,nsrc,npos);
+  double err_n=check_bconds<SUPERCELL_OPEN>(lat_n,nsrc,npos);
+  cout << "sources = " << nsrc << " positions = " << npos << endl;
+  cout << "  max error of the general cell      = " << setw(12) << err_g << endl;
+  cout << "  max error of the orthorhombic cell = " << setw(12) << err_o << endl;
+  cout << "  max error of the open cell         = " << setw(12) << err_n << endl;
+  bool passed=(err_g<eps && err_o<eps && err_n<eps);
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,315 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file cell_list.cpp
+ * @brief Check the distance tables of the cell lists against DT_AOS
+ *
+ * Electrons and ions in a periodic cell of several cell lists along each
+ * direction are moved particle by particle with the tables of DT_CELL and
+ * DT_AOS. The moves by makeMoveAndCheck, some of them across the cell, and by
+ * makeMoveOnSphere are accepted or rejected at random. For the AA and AB tables:
+ * - Temp of the pairs within celllist_rcut has to be that of DT_AOS;
+ * - the pairs of the accepted moves within celllist_rcut have to be those of
+ *   DT_AOS and the others at or beyond celllist_rcut.
+ * The ratios, gradients and laplacians of TwoBodyJastrowOrbital and
+ * OneBodyJastrowOrbital of the B-spline functors within celllist_rcut have to
+ * be those with DT_AOS, and so are the values from the walker buffer.
+ * Returns 1 if any difference exceeds eps.
+ *
+ * Usage: cell_list [-n electrons-per-spin] [-m moves]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Utilities/RandomGenerator.h"
+#include "Message/Communicate.h"
+#include "Particle/ParticleSet.h"
+#include "QMCWaveFunctions/Jastrow/BsplineFunctor.h"
+#include "QMCWaveFunctions/Jastrow/OneBodyJastrowOrbital.h"
+#include "QMCWaveFunctions/Jastrow/TwoBodyJastrowOrbital.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef OrbitalBase::PosType pos_t;
+typedef OrbitalBase::GradType grad_t;
+typedef BsplineFunctor<double> bspline_t;
+
+inline double rel_diff(double a, double b)
+{
+  return std::abs(a-b)/std::max(1.0,std::abs(b));
+}
+
+inline double max_diff(const pos_t& a, const pos_t& b)
+{
+  double err=0.0;
+  for(int d=0; d<OHMMS_DIM; ++d)
+    err=std::max(err,rel_diff(a[d],b[d]));
+  return err;
+}
+
+bspline_t* create_bspline(double rcut, double scale)
+{
+  bspline_t* f=new bspline_t;
+  f->cutoff_radius=rcut;
+  f->resize(6);
+  for(int i=0; i<6; ++i)
+    f->Parameters[i]=scale*(0.5-0.08*i);
+  f->reset();
+  return f;
+}
+
+/** electrons, the tables of dt_type and the Jastrow factors */
+struct jastrow_system
+{
+  ParticleSet P;
+  TwoBodyJastrowOrbital<bspline_t> J2;
+  OneBodyJastrowOrbital<bspline_t> J1;
+  OrbitalBase::BufferType Buffer;
+
+  jastrow_system(const ParticleSet& P0, const ParticleSet& ions, int dt_type, double rcut
+         , const vector<bspline_t*>& f2, const vector<bspline_t*>& f1)
+    : P(P0), J2(init(P,ions,dt_type,rcut),0), J1(ions,P)
+  {
+    J2.addFunc(0,0,f2[0]);
+    J2.addFunc(0,1,f2[1]);
+    for(int s=0; s<f1.size(); ++s)
+      J1.addFunc(s,f1[s]);
+    P.update();
+    P.G=0.0;
+    P.L=0.0;
+    J2.evaluateLog(P,P.G,P.L);
+    J1.evaluateLog(P,P.G,P.L);
+    J2.registerData(P,Buffer);
+    J1.registerData(P,Buffer);
+    Buffer.rewind();
+    J2.copyFromBuffer(P,Buffer);
+    J1.copyFromBuffer(P,Buffer);
+  }
+
+  ///add the tables of dt_type before the Jastrow factors are created
+  static ParticleSet& init(ParticleSet& P, const ParticleSet& ions, int dt_type, double rcut)
+  {
+    P.CellListCutoff=rcut;
+    P.addTable(P,dt_type,true);
+    P.addTable(ions,dt_type,true);
+    return P;
+  }
+
+  double ratio(int iat, int mode, grad_t& g, ParticleSet::ParticleGradient_t& dG
+               , ParticleSet::ParticleLaplacian_t& dL)
+  {
+    g=0.0;
+    dG=0.0;
+    dL=0.0;
+    switch(mode)
+    {
+    case 0:
+      return J2.ratio(P,iat)*J1.ratio(P,iat);
+    case 1:
+      return J2.ratioGrad(P,iat,g)*J1.ratioGrad(P,iat,g);
+    default:
+      return J2.ratio(P,iat,dG,dL)*J1.ratio(P,iat,dG,dL);
+    }
+  }
+
+  void accept(int iat)
+  {
+    P.acceptMove(iat);
+    J2.acceptMove(P,iat);
+    J1.acceptMove(P,iat);
+  }
+
+  void reject(int iat)
+  {
+    P.rejectMove(iat);
+    J2.restore(iat);
+    J1.restore(iat);
+  }
+};
+
+/** return the largest difference of Temp of the pairs within rcut */
+double diff_temp(const DistanceTableData& a, const DistanceTableData& a_ref, double rcut)
+{
+  double err=0.0;
+  for(int i=0; i<a_ref.Temp.size(); ++i)
+  {
+    if(a_ref.Temp[i].r1>=rcut)
+      continue;
+    err=std::max(err,rel_diff(a.Temp[i].r1,a_ref.Temp[i].r1));
+    err=std::max(err,max_diff(a.Temp[i].dr1,a_ref.Temp[i].dr1));
+  }
+  return err;
+}
+
+/** return the largest difference of the pairs within rcut, or the count of those below rcut beyond it */
+double diff_pairs(const DistanceTableData& a, const DistanceTableData& a_ref, double rcut)
+{
+  double err=0.0;
+  for(int nn=0; nn<a_ref.getTotNadj(); ++nn)
+  {
+    if(a_ref.r(nn)<rcut)
+    {
+      err=std::max(err,rel_diff(a.r(nn),a_ref.r(nn)));
+      err=std::max(err,max_diff(a.dr(nn),a_ref.dr(nn)));
+    }
+    else
+      err += (a.r(nn)<rcut*(1.0-1e-12));
+  }
+  return err;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("cell_list",OHMMS::Controller->rank());
+  int nup=32;
+  int nmoves=1000;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      nup=atoi(argv[++ic]);
+    else
+      if(c=="-m")
+        nmoves=atoi(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-10;
+  //four cell lists along each direction
+  const double L=11.0;
+  const double rcut=2.5;
+  Random.init(0,1,11);
+  ParticleSet::ParticleLayout_t lattice;
+  lattice.BoxBConds=1;
+  lattice.R.diagonal(L);
+  lattice.reset();
+  ParticleSet ions, P0;
+  ions.setName("i");
+  ions.Lattice.copy(lattice);
+  vector<int> ni(2,4);
+  ions.create(ni);
+  ions.getSpeciesSet().addSpecies("A");
+  ions.getSpeciesSet().addSpecies("B");
+  ions.resetGroups();
+  P0.setName("e");
+  P0.Lattice.copy(lattice);
+  vector<int> ng(2,nup);
+  P0.create(ng);
+  P0.getSpeciesSet().addSpecies("u");
+  P0.getSpeciesSet().addSpecies("d");
+  P0.resetGroups();
+  for(int iat=0; iat<ions.getTotalNum(); ++iat)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      ions.R[iat][d]=L*Random();
+  for(int iat=0; iat<P0.getTotalNum(); ++iat)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      P0.R[iat][d]=L*Random();
+  ions.update();
+  //the Chiesa correction of TwoBodyJastrowOrbital needs the k-vectors
+  P0.createSK();
+  //the functors vanish within celllist_rcut
+  vector<bspline_t*> f2(2), f1(2);
+  f2[0]=create_bspline(2.0,0.5);
+  f2[1]=create_bspline(rcut,1.0);
+  f1[0]=create_bspline(2.2,-1.0);
+  f1[1]=create_bspline(rcut,-0.6);
+  jastrow_system cell(P0,ions,DistanceTableData::DT_CELL,rcut,f2,f1);
+  jastrow_system aos(P0,ions,DistanceTableData::DT_AOS,rcut,f2,f1);
+  const int nel=P0.getTotalNum();
+  double err_temp=0.0, err_pairs=0.0, err_ratio=0.0, err_grad=0.0, err_buffer=0.0;
+  int naccept=0, nsphere=0, nscreened=0;
+  grad_t g, g_ref;
+  ParticleSet::ParticleGradient_t dG(nel), dG_ref(nel);
+  ParticleSet::ParticleLaplacian_t dL(nel), dL_ref(nel);
+  for(int m=0; m<nmoves; ++m)
+  {
+    const int iat=m%nel;
+    //the moves on a sphere of the pseudopotentials, some across the cell
+    const bool on_sphere=(m%5==0);
+    const double scale=(m%7==0)? L:1.0;
+    pos_t dr;
+    for(int d=0; d<OHMMS_DIM; ++d)
+      dr[d]=scale*(Random()-0.5);
+    if(on_sphere)
+    {
+      ++nsphere;
+      cell.P.makeMoveOnSphere(iat,dr);
+      aos.P.makeMoveOnSphere(iat,dr);
+    }
+    else
+      if(!cell.P.makeMoveAndCheck(iat,dr) || !aos.P.makeMoveAndCheck(iat,dr))
+        continue;
+    for(int t=0; t<2; ++t)
+      err_temp=std::max(err_temp,diff_temp(*cell.P.DistTables[t],*aos.P.DistTables[t],rcut));
+    nscreened += (cell.P.DistTables[0]->TempNeighbors.size()<nel);
+    const int mode=(m/nel)%3;
+    double r=cell.ratio(iat,mode,g,dG,dL);
+    double r_ref=aos.ratio(iat,mode,g_ref,dG_ref,dL_ref);
+    err_ratio=std::max(err_ratio,std::abs(r-r_ref)/std::abs(r_ref));
+    err_grad=std::max(err_grad,max_diff(g,g_ref));
+    for(int i=0; i<nel; ++i)
+    {
+      err_grad=std::max(err_grad,max_diff(dG[i],dG_ref[i]));
+      err_grad=std::max(err_grad,rel_diff(dL[i],dL_ref[i]));
+    }
+    if(Random()<0.6)
+    {
+      ++naccept;
+      cell.accept(iat);
+      aos.accept(iat);
+      for(int t=0; t<2; ++t)
+        err_pairs=std::max(err_pairs,diff_pairs(*cell.P.DistTables[t],*aos.P.DistTables[t],rcut));
+    }
+    else
+    {
+      cell.reject(iat);
+      aos.reject(iat);
+    }
+    const int jat=(iat+1)%nel;
+    err_grad=std::max(err_grad,max_diff(cell.J2.evalGrad(cell.P,jat)+cell.J1.evalGrad(cell.P,jat)
+                                        ,aos.J2.evalGrad(aos.P,jat)+aos.J1.evalGrad(aos.P,jat)));
+  }
+  //the values kept by the accepted moves as the drivers store them
+  cell.Buffer.rewind();
+  aos.Buffer.rewind();
+  double logj=cell.J2.evaluateLog(cell.P,cell.Buffer)+cell.J1.evaluateLog(cell.P,cell.Buffer);
+  double logj_ref=aos.J2.evaluateLog(aos.P,aos.Buffer)+aos.J1.evaluateLog(aos.P,aos.Buffer);
+  err_buffer=rel_diff(logj,logj_ref);
+  for(int i=0; i<nel; ++i)
+    err_buffer=std::max(err_buffer,max_diff(cell.J2.evalGrad(cell.P,i)+cell.J1.evalGrad(cell.P,i)
+                                            ,aos.J2.evalGrad(aos.P,i)+aos.J1.evalGrad(aos.P,i)));
+  bool passed=(err_temp<eps && err_pairs<eps && err_ratio<eps && err_grad<eps && err_buffer<eps
+               && naccept && nsphere && nscreened);
+  cout << "electrons = " << nel << " ions = " << ions.getTotalNum() << " moves = " << nmoves
+       << " celllist_rcut = " << rcut << endl;
+  cout << "  accepted = " << naccept << " on the sphere = " << nsphere
+       << " screened = " << nscreened << endl;
+  cout << "  max difference of Temp within rcut      = " << setw(12) << err_temp << endl;
+  cout << "  max difference of the pairs within rcut = " << setw(12) << err_pairs << endl;
+  cout << "  max difference of the ratios            = " << setw(12) << err_ratio << endl;
+  cout << "  max difference of the gradients         = " << setw(12) << err_grad << endl;
+  cout << "  max difference from the buffer          = " << setw(12) << err_buffer << endl;
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,193 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file crowd_wfc.cpp
+ * @brief Check the flex_ functions of TrialWaveFunction against the per-walker loop
+ *
+ * Two identical crowds of walkers with a Slater-Jastrow wavefunction are
+ * moved particle by particle. One crowd uses flex_evaluateLog, flex_ratio,
+ * flex_ratioGrad and flex_acceptMove, the other the single-walker functions.
+ * The ratios, gradients and log values of the two have to agree.
+ * Returns 1 if any difference exceeds eps.
+ *
+ * Usage: crowd_wfc [-w walkers] [-n electrons-per-spin] [-s sweeps]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Utilities/RandomGenerator.h"
+#include "Message/Communicate.h"
+#include "Particle/ParticleSet.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
+#include "QMCWaveFunctions/Fermion/SlaterDet.h"
+#include "QMCWaveFunctions/Jastrow/TwoBodyJastrowOrbital.h"
+#include "QMCWaveFunctions/Jastrow/PadeFunctors.h"
+#include "SandBox/CosineSet.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+/** create a walker: electrons, Slater determinants and a two-body Jastrow */
+void create_walker(int nup, ParticleSet*& P, TrialWaveFunction*& psi, CosineSet& spo)
+{
+  P=new ParticleSet;
+  P->setName("e");
+  vector<int> ng(2,nup);
+  P->create(ng);
+  SpeciesSet& species(P->getSpeciesSet());
+  species.addSpecies("u");
+  species.addSpecies("d");
+  P->resetGroups();
+  //open boundary conditions: every move is valid
+  P->setBoundBox(false);
+  for(int iat=0; iat<P->getTotalNum(); ++iat)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      P->R[iat][d]=3.0*Random();
+  psi=new TrialWaveFunction(OHMMS::Controller);
+  SlaterDet* sdet=new SlaterDet(*P);
+  for(int ig=0; ig<2; ++ig)
+  {
+    DiracDeterminantBase* adet=new DiracDeterminantBase(spo.makeClone(),P->first(ig));
+    adet->set(P->first(ig),nup);
+    sdet->add(adet,ig);
+  }
+  psi->addOrbital(sdet,"SlaterDet");
+  TwoBodyJastrowOrbital<PadeFunctor<double> >* j2
+  =new TwoBodyJastrowOrbital<PadeFunctor<double> >(*P,0);
+  j2->addFunc(0,0,new PadeFunctor<double>(-0.25,0.5));
+  j2->addFunc(0,1,new PadeFunctor<double>(-0.5,0.5));
+  psi->addOrbital(j2,"J2");
+  P->update();
+}
+
+inline double rel_diff(double a, double b)
+{
+  return std::abs(a-b)/std::max(1.0,std::abs(b));
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("crowd_wfc",OHMMS::Controller->rank());
+  int nw=4;
+  int nup=6;
+  int nsweeps=4;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-w")
+      nw=atoi(argv[++ic]);
+    else
+      if(c=="-n")
+        nup=atoi(argv[++ic]);
+      else
+        if(c=="-s")
+          nsweeps=atoi(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-10;
+  Random.init(0,1,11);
+  CosineSet spo(nup);
+  //walkers of the crowd and of the reference
+  vector<ParticleSet*> P_list(nw), P_ref(nw);
+  vector<TrialWaveFunction*> wf_list(nw), wf_ref(nw);
+  //the walker buffers of the particle-by-particle drivers
+  vector<TrialWaveFunction::BufferType> buf_list(nw), buf_ref(nw);
+  for(int iw=0; iw<nw; ++iw)
+  {
+    create_walker(nup,P_list[iw],wf_list[iw],spo);
+    P_ref[iw]=new ParticleSet(*P_list[iw]);
+    wf_ref[iw]=wf_list[iw]->makeClone(*P_ref[iw]);
+    P_ref[iw]->update();
+    wf_list[iw]->registerData(*P_list[iw],buf_list[iw]);
+    wf_ref[iw]->registerData(*P_ref[iw],buf_ref[iw]);
+  }
+  double err_log=0.0, err_ratio=0.0, err_grad=0.0;
+  vector<TrialWaveFunction::RealType> logs(nw), ratios(nw);
+  vector<TrialWaveFunction::GradType> grads(nw);
+  vector<bool> isAccepted(nw);
+  TrialWaveFunction::flex_evaluateLog(wf_list,P_list,logs);
+  for(int iw=0; iw<nw; ++iw)
+    err_log=std::max(err_log,rel_diff(logs[iw],wf_ref[iw]->evaluateLog(*P_ref[iw])));
+  const int nel=P_list[0]->getTotalNum();
+  for(int sweep=0; sweep<nsweeps; ++sweep)
+  {
+    for(int iat=0; iat<nel; ++iat)
+    {
+      for(int iw=0; iw<nw; ++iw)
+      {
+        TrialWaveFunction::PosType dr;
+        for(int d=0; d<OHMMS_DIM; ++d)
+          dr[d]=0.6*(Random()-0.5);
+        P_list[iw]->makeMoveAndCheck(iat,dr);
+        P_ref[iw]->makeMoveAndCheck(iat,dr);
+        isAccepted[iw]=((iw+iat+sweep)%3!=0);
+      }
+      TrialWaveFunction::flex_ratio(wf_list,P_list,iat,ratios);
+      for(int iw=0; iw<nw; ++iw)
+      {
+        err_ratio=std::max(err_ratio,rel_diff(ratios[iw],wf_ref[iw]->ratio(*P_ref[iw],iat)));
+        wf_ref[iw]->rejectMove(iat);
+      }
+      TrialWaveFunction::flex_ratioGrad(wf_list,P_list,iat,ratios,grads);
+      for(int iw=0; iw<nw; ++iw)
+      {
+        TrialWaveFunction::GradType g;
+        err_ratio=std::max(err_ratio,rel_diff(ratios[iw],wf_ref[iw]->ratioGrad(*P_ref[iw],iat,g)));
+        for(int d=0; d<OHMMS_DIM; ++d)
+          err_grad=std::max(err_grad,rel_diff(grads[iw][d],g[d]));
+        if(isAccepted[iw])
+        {
+          P_ref[iw]->acceptMove(iat);
+          wf_ref[iw]->acceptMove(*P_ref[iw],iat);
+        }
+        else
+        {
+          P_ref[iw]->rejectMove(iat);
+          wf_ref[iw]->rejectMove(iat);
+        }
+      }
+      TrialWaveFunction::flex_acceptMove(wf_list,P_list,iat,isAccepted);
+      for(int iw=0; iw<nw; ++iw)
+      {
+        if(isAccepted[iw])
+          P_list[iw]->acceptMove(iat);
+        else
+          P_list[iw]->rejectMove(iat);
+      }
+    }
+    //the updated log values against the reference and a recompute of the crowd
+    for(int iw=0; iw<nw; ++iw)
+      err_log=std::max(err_log,rel_diff(wf_list[iw]->getLogPsi(),wf_ref[iw]->getLogPsi()));
+    TrialWaveFunction::flex_evaluateLog(wf_list,P_list,logs);
+    for(int iw=0; iw<nw; ++iw)
+      err_log=std::max(err_log,rel_diff(logs[iw],wf_ref[iw]->evaluateLog(*P_ref[iw])));
+  }
+  cout << "walkers = " << nw << " electrons = " << nel << " sweeps = " << nsweeps << endl;
+  cout << "  max error of the log values = " << setw(12) << err_log << endl;
+  cout << "  max error of the ratios     = " << setw(12) << err_ratio << endl;
+  cout << "  max error of the gradients  = " << setw(12) << err_grad << endl;
+  bool passed=(err_log<eps && err_ratio<eps && err_grad<eps);
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,129 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file delayed_update.cpp
+ * @brief Check DelayedUpdate against Sherman-Morrison and the direct inversion
+ *
+ * Random rows are accepted one at a time, including a particle moved twice
+ * within a delay window. After every move, the ratios and the inverse rows
+ * of DelayedUpdate are compared with those of InverseUpdateByRow and of the
+ * inverse computed from scratch. Returns 1 if any difference exceeds eps.
+ *
+ * Usage: delayed_update [-n norb] [-k delay] [-m moves]
+ */
+#include "Utilities/RandomGenerator.h"
+#include "Numerics/DeterminantOperators.h"
+#include "QMCWaveFunctions/Fermion/DelayedUpdate.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef Matrix<double> mat_t;
+
+/** return Minv in the convention of DiracDeterminantBase::psiM
+ * @param a a(i,j) = phi_j(r_i)
+ */
+inline void direct_inverse(const mat_t& a, mat_t& minv)
+{
+  for(int i=0; i<a.rows(); ++i)
+    for(int j=0; j<a.cols(); ++j)
+      minv(j,i)=a(i,j);
+  invert_matrix(minv,false);
+}
+
+inline double max_diff(const double* a, const double* b, int n)
+{
+  double d=0.0;
+  for(int i=0; i<n; ++i)
+    d=std::max(d,std::abs(a[i]-b[i])/std::max(1.0,std::abs(b[i])));
+  return d;
+}
+
+int main(int argc, char** argv)
+{
+  int norb=64;
+  int delay=8;
+  int nmoves=40;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      norb=atoi(argv[++ic]);
+    else
+      if(c=="-k")
+        delay=atoi(argv[++ic]);
+      else
+        if(c=="-m")
+          nmoves=atoi(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-8;
+  Random.init(0,1,11);
+  mat_t a(norb,norb), minv_sm(norb,norb), minv_delay(norb,norb), minv_direct(norb,norb);
+  for(int i=0; i<norb; ++i)
+  {
+    for(int j=0; j<norb; ++j)
+      a(i,j)=Random()-0.5;
+    a(i,i)+=2.0;
+  }
+  direct_inverse(a,minv_sm);
+  minv_delay=minv_sm;
+  DelayedUpdate<double> engine;
+  engine.resize(norb,delay);
+  Vector<double> psiv(norb), rvec(norb), rvecinv(norb), invrow(norb);
+  double err_ratio=0.0, err_row=0.0, err_inv=0.0;
+  for(int m=0; m<nmoves; ++m)
+  {
+    int iat=static_cast<int>(Random()*norb);
+    //move a pending particle again to hit the early update
+    if(m%5==4 && engine.Delay)
+      iat=engine.DelayList[0];
+    for(int j=0; j<norb; ++j)
+      psiv[j]=Random()-0.5+((j==iat)?1.0:0.0);
+    direct_inverse(a,minv_direct);
+    engine.getInvRow(minv_delay,iat,invrow.data());
+    double r_delay=simd::dot(invrow.data(),psiv.data(),norb);
+    double r_sm=DetRatioByRow(minv_sm,psiv,iat);
+    double r_direct=DetRatioByRow(minv_direct,psiv,iat);
+    err_ratio=std::max(err_ratio,std::abs(r_delay-r_direct)/std::abs(r_direct));
+    err_ratio=std::max(err_ratio,std::abs(r_sm-r_direct)/std::abs(r_direct));
+    err_row=std::max(err_row,max_diff(invrow.data(),minv_direct[iat],norb));
+    //accept the move
+    engine.acceptRow(minv_delay,iat,psiv.data());
+    InverseUpdateByRow(minv_sm,psiv,rvec,rvecinv,iat,r_sm);
+    for(int j=0; j<norb; ++j)
+      a(iat,j)=psiv[j];
+  }
+  direct_inverse(a,minv_direct);
+  engine.updateInvMat(minv_delay);
+  err_inv=std::max(max_diff(minv_delay.data(),minv_direct.data(),norb*norb)
+                   ,max_diff(minv_delay.data(),minv_sm.data(),norb*norb));
+  cout << "norb = " << norb << " delay = " << delay << " moves = " << nmoves << endl;
+  cout << "  max relative error of the ratios  = " << setw(12) << err_ratio << endl;
+  cout << "  max error of the current inv rows = " << setw(12) << err_row << endl;
+  cout << "  max error of the final inverse    = " << setw(12) << err_inv << endl;
+  bool passed=(err_ratio<eps && err_row<eps && err_inv<eps);
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,305 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file distributed_spo.cpp
+ * @brief Check DistributedSPOSet with the bands divided among the tasks
+ *
+ * Periodic plane-wave orbitals of a skewed cell are splined on every task
+ * without the distribution, i.e., by the groups of a single task, and with
+ * the bands divided among the tasks by transport="shm" and transport="rma".
+ * The tasks evaluate different positions and a different number of them, so
+ * that the remote tables are read while their owners do something else.
+ * evaluate, evaluate_notranspose, evaluateValues and mw_evaluate of the
+ * distributed sets are compared with those of the set of a single task,
+ * whose values and derivatives are compared with einspline.
+ * Returns 1 if any difference exceeds eps.
+ *
+ * Usage: mpirun -np 4 distributed_spo [-n bands] [-g grid] [-m positions] [-p groupsize]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Utilities/RandomGenerator.h"
+#include "Message/Communicate.h"
+#include "Message/CommOperators.h"
+#include "Particle/ParticleSet.h"
+#include "Particle/VirtualParticleSet.h"
+#include "QMCWaveFunctions/DistributedSPOSet.h"
+#include "spline/einspline_engine.hpp"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef DistributedSPOSet::PosType pos_t;
+typedef SPOSetBase::ValueVector_t value_v;
+typedef SPOSetBase::GradVector_t grad_v;
+typedef SPOSetBase::HessVector_t hess_v;
+typedef SPOSetBase::ValueMatrix_t value_m;
+typedef SPOSetBase::GradMatrix_t grad_m;
+typedef SPOSetBase::HessMatrix_t hess_m;
+
+/** periodic orbitals cos(2 pi k_j.u+a_j) in the lattice unit u */
+struct PlaneWaves
+{
+  vector<TinyVector<int,3> > K;
+  vector<double> Phase;
+
+  PlaneWaves(int norb): K(norb), Phase(norb)
+  {
+    for(int j=0; j<norb; ++j)
+    {
+      for(int d=0; d<3; ++d)
+        K[j][d]=static_cast<int>(5.0*Random())-2;
+      Phase[j]=6.0*Random();
+    }
+  }
+
+  ///values of the j-th orbital on the n^3 grid of the cell
+  void sample(int j, int n, vector<double>& data) const
+  {
+    data.resize(n*n*n);
+    for(int ix=0,ijk=0; ix<n; ++ix)
+      for(int iy=0; iy<n; ++iy)
+        for(int iz=0; iz<n; ++iz,++ijk)
+          data[ijk]=std::cos(2.0*M_PI*(K[j][0]*ix+K[j][1]*iy+K[j][2]*iz)/n+Phase[j]);
+  }
+};
+
+/** create a DistributedSPOSet of the orbitals, collective over c */
+DistributedSPOSet* create_spo(Communicate* c, int transport, int groupsize
+                              , const CrystalLattice<double,3>& lattice, const PlaneWaves& pw, int ngrid)
+{
+  const int norb=pw.K.size();
+  DistributedSPOSet* spo=new DistributedSPOSet;
+  spo->PrimLattice=lattice;
+  spo->HalfG=0;
+  spo->setOrbitalSetSize(norb);
+  spo->resizeStorage(norb,norb);
+  spo->setCommunicator(c,transport,groupsize);
+  Ugrid grid[3];
+  DistributedSPOSet::BCType bc[3];
+  for(int d=0; d<3; ++d)
+  {
+    grid[d].start=0.0;
+    grid[d].end=1.0;
+    grid[d].num=ngrid;
+    bc[d].lCode=bc[d].rCode=PERIODIC;
+  }
+  spo->create_spline(grid,bc);
+  vector<double> data;
+  for(int j=spo->firstBand(); j<spo->firstBand()+spo->numBands(); ++j)
+  {
+    pw.sample(j,ngrid,data);
+    spo->set_spline(&data[0],j);
+  }
+  spo->finalizeTables();
+  return spo;
+}
+
+inline double rel_diff(double a, double b)
+{
+  return std::abs(a-b)/std::max(1.0,std::abs(b));
+}
+
+/** return the maximum difference of the values, gradients and hessians of n rows */
+template<typename VT, typename GT, typename HT>
+double max_diff(const VT* v, const VT* v_ref, const GT* g, const GT* g_ref, const HT* h, const HT* h_ref, int n)
+{
+  double err=0.0;
+  for(int j=0; j<n; ++j)
+  {
+    err=std::max(err,rel_diff(v[j],v_ref[j]));
+    if(g)
+      for(int d=0; d<3; ++d)
+        err=std::max(err,rel_diff(g[j][d],g_ref[j][d]));
+    if(h)
+      for(int d=0; d<9; ++d)
+        err=std::max(err,rel_diff(h[j](d),h_ref[j](d)));
+  }
+  return err;
+}
+
+/** return the maximum difference of the orbitals of spo from those of ref
+ * @param P walkers of this task
+ */
+double check_spo(DistributedSPOSet& spo, DistributedSPOSet& ref, vector<ParticleSet*>& P)
+{
+  const int norb=spo.getOrbitalSetSize();
+  const int nel=P[0]->getTotalNum();
+  double err=0.0;
+  value_v psi(norb), psi_ref(norb), d2psi(norb), d2psi_ref(norb);
+  grad_v dpsi(norb), dpsi_ref(norb);
+  hess_v hess(norb), hess_ref(norb);
+  for(int iat=0; iat<nel; ++iat)
+  {
+    spo.evaluate(*P[0],iat,psi);
+    ref.evaluate(*P[0],iat,psi_ref);
+    err=std::max(err,max_diff(psi.data(),psi_ref.data(),(pos_t*)0,(pos_t*)0,(Tensor<double,3>*)0,(Tensor<double,3>*)0,norb));
+    spo.evaluate(*P[0],iat,psi,dpsi,d2psi);
+    ref.evaluate(*P[0],iat,psi_ref,dpsi_ref,d2psi_ref);
+    err=std::max(err,max_diff(psi.data(),psi_ref.data(),dpsi.data(),dpsi_ref.data(),(Tensor<double,3>*)0,(Tensor<double,3>*)0,norb));
+    err=std::max(err,max_diff(d2psi.data(),d2psi_ref.data(),(pos_t*)0,(pos_t*)0,(Tensor<double,3>*)0,(Tensor<double,3>*)0,norb));
+    spo.evaluate(*P[0],iat,psi,dpsi,hess);
+    ref.evaluate(*P[0],iat,psi_ref,dpsi_ref,hess_ref);
+    err=std::max(err,max_diff(psi.data(),psi_ref.data(),dpsi.data(),dpsi_ref.data(),hess.data(),hess_ref.data(),norb));
+  }
+  value_m logdet(nel,norb), logdet_ref(nel,norb), d2logdet(nel,norb), d2logdet_ref(nel,norb);
+  grad_m dlogdet(nel,norb), dlogdet_ref(nel,norb);
+  hess_m hlogdet(nel,norb), hlogdet_ref(nel,norb);
+  spo.evaluate_notranspose(*P[0],0,nel,logdet,dlogdet,d2logdet);
+  ref.evaluate_notranspose(*P[0],0,nel,logdet_ref,dlogdet_ref,d2logdet_ref);
+  err=std::max(err,max_diff(logdet.data(),logdet_ref.data(),dlogdet.data(),dlogdet_ref.data(),(Tensor<double,3>*)0,(Tensor<double,3>*)0,nel*norb));
+  err=std::max(err,max_diff(d2logdet.data(),d2logdet_ref.data(),(pos_t*)0,(pos_t*)0,(Tensor<double,3>*)0,(Tensor<double,3>*)0,nel*norb));
+  spo.evaluate_notranspose(*P[0],0,nel,logdet,dlogdet,hlogdet);
+  ref.evaluate_notranspose(*P[0],0,nel,logdet_ref,dlogdet_ref,hlogdet_ref);
+  err=std::max(err,max_diff(logdet.data(),logdet_ref.data(),dlogdet.data(),dlogdet_ref.data(),hlogdet.data(),hlogdet_ref.data(),nel*norb));
+  //virtual moves of the first particle
+  VirtualParticleSet VP(*P[0],nel);
+  vector<pos_t> deltaV(nel);
+  for(int k=0; k<nel; ++k)
+    for(int d=0; d<3; ++d)
+      deltaV[k][d]=Random()-0.5;
+  VP.makeMoves(0,deltaV);
+  spo.evaluateValues(VP,logdet);
+  ref.evaluateValues(VP,logdet_ref);
+  err=std::max(err,max_diff(logdet.data(),logdet_ref.data(),(pos_t*)0,(pos_t*)0,(Tensor<double,3>*)0,(Tensor<double,3>*)0,nel*norb));
+  //a particle of all the walkers
+  const int nw=P.size();
+  vector<SPOSetBase*> spo_list(nw,&spo);
+  vector<value_v> v(nw,psi), l(nw,psi);
+  vector<grad_v> g(nw,dpsi);
+  vector<value_v*> v_list(nw), l_list(nw);
+  vector<grad_v*> g_list(nw);
+  for(int iw=0; iw<nw; ++iw)
+  {
+    v_list[iw]=&v[iw];
+    g_list[iw]=&g[iw];
+    l_list[iw]=&l[iw];
+  }
+  spo.mw_evaluate(spo_list,P,nel-1,v_list,g_list,l_list);
+  for(int iw=0; iw<nw; ++iw)
+  {
+    ref.evaluate(*P[iw],nel-1,psi_ref,dpsi_ref,d2psi_ref);
+    err=std::max(err,max_diff(v[iw].data(),psi_ref.data(),g[iw].data(),dpsi_ref.data(),(Tensor<double,3>*)0,(Tensor<double,3>*)0,norb));
+    err=std::max(err,max_diff(l[iw].data(),d2psi_ref.data(),(pos_t*)0,(pos_t*)0,(Tensor<double,3>*)0,(Tensor<double,3>*)0,norb));
+  }
+  return err;
+}
+
+/** return the maximum difference of the orbitals of ref from einspline */
+double check_einspline(DistributedSPOSet& ref, ParticleSet& P)
+{
+  const int norb=ref.getOrbitalSetSize();
+  const Tensor<double,3>& G(ref.PrimLattice.G);
+  value_v psi(norb), psi_ref(norb), d2psi(norb), d2psi_ref(norb);
+  grad_v dpsi(norb), dpsi_ref(norb);
+  hess_v hess(norb);
+  double err=0.0;
+  for(int iat=0; iat<P.getTotalNum(); ++iat)
+  {
+    pos_t u=ref.PrimLattice.toUnit(P.R[iat]);
+    for(int d=0; d<3; ++d)
+      u[d]-=std::floor(u[d]);
+    einspline::evaluate_vgh(ref.MultiSpline,u,psi_ref,dpsi_ref,hess);
+    for(int j=0; j<norb; ++j)
+    {
+      dpsi_ref[j]=dot(G,dpsi_ref[j]);
+      d2psi_ref[j]=trace(hess[j],ref.GGt);
+    }
+    ref.evaluate(P,iat,psi,dpsi,d2psi);
+    err=std::max(err,max_diff(psi.data(),psi_ref.data(),dpsi.data(),dpsi_ref.data(),(Tensor<double,3>*)0,(Tensor<double,3>*)0,norb));
+    err=std::max(err,max_diff(d2psi.data(),d2psi_ref.data(),(pos_t*)0,(pos_t*)0,(Tensor<double,3>*)0,(Tensor<double,3>*)0,norb));
+  }
+  return err;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  Communicate* comm=OHMMS::Controller;
+  OhmmsInfo Welcome("distributed_spo",comm->rank());
+  int norb=11;
+  int ngrid=12;
+  int npos=6;
+  int groupsize=0;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      norb=atoi(argv[++ic]);
+    else
+      if(c=="-g")
+        ngrid=atoi(argv[++ic]);
+      else
+        if(c=="-m")
+          npos=atoi(argv[++ic]);
+        else
+          if(c=="-p")
+            groupsize=atoi(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-10;
+  //the same orbitals on every task
+  Random.init(0,1,11);
+  PlaneWaves pw(norb);
+  CrystalLattice<double,3> lattice;
+  lattice.BoxBConds=1;
+  lattice.set(Tensor<double,3>(4.0,0.0,0.0, 1.1,3.6,0.0, -0.7,0.9,3.8));
+  DistributedSPOSet* ref=create_spo(comm,DistributedSPOSet::RMA_TRANSPORT,1,lattice,pw,ngrid);
+  DistributedSPOSet* shm=create_spo(comm,DistributedSPOSet::SHM_TRANSPORT,0,lattice,pw,ngrid);
+  DistributedSPOSet* rma=create_spo(comm,DistributedSPOSet::RMA_TRANSPORT,groupsize,lattice,pw,ngrid);
+  //different positions and numbers of the walkers on the tasks
+  Random.init(comm->rank(),comm->size(),13);
+  const int nw=2+comm->rank()%3;
+  vector<ParticleSet*> P(nw);
+  for(int iw=0; iw<nw; ++iw)
+  {
+    P[iw]=new ParticleSet;
+    P[iw]->create(npos+comm->rank());
+    for(int iat=0; iat<P[iw]->getTotalNum(); ++iat)
+      P[iw]->R[iat]=lattice.toCart(pos_t(3.0*Random()-1.0,3.0*Random()-1.0,3.0*Random()-1.0));
+  }
+  //errors of the tasks
+  vector<double> err(3*comm->size(),0.0);
+  err[3*comm->rank()]=check_einspline(*ref,*P[0]);
+  err[3*comm->rank()+1]=check_spo(*shm,*ref,P);
+  err[3*comm->rank()+2]=check_spo(*rma,*ref,P);
+  comm->allreduce(err);
+  double err_ref=0.0, err_shm=0.0, err_rma=0.0;
+  for(int p=0; p<comm->size(); ++p)
+  {
+    err_ref=std::max(err_ref,err[3*p]);
+    err_shm=std::max(err_shm,err[3*p+1]);
+    err_rma=std::max(err_rma,err[3*p+2]);
+  }
+  bool passed=(err_ref<eps && err_shm<eps && err_rma<eps);
+  if(comm->rank()==0)
+  {
+    cout << "tasks = " << comm->size() << " bands = " << norb << " grid = " << ngrid << endl;
+    cout << "  max error of a task from einspline = " << setw(12) << err_ref << endl;
+    cout << "  max error of transport=\"shm\"       = " << setw(12) << err_shm << endl;
+    cout << "  max error of transport=\"rma\"       = " << setw(12) << err_rma << endl;
+    cout << (passed? "  PASSED":"  FAILED") << endl;
+  }
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,166 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file eikr_recurrence.cpp
+ * @brief Check the phase factors of StructFact against the direct exponentials
+ *
+ * StructFact evaluates \f$e^{i{\bf k}\cdot{\bf r}}\f$ by the recurrences of
+ * the phase factors per dimension. Particles in a triclinic cell of many
+ * k-shells are moved particle by particle:
+ * - eikr and rhok of UpdateAllPart,
+ * - eikr_temp of the proposed moves, also far outside of the cell,
+ * - eikr and rhok updated by acceptMove over the sweeps
+ * have to be those of exp(i k.r) of the Cartesian k-vectors.
+ * Returns 1 if any difference exceeds eps.
+ *
+ * Usage: eikr_recurrence [-n particles-per-species] [-s sweeps] [-k kcut]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Utilities/RandomGenerator.h"
+#include "Message/Communicate.h"
+#include "Particle/ParticleSet.h"
+#include "LongRange/StructFact.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef ParticleSet::PosType PosType;
+typedef StructFact::ComplexType ComplexType;
+
+/** return the largest difference of eikr of the k-vectors at r from exp(i k.r) */
+double max_diff(const StructFact& sk, const ComplexType* eikr, const PosType& r)
+{
+  double err=0.0;
+  for(int ki=0; ki<sk.KLists.numk; ++ki)
+  {
+    const double phi=dot(sk.KLists.kpts_cart[ki],r);
+    err=std::max(err,std::abs(eikr[ki]-ComplexType(std::cos(phi),std::sin(phi))));
+  }
+  return err;
+}
+
+/** return the largest difference of eikr and rhok of P from the direct sums */
+double max_diff(const ParticleSet& P)
+{
+  const StructFact& sk(*P.SK);
+  const int nk=sk.KLists.numk;
+  Matrix<ComplexType> rhok(sk.rhok.rows(),nk);
+  rhok=ComplexType(0.0);
+  double err=0.0;
+  for(int iat=0; iat<P.getTotalNum(); ++iat)
+  {
+    err=std::max(err,max_diff(sk,sk.eikr[iat],P.R[iat]));
+    for(int ki=0; ki<nk; ++ki)
+    {
+      const double phi=dot(sk.KLists.kpts_cart[ki],P.R[iat]);
+      rhok(P.GroupID[iat],ki)+=ComplexType(std::cos(phi),std::sin(phi));
+    }
+  }
+  for(int ig=0; ig<rhok.rows(); ++ig)
+    for(int ki=0; ki<nk; ++ki)
+      err=std::max(err,std::abs(sk.rhok(ig,ki)-rhok(ig,ki))/P.getTotalNum());
+  return err;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("eikr_recurrence",OHMMS::Controller->rank());
+  int n=4;
+  int nsweeps=4;
+  double kcut=15.0;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      n=atoi(argv[++ic]);
+    else
+      if(c=="-s")
+        nsweeps=atoi(argv[++ic]);
+      else
+        if(c=="-k")
+          kcut=atof(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-10;
+  Random.init(0,1,11);
+  ParticleSet P;
+  P.setName("e");
+  P.Lattice.BoxBConds=1;
+  P.Lattice.LR_dim_cutoff=kcut;
+  P.Lattice.R(0,0)=3.1;
+  P.Lattice.R(0,1)=0.4;
+  P.Lattice.R(0,2)=-0.2;
+  P.Lattice.R(1,0)=0.7;
+  P.Lattice.R(1,1)=2.9;
+  P.Lattice.R(1,2)=0.3;
+  P.Lattice.R(2,0)=-0.5;
+  P.Lattice.R(2,1)=0.6;
+  P.Lattice.R(2,2)=3.4;
+  P.Lattice.reset();
+  vector<int> ng(2,n);
+  P.create(ng);
+  P.getSpeciesSet().addSpecies("u");
+  P.getSpeciesSet().addSpecies("d");
+  P.resetGroups();
+  for(int iat=0; iat<P.getTotalNum(); ++iat)
+    P.R[iat]=P.Lattice.toCart(PosType(Random(),Random(),Random()));
+  P.createSK();
+  P.SK->DoUpdate=true;
+  P.update();
+  const StructFact& sk(*P.SK);
+  double err_fill=max_diff(P), err_move=0.0, err_accept=0.0;
+  int naccept=0;
+  for(int sweep=0; sweep<nsweeps; ++sweep)
+  {
+    for(int iat=0; iat<P.getTotalNum(); ++iat)
+    {
+      //every fifth move goes far outside of the cell
+      const double scale=(iat%5)? 0.8:20.0;
+      PosType dr;
+      for(int d=0; d<OHMMS_DIM; ++d)
+        dr[d]=scale*(Random()-0.5);
+      PosType newpos(P.R[iat]+dr);
+      P.makeMove(iat,dr);
+      err_move=std::max(err_move,max_diff(sk,sk.eikr_temp.data(),newpos));
+      if(Random()<0.6)
+      {
+        ++naccept;
+        P.acceptMove(iat);
+      }
+      else
+        P.rejectMove(iat);
+    }
+    err_accept=std::max(err_accept,max_diff(P));
+  }
+  bool passed=(err_fill<eps && err_move<eps && err_accept<eps && naccept);
+  cout << "particles = " << P.getTotalNum() << " k-vectors = " << sk.KLists.numk
+       << " mmax = " << sk.KLists.mmax << " sweeps = " << nsweeps << endl;
+  cout << "  max difference of UpdateAllPart = " << setw(12) << err_fill << endl;
+  cout << "  max difference of the moves     = " << setw(12) << err_move << endl;
+  cout << "  max difference after the sweeps = " << setw(12) << err_accept << endl;
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
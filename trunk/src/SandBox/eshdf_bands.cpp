@@ -0,0 +1,137 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file eshdf_bands.cpp
+ * @brief Check the parallel read of the ES-HDF bands against a single-task read
+ *
+ * A minimal ES-HDF file of random psi_g on the G vectors |g_i|<=2 of a skewed
+ * cell is written at the Gamma point, whose orbitals are real, and at the
+ * twists +-1/4 of a cell tiled twice, whose orbitals are complex. The orbitals are
+ * created by EinsplineSetBuilder::createSPOSet on the first task with a
+ * communicator of a single task, which reads, transforms and splines every
+ * band as the serial code did, and then by all the tasks, which divide the
+ * bands among them and reduce the tables. The values, gradients and
+ * laplacians of the orbitals of every task at random positions are compared
+ * with those of the single-task read.
+ * Returns 1 if any difference exceeds eps.
+ *
+ * Usage: mpirun -np 4 eshdf_bands [-n bands]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Message/Communicate.h"
+#include "Message/CommOperators.h"
+#include "SandBox/eshdf_writer.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <algorithm>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef TinyVector<double,3> pos_t;
+
+/** return the largest difference of the orbitals read by all the tasks from the single-task read
+ * @param lattice primitive vectors
+ * @param k reduced twists of the primitive cell
+ * @param tile the supercell is tiled along the first primitive vector
+ * @param nb number of the bands of a twist
+ * @param nel number of the electrons
+ */
+double check_read(Communicate* comm, const Tensor<double,3>& lattice, const vector<pos_t>& k
+                  , int tile, int nb, int nel)
+{
+  const string fname("eshdf_bands.h5");
+  if(comm->rank()==0)
+    write_eshdf(fname,lattice,k,nb);
+  comm->barrier();
+  xmlNodePtr cur=eshdf_sposet_node(fname,nel/2,tile,"double");
+  Tensor<double,3> super(lattice);
+  for(int d=0; d<3; ++d)
+    super(0,d)*=tile;
+  vector<int> ns(2,nel/2);
+  ParticleSet P;
+  P.Lattice.BoxBConds=1;
+  P.Lattice.set(super);
+  P.create(ns);
+  //the same positions on every task
+  Random.init(0,1,13);
+  for(int iat=0; iat<nel; ++iat)
+    P.R[iat]=dot(pos_t(3.0*Random()-1.0,3.0*Random()-1.0,3.0*Random()-1.0),super);
+  //the reference is read by the first task alone
+  Communicate self(*comm,comm->size());
+  vector<double> ref;
+  if(comm->rank()==0)
+    read_bands(&self,cur,P,ref);
+  int n=ref.size();
+  comm->bcast(n);
+  ref.resize(n);
+  comm->bcast(ref);
+  vector<double> vgl;
+  read_bands(comm,cur,P,vgl);
+  xmlFreeNode(cur);
+  comm->barrier();
+  if(comm->rank()==0)
+    remove(fname.c_str());
+  double err=(vgl.size()==ref.size() && n>0)? 0.0:1.0;
+  for(int i=0; i<vgl.size() && i<ref.size(); ++i)
+    err=std::max(err,std::abs(vgl[i]-ref[i])/std::max(1.0,std::abs(ref[i])));
+  vector<double> errs(comm->size(),0.0);
+  errs[comm->rank()]=err;
+  comm->allreduce(errs);
+  return *std::max_element(errs.begin(),errs.end());
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  Communicate* comm=OHMMS::Controller;
+  OhmmsInfo Welcome("eshdf_bands",comm->rank());
+  int nb=7;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      nb=atoi(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-12;
+  Random.init(0,1,11);
+  Tensor<double,3> lattice(4.0,0.0,0.0, 1.1,3.6,0.0, -0.7,0.9,3.8);
+  //real orbitals of the Gamma point
+  vector<pos_t> k(1,pos_t(0.0,0.0,0.0));
+  double err_gamma=check_read(comm,lattice,k,1,nb,2*nb-2);
+  //complex orbitals of the twists +-1/4 of a cell tiled twice
+  k[0]=pos_t(0.25,0.0,0.0);
+  k.push_back(pos_t(-0.25,0.0,0.0));
+  double err_twist=check_read(comm,lattice,k,2,nb,2*nb-2);
+  bool passed=(err_gamma<eps && err_twist<eps);
+  if(comm->rank()==0)
+  {
+    cout << "tasks = " << comm->size() << " bands = " << nb << endl;
+    cout << "  max difference of the real orbitals    = " << setw(12) << err_gamma << endl;
+    cout << "  max difference of the complex orbitals = " << setw(12) << err_twist << endl;
+    cout << (passed? "  PASSED":"  FAILED") << endl;
+  }
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
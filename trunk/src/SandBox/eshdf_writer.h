@@ -0,0 +1,172 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file eshdf_writer.h
+ * @brief write a minimal ES-HDF file and create its orbitals for the checks
+ */
+#ifndef QMCPLUSPLUS_ESHDF_WRITER_H
+#define QMCPLUSPLUS_ESHDF_WRITER_H
+#include "Utilities/RandomGenerator.h"
+#include "OhmmsData/libxmldefs.h"
+#include "Numerics/HDFNumericAttrib.h"
+#include "Numerics/HDFSTLAttrib.h"
+#include "OhmmsData/HDFStringAttrib.h"
+#include "QMCWaveFunctions/EinsplineSetBuilder.h"
+#include <sstream>
+
+namespace qmcplusplus
+{
+/** write the scalar, vector or string a to the dataset name of grp */
+template<typename T>
+inline void write_data(hid_t grp, const char* name, T a)
+{
+  HDFAttribIO<T> h(a);
+  h.write(grp,name);
+}
+
+/** write an ES-HDF file of nb random bands at the reduced twists k
+ * @param fname file name
+ * @param lattice primitive vectors
+ * @param k reduced twists of the file, whose signs are flipped by the reader
+ * @param nb number of the bands of a twist
+ */
+inline void write_eshdf(const string& fname, const Tensor<double,3>& lattice, const vector<TinyVector<double,3> >& k, int nb)
+{
+  hid_t fid=H5Fcreate(fname.c_str(),H5F_ACC_TRUNC,H5P_DEFAULT,H5P_DEFAULT);
+  write_data(fid,"format",string("ES-HDF"));
+  write_data(fid,"version",TinyVector<int,3>(2,0,0));
+  hid_t g=H5Gcreate(fid,"supercell",0);
+  write_data(g,"primitive_vectors",lattice);
+  H5Gclose(g);
+  g=H5Gcreate(fid,"atoms",0);
+  write_data(g,"number_of_species",1);
+  Vector<int> ids(2);
+  ids[0]=ids[1]=0;
+  write_data(g,"species_ids",ids);
+  Vector<TinyVector<double,3> > pos(2);
+  pos[1]=TinyVector<double,3>(1.5,2.0,1.9);
+  write_data(g,"positions",pos);
+  hid_t s=H5Gcreate(g,"species_0",0);
+  write_data(s,"atomic_number",1);
+  H5Gclose(s);
+  H5Gclose(g);
+  g=H5Gcreate(fid,"muffin_tins",0);
+  write_data(g,"number_of_tins",0);
+  H5Gclose(g);
+  g=H5Gcreate(fid,"electrons",0);
+  write_data(g,"number_of_spins",1);
+  write_data(g,"number_of_kpoints",static_cast<int>(k.size()));
+  write_data(g,"have_dpsi",0);
+  write_data(g,"number_of_atomic_orbitals",0);
+  write_data(g,"psi_r_is_complex",1);
+  vector<TinyVector<int,3> > gv;
+  for(int i=-2; i<=2; ++i)
+    for(int j=-2; j<=2; ++j)
+      for(int l=-2; l<=2; ++l)
+        gv.push_back(TinyVector<int,3>(i,j,l));
+  for(int ik=0; ik<k.size(); ++ik)
+  {
+    ostringstream kname;
+    kname << "kpoint_" << ik;
+    hid_t kg=H5Gcreate(g,kname.str().c_str(),0);
+    write_data(kg,"reduced_k",k[ik]);
+    write_data(kg,"gvectors",gv);
+    s=H5Gcreate(kg,"spin_0",0);
+    write_data(s,"number_of_states",nb);
+    write_data(s,"number_of_core_states",0);
+    vector<double> eig(nb);
+    for(int b=0; b<nb; ++b)
+      eig[b]=0.1*b+0.01*Random();
+    write_data(s,"eigenvalues",eig);
+    Vector<complex<double> > psig(gv.size());
+    for(int b=0; b<nb; ++b)
+    {
+      for(int ig=0; ig<gv.size(); ++ig)
+        psig[ig]=complex<double>(Random()-0.5,Random()-0.5)/(1.0+dot(gv[ig],gv[ig]));
+      ostringstream sname;
+      sname << "state_" << b;
+      hid_t sg=H5Gcreate(s,sname.str().c_str(),0);
+      write_data(sg,"psi_g",psig);
+      H5Gclose(sg);
+    }
+    H5Gclose(s);
+    H5Gclose(kg);
+  }
+  H5Gclose(g);
+  H5Fclose(fid);
+}
+
+/** create the orbitals of the file by the tasks of c and return their
+ * values, gradients and laplacians at the particles of P
+ */
+inline void read_bands(Communicate* c, xmlNodePtr cur, ParticleSet& P, vector<double>& vgl)
+{
+  EinsplineSetBuilder::PtclPoolType psets;
+  EinsplineSetBuilder* builder=new EinsplineSetBuilder(P,psets,cur);
+  builder->initCommunicator(c);
+  //do not hand back a clone of the previous read
+  EinsplineSetBuilder::SPOSetMap.clear();
+  SPOSetBase* spo=builder->createSPOSet(cur);
+  EinsplineSetBuilder::SPOSetMap.clear();
+  delete builder;
+  const int norb=spo->getOrbitalSetSize();
+  SPOSetBase::ValueVector_t psi(norb), d2psi(norb);
+  SPOSetBase::GradVector_t dpsi(norb);
+  vgl.clear();
+  for(int iat=0; iat<P.getTotalNum(); ++iat)
+  {
+    spo->evaluate(P,iat,psi,dpsi,d2psi);
+    for(int j=0; j<norb; ++j)
+    {
+      vgl.push_back(psi[j]);
+      vgl.insert(vgl.end(),dpsi[j].begin(),dpsi[j].end());
+      vgl.push_back(d2psi[j]);
+    }
+  }
+  delete spo;
+}
+
+/** return the node of the orbitals of the file
+ * @param fname file name
+ * @param norb number of the orbitals
+ * @param tile the supercell is tiled along the first primitive vector
+ * @param precision precision of the spline table
+ */
+inline xmlNodePtr eshdf_sposet_node(const string& fname, int norb, int tile, const string& precision)
+{
+  ostringstream size, tmat;
+  size << norb;
+  tmat << tile << " 0 0 0 1 0 0 0 1";
+  xmlNodePtr cur=xmlNewNode(NULL,(const xmlChar*)"sposet_builder");
+  xmlNewProp(cur,(const xmlChar*)"type",(const xmlChar*)"bspline");
+  xmlNewProp(cur,(const xmlChar*)"href",(const xmlChar*)fname.c_str());
+  xmlNewProp(cur,(const xmlChar*)"size",(const xmlChar*)size.str().c_str());
+  xmlNewProp(cur,(const xmlChar*)"tilematrix",(const xmlChar*)tmat.str().c_str());
+  xmlNewProp(cur,(const xmlChar*)"twistnum",(const xmlChar*)"0");
+  xmlNewProp(cur,(const xmlChar*)"precision",(const xmlChar*)precision.c_str());
+  xmlNodePtr occ=xmlNewChild(cur,NULL,(const xmlChar*)"occupation",NULL);
+  xmlNewProp(occ,(const xmlChar*)"mode",(const xmlChar*)"ground");
+  xmlNewProp(occ,(const xmlChar*)"spindataset",(const xmlChar*)"0");
+  return cur;
+}
+
+}
+#endif
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
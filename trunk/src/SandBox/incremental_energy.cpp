@@ -0,0 +1,158 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file incremental_energy.cpp
+ * @brief Check the incremental local energy of QMCHamiltonian against evaluate
+ *
+ * Electrons in a periodic cell with ions are moved particle by particle in
+ * the order of VMCUpdatePbyP: the INCREMENTAL components, CoulombPBCAA and
+ * CoulombPBCAB, are updated by evaluatePbyPIncremental and
+ * acceptMoveIncremental on the accepted moves. After every sweep the local
+ * energy of evaluateIncremental is compared with evaluate, and the values
+ * restored from the walker buffer and recomputed by updateIncremental with
+ * those carried by the moves. Returns 1 if any difference exceeds eps.
+ *
+ * Usage: incremental_energy [-n electrons-per-spin] [-s sweeps]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Utilities/RandomGenerator.h"
+#include "Message/Communicate.h"
+#include "Particle/ParticleSet.h"
+#include "QMCHamiltonians/QMCHamiltonian.h"
+#include "QMCHamiltonians/BareKineticEnergy.h"
+#include "QMCHamiltonians/CoulombPBCAA.h"
+#include "QMCHamiltonians/CoulombPBCAB.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+/** add species of the same charge to P and create P.SK */
+void create_particles(ParticleSet& P, const string& name, const vector<string>& species
+                      , int n, double z, const ParticleSet::ParticleLayout_t& lattice)
+{
+  P.setName(name);
+  P.Lattice.copy(lattice);
+  vector<int> ng(species.size(),n);
+  P.create(ng);
+  SpeciesSet& tspecies(P.getSpeciesSet());
+  int icharge=tspecies.addAttribute("charge");
+  int imember=tspecies.addAttribute("membersize");
+  for(int ig=0; ig<species.size(); ++ig)
+  {
+    int s=tspecies.addSpecies(species[ig]);
+    tspecies(icharge,s)=z;
+    tspecies(imember,s)=n;
+  }
+  P.resetGroups();
+  for(int iat=0; iat<P.getTotalNum(); ++iat)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      P.R[iat][d]=lattice.R(d,d)*Random();
+  P.createSK();
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("incremental_energy",OHMMS::Controller->rank());
+  int nup=8;
+  int nsweeps=4;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      nup=atoi(argv[++ic]);
+    else
+      if(c=="-s")
+        nsweeps=atoi(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-10;
+  Random.init(0,1,11);
+  ParticleSet::ParticleLayout_t lattice;
+  lattice.BoxBConds=1;
+  lattice.LR_dim_cutoff=15.0;
+  lattice.R.diagonal(std::pow(2.0*nup,1.0/3.0)*1.8);
+  lattice.reset();
+  ParticleSet ions, P;
+  create_particles(ions,"i",vector<string>(1,"H"),nup,2.0,lattice);
+  vector<string> spins(2);
+  spins[0]="u";
+  spins[1]="d";
+  create_particles(P,"e",spins,nup,-1.0,lattice);
+  P.addTable(P,-1,false);
+  QMCHamiltonian H;
+  H.addOperator(new BareKineticEnergy<double>(P),"Kinetic");
+  H.addOperator(new CoulombPBCAA(P,true,false),"ElecElec");
+  H.addOperator(new CoulombPBCAB(ions,P,false),"LocalECP");
+  H.addObservables(P);
+  P.update();
+  QMCHamiltonian::BufferType buf;
+  H.registerIncremental(P,buf);
+  double err_energy=0.0, err_buffer=0.0;
+  int naccept=0;
+  const int nel=P.getTotalNum();
+  for(int sweep=0; sweep<nsweeps; ++sweep)
+  {
+    for(int iat=0; iat<nel; ++iat)
+    {
+      ParticleSet::SingleParticlePos_t dr;
+      for(int d=0; d<OHMMS_DIM; ++d)
+        dr[d]=0.8*(Random()-0.5);
+      if(!P.makeMoveAndCheck(iat,dr))
+        continue;
+      if(Random()<0.7)
+      {
+        ++naccept;
+        H.evaluatePbyPIncremental(P,iat);
+        P.acceptMove(iat);
+        H.acceptMoveIncremental(iat);
+      }
+      else
+        P.rejectMove(iat);
+    }
+    buf.rewind();
+    double e_inc=H.evaluateIncremental(P,buf);
+    //restore the values from the buffer and recompute them
+    buf.rewind();
+    H.copyFromIncremental(P,buf);
+    buf.rewind();
+    double e_saved=H.evaluateIncremental(P,buf);
+    P.update();
+    buf.rewind();
+    double v_inc=H.updateIncremental(P,buf);
+    double e_full=H.evaluate(P);
+    err_energy=std::max(err_energy,std::abs(e_inc-e_full)/std::max(1.0,std::abs(e_full)));
+    err_buffer=std::max(err_buffer,std::abs(e_saved-e_inc)/std::max(1.0,std::abs(e_inc)));
+    double v_full=H.getLocalPotential();
+    err_buffer=std::max(err_buffer,std::abs(v_inc-v_full)/std::max(1.0,std::abs(v_full)));
+  }
+  cout << "electrons = " << nel << " ions = " << ions.getTotalNum()
+       << " sweeps = " << nsweeps << " accepted = " << naccept << endl;
+  cout << "  max error of the incremental energy = " << setw(12) << err_energy << endl;
+  cout << "  max error of the buffered values    = " << setw(12) << err_buffer << endl;
+  bool passed=(err_energy<eps && err_buffer<eps && naccept>0);
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,343 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file jastrow_batch.cpp
+ * @brief Check the batched functor evaluations of the one- and two-body Jastrows
+ *
+ * BsplineFunctor::evaluateV and evaluateVGL are compared with the scalar
+ * evaluate on the knots, inside the intervals and beyond the cutoff.
+ * Electrons of two spins with the ions of three species, one without a
+ * functor, are moved particle by particle with ratio, ratioGrad and
+ * ratio(P,iat,dG,dL) in turn. The ratios, the gradients and the laplacians
+ * of TwoBodyJastrowOrbital and OneBodyJastrowOrbital are compared with
+ * the sums over the pairs of the scalar evaluate, for the B-spline functors
+ * and the generic functions with PadeFunctor, and with DT_AOS and DT_SOA
+ * tables. Returns 1 if any difference exceeds eps.
+ *
+ * Usage: jastrow_batch [-n electrons-per-spin] [-m moves]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Utilities/RandomGenerator.h"
+#include "Message/Communicate.h"
+#include "Particle/ParticleSet.h"
+#include "QMCWaveFunctions/Jastrow/BsplineFunctor.h"
+#include "QMCWaveFunctions/Jastrow/PadeFunctors.h"
+#include "QMCWaveFunctions/Jastrow/OneBodyJastrowOrbital.h"
+#include "QMCWaveFunctions/Jastrow/TwoBodyJastrowOrbital.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef OrbitalBase::PosType pos_t;
+typedef BsplineFunctor<double> bspline_t;
+typedef PadeFunctor<double> pade_t;
+
+inline double rel_diff(double a, double b)
+{
+  return std::abs(a-b)/std::max(1.0,std::abs(b));
+}
+
+bspline_t* create_bspline(double rcut, double scale)
+{
+  bspline_t* f=new bspline_t;
+  f->cutoff_radius=rcut;
+  f->resize(6);
+  for(int i=0; i<6; ++i)
+    f->Parameters[i]=scale*(0.5-0.08*i);
+  f->reset();
+  return f;
+}
+
+/** return the maximum difference of evaluateV and evaluateVGL from evaluate */
+double check_bspline(bspline_t& f)
+{
+  const double rcut=f.cutoff_radius;
+  const double delta=1.0/f.DeltaRInv;
+  vector<double> r;
+  //the knots, the intervals, the last interval and beyond the cutoff
+  for(double x=0.0; x<rcut; x+=delta)
+  {
+    r.push_back(x);
+    r.push_back(x+0.37*delta);
+  }
+  r.push_back(rcut*(1.0-1e-12));
+  r.push_back(rcut);
+  r.push_back(1.3*rcut);
+  for(int i=0; i<37; ++i)
+    r.push_back(1.2*rcut*Random());
+  const int n=r.size();
+  vector<double> u(n), v(n), du(n), d2u(n);
+  evaluateV(f,n,&r[0],&v[0]);
+  evaluateVGL(f,n,&r[0],&u[0],&du[0],&d2u[0]);
+  double err=0.0;
+  for(int i=0; i<n; ++i)
+  {
+    double du_ref=0.0, d2u_ref=0.0;
+    double u_ref=f.evaluate(r[i],du_ref,d2u_ref);
+    err=std::max(err,rel_diff(v[i],f.evaluate(r[i])));
+    err=std::max(err,rel_diff(u[i],u_ref));
+    err=std::max(err,rel_diff(du[i],du_ref));
+    err=std::max(err,rel_diff(d2u[i],d2u_ref));
+  }
+  return err;
+}
+
+/** the Jastrow factors of the pairs evaluated with the scalar functions
+ *
+ * log J = -sum_{i<j} u(r_ij) - sum_{iI} u(r_iI) and its gradients and laplacians
+ */
+template<typename FT>
+struct JastrowSum
+{
+  ///functors of the pairs of the electron groups
+  vector<FT*> F2;
+  ///functors of the ion species, 0 if none
+  vector<FT*> F1;
+  const ParticleSet& ions;
+
+  JastrowSum(const ParticleSet& p): ions(p) {}
+
+  double evaluate(const ParticleSet& P, vector<pos_t>& G, vector<double>& L) const
+  {
+    const int nel=P.getTotalNum();
+    const int ng=P.groups();
+    G.assign(nel,pos_t());
+    L.assign(nel,0.0);
+    double logj=0.0;
+    for(int i=0; i<nel; ++i)
+    {
+      for(int j=0; j<nel; ++j)
+        if(i!=j)
+          logj-=add(*F2[P.GroupID[i]*ng+P.GroupID[j]],P.R[i]-P.R[j],G[i],L[i])/2.0;
+      for(int I=0; I<ions.getTotalNum(); ++I)
+        if(F1[ions.GroupID[I]])
+          logj-=add(*F1[ions.GroupID[I]],P.R[i]-ions.R[I],G[i],L[i]);
+    }
+    return logj;
+  }
+
+  ///return u(r) and add the contributions of the pair of displacement dr
+  double add(FT& f, const pos_t& dr, pos_t& g, double& l) const
+  {
+    double r=std::sqrt(dot(dr,dr));
+    double du, d2u;
+    double u=f.evaluate(r,du,d2u);
+    g-=du/r*dr;
+    l-=d2u+2.0*du/r;
+    return u;
+  }
+};
+
+/** create the Jastrow factors with the tables of dt_type and move the electrons
+ * @return the maximum relative difference from the sums over the pairs
+ */
+template<typename FT>
+double check_jastrow(const ParticleSet& P0, const ParticleSet& ions, int dt_type
+                     , const vector<FT*>& f2, const vector<FT*>& f1, int nmoves)
+{
+  //P0 has no tables: the copy creates them with dt_type
+  ParticleSet P(P0);
+  P.addTable(P,dt_type,false);
+  P.addTable(ions,dt_type,false);
+  TwoBodyJastrowOrbital<FT> j2(P,0);
+  j2.addFunc(0,0,f2[0]);
+  j2.addFunc(0,1,f2[1]);
+  OneBodyJastrowOrbital<FT> j1(ions,P);
+  JastrowSum<FT> ref(ions);
+  ref.F2.push_back(f2[0]);
+  ref.F2.push_back(f2[1]);
+  ref.F2.push_back(f2[1]);
+  ref.F2.push_back(f2[0]);
+  ref.F1.resize(ions.getSpeciesSet().getTotalNum(),0);
+  for(int s=0; s<f1.size(); ++s)
+  {
+    j1.addFunc(s,f1[s]);
+    ref.F1[s]=f1[s];
+  }
+  const int nel=P.getTotalNum();
+  P.update();
+  ParticleSet::ParticleGradient_t G(nel), dG(nel);
+  ParticleSet::ParticleLaplacian_t L(nel), dL(nel);
+  G=0.0;
+  L=0.0;
+  double logj=j2.evaluateLog(P,G,L)+j1.evaluateLog(P,G,L);
+  vector<pos_t> G_ref, G_new;
+  vector<double> L_ref, L_new;
+  double log_ref=ref.evaluate(P,G_ref,L_ref);
+  double err=rel_diff(logj,log_ref);
+  for(int i=0; i<nel; ++i)
+  {
+    err=std::max(err,rel_diff(L[i],L_ref[i]));
+    for(int d=0; d<OHMMS_DIM; ++d)
+      err=std::max(err,rel_diff(G[i][d],G_ref[i][d]));
+  }
+  //the walker buffer of the particle-by-particle drivers
+  OrbitalBase::BufferType buf;
+  j2.registerData(P,buf);
+  j1.registerData(P,buf);
+  buf.rewind();
+  j2.copyFromBuffer(P,buf);
+  j1.copyFromBuffer(P,buf);
+  for(int m=0; m<nmoves; ++m)
+  {
+    const int iat=m%nel;
+    pos_t dr;
+    for(int d=0; d<OHMMS_DIM; ++d)
+      dr[d]=0.8*(Random()-0.5);
+    P.makeMoveAndCheck(iat,dr);
+    //R[iat] is the proposed position until the move is rejected
+    double log_new=ref.evaluate(P,G_new,L_new);
+    const double r_ref=std::exp(log_new-log_ref);
+    double r;
+    switch((m/nel)%3)
+    {
+    case 0:
+      r=j2.ratio(P,iat)*j1.ratio(P,iat);
+      break;
+    case 1:
+    {
+      OrbitalBase::GradType g;
+      r=j2.ratioGrad(P,iat,g)*j1.ratioGrad(P,iat,g);
+      for(int d=0; d<OHMMS_DIM; ++d)
+        err=std::max(err,rel_diff(g[d],G_new[iat][d]));
+      break;
+    }
+    default:
+      dG=0.0;
+      dL=0.0;
+      r=j2.ratio(P,iat,dG,dL)*j1.ratio(P,iat,dG,dL);
+      for(int i=0; i<nel; ++i)
+      {
+        err=std::max(err,rel_diff(dL[i],L_new[i]-L_ref[i]));
+        for(int d=0; d<OHMMS_DIM; ++d)
+          err=std::max(err,rel_diff(dG[i][d],G_new[i][d]-G_ref[i][d]));
+      }
+      break;
+    }
+    err=std::max(err,std::abs(r-r_ref)/r_ref);
+    if(Random()<0.7)
+    {
+      P.acceptMove(iat);
+      j2.acceptMove(P,iat);
+      j1.acceptMove(P,iat);
+      log_ref=log_new;
+      G_ref=G_new;
+      L_ref=L_new;
+    }
+    else
+    {
+      P.rejectMove(iat);
+      j2.restore(iat);
+      j1.restore(iat);
+    }
+  }
+  //the values kept by the accepted moves as the drivers store them
+  buf.rewind();
+  double log_buf=j2.evaluateLog(P,buf);
+  log_buf+=j1.evaluateLog(P,buf);
+  err=std::max(err,rel_diff(log_buf,log_ref));
+  for(int i=0; i<nel; ++i)
+  {
+    OrbitalBase::GradType g=j2.evalGrad(P,i)+j1.evalGrad(P,i);
+    for(int d=0; d<OHMMS_DIM; ++d)
+      err=std::max(err,rel_diff(g[d],G_ref[i][d]));
+  }
+  return err;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("jastrow_batch",OHMMS::Controller->rank());
+  int nup=7;
+  int nmoves=144;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      nup=atoi(argv[++ic]);
+    else
+      if(c=="-m")
+        nmoves=atoi(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-10;
+  Random.init(0,1,11);
+  //open boundary conditions: every move is valid
+  ParticleSet ions, P;
+  ions.setName("i");
+  vector<int> ni(3,2);
+  ions.create(ni);
+  SpeciesSet& ispecies(ions.getSpeciesSet());
+  ispecies.addSpecies("A");
+  ispecies.addSpecies("B");
+  ispecies.addSpecies("C");
+  ions.resetGroups();
+  ions.setBoundBox(false);
+  P.setName("e");
+  vector<int> ng(2,nup);
+  P.create(ng);
+  SpeciesSet& species(P.getSpeciesSet());
+  species.addSpecies("u");
+  species.addSpecies("d");
+  P.resetGroups();
+  P.setBoundBox(false);
+  const double L=std::pow(2.0*nup,1.0/3.0)*1.2;
+  for(int iat=0; iat<ions.getTotalNum(); ++iat)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      ions.R[iat][d]=L*Random();
+  for(int iat=0; iat<P.getTotalNum(); ++iat)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      P.R[iat][d]=L*Random();
+  //the cutoffs are shorter than the box: some pairs are beyond them
+  vector<bspline_t*> b2(2), b1(2);
+  b2[0]=create_bspline(1.6,0.5);
+  b2[1]=create_bspline(1.9,1.0);
+  b1[0]=create_bspline(1.7,-1.0);
+  b1[1]=create_bspline(2.1,-0.6);
+  vector<pade_t*> p2(2), p1(2);
+  p2[0]=new pade_t(-0.25,0.5);
+  p2[1]=new pade_t(-0.5,0.5);
+  p1[0]=new pade_t(0.8,1.2);
+  p1[1]=new pade_t(0.5,0.7);
+  double err_f=0.0;
+  for(int k=0; k<2; ++k)
+  {
+    err_f=std::max(err_f,check_bspline(*b2[k]));
+    err_f=std::max(err_f,check_bspline(*b1[k]));
+  }
+  double err_aos=check_jastrow(P,ions,DistanceTableData::DT_AOS,b2,b1,nmoves);
+  double err_soa=check_jastrow(P,ions,DistanceTableData::DT_SOA,b2,b1,nmoves);
+  double err_pade=check_jastrow(P,ions,DistanceTableData::DT_SOA,p2,p1,nmoves);
+  cout << "electrons = " << P.getTotalNum() << " ions = " << ions.getTotalNum()
+       << " moves = " << nmoves << endl;
+  cout << "  max error of evaluateV and evaluateVGL = " << setw(12) << err_f << endl;
+  cout << "  max error with the DT_AOS tables       = " << setw(12) << err_aos << endl;
+  cout << "  max error with the DT_SOA tables       = " << setw(12) << err_soa << endl;
+  cout << "  max error of the generic functions     = " << setw(12) << err_pade << endl;
+  bool passed=(err_f<eps && err_aos<eps && err_soa<eps && err_pade<eps);
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,133 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file lcao_batch.cpp
+ * @brief Check the orbitals of the walkers by a single gemm against those of the particles
+ *
+ * LCOrbitalSet::evaluate_notranspose contracts the OHMMS_DIM+2 rows of the
+ * basis functions of all the particles with the coefficients by a gemm. The
+ * values, gradients and laplacians of every particle of the ranges
+ * [first,last) have to be those of evaluate of the particle at the same
+ * position, with and without the cutoff radii of the centers.
+ * Returns 1 if any difference exceeds eps.
+ *
+ * Usage: lcao_batch [-n centers-per-axis] [-e electrons] [-t tolerance]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Message/Communicate.h"
+#include "SandBox/lcao_system.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef gto_spo_t::ValueVector_t ValueVector_t;
+typedef gto_spo_t::GradVector_t GradVector_t;
+typedef gto_spo_t::ValueMatrix_t ValueMatrix_t;
+typedef gto_spo_t::GradMatrix_t GradMatrix_t;
+
+inline double rel_diff(double a, double b)
+{
+  return std::abs(a-b)/std::max(1.0,std::abs(b));
+}
+
+/** return the largest difference of the orbitals of the particles [first,last) */
+double max_diff(gto_spo_t& spo, ParticleSet& P, int first, int last)
+{
+  const int norb=spo.getOrbitalSetSize();
+  const int nptcl=last-first;
+  ValueMatrix_t psiM(nptcl,norb), d2psiM(nptcl,norb);
+  GradMatrix_t dpsiM(nptcl,norb);
+  spo.evaluate_notranspose(P,first,last,psiM,dpsiM,d2psiM);
+  ValueVector_t v(norb), l(norb);
+  GradVector_t g(norb);
+  double err=0.0;
+  for(int iat=first; iat<last; ++iat)
+  {
+    //a move of the particle to its own position
+    P.makeMove(iat,ParticleSet::SingleParticlePos_t(0.0));
+    spo.evaluate(P,iat,v,g,l);
+    P.rejectMove(iat);
+    const int i=iat-first;
+    for(int j=0; j<norb; ++j)
+    {
+      err=std::max(err,rel_diff(psiM(i,j),v[j]));
+      err=std::max(err,rel_diff(d2psiM(i,j),l[j]));
+      for(int d=0; d<OHMMS_DIM; ++d)
+        err=std::max(err,rel_diff(dpsiM(i,j)[d],g[j][d]));
+    }
+  }
+  return err;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("lcao_batch",OHMMS::Controller->rank());
+  int n=3;
+  int nel=12;
+  double tol=1e-8;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      n=atoi(argv[++ic]);
+    else
+      if(c=="-e")
+        nel=atoi(argv[++ic]);
+      else
+        if(c=="-t")
+          tol=atof(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-12;
+  const double a=4.0;
+  const int norb=nel/2;
+  Random.init(0,1,11);
+  ParticleSet ions, P;
+  create_gto_ions(ions,n,a);
+  create_gto_electrons(P,nel,n,a);
+  gto_basis_t* basis_dense=create_gto_basis(ions,P,0.0);
+  gto_basis_t* basis=create_gto_basis(ions,P,tol);
+  gto_spo_t* dense=create_gto_spo(basis_dense,norb);
+  gto_spo_t* spo=create_gto_spo(basis,norb);
+  P.update();
+  //all the particles and the two halves as the determinants of two spins
+  double err_dense=0.0, err_cutoff=0.0;
+  err_dense=std::max(err_dense,max_diff(*dense,P,0,nel));
+  err_dense=std::max(err_dense,max_diff(*dense,P,0,nel/2));
+  err_dense=std::max(err_dense,max_diff(*dense,P,nel/2,nel));
+  err_cutoff=std::max(err_cutoff,max_diff(*spo,P,0,nel));
+  err_cutoff=std::max(err_cutoff,max_diff(*spo,P,0,nel/2));
+  err_cutoff=std::max(err_cutoff,max_diff(*spo,P,nel/2,nel));
+  bool passed=(err_dense<eps && err_cutoff<eps);
+  cout << "centers = " << basis->NumCenters << " basis functions = " << basis->BasisSetSize
+       << " electrons = " << nel << " orbitals = " << norb << endl;
+  cout << "  max difference without the cutoff = " << setw(12) << err_dense << endl;
+  cout << "  max difference with the cutoff    = " << setw(12) << err_cutoff << endl;
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  delete spo;
+  delete dense;
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,257 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file lcao_cutoff.cpp
+ * @brief Check the LCAO orbitals screened by the cutoff radii of the centers
+ *
+ * The basis functions of a cluster of Gaussian-type orbitals are screened
+ * with cutoffTolerance eps:
+ * - every radial function has to stay below eps beyond the cutoff radius
+ *   of its species;
+ * - the ranges of the active basis functions have to be those of the centers
+ *   within their radii;
+ * - the orbitals and their gradients, laplacians and hessians of the
+ *   particle moves and of the walkers have to agree with the dense ones
+ *   within the bounds of the neglected tails.
+ * A value below eps is bounded by eps per basis function. The derivatives
+ * of a Gaussian tail beyond the radius rc carry the factors 2*alpha*rc for
+ * the gradients and its square for the second derivatives.
+ * Returns 1 if a radius or an active range is wrong or any bound is exceeded.
+ *
+ * Usage: lcao_cutoff [-n centers-per-axis] [-e electrons] [-t tolerance]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Message/Communicate.h"
+#include "SandBox/lcao_system.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef gto_spo_t::ValueVector_t ValueVector_t;
+typedef gto_spo_t::GradVector_t GradVector_t;
+typedef gto_spo_t::HessVector_t HessVector_t;
+typedef gto_spo_t::ValueMatrix_t ValueMatrix_t;
+typedef gto_spo_t::GradMatrix_t GradMatrix_t;
+
+/** largest difference of the orbitals and their derivatives */
+struct orbital_errors
+{
+  double V, G, L;
+  orbital_errors(): V(0.0), G(0.0), L(0.0) {}
+  void add(const ValueVector_t& v, const ValueVector_t& v_ref)
+  {
+    for(int j=0; j<v.size(); ++j)
+      V=std::max(V,std::abs(v[j]-v_ref[j]));
+  }
+  void add(const GradVector_t& g, const GradVector_t& g_ref)
+  {
+    for(int j=0; j<g.size(); ++j)
+      for(int d=0; d<OHMMS_DIM; ++d)
+        G=std::max(G,std::abs(g[j][d]-g_ref[j][d]));
+  }
+  void add(const HessVector_t& h, const HessVector_t& h_ref)
+  {
+    for(int j=0; j<h.size(); ++j)
+      for(int k=0; k<OHMMS_DIM*OHMMS_DIM; ++k)
+        L=std::max(L,std::abs(h[j](k)-h_ref[j](k)));
+  }
+  void addLap(const ValueVector_t& l, const ValueVector_t& l_ref)
+  {
+    for(int j=0; j<l.size(); ++j)
+      L=std::max(L,std::abs(l[j]-l_ref[j]));
+  }
+};
+
+/** return the number of the radial functions above eps beyond the cutoff radius */
+int count_tails(const gto_basis_t& basis, double eps, double rlimit)
+{
+  int nbad=0;
+  for(int i=0; i<basis.LOBasisSet.size(); ++i)
+  {
+    const gto_center_t& aos(*basis.LOBasisSet[i]);
+    for(int nl=0; nl<aos.Rnl.size(); ++nl)
+    {
+      const int l=aos.RnlID[nl][q_l];
+      bool above=false;
+      for(double r=aos.Rmax; r<rlimit; r+=0.001)
+        above = above || std::abs(aos.Rnl[nl]->evaluate(r,1.0/r)*std::pow(r,l))>eps;
+      nbad += above;
+    }
+  }
+  return nbad;
+}
+
+/** return the number of the basis functions of the active ranges which are wrong
+ * @param r distances of the centers
+ */
+int count_active(const gto_basis_t& basis, const vector<double>& r)
+{
+  vector<int> active(basis.BasisSetSize,0);
+  const vector<int>& blocks(basis.ActiveBlocks);
+  int nactive=0;
+  for(int k=0; k+1<blocks.size(); k+=2)
+    for(int b=blocks[k]; b<blocks[k+1]; ++b)
+    {
+      active[b]++;
+      nactive++;
+    }
+  int nbad=std::abs(nactive-basis.NumActiveBasis);
+  for(int c=0; c<basis.NumCenters; ++c)
+  {
+    const int within=(r[c]<=basis.CenterCutoff[c]);
+    for(int b=basis.BasisOffset[c]; b<basis.BasisOffset[c+1]; ++b)
+      nbad += (active[b]!=within);
+  }
+  return nbad;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("lcao_cutoff",OHMMS::Controller->rank());
+  int n=4;
+  int nel=16;
+  double eps=1e-8;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      n=atoi(argv[++ic]);
+    else
+      if(c=="-e")
+        nel=atoi(argv[++ic]);
+      else
+        if(c=="-t")
+          eps=atof(argv[++ic]);
+    ++ic;
+  }
+  const double a=4.0;
+  const double rlimit=100.0;
+  const int norb=nel;
+  Random.init(0,1,11);
+  ParticleSet ions, P;
+  create_gto_ions(ions,n,a);
+  create_gto_electrons(P,nel,n,a);
+  gto_basis_t* basis_ref=create_gto_basis(ions,P,0.0);
+  gto_basis_t* basis=create_gto_basis(ions,P,eps);
+  gto_spo_t* ref=create_gto_spo(basis_ref,norb);
+  gto_spo_t* spo=create_gto_spo(basis,norb);
+  spo->C=ref->C;
+  P.update();
+  //bounds of the neglected tails
+  double csum=0.0, rc=0.0;
+  for(int j=0; j<norb; ++j)
+  {
+    double s=0.0;
+    for(int b=0; b<ref->getBasisSetSize(); ++b)
+      s+=std::abs(ref->C(j,b));
+    csum=std::max(csum,s);
+  }
+  for(int c=0; c<basis->NumCenters; ++c)
+    rc=std::max(rc,basis->CenterCutoff[c]);
+  const double alpha=max_exponent(*basis);
+  const double gfac=2.0*alpha*rc+2.0;
+  const double bound_v=eps*csum;
+  const double bound_g=bound_v*gfac;
+  const double bound_l=bound_v*(gfac*gfac+10.0*alpha);
+  const int nbad_tail=count_tails(*basis,eps,rlimit);
+  int nbad_active=0, nscreened=0;
+  orbital_errors err_move, err_walker;
+  ValueVector_t v(norb), v_ref(norb), l(norb), l_ref(norb);
+  GradVector_t g(norb), g_ref(norb);
+  HessVector_t h(norb), h_ref(norb);
+  vector<double> r(basis->NumCenters);
+  const DistanceTableData* dt=basis->myTable;
+  //particle moves
+  for(int iat=0; iat<nel; ++iat)
+  {
+    ParticleSet::SingleParticlePos_t dr;
+    for(int d=0; d<OHMMS_DIM; ++d)
+      dr[d]=2.0*(Random()-0.5);
+    P.makeMove(iat,dr);
+    for(int c=0; c<basis->NumCenters; ++c)
+      r[c]=dt->Temp[c].r1;
+    ref->evaluate(P,iat,v_ref);
+    spo->evaluate(P,iat,v);
+    err_move.add(v,v_ref);
+    nbad_active += count_active(*basis,r);
+    nscreened += (basis->NumActiveBasis<basis->BasisSetSize);
+    ref->evaluate(P,iat,v_ref,g_ref,l_ref);
+    spo->evaluate(P,iat,v,g,l);
+    err_move.add(v,v_ref);
+    err_move.add(g,g_ref);
+    err_move.addLap(l,l_ref);
+    nbad_active += count_active(*basis,r);
+    ref->evaluate(P,iat,v_ref,g_ref,h_ref);
+    spo->evaluate(P,iat,v,g,h);
+    err_move.add(v,v_ref);
+    err_move.add(g,g_ref);
+    err_move.add(h,h_ref);
+    nbad_active += count_active(*basis,r);
+    P.rejectMove(iat);
+  }
+  //walkers
+  ValueMatrix_t psiM(nel,norb), psiM_ref(nel,norb), d2psiM(nel,norb), d2psiM_ref(nel,norb);
+  GradMatrix_t dpsiM(nel,norb), dpsiM_ref(nel,norb);
+  ref->evaluate_notranspose(P,0,nel,psiM_ref,dpsiM_ref,d2psiM_ref);
+  spo->evaluate_notranspose(P,0,nel,psiM,dpsiM,d2psiM);
+  for(int iat=0; iat<nel; ++iat)
+  {
+    for(int j=0; j<norb; ++j)
+    {
+      v[j]=psiM(iat,j);
+      v_ref[j]=psiM_ref(iat,j);
+      g[j]=dpsiM(iat,j);
+      g_ref[j]=dpsiM_ref(iat,j);
+      l[j]=d2psiM(iat,j);
+      l_ref[j]=d2psiM_ref(iat,j);
+    }
+    err_walker.add(v,v_ref);
+    err_walker.add(g,g_ref);
+    err_walker.addLap(l,l_ref);
+    for(int c=0; c<basis->NumCenters; ++c)
+      r[c]=dt->r(dt->M[c]+iat);
+    basis->evaluateForWalkerMove(P,iat);
+    nbad_active += count_active(*basis,r);
+  }
+  bool passed=(nbad_tail==0 && nbad_active==0 && nscreened>0
+               && err_move.V<=bound_v && err_move.G<=bound_g && err_move.L<=bound_l
+               && err_walker.V<=bound_v && err_walker.G<=bound_g && err_walker.L<=bound_l);
+  cout << "centers = " << basis->NumCenters << " basis functions = " << basis->BasisSetSize
+       << " electrons = " << nel << " tolerance = " << eps << endl;
+  for(int i=0; i<basis->LOBasisSet.size(); ++i)
+    cout << "  cutoff radius of " << ions.getSpeciesSet().speciesName[i] << " = " << basis->LOBasisSet[i]->Rmax << endl;
+  cout << "  radial functions above the tolerance beyond the radius = " << nbad_tail << endl;
+  cout << "  wrong basis functions of the active ranges          = " << nbad_active << endl;
+  cout << "  screened moves = " << nscreened << " of " << nel << endl;
+  cout << "                         values        gradients     laplacians" << endl;
+  cout << "  bounds          " << setw(14) << bound_v << setw(14) << bound_g << setw(14) << bound_l << endl;
+  cout << "  particle moves  " << setw(14) << err_move.V << setw(14) << err_move.G << setw(14) << err_move.L << endl;
+  cout << "  walkers         " << setw(14) << err_walker.V << setw(14) << err_walker.G << setw(14) << err_walker.L << endl;
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  delete spo;
+  delete ref;
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
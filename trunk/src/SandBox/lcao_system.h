@@ -0,0 +1,153 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file lcao_system.h
+ * @brief A cluster of Gaussian-type orbitals for the checks of LCOrbitalSet
+ *
+ * The centers of two species are placed on a cubic grid in open boundary
+ * conditions. A has a diffuse s and p shell and B a contracted s shell and a
+ * tight p shell. The coefficients of the orbitals are random.
+ */
+#ifndef QMCPLUSPLUS_SANDBOX_LCAO_SYSTEM_H
+#define QMCPLUSPLUS_SANDBOX_LCAO_SYSTEM_H
+#include "Particle/ParticleSet.h"
+#include "Utilities/RandomGenerator.h"
+#include "Numerics/GaussianBasisSet.h"
+#include "QMCWaveFunctions/SphericalBasisSet.h"
+#include "QMCWaveFunctions/LocalizedBasisSet.h"
+#include "QMCWaveFunctions/LCOrbitalSet.h"
+
+namespace qmcplusplus
+{
+
+typedef GaussianCombo<double> gto_radial_t;
+typedef SphericalBasisSet<gto_radial_t> gto_center_t;
+typedef LocalizedBasisSet<gto_center_t> gto_basis_t;
+typedef LCOrbitalSet<gto_basis_t,false> gto_spo_t;
+
+/** add a shell of angular momentum l of the contracted Gaussians to a center
+ * @param alpha exponents
+ * @param c contraction coefficients of the normalized Gaussians
+ */
+inline void add_gto_shell(gto_center_t* aos, int l, const vector<double>& alpha, const vector<double>& c)
+{
+  gto_radial_t* radorb=new gto_radial_t(l,false);
+  for(int i=0; i<alpha.size(); ++i)
+    radorb->gset.push_back(gto_radial_t::BasicGaussian(alpha[i],c[i]*radorb->NormL*std::pow(alpha[i],radorb->NormPow)));
+  const int nl=aos->Rnl.size();
+  aos->Rnl.push_back(radorb);
+  aos->RnlID.push_back(QuantumNumberType(nl+1,l,0,0));
+  for(int m=-l; m<=l; ++m)
+  {
+    aos->NL.push_back(nl);
+    aos->LM.push_back(aos->Ylm.index(l,m));
+  }
+  aos->setBasisSetSize(-1);
+}
+
+/** return the largest exponent of the centers */
+inline double max_exponent(const gto_basis_t& basis)
+{
+  double a=0.0;
+  for(int i=0; i<basis.LOBasisSet.size(); ++i)
+    for(int nl=0; nl<basis.LOBasisSet[i]->Rnl.size(); ++nl)
+    {
+      const gto_radial_t& radorb(*basis.LOBasisSet[i]->Rnl[nl]);
+      for(int k=0; k<radorb.gset.size(); ++k)
+        a=std::max(a,radorb.gset[k].Sigma);
+    }
+  return a;
+}
+
+/** centers of A and B alternating on a cubic grid
+ * @param n number of the centers along an axis
+ * @param a spacing of the grid
+ */
+inline void create_gto_ions(ParticleSet& ions, int n, double a)
+{
+  ions.setName("ion0");
+  SpeciesSet& species(ions.getSpeciesSet());
+  species.addSpecies("A");
+  species.addSpecies("B");
+  vector<int> ng(2,0);
+  ng[0]=(n*n*n+1)/2;
+  ng[1]=n*n*n/2;
+  ions.create(ng);
+  int ig[2]= {0,ng[0]};
+  for(int i=0; i<n; ++i)
+    for(int j=0; j<n; ++j)
+      for(int k=0; k<n; ++k)
+      {
+        const int s=(i+j+k)%2;
+        ions.R[ig[s]++]=ParticleSet::SingleParticlePos_t(a*i,a*j,a*k);
+      }
+  ions.resetGroups();
+  ions.setBoundBox(false);
+}
+
+/** electrons at random positions around the ions */
+inline void create_gto_electrons(ParticleSet& P, int nel, int n, double a)
+{
+  P.setName("e");
+  P.getSpeciesSet().addSpecies("u");
+  vector<int> ng(1,nel);
+  P.create(ng);
+  P.setBoundBox(false);
+  for(int iat=0; iat<nel; ++iat)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      P.R[iat][d]=a*(n+1)*Random()-a;
+}
+
+/** return the basis set of the cluster, screened by eps if positive */
+inline gto_basis_t* create_gto_basis(ParticleSet& ions, ParticleSet& P, double eps)
+{
+  gto_basis_t* basis=new gto_basis_t(ions,P);
+  gto_center_t* a=new gto_center_t(1);
+  add_gto_shell(a,0,vector<double>(1,0.15),vector<double>(1,1.0));
+  add_gto_shell(a,1,vector<double>(1,0.3),vector<double>(1,1.0));
+  gto_center_t* b=new gto_center_t(1);
+  vector<double> alpha(2), c(2);
+  alpha[0]=3.0;
+  alpha[1]=0.6;
+  c[0]=0.4;
+  c[1]=0.7;
+  add_gto_shell(b,0,alpha,c);
+  add_gto_shell(b,1,vector<double>(1,1.2),vector<double>(1,1.0));
+  basis->add(0,a);
+  basis->add(1,b);
+  basis->setBasisSetSize(-1);
+  basis->setCutoff(eps,100.0,0.01);
+  return basis;
+}
+
+/** return the orbitals of the basis set of random coefficients */
+inline gto_spo_t* create_gto_spo(gto_basis_t* basis, int norb)
+{
+  gto_spo_t* spo=new gto_spo_t(basis);
+  spo->setOrbitalSetSize(norb);
+  spo->C.resize(norb,spo->getBasisSetSize());
+  for(int j=0; j<norb; ++j)
+    for(int b=0; b<spo->getBasisSetSize(); ++b)
+      spo->C(j,b)=2.0*Random()-1.0;
+  return spo;
+}
+
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,232 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file mixed_det.cpp
+ * @brief Check DiracDeterminantMixed against DiracDeterminantBase over a long run
+ *
+ * Two walkers share a DiracDeterminantMixed and a DiracDeterminantBase and
+ * are swapped in and out of the walker buffers at every sweep as the
+ * particle-by-particle drivers do. The moves of the even sweeps alternate
+ * ratioGrad and ratio with the gradients of all the particles, and the odd
+ * sweeps use ratio, which leaves the gradients to updateBuffer. The moves are
+ * accepted by the Metropolis test of the double-precision ratio. The ratios, gradients and log values of the mixed determinant
+ * have to agree with the double-precision ones to the single precision. At
+ * every recompute interval the log value of the mixed determinant has to be
+ * the double-precision one from scratch, and the number of the recomputes
+ * has to match the interval. The walker buffer has to hold the inverse in
+ * single precision.
+ * Returns 1 if any difference exceeds its tolerance.
+ *
+ * Usage: mixed_det [-n electrons] [-s sweeps] [-r recompute]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Utilities/RandomGenerator.h"
+#include "Message/Communicate.h"
+#include "Particle/ParticleSet.h"
+#include "QMCWaveFunctions/Fermion/DiracDeterminantMixed.h"
+#include "SandBox/CosineSet.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef DiracDeterminantBase::RealType RealType;
+typedef DiracDeterminantBase::ValueType ValueType;
+typedef DiracDeterminantBase::GradType GradType;
+
+inline double rel_diff(ValueType a, ValueType b)
+{
+  return std::abs(a-b)/std::max(1.0,static_cast<double>(std::abs(b)));
+}
+
+/** return the largest difference of the gradients of the particles */
+double max_diff(const ParticleSet::ParticleGradient_t& a, const ParticleSet::ParticleGradient_t& b)
+{
+  double err=0.0;
+  for(int i=0; i<a.size(); ++i)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      err=std::max(err,rel_diff(a[i][d],b[i][d]));
+  return err;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("mixed_det",OHMMS::Controller->rank());
+  int nel=8;
+  int nsweeps=200;
+  int recompute=10;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      nel=atoi(argv[++ic]);
+    else
+      if(c=="-s")
+        nsweeps=atoi(argv[++ic]);
+      else
+        if(c=="-r")
+          recompute=atoi(argv[++ic]);
+    ++ic;
+  }
+  //single-precision tolerance of the ratios, gradients and the drift of log|Psi|
+  const double eps_mixed=1e-3;
+  //the laplacians of all the particles lose more digits to the cancellations
+  const double eps_lap=1e-2;
+  const double eps=1e-10;
+  const int nw=2;
+  Random.init(0,1,11);
+  CosineSet spo(nel);
+  DiracDeterminantBase ref(spo.makeClone(),0);
+  ref.set(0,nel);
+  DiracDeterminantMixed mixed(spo.makeClone(),0);
+  mixed.set(0,nel);
+  mixed.setRecomputeInterval(recompute);
+  DiracDeterminantBase scratch(spo.makeClone(),0);
+  scratch.set(0,nel);
+  //walkers and their buffers
+  vector<ParticleSet*> P_list(nw);
+  vector<PooledData<RealType> > buf_ref(nw), buf_mixed(nw), buf_scratch(nw);
+  for(int iw=0; iw<nw; ++iw)
+  {
+    ParticleSet* P=P_list[iw]=new ParticleSet;
+    P->setName("e");
+    vector<int> ng(1,nel);
+    P->create(ng);
+    //open boundary conditions: every move is valid
+    P->setBoundBox(false);
+    for(int iat=0; iat<nel; ++iat)
+      for(int d=0; d<OHMMS_DIM; ++d)
+        P->R[iat][d]=3.0*Random();
+    P->update();
+    ref.registerData(*P,buf_ref[iw]);
+    mixed.registerData(*P,buf_mixed[iw]);
+    scratch.registerData(*P,buf_scratch[iw]);
+  }
+  double err_ratio=0.0, err_grad=0.0, err_lap=0.0, err_drift=0.0, err_recompute=0.0;
+  int naccepted=0, nrejected=0;
+  ParticleSet::ParticleGradient_t dG_ref(nel), dG_mixed(nel), G(nel);
+  ParticleSet::ParticleLaplacian_t dL_ref(nel), dL_mixed(nel), L(nel);
+  for(int sweep=0; sweep<nsweeps; ++sweep)
+  {
+    for(int iw=0; iw<nw; ++iw)
+    {
+      ParticleSet& P(*P_list[iw]);
+      buf_ref[iw].rewind();
+      buf_mixed[iw].rewind();
+      ref.copyFromBuffer(P,buf_ref[iw]);
+      mixed.copyFromBuffer(P,buf_mixed[iw]);
+      for(int iat=0; iat<nel; ++iat)
+      {
+        ParticleSet::PosType dr;
+        for(int d=0; d<OHMMS_DIM; ++d)
+          dr[d]=0.6*(Random()-0.5);
+        P.makeMoveAndCheck(iat,dr);
+        ValueType r_ref, r_mixed;
+        switch((sweep%2)? 1:2*(iat%2))
+        {
+        case 0:
+        {
+          GradType g_ref, g_mixed;
+          r_ref=ref.ratioGrad(P,iat,g_ref);
+          r_mixed=mixed.ratioGrad(P,iat,g_mixed);
+          for(int d=0; d<OHMMS_DIM; ++d)
+            err_grad=std::max(err_grad,rel_diff(g_mixed[d],g_ref[d]));
+        }
+        break;
+        case 1:
+          r_ref=ref.ratio(P,iat);
+          r_mixed=mixed.ratio(P,iat);
+          break;
+        default:
+          dG_ref=0.0;
+          dL_ref=0.0;
+          dG_mixed=0.0;
+          dL_mixed=0.0;
+          r_ref=ref.ratio(P,iat,dG_ref,dL_ref);
+          r_mixed=mixed.ratio(P,iat,dG_mixed,dL_mixed);
+          err_grad=std::max(err_grad,max_diff(dG_mixed,dG_ref));
+          for(int i=0; i<nel; ++i)
+            err_lap=std::max(err_lap,rel_diff(dL_mixed[i],dL_ref[i]));
+          break;
+        }
+        err_ratio=std::max(err_ratio,rel_diff(r_mixed,r_ref));
+        //Metropolis test keeps the walkers away from the nodes
+        if(r_ref*r_ref>Random())
+        {
+          ++naccepted;
+          P.acceptMove(iat);
+          ref.acceptMove(P,iat);
+          mixed.acceptMove(P,iat);
+        }
+        else
+        {
+          ++nrejected;
+          P.rejectMove(iat);
+          ref.restore(iat);
+          mixed.restore(iat);
+        }
+        const int jat=(iat+1)%nel;
+        GradType g_ref=ref.evalGrad(P,jat);
+        GradType g_mixed=mixed.evalGrad(P,jat);
+        for(int d=0; d<OHMMS_DIM; ++d)
+          err_grad=std::max(err_grad,rel_diff(g_mixed[d],g_ref[d]));
+      }
+      buf_ref[iw].rewind();
+      buf_mixed[iw].rewind();
+      P.G=0.0;
+      P.L=0.0;
+      ref.updateBuffer(P,buf_ref[iw]);
+      mixed.updateBuffer(P,buf_mixed[iw]);
+      err_drift=std::max(err_drift,std::abs(mixed.LogValue-ref.LogValue));
+      if((sweep+1)%recompute == 0)
+      {
+        G=0.0;
+        L=0.0;
+        RealType logpsi=scratch.evaluateLog(P,G,L);
+        err_recompute=std::max(err_recompute,std::abs(mixed.LogValue-logpsi));
+      }
+    }
+  }
+  const int nrecompute=nw*(nsweeps/recompute);
+  //psiM in double precision replaced by psiMf packed in the buffer
+  const int nbuf=buf_ref[0].size()-nel*nel*sizeof(ValueType)/sizeof(RealType)
+                 +PooledData<RealType>::packed_size(nel*nel*sizeof(DiracDeterminantMixed::mValueType))+1;
+  bool passed=(err_ratio<eps_mixed && err_grad<eps_mixed && err_lap<eps_lap && err_drift<eps_mixed && err_recompute<eps
+               && naccepted && nrejected && mixed.NumRecomputes==nrecompute && buf_mixed[0].size()==nbuf);
+  cout << "electrons = " << nel << " sweeps = " << nsweeps << " recompute = " << recompute << endl;
+  cout << "  accepted = " << naccepted << " rejected = " << nrejected << endl;
+  cout << "  max error of the ratios     = " << setw(12) << err_ratio << endl;
+  cout << "  max error of the gradients  = " << setw(12) << err_grad << endl;
+  cout << "  max error of the laplacians = " << setw(12) << err_lap << endl;
+  cout << "  max drift of log|Psi|       = " << setw(12) << err_drift << endl;
+  cout << "  max error at the recomputes = " << setw(12) << err_recompute << endl;
+  cout << "  recomputes = " << mixed.NumRecomputes << " (" << nrecompute << ")" << endl;
+  cout << "  buffer size = " << buf_mixed[0].size() << " (" << nbuf << ")"
+       << " double precision = " << buf_ref[0].size() << endl;
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  for(int iw=0; iw<nw; ++iw)
+    delete P_list[iw];
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,248 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file multidet_ratio.cpp
+ * @brief Check MultiSlaterDeterminantFast against the explicit sum over the determinants
+ *
+ * A CI expansion over single and double excitations of each spin is moved
+ * particle by particle with ratio, ratioGrad and ratio(P,iat,dG,dL) in turn,
+ * so that the contracted coefficients ContractedC are used and invalidated
+ * by the accepted moves of both spins. The ratios are compared with
+ * \f$\sum_I C_I D^{up}_I D^{dn}_I\f$ evaluated from scratch, the gradients
+ * with its finite differences. Returns 1 if any difference exceeds eps.
+ *
+ * Usage: multidet_ratio [-m moves]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Utilities/RandomGenerator.h"
+#include "Message/Communicate.h"
+#include "Particle/ParticleSet.h"
+#include "Numerics/DeterminantOperators.h"
+#include "QMCWaveFunctions/Fermion/MultiSlaterDeterminantFast.h"
+#include "SandBox/CosineSet.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef OrbitalBase::PosType pos_t;
+typedef vector<ci_configuration2> ci_list_t;
+
+/** occupied orbitals of the unique determinants of a spin: the reference, singles and a double */
+void make_configurations(int nel, ci_list_t& confg)
+{
+  const int ex[][2]= {{nel-1,nel},{nel-1,nel+1},{nel-2,nel},{nel-1,nel+2}};
+  const int nex=sizeof(ex)/sizeof(ex[0]);
+  ci_configuration2 ref;
+  ref.occup.resize(nel);
+  for(int i=0; i<nel; ++i)
+    ref.occup[i]=i;
+  confg.assign(nex+2,ref);
+  for(int c=0; c<nex; ++c)
+  {
+    vector<int>& o(confg[c+1].occup);
+    std::replace(o.begin(),o.end(),ex[c][0],ex[c][1]);
+    std::sort(o.begin(),o.end());
+  }
+  confg[nex+1].occup[nel-2]=nel;
+  confg[nex+1].occup[nel-1]=nel+1;
+}
+
+/** psi from scratch: sum_I C_I D^{up}_{up(I)} D^{dn}_{dn(I)} */
+double psi_from_scratch(const vector<pos_t>& R, const CosineSet& spo, const MultiSlaterDeterminantFast& msd)
+{
+  vector<double> d[2];
+  for(int s=0; s<2; ++s)
+  {
+    const MultiDiracDeterminantBase& det(*msd.Dets[s]);
+    const int nel=det.NumPtcls;
+    Matrix<double> a(nel,nel);
+    vector<int> pivot(nel);
+    d[s].resize(det.confgList.size());
+    for(int c=0; c<d[s].size(); ++c)
+    {
+      const vector<int>& o(det.confgList[c].occup);
+      for(int i=0; i<nel; ++i)
+        for(int j=0; j<nel; ++j)
+          a(i,j)=std::cos(dot(spo.K[o[j]],R[det.FirstIndex+i])+spo.Phase[o[j]]);
+      d[s][c]=Determinant(a.data(),nel,nel,&pivot[0]);
+    }
+  }
+  double psi=0.0;
+  for(int I=0; I<msd.C.size(); ++I)
+    psi += msd.C[I]*d[0][msd.C2node_up[I]]*d[1][msd.C2node_dn[I]];
+  return psi;
+}
+
+/** gradient of log(psi) w.r.t. the iat-th particle by the central differences */
+pos_t grad_from_scratch(vector<pos_t> R, int iat, const CosineSet& spo, const MultiSlaterDeterminantFast& msd)
+{
+  const double h=1e-4;
+  const double psi=psi_from_scratch(R,spo,msd);
+  pos_t g;
+  for(int d=0; d<OHMMS_DIM; ++d)
+  {
+    const double r0=R[iat][d];
+    R[iat][d]=r0+h;
+    double psi_p=psi_from_scratch(R,spo,msd);
+    R[iat][d]=r0-h;
+    double psi_m=psi_from_scratch(R,spo,msd);
+    R[iat][d]=r0;
+    g[d]=(psi_p-psi_m)/(2.0*h*psi);
+  }
+  return g;
+}
+
+inline vector<pos_t> positions(const ParticleSet& P)
+{
+  vector<pos_t> R(P.getTotalNum());
+  for(int iat=0; iat<R.size(); ++iat)
+    R[iat]=P.R[iat];
+  return R;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("multidet_ratio",OHMMS::Controller->rank());
+  int nmoves=96;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-m")
+      nmoves=atoi(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-10;
+  const double eps_grad=1e-6;
+  const int nup=4;
+  Random.init(0,1,11);
+  CosineSet spo(nup+3);
+  ParticleSet P;
+  P.setName("e");
+  vector<int> ng(2,nup);
+  P.create(ng);
+  SpeciesSet& species(P.getSpeciesSet());
+  species.addSpecies("u");
+  species.addSpecies("d");
+  P.resetGroups();
+  //open boundary conditions: every move is valid
+  P.setBoundBox(false);
+  for(int iat=0; iat<P.getTotalNum(); ++iat)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      P.R[iat][d]=2.0*Random();
+  MultiDiracDeterminantBase* up=new MultiDiracDeterminantBase(spo.makeClone(),0);
+  MultiDiracDeterminantBase* dn=new MultiDiracDeterminantBase(spo.makeClone(),1);
+  MultiSlaterDeterminantFast msd(P,up,dn);
+  for(int s=0; s<2; ++s)
+  {
+    make_configurations(nup,msd.Dets[s]->confgList);
+    msd.Dets[s]->ReferenceDeterminant=0;
+    msd.Dets[s]->NumDets=msd.Dets[s]->confgList.size();
+    msd.Dets[s]->set(P.first(s),nup,spo.getOrbitalSetSize());
+  }
+  //the CI expansion over the pairs of the unique determinants
+  const int nu=msd.Dets[0]->NumDets;
+  for(int u=0; u<nu; ++u)
+    for(int d=0; d<nu; ++d)
+      if(u==0 || d==0 || (u+d)%3==0)
+      {
+        msd.C2node_up.push_back(u);
+        msd.C2node_dn.push_back(d);
+        msd.C.push_back((u+d)? 0.4*(Random()-0.5):1.0);
+      }
+  P.update();
+  OrbitalBase::BufferType buf;
+  msd.registerData(P,buf);
+  double err_log=0.0, err_ratio=0.0, err_grad=0.0;
+  double psi_ref=psi_from_scratch(positions(P),spo,msd);
+  err_log=std::abs(msd.LogValue-std::log(std::abs(psi_ref)));
+  const int nel=P.getTotalNum();
+  ParticleSet::ParticleGradient_t dG(nel);
+  ParticleSet::ParticleLaplacian_t dL(nel);
+  for(int m=0; m<nmoves; ++m)
+  {
+    const int iat=m%nel;
+    pos_t dr;
+    for(int d=0; d<OHMMS_DIM; ++d)
+      dr[d]=0.6*(Random()-0.5);
+    P.makeMoveAndCheck(iat,dr);
+    const vector<pos_t> R(positions(P));
+    const double psi_new=psi_from_scratch(R,spo,msd);
+    OrbitalBase::ValueType r;
+    switch((m/nel)%3)
+    {
+    case 0:
+      r=msd.ratio(P,iat);
+      break;
+    case 1:
+    {
+      OrbitalBase::GradType g;
+      r=msd.ratioGrad(P,iat,g);
+      const pos_t g_ref=grad_from_scratch(R,iat,spo,msd);
+      for(int d=0; d<OHMMS_DIM; ++d)
+        err_grad=std::max(err_grad,std::abs(g[d]-g_ref[d])/std::max(1.0,std::abs(g_ref[d])));
+      break;
+    }
+    default:
+      dG=0.0;
+      dL=0.0;
+      r=msd.ratio(P,iat,dG,dL);
+      break;
+    }
+    err_ratio=std::max(err_ratio,std::abs(r-psi_new/psi_ref)/std::abs(psi_new/psi_ref));
+    if(Random()<0.7)
+    {
+      P.acceptMove(iat);
+      msd.acceptMove(P,iat);
+      psi_ref=psi_new;
+    }
+    else
+    {
+      P.rejectMove(iat);
+      msd.restore(iat);
+    }
+  }
+  //the updated log value and the gradients from scratch
+  P.update();
+  P.G=0.0;
+  P.L=0.0;
+  double logpsi=msd.evaluateLog(P,P.G,P.L);
+  err_log=std::max(err_log,std::abs(logpsi-std::log(std::abs(psi_ref))));
+  for(int iat=0; iat<nel; ++iat)
+  {
+    const pos_t g_ref=grad_from_scratch(positions(P),iat,spo,msd);
+    for(int d=0; d<OHMMS_DIM; ++d)
+      err_grad=std::max(err_grad,std::abs(P.G[iat][d]-g_ref[d])/std::max(1.0,std::abs(g_ref[d])));
+  }
+  cout << "determinants = " << msd.C.size() << " unique per spin = " << nu
+       << " electrons = " << nel << " moves = " << nmoves << endl;
+  cout << "  max error of the log values = " << setw(12) << err_log << endl;
+  cout << "  max error of the ratios     = " << setw(12) << err_ratio << endl;
+  cout << "  max error of the gradients  = " << setw(12) << err_grad << endl;
+  bool passed=(err_log<eps && err_ratio<eps && err_grad<eps_grad);
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
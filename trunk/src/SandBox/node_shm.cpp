@@ -0,0 +1,168 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file node_shm.cpp
+ * @brief Check the spline tables shared by the tasks on a node
+ *
+ * A segment of NodeSharedMemory is filled by the node leader and read by
+ * every task of the node. A forked copy of a task other than the leader
+ * writes to the segment and must be aborted with the message of
+ * NodeSharedMemory instead of a bare SIGSEGV. The single-precision orbitals
+ * of a minimal ES-HDF file are created with --shared_splines, once by FFT and
+ * spline and once from the cached table, and are compared with the orbitals
+ * of private tables on every task.
+ * Returns 1 if the segment, the abort or any difference is wrong.
+ *
+ * Usage: mpirun -np 4 node_shm [-n bands]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Message/Communicate.h"
+#include "Message/CommOperators.h"
+#include "Message/NodeSharedMemory.h"
+#include "SandBox/eshdf_writer.h"
+#include "spline/einspline_util.hpp"
+#include "qmc_common.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <csignal>
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef TinyVector<double,3> pos_t;
+
+/** return the largest difference of vgl from ref */
+double max_diff(const vector<double>& vgl, const vector<double>& ref)
+{
+  double err=(vgl.size()==ref.size() && ref.size())? 0.0:1.0;
+  for(int i=0; i<vgl.size() && i<ref.size(); ++i)
+    err=std::max(err,std::abs(vgl[i]-ref[i])/std::max(1.0,std::abs(ref[i])));
+  return err;
+}
+
+/** fill a segment on the leader and return the number of wrong elements on this task
+ * @param aborted true, if a write to the segment by a task other than the leader is aborted
+ */
+int check_segment(Communicate* comm, bool& aborted)
+{
+  const int n=1000;
+  NodeSharedMemory shm(comm);
+  double* data=static_cast<double*>(shm.allocate(n*sizeof(double)));
+  //all the tasks of the sandbox run on a node, which a single task does not share
+  aborted=true;
+  if(data==0)
+    return shm.isShared()? n:0;
+  if(shm.isLeader())
+    for(int i=0; i<n; ++i)
+      data[i]=0.5*i;
+  shm.fence();
+  int nbad=0;
+  for(int i=0; i<n; ++i)
+    nbad += (data[i]!=0.5*i);
+  if(shm.NodeComm->rank()==1)
+  {
+    pid_t pid=fork();
+    if(pid==0)
+    {
+      data[n/2]=-1.0;
+      _exit(0);
+    }
+    int status=0;
+    waitpid(pid,&status,0);
+    aborted=(WIFSIGNALED(status) && WTERMSIG(status)==SIGABRT);
+  }
+  return nbad;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  Communicate* comm=OHMMS::Controller;
+  OhmmsInfo Welcome("node_shm",comm->rank());
+  int nb=5;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      nb=atoi(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-12;
+  bool aborted;
+  int nbad=check_segment(comm,aborted);
+  const string fname("node_shm.h5");
+  Tensor<int,3> tmat(1,0,0,0,1,0,0,0,1);
+  const string cachefile=make_spline_filename(fname,tmat,0,0,TinyVector<int,3>(8,8,8));
+  Tensor<double,3> lattice(4.0,0.0,0.0, 1.1,3.6,0.0, -0.7,0.9,3.8);
+  const int nel=2*nb-2;
+  vector<int> ns(2,nel/2);
+  ParticleSet P;
+  P.Lattice.BoxBConds=1;
+  P.Lattice.set(lattice);
+  P.create(ns);
+  Random.init(0,1,13);
+  for(int iat=0; iat<nel; ++iat)
+    P.R[iat]=dot(pos_t(3.0*Random()-1.0,3.0*Random()-1.0,3.0*Random()-1.0),lattice);
+  if(comm->rank()==0)
+  {
+    remove(cachefile.c_str());
+    Random.init(0,1,11);
+    vector<pos_t> k(1,pos_t(0.0,0.0,0.0));
+    write_eshdf(fname,lattice,k,nb);
+  }
+  comm->barrier();
+  xmlNodePtr cur=eshdf_sposet_node(fname,nb-1,1,"single");
+  vector<double> ref, vgl_fft, vgl_cache;
+  read_bands(comm,cur,P,ref);
+  qmc_common.shared_splines=true;
+  qmc_common.spline_cache=true;
+  read_bands(comm,cur,P,vgl_fft);
+  read_bands(comm,cur,P,vgl_cache);
+  qmc_common.shared_splines=false;
+  qmc_common.spline_cache=false;
+  xmlFreeNode(cur);
+  //the differences and the failures of every task
+  vector<double> errs(4,0.0);
+  errs[0]=max_diff(vgl_fft,ref);
+  errs[1]=max_diff(vgl_cache,ref);
+  errs[2]=nbad;
+  errs[3]=aborted? 0:1;
+  comm->allreduce(errs);
+  bool passed=(errs[0]<eps && errs[1]<eps && errs[2]==0 && errs[3]==0);
+  if(comm->rank()==0)
+  {
+    cout << "tasks = " << comm->size() << " bands = " << nb << endl;
+    cout << "  wrong elements of the shared segment = " << errs[2] << endl;
+    cout << "  write by a task other than the leader " << (errs[3]==0? "aborted":"not aborted") << endl;
+    cout << "  max difference of the shared table by FFT   = " << setw(12) << errs[0] << endl;
+    cout << "  max difference of the shared cached table   = " << setw(12) << errs[1] << endl;
+    cout << (passed? "  PASSED":"  FAILED") << endl;
+    remove(fname.c_str());
+    remove(cachefile.c_str());
+  }
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,174 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file reblock_error.cpp
+ * @brief Check reblock_accumulator against the blocking of the stored series
+ *
+ * AR(1) series \f$x_t=\phi x_{t-1}+\sqrt{1-\phi^2}\xi_t\f$ of unit variance,
+ * whose autocorrelation time is \f$\kappa=(1+\phi)/(1-\phi)\f$, are
+ * accumulated with unit and random weights. The errors of every level and
+ * the optimal level of the Lee criterion are compared with those of the
+ * blocks formed from the stored samples. The error at the optimal level and
+ * kappa are compared with \f$\sqrt{\kappa/N}\f$ and \f$(1+\phi)/(1-\phi)\f$.
+ * Returns 1 if any difference exceeds its tolerance.
+ *
+ * Usage: reblock_error [-n samples]
+ */
+#include "Configuration.h"
+#include "Utilities/RandomGenerator.h"
+#include "ParticleBase/RandomSeqGenerator.h"
+#include "Estimators/reblock_accumulator.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <vector>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef reblock_accumulator<double> accumulator_t;
+
+/** the error of the weighted mean with the complete blocks of b samples
+ *
+ * The block means \f$m_b\f$ of the weights \f$W_b\f$ give
+ * \f$\sigma^2=\frac{n}{n-1}\sum_b W_b^2(m_b-\bar{m})^2/(\sum_b W_b)^2\f$.
+ */
+double block_error(const vector<double>& x, const vector<double>& w, long b)
+{
+  const long n=x.size()/b;
+  vector<double> mb(n), wb(n,0.0);
+  double sw=0.0, swx=0.0;
+  for(long i=0; i<n; ++i)
+  {
+    double s=0.0;
+    for(long j=i*b; j<(i+1)*b; ++j)
+    {
+      s+=w[j]*x[j];
+      wb[i]+=w[j];
+    }
+    mb[i]=s/wb[i];
+    sw+=wb[i];
+    swx+=s;
+  }
+  if(n<2)
+    return 0.0;
+  const double m=swx/sw;
+  double v=0.0;
+  for(long i=0; i<n; ++i)
+    v+=wb[i]*wb[i]*(mb[i]-m)*(mb[i]-m);
+  return std::sqrt(v/(sw*sw)*static_cast<double>(n)/static_cast<double>(n-1));
+}
+
+/** accumulate an AR(1) series and return the maximum relative difference
+ * from the blocking of the stored series
+ * @param phi correlation of the consecutive samples
+ * @param weighted use random weights in (0.5,1.5) if true
+ * @param n number of the samples
+ * @param acc accumulator
+ * @param kopt optimal level of the Lee criterion on the stored series
+ */
+double check_series(double phi, bool weighted, long n, accumulator_t& acc, int& kopt)
+{
+  vector<double> x(n), w(n,1.0);
+  assignGaussRand(&x[0],n,Random);
+  for(long i=1; i<n; ++i)
+    x[i]=phi*x[i-1]+std::sqrt(1.0-phi*phi)*x[i];
+  if(weighted)
+    for(long i=0; i<n; ++i)
+      w[i]=0.5+Random();
+  acc.clear();
+  for(long i=0; i<n; ++i)
+    acc(x[i],w[i]);
+  double sw=0.0, swx=0.0, swx2=0.0;
+  for(long i=0; i<n; ++i)
+  {
+    sw+=w[i];
+    swx+=w[i]*x[i];
+    swx2+=w[i]*x[i]*x[i];
+  }
+  const double m=swx/sw;
+  double err=std::abs(acc.mean()-m);
+  err=std::max(err,std::abs(acc.variance()-(swx2/sw-m*m)));
+  //every level with two or more complete blocks and the Lee criterion
+  int nk=0;
+  while((2L<<nk)<=n)
+    ++nk;
+  if(acc.levels()!=nk)
+    err=std::max(err,1.0);
+  const double e0=block_error(x,w,1);
+  kopt=-1;
+  for(int k=0; k<nk; ++k)
+  {
+    const long b=1L<<k;
+    const double e=block_error(x,w,b);
+    err=std::max(err,std::abs(acc.error(k)-e)/e);
+    const double r=e/e0;
+    if(kopt<0 && static_cast<double>(b*b*b)>2.0*n*r*r*r*r)
+      kopt=k;
+  }
+  return err;
+}
+
+int main(int argc, char** argv)
+{
+  long n=1000003;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      n=atol(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-8;
+  //statistical tolerances of the error and kappa at about 1000 blocks
+  const double eps_error=0.1;
+  const double eps_kappa=0.2;
+  Random.init(0,1,11);
+  const double phis[]= {0.0,0.5,0.9};
+  bool passed=true;
+  cout << "samples = " << n << endl;
+  for(int i=0; i<3; ++i)
+    for(int weighted=0; weighted<2; ++weighted)
+    {
+      const double phi=phis[i];
+      //the uncorrelated weights in (0.5,1.5) of <w>=1 and <w^2>=13/12 add
+      //the variance 1/12 to the diagonal term of the variance of the sum
+      const double w2=weighted? 1.0/12.0:0.0;
+      const double kappa=(1.0+phi)/(1.0-phi);
+      const double kappa_ref=(kappa+w2)/(1.0+w2);
+      const double error_ref=std::sqrt((kappa+w2)/n);
+      accumulator_t acc;
+      int kopt;
+      double err=check_series(phi,weighted,n,acc,kopt);
+      bool converged;
+      const int k=acc.optimal_level(converged);
+      const double d_error=std::abs(acc.error()-error_ref)/error_ref;
+      const double d_kappa=std::abs(acc.kappa()-kappa_ref)/kappa_ref;
+      cout << "  phi = " << phi << (weighted? " weighted  ":" unweighted")
+           << " level = " << k << " (" << kopt << ")"
+           << " error = " << setw(12) << acc.error() << " (" << setw(12) << error_ref << ")"
+           << " kappa = " << setw(10) << acc.kappa() << " (" << kappa_ref << ")"
+           << " max error of the levels = " << setw(12) << err << endl;
+      passed = passed && err<eps && converged && k==kopt && d_error<eps_error && d_kappa<eps_kappa;
+    }
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
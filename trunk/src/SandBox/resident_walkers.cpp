@@ -0,0 +1,248 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file resident_walkers.cpp
+ * @brief Check the walkers of residentState="yes" against those of the walker buffers
+ *
+ * Two DMCUpdatePbyPWithRejection of the same random numbers advance the same
+ * walkers of Slater determinants, one with the walker buffers and one with
+ * residentState="yes". The walkers are recomputed by updateWalkers at every
+ * recompute interval as the drivers do. The positions, gradients, laplacians,
+ * log values, kinetic energies and weights of the two have to agree after
+ * every step. The resident
+ * walkers have to keep an empty DataSet and the same resources over the run,
+ * and their log values, gradients and laplacians after updateWalkers have to
+ * be those of evaluateLog from scratch.
+ * Returns 1 if a walker is wrong or any difference exceeds eps.
+ *
+ * Usage: resident_walkers [-n electrons-per-spin] [-w walkers] [-s steps] [-r recompute]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Utilities/RandomGenerator.h"
+#include "Message/Communicate.h"
+#include "Particle/MCWalkerConfiguration.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
+#include "QMCWaveFunctions/Fermion/SlaterDet.h"
+#include "QMCHamiltonians/QMCHamiltonian.h"
+#include "QMCHamiltonians/BareKineticEnergy.h"
+#include "QMCDrivers/DMC/DMCUpdatePbyP.h"
+#include "QMCDrivers/SimpleFixedNodeBranch.h"
+#include "Estimators/EstimatorManager.h"
+#include "SandBox/CosineSet.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef MCWalkerConfiguration::Walker_t walker_t;
+
+/** electrons of two spins of unit mass in open boundary conditions */
+void create_electrons(ParticleSet& P, int nup)
+{
+  P.setName("e");
+  vector<int> ng(2,nup);
+  P.create(ng);
+  SpeciesSet& species(P.getSpeciesSet());
+  species.addSpecies("u");
+  species.addSpecies("d");
+  int imass=species.addAttribute("mass");
+  species(imass,0)=1.0;
+  species(imass,1)=1.0;
+  P.resetGroups();
+  //open boundary conditions: every move is valid
+  P.setBoundBox(false);
+}
+
+/** return a trial wavefunction of Slater determinants of P */
+TrialWaveFunction* create_psi(ParticleSet& P, int nup, CosineSet& spo)
+{
+  TrialWaveFunction* psi=new TrialWaveFunction(OHMMS::Controller);
+  SlaterDet* sdet=new SlaterDet(P);
+  for(int ig=0; ig<2; ++ig)
+  {
+    DiracDeterminantBase* adet=new DiracDeterminantBase(spo.makeClone(),P.first(ig));
+    adet->set(P.first(ig),nup);
+    sdet->add(adet,ig);
+  }
+  psi->addOrbital(sdet,"SlaterDet");
+  return psi;
+}
+
+/** a walker population advanced by a DMCUpdatePbyPWithRejection */
+struct population
+{
+  MCWalkerConfiguration W;
+  TrialWaveFunction* Psi;
+  QMCHamiltonian H;
+  RandomGenerator_t RNG;
+  EstimatorManager Est;
+  SimpleFixedNodeBranch Branch;
+  DMCUpdatePbyPWithRejection* Mover;
+
+  population(int nup, int nw, CosineSet& spo, const string& resident)
+    : Est(OHMMS::Controller), Branch(0.1,nw)
+  {
+    create_electrons(W,nup);
+    Psi=create_psi(W,nup,spo);
+    H.addOperator(new BareKineticEnergy<double>(W),"Kinetic");
+    H.addObservables(W);
+    RNG.init(0,1,17);
+    Random.init(0,1,11);
+    W.createWalkers(nw);
+    //the walkers hold the observables of H as QMCDriver does
+    W.resetWalkerProperty(1);
+    for(int iw=0; iw<nw; ++iw)
+      for(int iat=0; iat<W.getTotalNum(); ++iat)
+        for(int d=0; d<OHMMS_DIM; ++d)
+          W[iw]->R[iat][d]=3.0*Random();
+    Branch.setEstimatorManager(&Est);
+    Branch.put(NULL);
+    Mover=new DMCUpdatePbyPWithRejection(W,*Psi,H,RNG);
+    xmlNodePtr cur=xmlNewNode(NULL,(const xmlChar*)"qmc");
+    xmlNodePtr p=xmlNewTextChild(cur,NULL,(const xmlChar*)"parameter",(const xmlChar*)resident.c_str());
+    xmlNewProp(p,(const xmlChar*)"name",(const xmlChar*)"residentState");
+    p=xmlNewTextChild(cur,NULL,(const xmlChar*)"parameter",(const xmlChar*)"100.0");
+    xmlNewProp(p,(const xmlChar*)"name",(const xmlChar*)"maxDisplSq");
+    Mover->put(cur);
+    xmlFreeNode(cur);
+    Mover->resetRun(&Branch,&Est);
+    Mover->initWalkersForPbyP(W.begin(),W.end());
+  }
+
+  ~population()
+  {
+    delete Mover;
+    delete Psi;
+  }
+};
+
+/** return the largest difference of the particle attributes */
+template<typename PA>
+double max_diff(const PA& a, const PA& b)
+{
+  double err=0.0;
+  for(int i=0; i<a.size(); ++i)
+  {
+    double d=std::sqrt(std::abs(dot(a[i]-b[i],a[i]-b[i])));
+    err=std::max(err,d/std::max(1.0,std::sqrt(std::abs(dot(b[i],b[i])))));
+  }
+  return err;
+}
+
+/** return the largest difference of the walkers */
+double max_diff(const walker_t& a, const walker_t& b)
+{
+  double err=max_diff(a.R,b.R);
+  err=std::max(err,max_diff(a.G,b.G));
+  for(int i=0; i<a.L.size(); ++i)
+    err=std::max(err,std::abs(a.L[i]-b.L[i])/std::max(1.0,std::abs(b.L[i])));
+  err=std::max(err,std::abs(a.Properties(LOGPSI)-b.Properties(LOGPSI)));
+  err=std::max(err,std::abs(a.Properties(LOCALENERGY)-b.Properties(LOCALENERGY))
+               /std::max(1.0,std::abs(b.Properties(LOCALENERGY))));
+  err=std::max(err,std::abs(a.Weight-b.Weight));
+  return err;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("resident_walkers",OHMMS::Controller->rank());
+  int nup=4;
+  int nw=4;
+  int nsteps=40;
+  int recompute=5;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      nup=atoi(argv[++ic]);
+    else
+      if(c=="-w")
+        nw=atoi(argv[++ic]);
+      else
+        if(c=="-s")
+          nsteps=atoi(argv[++ic]);
+        else
+          if(c=="-r")
+            recompute=atoi(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-8;
+  CosineSet spo(nup);
+  population buffered(nup,nw,spo,"no");
+  population resident(nup,nw,spo,"yes");
+  //walkers from scratch
+  ParticleSet P;
+  create_electrons(P,nup);
+  TrialWaveFunction* psi=create_psi(P,nup,spo);
+  //resources of the resident walkers, which have to be kept over the run
+  vector<WalkerResource*> res;
+  for(int iw=0; iw<nw; ++iw)
+    res.insert(res.end(),resident.W[iw]->Resources.Data.begin(),resident.W[iw]->Resources.Data.end());
+  double err_walker=0.0, err_scratch=0.0;
+  int nbad_dataset=0, nbad_resource=0, nupdates=0;
+  for(int step=0; step<nsteps; ++step)
+  {
+    buffered.Mover->advanceWalkers(buffered.W.begin(),buffered.W.end(),false);
+    resident.Mover->advanceWalkers(resident.W.begin(),resident.W.end(),false);
+    if((step+1)%recompute == 0)
+    {
+      buffered.Mover->updateWalkers(buffered.W.begin(),buffered.W.end());
+      resident.Mover->updateWalkers(resident.W.begin(),resident.W.end());
+      ++nupdates;
+      for(int iw=0; iw<nw; ++iw)
+      {
+        const walker_t& w(*resident.W[iw]);
+        P.R=w.R;
+        P.update();
+        psi->evaluateLog(P);
+        err_scratch=std::max(err_scratch,max_diff(w.G,P.G));
+        for(int i=0; i<w.L.size(); ++i)
+          err_scratch=std::max(err_scratch,std::abs(w.L[i]-P.L[i])/std::max(1.0,std::abs(P.L[i])));
+        err_scratch=std::max(err_scratch,std::abs(w.Properties(LOGPSI)-psi->getLogPsi()));
+      }
+      //the trial wavefunction of the mover is left with the last walker
+      err_scratch=std::max(err_scratch,std::abs(resident.Psi->getLogPsi()-psi->getLogPsi()));
+    }
+    for(int iw=0; iw<nw; ++iw)
+    {
+      const walker_t& w(*resident.W[iw]);
+      err_walker=std::max(err_walker,max_diff(w,*buffered.W[iw]));
+      nbad_dataset += (w.DataSet.size()!=0 || buffered.W[iw]->DataSet.size()==0);
+      for(int i=0; i<w.Resources.size(); ++i)
+        nbad_resource += (w.Resources.Data[i]!=res[iw*w.Resources.size()+i]);
+    }
+  }
+  bool passed=(err_walker<eps && err_scratch<eps && nbad_dataset==0 && nbad_resource==0
+               && res.size()==nw && nupdates);
+  cout << "electrons = " << 2*nup << " walkers = " << nw << " steps = " << nsteps
+       << " recompute = " << recompute << endl;
+  cout << "  max difference from the buffered walkers = " << setw(12) << err_walker << endl;
+  cout << "  max difference from scratch              = " << setw(12) << err_scratch << endl;
+  cout << "  walkers with a wrong DataSet             = " << nbad_dataset << endl;
+  cout << "  resources replaced                       = " << nbad_resource << endl;
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  delete psi;
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,288 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file rmc_harmonic.cpp
+ * @brief Check RMCUpdatePbyPWithDrift against the exact harmonic oscillator
+ *
+ * A particle of unit mass in the harmonic potential r^2/2 is sampled by a
+ * reptile with the trial wavefunction exp(-a r^2), whose exact exponent is 1/2.
+ * The ground state has the potential energy 3/4, which the beads at the center
+ * have to give as a pure estimate, while the head gives the mixed estimate
+ * 3/(2(2a+1)) of exp(-(2a+1) r^2). The local energy of every bead has to be
+ * 3a+(1/2-2a^2)r^2 after initReptile and at the end of the run.
+ * Returns 1 if an estimate is off by more than 4 error bars and the bias of
+ * the time step, or a local energy is wrong.
+ *
+ * Usage: rmc_harmonic [-a exponent] [-b beads] [-s steps] [-t timestep]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Utilities/RandomGenerator.h"
+#include "Message/Communicate.h"
+#include "Particle/MCWalkerConfiguration.h"
+#include "Particle/DistanceTable.h"
+#include "Numerics/OptimizableFunctorBase.h"
+#include "QMCWaveFunctions/TrialWaveFunction.h"
+#include "QMCWaveFunctions/Jastrow/OneBodyJastrowOrbital.h"
+#include "QMCHamiltonians/QMCHamiltonian.h"
+#include "QMCHamiltonians/BareKineticEnergy.h"
+#include "QMCDrivers/RMC/RMCUpdatePbyP.h"
+#include "QMCDrivers/SimpleFixedNodeBranch.h"
+#include "Estimators/EstimatorManager.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef MCWalkerConfiguration::Walker_t walker_t;
+
+/** u(r)=a r^2 of the one-body Jastrow exp(-u) */
+struct gaussian_functor: public OptimizableFunctorBase
+{
+  real_type A;
+  gaussian_functor(real_type a): A(a) {}
+  inline real_type evaluate(real_type r)
+  {
+    return A*r*r;
+  }
+  inline real_type evaluate(real_type r, real_type& dudr, real_type& d2udr2)
+  {
+    dudr=2.0*A*r;
+    d2udr2=2.0*A;
+    return A*r*r;
+  }
+  inline real_type evaluate(real_type r, real_type& dudr, real_type& d2udr2, real_type& d3udr3)
+  {
+    d3udr3=0.0;
+    return evaluate(r,dudr,d2udr2);
+  }
+  OptimizableFunctorBase* makeClone() const
+  {
+    return new gaussian_functor(*this);
+  }
+  void reset() {}
+  real_type f(real_type r)
+  {
+    return evaluate(r);
+  }
+  real_type df(real_type r)
+  {
+    return 2.0*A*r;
+  }
+  bool put(xmlNodePtr cur)
+  {
+    return true;
+  }
+  void checkInVariables(opt_variables_type& active) {}
+  void checkOutVariables(const opt_variables_type& active) {}
+  void resetParameters(const opt_variables_type& active) {}
+};
+
+/** harmonic potential r^2/2 around the origin */
+struct harmonic_potential: public QMCHamiltonianBase
+{
+  void resetTargetParticleSet(ParticleSet& P) {}
+  Return_t evaluate(ParticleSet& P)
+  {
+    Value=0.0;
+    for(int iat=0; iat<P.getTotalNum(); ++iat)
+      Value+=0.5*dot(P.R[iat],P.R[iat]);
+    return Value;
+  }
+  Return_t evaluate(ParticleSet& P, vector<NonLocalData>& Txy)
+  {
+    return evaluate(P);
+  }
+  bool put(xmlNodePtr cur)
+  {
+    return true;
+  }
+  bool get(std::ostream& os) const
+  {
+    os << "harmonic potential";
+    return true;
+  }
+  QMCHamiltonianBase* makeClone(ParticleSet& qp, TrialWaveFunction& psi)
+  {
+    return new harmonic_potential;
+  }
+};
+
+/** return the largest error of the local energies of the beads */
+double max_eloc_error(const Reptile& reptile, double a)
+{
+  double err=0.0;
+  for(int i=0; i<reptile.size(); ++i)
+  {
+    const walker_t& w(reptile.getBead(i));
+    const double r2=dot(w.R[0],w.R[0]);
+    const double eloc=3.0*a+(0.5-2.0*a*a)*r2;
+    err=std::max(err,std::abs(w.Properties(LOCALENERGY)-eloc));
+  }
+  return err;
+}
+
+/** block averages of a series */
+struct block_average
+{
+  int BlockSize, Count;
+  double Sum;
+  vector<double> Blocks;
+  block_average(int n): BlockSize(n), Count(0), Sum(0.0) {}
+  void add(double x)
+  {
+    Sum+=x;
+    if(++Count == BlockSize)
+    {
+      Blocks.push_back(Sum/BlockSize);
+      Count=0;
+      Sum=0.0;
+    }
+  }
+  double mean() const
+  {
+    double s=0.0;
+    for(int i=0; i<Blocks.size(); ++i)
+      s+=Blocks[i];
+    return s/Blocks.size();
+  }
+  double error() const
+  {
+    const double m=mean();
+    double s=0.0;
+    for(int i=0; i<Blocks.size(); ++i)
+      s+=(Blocks[i]-m)*(Blocks[i]-m);
+    return std::sqrt(s/(Blocks.size()*(Blocks.size()-1.0)));
+  }
+};
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("rmc_harmonic",OHMMS::Controller->rank());
+  double a=0.3;
+  int nbeads=100;
+  int nsteps=1000000;
+  double tau=0.05;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-a")
+      a=atof(argv[++ic]);
+    else
+      if(c=="-b")
+        nbeads=atoi(argv[++ic]);
+      else
+        if(c=="-s")
+          nsteps=atoi(argv[++ic]);
+        else
+          if(c=="-t")
+            tau=atof(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-10;
+  //allowance for the bias of the time step and of the finite reptile
+  const double bias=0.02;
+  const int ncenter=5;
+  const int nblocks=100;
+  const double v_pure=0.75;
+  const double v_mixed=1.5/(2.0*a+1.0);
+  ParticleSet ions;
+  ions.setName("ion0");
+  ions.getSpeciesSet().addSpecies("O");
+  ions.create(1);
+  ions.R[0]=0.0;
+  MCWalkerConfiguration W;
+  W.setName("e");
+  SpeciesSet& species(W.getSpeciesSet());
+  species.addSpecies("u");
+  int imass=species.addAttribute("mass");
+  species(imass,0)=1.0;
+  vector<int> ng(1,1);
+  W.create(ng);
+  W.resetGroups();
+  //open boundary conditions: every move is valid
+  W.setBoundBox(false);
+  TrialWaveFunction psi(OHMMS::Controller);
+  OneBodyJastrowOrbital<gaussian_functor>* j1=new OneBodyJastrowOrbital<gaussian_functor>(ions,W);
+  j1->addFunc(0,new gaussian_functor(a));
+  psi.addOrbital(j1,"J1");
+  QMCHamiltonian H;
+  H.addOperator(new BareKineticEnergy<double>(W),"Kinetic");
+  H.addOperator(new harmonic_potential,"Harmonic");
+  H.addObservables(W);
+  RandomGenerator_t RNG;
+  RNG.init(0,1,17);
+  Random.init(0,1,11);
+  W.createWalkers(nbeads+1);
+  W.resetWalkerProperty(1);
+  for(int iw=0; iw<W.getActiveWalkers(); ++iw)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      W[iw]->R[0][d]=Random()-0.5;
+  EstimatorManager Est(OHMMS::Controller);
+  SimpleFixedNodeBranch Branch(tau,nbeads+1);
+  Branch.setEstimatorManager(&Est);
+  Branch.put(NULL);
+  RMCUpdatePbyPWithDrift mover(W,psi,H,RNG);
+  xmlNodePtr cur=xmlNewNode(NULL,(const xmlChar*)"qmc");
+  xmlNodePtr p=xmlNewTextChild(cur,NULL,(const xmlChar*)"parameter",(const xmlChar*)"100.0");
+  xmlNewProp(p,(const xmlChar*)"name",(const xmlChar*)"maxDisplSq");
+  mover.put(cur);
+  xmlFreeNode(cur);
+  mover.resetRun(&Branch,&Est);
+  mover.nSubSteps=1;
+  mover.initReptile(W.begin(),W.end());
+  const Reptile& reptile(mover.getReptile());
+  double err_init=max_eloc_error(reptile,a);
+  //renew the reptile
+  for(int step=0; step<nsteps/10; ++step)
+    mover.advanceWalkers(W.begin(),W.end(),false);
+  block_average v_center(nsteps/nblocks), v_head(nsteps/nblocks);
+  vector<walker_t*> center;
+  for(int step=0; step<nsteps; ++step)
+  {
+    mover.advanceWalkers(W.begin(),W.end(),true);
+    reptile.getCenter(ncenter,center);
+    double v=0.0;
+    for(int i=0; i<ncenter; ++i)
+      v+=0.5*dot(center[i]->R[0],center[i]->R[0]);
+    v_center.add(v/ncenter);
+    const walker_t& head(reptile.getHead());
+    v_head.add(0.5*dot(head.R[0],head.R[0]));
+  }
+  double err_end=max_eloc_error(reptile,a);
+  const double err_pure=std::abs(v_center.mean()-v_pure);
+  const double err_mixed=std::abs(v_head.mean()-v_mixed);
+  bool passed=(err_init<eps && err_end<eps && mover.nAcceptHead && mover.nBounce
+               && err_pure<4.0*v_center.error()+bias && err_mixed<4.0*v_head.error()+bias);
+  cout << "exponent = " << a << " beads = " << nbeads << " steps = " << nsteps << " timestep = " << tau << endl;
+  cout << "  reptile moves accepted = " << mover.nAcceptHead << " bounced = " << mover.nBounce << endl;
+  cout << "  max error of the local energies of the beads = " << err_init << " (initReptile) "
+       << err_end << " (end)" << endl;
+  cout << "  potential energy at the center = " << setw(10) << v_center.mean() << " +/- " << v_center.error()
+       << " exact " << v_pure << endl;
+  cout << "  potential energy at the head   = " << setw(10) << v_head.mean() << " +/- " << v_head.error()
+       << " mixed " << v_mixed << endl;
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
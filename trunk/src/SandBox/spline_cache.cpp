@@ -0,0 +1,209 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file spline_cache.cpp
+ * @brief Check the hits, misses and invalidation of the cached spline tables
+ *
+ * The single-precision orbitals of a minimal ES-HDF file are created with
+ * --spline_cache four times:
+ * - without a cached table, which is written (miss);
+ * - with the table of the same file, which is read (hit);
+ * - after the file is regenerated with other orbitals (miss);
+ * - after the file is regenerated again and its modification time is set
+ *   back, so that only the eigenvalues of the orbitals differ (miss).
+ * A table which is read is not written again, whose modification time,
+ * set back after every creation, tells the hits from the misses. The orbitals
+ * are compared with those of a copy of the file without a cached table.
+ * Returns 1 if a hit or a miss is wrong or any difference exceeds eps.
+ *
+ * Usage: spline_cache [-n bands]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Message/Communicate.h"
+#include "Message/CommOperators.h"
+#include "SandBox/eshdf_writer.h"
+#include "spline/einspline_util.hpp"
+#include "qmc_common.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstdio>
+#include <utime.h>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef TinyVector<double,3> pos_t;
+
+///modification time of the tables, which a hit does not change
+const time_t stale_time=1000000000;
+
+/** set the modification time of the file */
+void set_mtime(const string& fname, time_t t)
+{
+  struct utimbuf ut;
+  ut.actime=t;
+  ut.modtime=t;
+  utime(fname.c_str(),&ut);
+}
+
+/** return the modification time of the file or 0 if it does not exist */
+time_t get_mtime(const string& fname)
+{
+  struct stat fs;
+  return stat(fname.c_str(),&fs)? 0:fs.st_mtime;
+}
+
+/** return the size of the file */
+long get_size(const string& fname)
+{
+  struct stat fs;
+  return stat(fname.c_str(),&fs)? 0:static_cast<long>(fs.st_size);
+}
+
+/** return the largest difference of vgl from ref */
+double max_diff(const vector<double>& vgl, const vector<double>& ref)
+{
+  double err=(vgl.size()==ref.size() && ref.size())? 0.0:1.0;
+  for(int i=0; i<vgl.size() && i<ref.size(); ++i)
+    err=std::max(err,std::abs(vgl[i]-ref[i])/std::max(1.0,std::abs(ref[i])));
+  return err;
+}
+
+/** create the orbitals of the file, return true if the cached table is read
+ * @param fname ES-HDF file
+ * @param cachefile file of the cached table
+ * @param seed seed of the orbitals of the file, no new file if negative
+ * @param vgl values, gradients and laplacians of the orbitals
+ * @param err largest difference from the orbitals of a copy of the file
+ */
+bool create_orbitals(Communicate* comm, const string& fname, const string& cachefile, int seed
+                     , int nb, ParticleSet& P, vector<double>& vgl, double& err)
+{
+  const string fname_ref("spline_cache_ref.h5");
+  vector<pos_t> k(1,pos_t(0.0,0.0,0.0));
+  if(comm->rank()==0)
+  {
+    Random.init(0,1,seed);
+    write_eshdf(fname_ref,P.Lattice.R,k,nb);
+  }
+  comm->barrier();
+  xmlNodePtr cur=eshdf_sposet_node(fname_ref,nb-1,1,"single");
+  vector<double> ref;
+  qmc_common.spline_cache=false;
+  read_bands(comm,cur,P,ref);
+  xmlFreeNode(cur);
+  cur=eshdf_sposet_node(fname,nb-1,1,"single");
+  qmc_common.spline_cache=true;
+  read_bands(comm,cur,P,vgl);
+  xmlFreeNode(cur);
+  err=max_diff(vgl,ref);
+  comm->barrier();
+  bool hit=(get_mtime(cachefile)==stale_time);
+  comm->barrier();
+  if(comm->rank()==0)
+  {
+    set_mtime(cachefile,stale_time);
+    remove(fname_ref.c_str());
+  }
+  comm->barrier();
+  return hit;
+}
+
+/** write the ES-HDF file of the orbitals of the seed */
+void write_file(Communicate* comm, const string& fname, int seed, int nb, ParticleSet& P)
+{
+  vector<pos_t> k(1,pos_t(0.0,0.0,0.0));
+  if(comm->rank()==0)
+  {
+    Random.init(0,1,seed);
+    write_eshdf(fname,P.Lattice.R,k,nb);
+  }
+  comm->barrier();
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  Communicate* comm=OHMMS::Controller;
+  OhmmsInfo Welcome("spline_cache",comm->rank());
+  int nb=5;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-n")
+      nb=atoi(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-12;
+  const string fname("spline_cache.h5");
+  Tensor<int,3> tmat(1,0,0,0,1,0,0,0,1);
+  const string cachefile=make_spline_filename(fname,tmat,0,0,TinyVector<int,3>(8,8,8));
+  Tensor<double,3> lattice(4.0,0.0,0.0, 1.1,3.6,0.0, -0.7,0.9,3.8);
+  const int nel=2*nb-2;
+  vector<int> ns(2,nel/2);
+  ParticleSet P;
+  P.Lattice.BoxBConds=1;
+  P.Lattice.set(lattice);
+  P.create(ns);
+  Random.init(0,1,13);
+  for(int iat=0; iat<nel; ++iat)
+    P.R[iat]=dot(pos_t(3.0*Random()-1.0,3.0*Random()-1.0,3.0*Random()-1.0),lattice);
+  if(comm->rank()==0)
+    remove(cachefile.c_str());
+  vector<double> vgl[4];
+  double err[4];
+  bool hit[4];
+  write_file(comm,fname,11,nb,P);
+  hit[0]=create_orbitals(comm,fname,cachefile,11,nb,P,vgl[0],err[0]);
+  hit[1]=create_orbitals(comm,fname,cachefile,11,nb,P,vgl[1],err[1]);
+  write_file(comm,fname,17,nb,P);
+  const time_t mtime=get_mtime(fname);
+  const long fsize=get_size(fname);
+  hit[2]=create_orbitals(comm,fname,cachefile,17,nb,P,vgl[2],err[2]);
+  write_file(comm,fname,19,nb,P);
+  if(comm->rank()==0)
+    set_mtime(fname,mtime);
+  comm->barrier();
+  const bool same_stamp=(get_mtime(fname)==mtime && get_size(fname)==fsize);
+  hit[3]=create_orbitals(comm,fname,cachefile,19,nb,P,vgl[3],err[3]);
+  const bool changed=(max_diff(vgl[2],vgl[0])>eps && max_diff(vgl[3],vgl[2])>eps);
+  bool passed=(!hit[0] && hit[1] && !hit[2] && !hit[3] && same_stamp && changed);
+  for(int i=0; i<4; ++i)
+    passed = passed && err[i]<eps;
+  if(comm->rank()==0)
+  {
+    const char* names[]= {"no table      ","same file     ","new orbitals  ","new eigenvalues"};
+    const bool expected[]= {false,true,false,false};
+    cout << "tasks = " << comm->size() << " bands = " << nb << endl;
+    for(int i=0; i<4; ++i)
+      cout << "  " << names[i] << (hit[i]? " hit ":" miss")
+           << (hit[i]==expected[i]? "    ":" (wrong)")
+           << " max difference = " << setw(12) << err[i] << endl;
+    if(!same_stamp)
+      cout << "  the size or the time of the regenerated file differs" << endl;
+    cout << (passed? "  PASSED":"  FAILED") << endl;
+    remove(fname.c_str());
+    remove(cachefile.c_str());
+  }
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
@@ -0,0 +1,175 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file sr_coulomb_spline.cpp
+ * @brief Check SRCoulombSpline against the OneDimCubicSpline of the short-range Coulomb term
+ *
+ * The short-range term of the Coulomb handler of a periodic cell is splined
+ * by LRCoulombSingleton::createSpline4RbyVs and SRCoulombSpline is initialized
+ * from it as CoulombPBCAA and CoulombPBCAB do. Over [0,Rcut]:
+ * - r evaluateV has to be splint of the OneDimCubicSpline on a fine mesh,
+ *   at the grid points and in the last interval;
+ * - evaluateV has to be zero at r=0 and for r>=Rcut;
+ * - sumV of rows of random distances and charges, which include r=0, Rcut
+ *   and beyond, has to be the sum of the charges times splint(r)/r.
+ * Returns 1 if any difference exceeds eps.
+ *
+ * Usage: sr_coulomb_spline [-m rows] [-l row-length]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Utilities/RandomGenerator.h"
+#include "Message/Communicate.h"
+#include "Particle/ParticleSet.h"
+#include "LongRange/LRCoulombSingleton.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef LRCoulombSingleton::RealType RealType;
+typedef LRCoulombSingleton::RadFunctorType RadFunctorType;
+typedef LRCoulombSingleton::SRSplineType SRSplineType;
+
+/** return V_s of the OneDimCubicSpline, zero for r=0 and r>=Rcut as the pair sums */
+inline RealType reference_V(RadFunctorType& rVs, RealType rcut, RealType r)
+{
+  return (r>0.0 && r<rcut)? rVs.splint(r)/r:0.0;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("sr_coulomb_spline",OHMMS::Controller->rank());
+  int nrows=50;
+  int ncols=37;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-m")
+      nrows=atoi(argv[++ic]);
+    else
+      if(c=="-l")
+        ncols=atoi(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-10;
+  Random.init(0,1,11);
+  ParticleSet P;
+  P.setName("e");
+  P.Lattice.BoxBConds=1;
+  P.Lattice.LR_dim_cutoff=15.0;
+  P.Lattice.R.diagonal(4.0);
+  P.Lattice.reset();
+  vector<int> ng(1,8);
+  P.create(ng);
+  SpeciesSet& tspecies(P.getSpeciesSet());
+  int icharge=tspecies.addAttribute("charge");
+  tspecies(icharge,tspecies.addSpecies("u"))=-1.0;
+  for(int iat=0; iat<P.getTotalNum(); ++iat)
+    for(int d=0; d<OHMMS_DIM; ++d)
+      P.R[iat][d]=4.0*Random();
+  P.createSK();
+  LRCoulombSingleton::LRHandlerType* AA=LRCoulombSingleton::getHandler(P);
+  RadFunctorType* rVs=LRCoulombSingleton::createSpline4RbyVs(AA,AA->get_rc(),0);
+  SRSplineType sr;
+  sr.init(*rVs);
+  //the end of the grid, which can differ from get_rc() by the rounding of the grid
+  const RealType rcut=sr.Rcut;
+  const RealType delta=1.0/sr.DeltaInv;
+  //values over [0,Rcut]: a fine mesh, the grid points and the last interval
+  vector<RealType> r;
+  for(int i=0; i<=20*sr.NumIntervals; ++i)
+    r.push_back(0.05*i*delta);
+  for(int i=0; i<=sr.NumIntervals; ++i)
+    r.push_back(i*delta);
+  for(int i=0; i<100; ++i)
+    r.push_back(rcut-delta*Random());
+  r.push_back(std::min(rcut-1e-12,rcut*(1.0-1e-15)));
+  const int nmesh=r.size();
+  //r=0, Rcut and beyond have to be zero
+  r.push_back(0.0);
+  r.push_back(rcut);
+  r.push_back(rcut+1e-12);
+  r.push_back(2.0*rcut);
+  vector<RealType> v(r.size());
+  sr.evaluateV(r.size(),&r[0],&v[0]);
+  double err_value=0.0, err_split=0.0, err_outside=0.0, err_sum=0.0;
+  for(int i=0; i<nmesh; ++i)
+  {
+    const RealType ref=rVs->splint(r[i]);
+    if(r[i]>0.0)
+      err_value=std::max(err_value,std::abs(r[i]*v[i]-ref));
+    else
+      err_outside=std::max(err_outside,std::abs(v[i]));
+    err_split=std::max(err_split,std::abs(sr.splint(r[i])-ref));
+  }
+  for(int i=nmesh; i<r.size(); ++i)
+  {
+    err_outside=std::max(err_outside,std::abs(v[i]));
+    err_split=std::max(err_split,std::abs(sr.splint(r[i])-(r[i]>0.0? 0.0:rVs->splint(r[i]))));
+  }
+  //rows of distances as the pair rows of the distance tables
+  vector<RealType> rrow(ncols), q(ncols);
+  for(int row=0; row<nrows; ++row)
+  {
+    for(int j=0; j<ncols; ++j)
+    {
+      q[j]=2.0*Random()-1.0;
+      switch(j%8)
+      {
+      case 0:
+        rrow[j]=0.0;
+        break;
+      case 1:
+        rrow[j]=rcut;
+        break;
+      case 2:
+        rrow[j]=rcut*(1.0+Random());
+        break;
+      case 3:
+        rrow[j]=rcut-delta*Random();
+        break;
+      default:
+        rrow[j]=rcut*(0.01+0.99*Random());
+      }
+    }
+    RealType s_ref=0.0, s_abs=0.0;
+    for(int j=0; j<ncols; ++j)
+    {
+      s_ref+=q[j]*reference_V(*rVs,rcut,rrow[j]);
+      s_abs+=std::abs(q[j]*reference_V(*rVs,rcut,rrow[j]));
+    }
+    RealType s=sr.sumV(ncols,&rrow[0],&q[0]);
+    err_sum=std::max(err_sum,std::abs(s-s_ref)/std::max(1.0,static_cast<double>(s_abs)));
+  }
+  bool passed=(err_value<eps && err_split<eps && err_outside==0.0 && err_sum<eps);
+  cout << "rcut = " << rcut << " intervals = " << sr.NumIntervals << " spacing = " << delta << endl;
+  cout << "  max difference of r evaluateV    = " << setw(12) << err_value << endl;
+  cout << "  max difference of splint         = " << setw(12) << err_split << endl;
+  cout << "  max value at r=0 and r>=Rcut     = " << setw(12) << err_outside << endl;
+  cout << "  max difference of sumV           = " << setw(12) << err_sum << endl;
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  delete rVs;
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
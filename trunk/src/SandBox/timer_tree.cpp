@@ -0,0 +1,170 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file timer_tree.cpp
+ * @brief Check the inclusive and exclusive time of nested NewTimer
+ *
+ * A tree of timers, root with the children a and b and a with the child
+ * leaf, spins for the given time in each:
+ * - the parents have to be those of the tree;
+ * - the inclusive time has to cover the time spent in the timer and its
+ *   children, and the exclusive time has to be the inclusive time less
+ *   that of the children;
+ * - a timer stopped while another is running has to leave the running one.
+ * The ranks register the timers in different orders and each adds a timer
+ * of its own. The profile written by TimerManager has to have the calls of
+ * all the ranks and every timer of the ranks.
+ * Returns 1 if a time, a parent or the profile is wrong.
+ *
+ * Usage: timer_tree [-r repeats] [-t seconds]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Utilities/NewTimer.h"
+#include "Message/Communicate.h"
+#include "Message/CommOperators.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <fstream>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+///spin for dt seconds
+inline void spin(double dt)
+{
+  double t0=cpu_clock();
+  while(cpu_clock()-t0<dt) {}
+}
+
+/** return true if the profile has the line of a timer */
+bool has_timer(const string& json, const string& name, const string& parent, long calls)
+{
+  ostringstream line;
+  line << "{\"name\": \"" << name << "\", \"parent\": \"" << parent << "\", \"calls\": " << calls << ",";
+  return json.find(line.str())!=string::npos;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("timer_tree",OHMMS::Controller->rank());
+  int nrepeats=3;
+  double dt=0.005;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-r")
+      nrepeats=atoi(argv[++ic]);
+    else
+      if(c=="-t")
+        dt=atof(argv[++ic]);
+    ++ic;
+  }
+  Communicate* comm=OHMMS::Controller;
+  const int rank=comm->rank();
+  //the ranks register the timers in different orders
+  NewTimer root("tree_root"), a("tree_a"), leaf("tree_a_leaf"), b("tree_b");
+  ostringstream own;
+  own << "tree_rank_" << rank;
+  NewTimer mine(own.str());
+  NewTimer* timers[]= {&root,&a,&leaf,&b,&mine};
+  for(int i=0; i<5; ++i)
+    TimerManager.addTimer(timers[(rank%2)? 4-i:i]);
+  //the time of root, a, leaf and b spent in themselves
+  const double t_root=2*dt, t_a=dt, t_leaf=3*dt, t_b=2*dt;
+  for(int i=0; i<nrepeats; ++i)
+  {
+    root.start();
+    spin(t_root);
+    a.start();
+    spin(t_a);
+    leaf.start();
+    spin(t_leaf);
+    leaf.stop();
+    a.stop();
+    b.start();
+    spin(t_b);
+    b.stop();
+    root.stop();
+  }
+  mine.start();
+  mine.stop();
+  //the time in a timer is at least its spin and the exclusive time is
+  //the inclusive time less that of the children
+  const double roundoff=1e-12;
+  bool tree_ok=(root.get_parent()==0 && a.get_parent()==&root && leaf.get_parent()==&a
+                && b.get_parent()==&root && root.get_num_calls()==nrepeats && current_timer==0);
+  bool incl_ok=(root.get_total()>=nrepeats*(t_root+t_a+t_leaf+t_b)
+                && a.get_total()>=nrepeats*(t_a+t_leaf)
+                && leaf.get_total()>=nrepeats*t_leaf
+                && b.get_total()>=nrepeats*t_b);
+  bool excl_ok=(root.get_exclusive()>=nrepeats*t_root && a.get_exclusive()>=nrepeats*t_a
+                && std::abs(root.get_exclusive()-(root.get_total()-a.get_total()-b.get_total()))<roundoff
+                && std::abs(a.get_exclusive()-(a.get_total()-leaf.get_total()))<roundoff
+                && std::abs(leaf.get_exclusive()-leaf.get_total())<roundoff
+                && std::abs(b.get_exclusive()-b.get_total())<roundoff);
+  //a stray stop leaves the running timer
+  NewTimer x("tree_x"), stray("tree_stray");
+  stray.start();
+  stray.stop();
+  x.start();
+  stray.stop();
+  bool stray_ok=(current_timer==&x);
+  x.stop();
+  stray_ok = stray_ok && current_timer==0 && stray.get_num_calls()==2;
+  //the profile of all the ranks
+  TimerManager.write(comm,"timer_tree","check");
+  int profile_ok=1;
+  if(rank==0)
+  {
+    ifstream fin("timer_tree.timers.json");
+    string json((istreambuf_iterator<char>(fin)),istreambuf_iterator<char>());
+    const int nranks=comm->size();
+    profile_ok=(has_timer(json,"tree_root","",nrepeats*nranks)
+                && has_timer(json,"tree_a","tree_root",nrepeats*nranks)
+                && has_timer(json,"tree_a_leaf","tree_a",nrepeats*nranks)
+                && has_timer(json,"tree_b","tree_root",nrepeats*nranks));
+    for(int r=0; r<nranks; ++r)
+    {
+      ostringstream name;
+      name << "tree_rank_" << r;
+      profile_ok = profile_ok && has_timer(json,name.str(),"",1);
+    }
+  }
+  comm->bcast(profile_ok);
+  bool passed=(tree_ok && incl_ok && excl_ok && stray_ok && profile_ok);
+  if(rank==0)
+  {
+    cout << "ranks = " << comm->size() << " repeats = " << nrepeats << " time = " << dt << endl;
+    cout << "                  inclusive     exclusive" << endl;
+    for(int i=0; i<4; ++i)
+      cout << "  " << setw(12) << timers[i]->get_name() << setw(14) << timers[i]->get_total()
+           << setw(14) << timers[i]->get_exclusive() << endl;
+    cout << "  tree " << (tree_ok? "ok":"wrong") << ", inclusive " << (incl_ok? "ok":"wrong")
+         << ", exclusive " << (excl_ok? "ok":"wrong") << ", stray stop " << (stray_ok? "ok":"wrong")
+         << ", profile " << (profile_ok? "ok":"wrong") << endl;
+    cout << (passed? "  PASSED":"  FAILED") << endl;
+  }
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
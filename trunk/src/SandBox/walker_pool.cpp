@@ -0,0 +1,298 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file walker_pool.cpp
+ * @brief Check the walkers recycled by WalkerControlBase
+ *
+ * Walkers with other data, resources and derivative buffers are put in the
+ * pool of a walker controller and are taken by newWalker:
+ * - a copy has to be the same as a new copy of the reference walker;
+ * - a walker without the copy, which unpacks a message, has to be the same
+ *   as a new walker which unpacks the message;
+ * - a pooled walker of another layout has to be recopied.
+ * The walkers of the first two have to keep their DataSet storage. A branch
+ * by sortWalkers and copyWalkers has to create the copies of the walkers in
+ * the storage of the killed walkers, and trimWalkerPool has to bound the pool.
+ * Returns 1 if a walker or the pool is wrong.
+ *
+ * Usage: walker_pool [-w walkers] [-n particles]
+ */
+#include "Utilities/OhmmsInfo.h"
+#include "Utilities/RandomGenerator.h"
+#include "Message/Communicate.h"
+#include "Particle/MCWalkerConfiguration.h"
+#include "QMCDrivers/WalkerControlBase.h"
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include <set>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef MCWalkerConfiguration::Walker_t walker_t;
+typedef walker_t::RealType real_t;
+
+/** message of bytes with the interface of OOMPI_Packed used by Walker */
+struct byte_message
+{
+  vector<char> Data;
+  size_t Pos;
+  byte_message(): Pos(0) {}
+  template<typename T>
+  void Pack(const T* p, int n)
+  {
+    const char* c=reinterpret_cast<const char*>(p);
+    Data.insert(Data.end(),c,c+n*sizeof(T));
+  }
+  template<typename T>
+  void Unpack(T* p, int n)
+  {
+    memcpy(p,&Data[Pos],n*sizeof(T));
+    Pos+=n*sizeof(T);
+  }
+  template<typename T>
+  byte_message& operator<<(const T& x)
+  {
+    Pack(&x,1);
+    return *this;
+  }
+  template<typename T>
+  byte_message& operator>>(T& x)
+  {
+    Unpack(&x,1);
+    return *this;
+  }
+};
+
+/** resource of a walker */
+struct vector_resource: public WalkerResource
+{
+  vector<double> V;
+  WalkerResource* makeClone() const
+  {
+    return new vector_resource(*this);
+  }
+  void copyFrom(const WalkerResource& a)
+  {
+    V=static_cast<const vector_resource&>(a).V;
+  }
+};
+
+/** return a walker of random data
+ * @param nptcl number of particles
+ * @param nbuf size of DataSet
+ * @param nhist length of the property history
+ */
+walker_t* make_walker(int nptcl, int nbuf, int nhist, long id)
+{
+  walker_t* w=new walker_t(nptcl);
+  w->ID=id;
+  w->ParentID=id+100;
+  w->Generation=static_cast<int>(10*Random());
+  w->Age=static_cast<int>(10*Random());
+  w->ReleasedNodeAge=static_cast<int>(10*Random());
+  w->ReleasedNodeWeight=Random();
+  w->Weight=Random();
+  w->Multiplicity=1.0;
+  for(int i=0; i<nptcl; ++i)
+  {
+    for(int d=0; d<OHMMS_DIM; ++d)
+    {
+      w->R[i][d]=Random();
+      w->G[i][d]=Random();
+    }
+    w->L[i]=Random();
+  }
+  for(int i=0; i<w->Properties.size(); ++i)
+    w->Properties.data()[i]=Random();
+  for(int i=0; i<nbuf; ++i)
+    w->DataSet.add(Random());
+  for(int i=0; i<nbuf/2; ++i)
+    w->DataSetForDerivatives.add(Random());
+  w->addPropertyHistory(nhist);
+  for(int i=0; i<nhist; ++i)
+    w->PropertyHistory[0][i]=Random();
+  w->PHindex[0]=static_cast<int>(nhist*Random());
+  vector_resource* r=new vector_resource;
+  r->V.resize(nbuf);
+  for(int i=0; i<nbuf; ++i)
+    r->V[i]=Random();
+  w->Resources.push_back(r);
+  return w;
+}
+
+/** return true if the walkers are the same
+ * @param with_id if false, the IDs are not compared
+ */
+bool same_walker(const walker_t& a, const walker_t& b, bool with_id=true)
+{
+  bool same=(a.Generation==b.Generation && a.Age==b.Age
+             && a.ReleasedNodeAge==b.ReleasedNodeAge && a.ReleasedNodeWeight==b.ReleasedNodeWeight
+             && a.Weight==b.Weight && a.Multiplicity==b.Multiplicity
+             && a.R.size()==b.R.size() && a.Properties.size()==b.Properties.size()
+             && a.DataSet.size()==b.DataSet.size()
+             && a.DataSetForDerivatives.size()==b.DataSetForDerivatives.size()
+             && a.PropertyHistory==b.PropertyHistory && a.PHindex==b.PHindex
+             && a.Resources.size()==b.Resources.size());
+  if(with_id)
+    same = same && a.ID==b.ID && a.ParentID==b.ParentID;
+  for(int i=0; same && i<a.R.size(); ++i)
+  {
+    same=(a.L[i]==b.L[i]);
+    for(int d=0; d<OHMMS_DIM; ++d)
+      same = same && a.R[i][d]==b.R[i][d] && a.G[i][d]==b.G[i][d];
+  }
+  for(int i=0; same && i<a.Properties.size(); ++i)
+    same=(a.Properties.data()[i]==b.Properties.data()[i]);
+  for(int i=0; same && i<a.DataSet.size(); ++i)
+    same=(a.DataSet[i]==b.DataSet[i]);
+  for(int i=0; same && i<a.DataSetForDerivatives.size(); ++i)
+    same=(a.DataSetForDerivatives[i]==b.DataSetForDerivatives[i]);
+  for(int i=0; same && i<a.Resources.size(); ++i)
+    same=(static_cast<const vector_resource*>(a.Resources.Data[i])->V
+          ==static_cast<const vector_resource*>(b.Resources.Data[i])->V);
+  return same;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  OhmmsInfo Welcome("walker_pool",OHMMS::Controller->rank());
+  int nw=8;
+  int nptcl=4;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-w")
+      nw=atoi(argv[++ic]);
+    else
+      if(c=="-n")
+        nptcl=atoi(argv[++ic]);
+    ++ic;
+  }
+  nw=std::max(nw,2);
+  const int nbuf=50*nptcl;
+  const int nhist=5;
+  Random.init(0,1,11);
+  WalkerControlBase wc(OHMMS::Controller);
+  MCWalkerConfiguration W;
+  int nbad_copy=0, nbad_message=0, nbad_layout=0, nbad_storage=0;
+  //copies and messages of the reference walkers into the pooled walkers
+  for(int iw=0; iw<nw; ++iw)
+    W.push_back(make_walker(nptcl,nbuf,nhist,iw));
+  vector<const real_t*> storage(nw);
+  for(int iw=0; iw<nw; ++iw)
+    storage[iw]=W[iw]->DataSet.data();
+  wc.recycleWalkers(W,0);
+  for(int iw=0; iw<nw; ++iw)
+  {
+    walker_t* a=make_walker(nptcl,nbuf,nhist,1000+iw);
+    walker_t* w=wc.newWalker(*a,(iw%2)==0);
+    if(iw%2)
+    {
+      walker_t* c=make_walker(nptcl,nbuf,nhist,2000+iw);
+      byte_message m;
+      c->putMessage(m);
+      byte_message m_new(m);
+      w->getMessage(m);
+      walker_t* w_new=new walker_t(*a);
+      w_new->getMessage(m_new);
+      nbad_message += !same_walker(*w,*w_new);
+      delete w_new;
+      delete c;
+    }
+    else
+    {
+      walker_t w_new(*a);
+      nbad_copy += !same_walker(*w,w_new);
+    }
+    nbad_storage += (w->DataSet.data()!=storage[nw-1-iw]);
+    delete a;
+    delete w;
+  }
+  //the pooled walkers of another DataSet or property history are recopied
+  for(int iw=0; iw<nw; ++iw)
+    W.push_back(make_walker(nptcl,(iw%2)? nbuf/2:nbuf,nhist+1-iw%2,iw));
+  wc.recycleWalkers(W,0);
+  for(int iw=0; iw<nw; ++iw)
+  {
+    walker_t* a=make_walker(nptcl,nbuf,nhist,1000+iw);
+    walker_t* c=make_walker(nptcl,nbuf,nhist,2000+iw);
+    byte_message m;
+    c->putMessage(m);
+    byte_message m_new(m);
+    walker_t* w=wc.newWalker(*a,false);
+    w->getMessage(m);
+    walker_t w_new(*a);
+    w_new.getMessage(m_new);
+    nbad_layout += !same_walker(*w,w_new);
+    delete a;
+    delete c;
+    delete w;
+  }
+  //a branch: a walker of each pair is killed and the other is copied in it
+  const int nw_pairs=2*(nw/2);
+  wc.Nmin=1;
+  wc.Nmax=2*nw;
+  set<walker_t*> killed;
+  vector<walker_t*> parents;
+  for(int iw=0; iw<nw_pairs; ++iw)
+  {
+    walker_t* w=make_walker(nptcl,nbuf,nhist,iw);
+    //walkers of the fixed node
+    w->ReleasedNodeAge=0;
+    w->Multiplicity=(iw%2)? 0.0:2.0;
+    if(iw%2)
+      killed.insert(w);
+    else
+      parents.push_back(w);
+    W.push_back(w);
+  }
+  wc.sortWalkers(W);
+  int nw_branch=wc.copyWalkers(W);
+  int nbad_branch=(nw_branch!=nw_pairs);
+  for(int iw=0; iw<nw_branch; ++iw)
+  {
+    walker_t* w=W[iw];
+    if(iw<parents.size())
+      nbad_branch += (w!=parents[iw]);
+    else
+      nbad_branch += (killed.count(w)==0 || !same_walker(*w,*parents[iw-parents.size()],false));
+  }
+  const int npool_branch=wc.FreeWalkers.size();
+  wc.trimWalkerPool(0);
+  for(int iw=0; iw<nw_branch; ++iw)
+    delete W[iw];
+  W.clear();
+  bool passed=(nbad_copy==0 && nbad_message==0 && nbad_layout==0 && nbad_storage==0
+               && nbad_branch==0 && npool_branch==0 && wc.FreeWalkers.empty());
+  cout << "walkers = " << nw << " particles = " << nptcl << endl;
+  cout << "  wrong copies                   = " << nbad_copy << endl;
+  cout << "  wrong walkers of the messages  = " << nbad_message << endl;
+  cout << "  wrong walkers of other layouts = " << nbad_layout << endl;
+  cout << "  walkers with new storage       = " << nbad_storage << endl;
+  cout << "  wrong walkers of the branch    = " << nbad_branch << endl;
+  cout << "  walkers left in the pool       = " << npool_branch << endl;
+  cout << (passed? "  PASSED":"  FAILED") << endl;
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
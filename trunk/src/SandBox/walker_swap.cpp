@@ -0,0 +1,223 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013-  by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file walker_swap.cpp
+ * @brief Check the overlapped walker exchange against the blocking one
+ *
+ * A particle in a harmonic well is propagated by SimpleFixedNodeBranch in the
+ * order of DMCOMP::run: the local walkers are advanced, the walkers in flight
+ * are completed and advanced, and the population is branched. The random
+ * numbers of a walker depend only on its ID and the step, so that the
+ * trajectories do not depend on where and when a walker is advanced. The
+ * tasks start with different numbers of walkers so that the walkers are
+ * exchanged from the first branch. The global sums of the estimators and the
+ * block weights of a run with OverlapSwap are compared with those of a run
+ * with the blocking exchange, and the walker offsets with the populations.
+ * Returns 1 if any difference exceeds eps.
+ *
+ * Usage: mpirun -np 4 walker_swap [-w walkers] [-b blocks] [-s steps]
+ */
+#include "Configuration.h"
+#include "Utilities/OhmmsInfo.h"
+#include "Message/Communicate.h"
+#include "Message/CommOperators.h"
+#include "Particle/MCWalkerConfiguration.h"
+#include "Estimators/EstimatorManager.h"
+#include "Estimators/LocalEnergyOnlyEstimator.h"
+#include "QMCDrivers/SimpleFixedNodeBranch.h"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+using namespace qmcplusplus;
+using namespace std;
+
+typedef MCWalkerConfiguration::Walker_t walker_t;
+
+/** uniform random number in [0,1) of the walker id at the step */
+inline double walker_rand(long id, int step, int k)
+{
+  unsigned long long x=static_cast<unsigned long long>(id)*0x9E3779B97F4A7C15ULL
+                       +static_cast<unsigned long long>(step+1)*0xBF58476D1CE4E5B9ULL
+                       +static_cast<unsigned long long>(k+1)*0x94D049BB133111EBULL;
+  x^=x>>30;
+  x*=0xBF58476D1CE4E5B9ULL;
+  x^=x>>27;
+  x*=0x94D049BB133111EBULL;
+  x^=x>>31;
+  return static_cast<double>(x>>11)*(1.0/9007199254740992.0);
+}
+
+/** EstimatorManager which records the global sums of every block */
+struct BlockSums: public EstimatorManager
+{
+  ///sum of the weighted energies, the estimator weights and BlockWeight per block
+  vector<double> Sums;
+
+  BlockSums(Communicate* c): EstimatorManager(c)
+  {
+    add(new LocalEnergyOnlyEstimator(),MainEstimatorName);
+  }
+
+  ///add the global sums of the current block, called before stopBlock
+  void record()
+  {
+    vector<double> s(3);
+    s[0]=Estimators[0]->scalars[0].result();
+    s[1]=Estimators[0]->scalars[0].count();
+    s[2]=BlockWeight;
+    myComm->allreduce(s);
+    Sums.insert(Sums.end(),s.begin(),s.end());
+  }
+};
+
+/** propagate the walkers [first,last) of the step */
+void advance(MCWalkerConfiguration& W, int first, int last, int step
+             , const SimpleFixedNodeBranch& branch, double tau)
+{
+  const double sqrttau=std::sqrt(tau);
+  for(int iw=first; iw<last; ++iw)
+  {
+    walker_t& w(*W[iw]);
+    for(int d=0; d<OHMMS_DIM; ++d)
+    {
+      //Box-Muller
+      double u=walker_rand(w.ID,step,2*d);
+      double v=walker_rand(w.ID,step,2*d+1);
+      w.R[0][d]+=sqrttau*std::sqrt(-2.0*std::log(1.0-u))*std::cos(2.0*M_PI*v);
+    }
+    double eold=w.Properties(LOCALENERGY);
+    double enew=0.5*dot(w.R[0],w.R[0]);
+    w.Properties(LOCALENERGY)=enew;
+    w.Properties(LOCALPOTENTIAL)=enew;
+    w.Properties(R2ACCEPTED)=tau;
+    w.Properties(R2PROPOSED)=tau;
+    w.Weight*=branch.branchWeightBare(enew,eold);
+    w.Multiplicity=w.Weight+walker_rand(w.ID,step,2*OHMMS_DIM);
+  }
+}
+
+/** run the toy DMC and return the largest error of the walker offsets
+ * @param overlap if true, use the overlapped exchange
+ * @param sums global sums of the blocks
+ */
+double run(Communicate* comm, bool overlap, int nw, int nblocks, int nsteps, vector<double>& sums)
+{
+  const double tau=0.05;
+  MCWalkerConfiguration W;
+  W.create(1);
+  W.createWalkers(nw+3*comm->rank());
+  BlockSums est(comm);
+  SimpleFixedNodeBranch branch(tau,W.getActiveWalkers());
+  branch.setEstimatorManager(&est);
+  branch.put(NULL);
+  branch.initWalkerController(W,false,false);
+  for(int iw=0; iw<W.getActiveWalkers(); ++iw)
+  {
+    walker_t& w(*W[iw]);
+    for(int d=0; d<OHMMS_DIM; ++d)
+      w.R[0][d]=walker_rand(w.ID,-1,d)-0.5;
+    w.Properties(LOCALENERGY)=0.5*dot(w.R[0],w.R[0]);
+    w.Weight=1.0;
+    w.Multiplicity=1.0;
+  }
+  est.start(nblocks,false);
+  branch.setOverlapSwap(overlap);
+  double err=0.0;
+  int step=0;
+  vector<int> nwoff(comm->size()+1);
+  for(int block=0; block<nblocks; ++block)
+  {
+    est.startBlock(nsteps);
+    for(int is=0; is<nsteps; ++is, ++step)
+    {
+      advance(W,0,W.getActiveWalkers(),step,branch,tau);
+      int nw_local=W.getActiveWalkers();
+      if(branch.completeSwap(W))
+        advance(W,nw_local,W.getActiveWalkers(),step,branch,tau);
+      branch.branch(step,W);
+      if(is+1 == nsteps)
+        branch.completeSwap(W);
+    }
+    est.record();
+    est.stopBlock(1.0);
+    //all the walkers are local at the end of a block
+    if(comm->size()==1)
+      continue;
+    vector<int> nwp(comm->size(),0);
+    nwp[comm->rank()]=W.getActiveWalkers();
+    comm->allreduce(nwp);
+    nwoff[0]=0;
+    for(int ip=0; ip<comm->size(); ++ip)
+      nwoff[ip+1]=nwoff[ip]+nwp[ip];
+    if(W.WalkerOffsets!=nwoff || W.getGlobalNumWalkers()!=nwoff[comm->size()])
+      err=1.0;
+  }
+  branch.setOverlapSwap(false);
+  est.stop();
+  sums=est.Sums;
+  return err;
+}
+
+int main(int argc, char** argv)
+{
+  OHMMS::Controller->initialize(argc,argv);
+  Communicate* comm=OHMMS::Controller;
+  OhmmsInfo Welcome("walker_swap",comm->rank());
+  int nw=16;
+  int nblocks=4;
+  int nsteps=25;
+  int ic=1;
+  while(ic<argc)
+  {
+    string c(argv[ic]);
+    if(c=="-w")
+      nw=atoi(argv[++ic]);
+    else
+      if(c=="-b")
+        nblocks=atoi(argv[++ic]);
+      else
+        if(c=="-s")
+          nsteps=atoi(argv[++ic]);
+    ++ic;
+  }
+  const double eps=1e-10;
+  vector<double> sums_simple, sums_overlap;
+  double err_simple=run(comm,false,nw,nblocks,nsteps,sums_simple);
+  double err_overlap=run(comm,true,nw,nblocks,nsteps,sums_overlap);
+  double err=0.0;
+  for(int i=0; i<sums_simple.size(); ++i)
+    err=std::max(err,std::abs(sums_overlap[i]-sums_simple[i])/std::abs(sums_simple[i]));
+  bool passed=(err<eps && err_simple==0.0 && err_overlap==0.0);
+  if(comm->rank()==0)
+  {
+    cout << "tasks = " << comm->size() << " blocks = " << nblocks << " steps = " << nsteps << endl;
+    for(int b=0; b<nblocks; ++b)
+      cout << "  block " << b
+           << " energy sum = " << setw(14) << sums_simple[3*b] << setw(14) << sums_overlap[3*b]
+           << " weight = " << setw(10) << sums_simple[3*b+2] << setw(10) << sums_overlap[3*b+2] << endl;
+    cout << "  max relative difference of the sums = " << setw(12) << err << endl;
+    cout << "  walker offsets " << ((err_simple==0.0 && err_overlap==0.0)? "match":"differ")
+         << " the populations" << endl;
+    cout << (passed? "  PASSED":"  FAILED") << endl;
+  }
+  OHMMS::Controller->finalize();
+  return passed? 0:1;
+}
+
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
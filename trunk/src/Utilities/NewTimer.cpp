@@ -16,16 +16,33 @@
 /** @file NewTimer.cpp
  * @brief Implements TimerManager
  */
+#include "Configuration.h"
 #include "Utilities/NewTimer.h"
 #include "Message/Communicate.h"
 #include "Message/CommOperators.h"
 #include <map>
 #include <limits>
 #include <cstdio>
+#include <fstream>
 namespace qmcplusplus
 {
 TimerManagerClass TimerManager;
 
+NewTimer* current_timer=0;
+
+void NewTimer::warn_unbalanced()
+{
+  if(unbalanced)
+    return;
+  unbalanced=true;
+  #pragma omp critical
+  {
+    app_warning() << "Timer " << name << " is stopped while "
+                  << (current_timer? current_timer->get_name():std::string("no timer"))
+                  << " is running. The running timer is kept." << endl;
+  }
+}
+
 void TimerManagerClass::reset()
 {
   for (int i=0; i<TimerList.size(); i++)
@@ -82,4 +99,176 @@ TimerManagerClass::print(Communicate* comm)
   }
 #endif
 }
+
+///write a as a JSON string
+static void write_json_string(std::ostream& os, const std::string& a)
+{
+  os << '"';
+  for(int i=0; i<a.size(); ++i)
+  {
+    if(a[i]=='"' || a[i]=='\\')
+      os << '\\';
+    os << a[i];
+  }
+  os << '"';
+}
+
+#if defined(HAVE_MPI)
+/** add the names and the parents of the timers of all the ranks
+ * @param names names and parents of the timers of this rank
+ */
+static void gather_names(Communicate* comm, std::map<std::string,std::string>& names)
+{
+  std::vector<char> sb;
+  std::map<std::string,std::string>::iterator it(names.begin()), it_end(names.end());
+  for(; it != it_end; ++it)
+  {
+    sb.insert(sb.end(),(*it).first.begin(),(*it).first.end());
+    sb.push_back('\0');
+    sb.insert(sb.end(),(*it).second.begin(),(*it).second.end());
+    sb.push_back('\0');
+  }
+  int nb=sb.size();
+  std::vector<int> counts(comm->size()), displ(comm->size()+1,0);
+  MPI_Allgather(&nb,1,MPI_INT,&counts[0],1,MPI_INT,comm->getMPI());
+  for(int i=0; i<counts.size(); ++i)
+    displ[i+1]=displ[i]+counts[i];
+  std::vector<char> rb(displ.back()+1);
+  sb.push_back('\0');
+  MPI_Allgatherv(&sb[0],nb,MPI_CHAR,&rb[0],&counts[0],&displ[0],MPI_CHAR,comm->getMPI());
+  for(int pos=0; pos<displ.back();)
+  {
+    std::string name(&rb[pos]);
+    pos+=name.size()+1;
+    std::string parent(&rb[pos]);
+    pos+=parent.size()+1;
+    std::string& p(names[name]);
+    if(p.empty())
+      p=parent;
+  }
+}
+#endif
+
+void TimerManagerClass::write(Communicate* comm, const std::string& root, const std::string& method)
+{
+#if !defined(DISABLE_TIMER)
+  //merge the timers of the same name of this rank
+  std::map<std::string,int> localList;
+  std::vector<std::string> localParent;
+  std::vector<double> localTime, localExcl, localMin, localMax;
+  std::vector<long> localCalls;
+  std::vector<int> localCount;
+  for(int i=0; i<TimerList.size(); ++i)
+  {
+    NewTimer &timer = *TimerList[i];
+    std::map<std::string,int>::iterator it(localList.find(timer.get_name()));
+    int ind;
+    if(it == localList.end())
+    {
+      ind=localList.size();
+      localList[timer.get_name()]=ind;
+      localParent.push_back(std::string());
+      localTime.push_back(0.0);
+      localExcl.push_back(0.0);
+      localMin.push_back(numeric_limits<double>::max());
+      localMax.push_back(0.0);
+      localCalls.push_back(0);
+      localCount.push_back(0);
+    }
+    else
+      ind=(*it).second;
+    if(localParent[ind].empty() && timer.get_parent())
+      localParent[ind]=timer.get_parent()->get_name();
+    if(timer.get_num_calls()==0)
+      continue;
+    localTime[ind]+=timer.get_total();
+    localExcl[ind]+=timer.get_exclusive();
+    localCalls[ind]+=timer.get_num_calls();
+    localMin[ind]=std::min(localMin[ind],timer.get_total());
+    localMax[ind]=std::max(localMax[ind],timer.get_total());
+    localCount[ind]+=1;
+  }
+  //the names of all the ranks: the reductions run over the same sorted list
+  std::map<std::string,std::string> nameList;
+  std::map<std::string,int>::iterator lit(localList.begin()), lit_end(localList.end());
+  for(; lit != lit_end; ++lit)
+    nameList[(*lit).first]=localParent[(*lit).second];
+#if defined(HAVE_MPI)
+  gather_names(comm,nameList);
+#endif
+  int n=nameList.size();
+  std::vector<double> timeList(n,0.0), exclList(n,0.0), threadMin(n,numeric_limits<double>::max()), threadMax(n,0.0);
+  std::vector<long> callList(n,0);
+  std::vector<int> threadCount(n,0);
+  std::map<std::string,std::string>::iterator it(nameList.begin()), it_end(nameList.end());
+  for(int i=0; it != it_end; ++it, ++i)
+  {
+    lit=localList.find((*it).first);
+    if(lit == localList.end())
+      continue;
+    int ind=(*lit).second;
+    timeList[i]=localTime[ind];
+    exclList[i]=localExcl[ind];
+    threadMin[i]=localMin[ind];
+    threadMax[i]=localMax[ind];
+    callList[i]=localCalls[ind];
+    threadCount[i]=localCount[ind];
+  }
+  //per-rank inclusive time
+  std::vector<double> rankMin(timeList), rankMax(timeList);
+#if defined(HAVE_MPI)
+  if(n)
+  {
+    std::vector<double> buf(n);
+    MPI_Allreduce(&threadMin[0],&buf[0],n,MPI_DOUBLE,MPI_MIN,comm->getMPI());
+    threadMin=buf;
+    MPI_Allreduce(&threadMax[0],&buf[0],n,MPI_DOUBLE,MPI_MAX,comm->getMPI());
+    threadMax=buf;
+    MPI_Allreduce(&rankMin[0],&buf[0],n,MPI_DOUBLE,MPI_MIN,comm->getMPI());
+    rankMin=buf;
+    MPI_Allreduce(&rankMax[0],&buf[0],n,MPI_DOUBLE,MPI_MAX,comm->getMPI());
+    rankMax=buf;
+  }
+#endif
+  comm->allreduce(timeList);
+  comm->allreduce(exclList);
+  comm->allreduce(callList);
+  comm->allreduce(threadCount);
+  if(comm->rank())
+    return;
+  std::ofstream fout((root+".timers.json").c_str());
+  fout.setf(std::ios::scientific, std::ios::floatfield);
+  fout.precision(6);
+  fout << "{\n  \"section\": ";
+  write_json_string(fout,root);
+  fout << ",\n  \"method\": ";
+  write_json_string(fout,method);
+  fout << ",\n  \"ranks\": " << comm->size()
+       << ",\n  \"threads\": " << omp_get_max_threads()
+       << ",\n  \"timers\": [";
+  bool first=true;
+  it=nameList.begin();
+  for(int i=0; it != it_end; ++it, ++i)
+  {
+    if(callList[i]==0)
+      continue;
+    fout << (first?"\n":",\n") << "    {\"name\": ";
+    write_json_string(fout,(*it).first);
+    fout << ", \"parent\": ";
+    write_json_string(fout,(*it).second);
+    fout << ", \"calls\": " << callList[i]
+         << ", \"inclusive\": " << timeList[i]
+         << ", \"exclusive\": " << exclList[i]
+         << ",\n     \"thread\": {\"count\": " << threadCount[i]
+         << ", \"min\": " << threadMin[i]
+         << ", \"max\": " << threadMax[i]
+         << ", \"mean\": " << timeList[i]/static_cast<double>(threadCount[i]) << "}"
+         << ",\n     \"rank\": {\"min\": " << rankMin[i]
+         << ", \"max\": " << rankMax[i]
+         << ", \"mean\": " << timeList[i]/static_cast<double>(comm->size()) << "}}";
+    first=false;
+  }
+  fout << "\n  ]\n}\n";
+#endif
+}
 }
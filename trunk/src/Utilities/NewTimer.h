@@ -29,14 +29,39 @@ class Communicate;
 namespace qmcplusplus
 {
 
-/* Timer using omp_get_wtime  */
+class NewTimer;
+
+/** the timer running on this thread, 0 if none
+ *
+ * The timers started while a timer is running are its children.
+ */
+extern NewTimer* current_timer;
+#pragma omp threadprivate(current_timer)
+
+/* Timer using omp_get_wtime
+ *
+ * The nesting of the timers is tracked per thread: the time of a timer
+ * is inclusive of the timers started while it is running and the exclusive
+ * time excludes them. The parent is the first timer found running when
+ * this is started.
+ */
 class NewTimer
 {
 protected:
   double start_time;
   double total_time;
+  ///time of the children
+  double child_time;
   long num_calls;
   std::string name;
+  ///timer running when this is started
+  NewTimer* caller;
+  ///first non-null caller
+  NewTimer* parent;
+  ///true, if stop was called while another timer was running
+  bool unbalanced;
+  ///warn once that this is stopped while another timer is running
+  void warn_unbalanced();
 public:
 #if defined(DISABLE_TIMER)
   inline void start() {}
@@ -44,13 +69,31 @@ public:
 #else
   inline void start()
   {
+    caller=current_timer;
+    if(parent==0 && caller!=this)
+      parent=caller;
+    current_timer=this;
     start_time = cpu_clock();
   }
 
+  /** stop the timer
+   *
+   * The caller is restored only if this is the running timer. Otherwise,
+   * another timer is still running and the nesting is left to it.
+   */
   inline void stop()
   {
-    total_time += cpu_clock() - start_time;
+    double dt=cpu_clock() - start_time;
+    total_time += dt;
     num_calls++;
+    if(current_timer==this)
+    {
+      if(caller && caller!=this)
+        caller->child_time += dt;
+      current_timer=caller;
+    }
+    else
+      warn_unbalanced();
   }
 #endif
 
@@ -59,6 +102,11 @@ public:
     return total_time;
   }
 
+  inline double get_exclusive() const
+  {
+    return total_time-child_time;
+  }
+
   inline long  get_num_calls() const
   {
     return num_calls;
@@ -69,14 +117,20 @@ public:
     return name;
   }
 
+  inline const NewTimer* get_parent() const
+  {
+    return parent;
+  }
+
   inline void reset()
   {
     num_calls = 0;
     total_time=0.0;
+    child_time=0.0;
   }
 
   NewTimer(const std::string& myname) :
-    total_time(0.0), num_calls(0), name(myname)
+    total_time(0.0), child_time(0.0), num_calls(0), name(myname), caller(0), parent(0), unbalanced(false)
   { }
 
   void set_name(const std::string& myname)
@@ -109,6 +163,17 @@ public:
 
   void reset();
   void print (Communicate* comm);
+  /** write the profile of a qmc section to root.timers.json
+   * @param comm communicator of the section
+   * @param root root name of the section
+   * @param method qmc method of the section
+   *
+   * The timers of the same name are merged and the names of all the ranks are
+   * reduced in the sorted order. For each, the parent, the call counts,
+   * the inclusive and exclusive time summed over the threads and ranks and
+   * the min/max/mean of the inclusive time per thread and per rank are written.
+   */
+  void write(Communicate* comm, const std::string& root, const std::string& method);
 };
 
 extern TimerManagerClass TimerManager;
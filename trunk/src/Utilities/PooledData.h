@@ -25,6 +25,7 @@
 #include <vector>
 #include <complex>
 #include <limits>
+#include <cstring>
 
 //#define USE_POOLED_DATA_ITERATOR 1
 //typedef double RealType;
@@ -229,6 +230,39 @@ struct PooledData
   ///@}
 
 
+  ///@{Copy the bytes of data of another type, e.g. float, without a conversion to T
+  ///return the number of the elements which hold nbytes
+  static inline size_type packed_size(size_t nbytes)
+  {
+    return (nbytes+sizeof(T)-1)/sizeof(T);
+  }
+
+  ///add nbytes from first, padded to whole elements
+  inline void add_bytes(const void* first, size_t nbytes)
+  {
+    size_type now=myData.size();
+    myData.resize(now+packed_size(nbytes),T());
+    if(nbytes)
+      std::memcpy(&myData[now],first,nbytes);
+  }
+
+  ///copy nbytes from the pool to first and advance the Anchor
+  inline void get_bytes(void* first, size_t nbytes)
+  {
+    if(nbytes)
+      std::memcpy(first,&(*Anchor),nbytes);
+    Anchor += packed_size(nbytes);
+  }
+
+  ///copy nbytes from first to the pool and advance the Anchor
+  inline void put_bytes(const void* first, size_t nbytes)
+  {
+    if(nbytes)
+      std::memcpy(&(*Anchor),first,nbytes);
+    Anchor += packed_size(nbytes);
+  }
+  ///@}
+
   /** return the address of the first element **/
   inline T* data()
   {
@@ -453,6 +487,40 @@ struct PooledData
   }
 
 
+  /*@{ copy the bytes of data of another type, e.g. float, without a conversion to T */
+  ///return the number of the elements which hold nbytes
+  static inline size_type packed_size(size_t nbytes)
+  {
+    return (nbytes+sizeof(T)-1)/sizeof(T);
+  }
+
+  ///add nbytes from first, padded to whole elements
+  inline void add_bytes(const void* first, size_t nbytes)
+  {
+    size_type now=myData.size();
+    myData.resize(now+packed_size(nbytes),T());
+    if(nbytes)
+      std::memcpy(&myData[now],first,nbytes);
+    Current+=packed_size(nbytes);
+  }
+
+  ///copy nbytes from the pool to first and advance Current
+  inline void get_bytes(void* first, size_t nbytes)
+  {
+    if(nbytes)
+      std::memcpy(first,&myData[Current],nbytes);
+    Current+=packed_size(nbytes);
+  }
+
+  ///copy nbytes from first to the pool and advance Current
+  inline void put_bytes(const void* first, size_t nbytes)
+  {
+    if(nbytes)
+      std::memcpy(&myData[Current],first,nbytes);
+    Current+=packed_size(nbytes);
+  }
+  /*@}*/
+
   /** return the address of the first element **/
   inline T* data()
   {
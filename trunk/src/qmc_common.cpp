@@ -16,7 +16,10 @@ QMCState::QMCState()
   use_density=false;
   dryrun=false;
   save_wfs=false;
+  spline_cache=false;
+  shared_splines=false;
   async_swap=false;
+  overlap_swap=false;
   qmc_counter=0;
 #if defined(QMC_CUDA)
   compute_device=1;
@@ -49,15 +52,30 @@ void QMCState::initialize(int argc, char **argv)
           async_swap=(c.find("no")>=c.size());
         }
         else
-          if(c.find("help")< c.size())
+          if(c.find("overlap_swap") < c.size())
           {
-            stopit=true;
+            overlap_swap=(c.find("no")>=c.size());
           }
           else
-            if(c.find("version")<c.size())
+            if(c.find("spline_cache") < c.size())
             {
-              stopit=true;
+              spline_cache=(c.find("no")>=c.size());
             }
+            else
+              if(c.find("shared_splines") < c.size())
+              {
+                shared_splines=(c.find("no")>=c.size());
+              }
+              else
+                if(c.find("help")< c.size())
+                {
+                  stopit=true;
+                }
+                else
+                  if(c.find("version")<c.size())
+                  {
+                    stopit=true;
+                  }
     ++i;
   }
   if(stopit)
@@ -67,7 +85,7 @@ void QMCState::initialize(int argc, char **argv)
 //      << QMCPLUSPLUS_VERSION_MINOR << "." << QMCPLUSPLUS_VERSION_PATCH
 //      << " subversion " << QMCPLUSPLUS_BRANCH
 //      << " build on " << getDateAndTime("%Y%m%d_%H%M") << endl;
-    cerr << "Usage: qmcapp input [--dryrun --save_wfs[=no] --async_swap[=no] --gpu]" << endl << endl;
+    cerr << "Usage: qmcapp input [--dryrun --save_wfs[=no] --async_swap[=no] --overlap_swap[=no] --spline_cache[=no] --shared_splines[=no] --gpu]" << endl << endl;
     abort();
   }
 }
@@ -79,10 +97,16 @@ void QMCState::print_options(ostream& os)
     os << "  dryrun : qmc sections will be ignored." << endl;
   if(save_wfs)
     os << "  save_wfs=1 : save wavefunctions in hdf5. " << endl;
+  if(spline_cache)
+    os << "  spline_cache=1 : spline tables are cached and reused " << endl;
+  if(shared_splines)
+    os << "  shared_splines=1 : spline tables are shared by the tasks on a node " << endl;
   if(async_swap)
     os << "  async_swap=1 : using async isend/irecv for walker swaps " << endl;
   else
     os << "  async_swap=0 : using blocking send/recv for walker swaps " << endl;
+  if(overlap_swap)
+    os << "  overlap_swap=1 : overlapping walker swaps with the propagation " << endl;
 }
 
 QMCState qmc_common;
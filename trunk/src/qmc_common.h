@@ -31,8 +31,14 @@ struct QMCState
   bool dryrun;
   ///true, if wave functions are stored for next runs
   bool save_wfs;
+  ///true, if spline tables are cached and reused by next runs
+  bool spline_cache;
+  ///true, if spline tables are shared by the tasks on a node
+  bool shared_splines;
   ///true, if walker swap is done by async
   bool async_swap;
+  ///true, if walker swap is overlapped with the propagation
+  bool overlap_swap;
   ///int for compute_device
   int compute_device;
   ///init for <qmc/> section
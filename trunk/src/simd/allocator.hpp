@@ -0,0 +1,139 @@
+//////////////////////////////////////////////////////////////////
+// (c) Copyright 2013- by Jeongnim Kim
+//////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////
+//   Jeongnim Kim
+//   National Center for Supercomputing Applications &
+//   Materials Computation Center
+//   University of Illinois, Urbana-Champaign
+//   Urbana, IL 61801
+//   e-mail: jnkim@ncsa.uiuc.edu
+//
+// Supported by
+//   National Center for Supercomputing Applications, UIUC
+//   Materials Computation Center, UIUC
+//////////////////////////////////////////////////////////////////
+// -*- C++ -*-
+/**@file allocator.hpp
+ *
+ * aligned allocator for std::vector and helper functions to pad the arrays
+ * so that each row of a structure-of-arrays container starts at an aligned address.
+ */
+#ifndef QMCPLUSPLUS_SIMD_ALIGNED_ALLOCATOR_HPP
+#define QMCPLUSPLUS_SIMD_ALIGNED_ALLOCATOR_HPP
+
+#include <cstdlib>
+#include <cstddef>
+#include <new>
+#include <limits>
+
+#ifndef QMC_SIMD_ALIGNMENT
+#define QMC_SIMD_ALIGNMENT 64
+#endif
+
+namespace qmcplusplus
+{
+
+/** return the padded size of n elements of T for the alignment ALIGN in bytes */
+template<typename T, size_t ALIGN>
+inline size_t getAlignedSize(size_t n)
+{
+  const size_t ND=(ALIGN>sizeof(T))? ALIGN/sizeof(T):1;
+  return ((n+ND-1)/ND)*ND;
+}
+
+/** return the padded size with the default alignment */
+template<typename T>
+inline size_t getAlignedSize(size_t n)
+{
+  return getAlignedSize<T,QMC_SIMD_ALIGNMENT>(n);
+}
+
+/** allocator returning ALIGN-byte aligned memory
+ *
+ * Meets the C++98 allocator requirements to be used with std::vector.
+ */
+template<typename T, size_t ALIGN=QMC_SIMD_ALIGNMENT>
+struct aligned_allocator
+{
+  typedef T         value_type;
+  typedef T*        pointer;
+  typedef const T*  const_pointer;
+  typedef T&        reference;
+  typedef const T&  const_reference;
+  typedef size_t    size_type;
+  typedef ptrdiff_t difference_type;
+
+  template<typename U> struct rebind
+  {
+    typedef aligned_allocator<U,ALIGN> other;
+  };
+
+  aligned_allocator() {}
+  aligned_allocator(const aligned_allocator&) {}
+  template<typename U> aligned_allocator(const aligned_allocator<U,ALIGN>&) {}
+  ~aligned_allocator() {}
+
+  pointer address(reference x) const
+  {
+    return &x;
+  }
+  const_pointer address(const_reference x) const
+  {
+    return &x;
+  }
+  size_type max_size() const
+  {
+    return std::numeric_limits<size_type>::max()/sizeof(T);
+  }
+
+  pointer allocate(size_type n, const void* hint=0)
+  {
+    if(n==0)
+      return 0;
+    void* ptr=0;
+#if defined(HAVE_POSIX_MEMALIGN) || defined(__linux__) || defined(__APPLE__)
+    if(posix_memalign(&ptr,ALIGN,n*sizeof(T)))
+      ptr=0;
+#else
+    ptr=std::malloc(n*sizeof(T));
+#endif
+    if(ptr==0)
+      throw std::bad_alloc();
+    return static_cast<pointer>(ptr);
+  }
+
+  void deallocate(pointer p, size_type)
+  {
+    std::free(p);
+  }
+
+  void construct(pointer p, const T& val)
+  {
+    new(static_cast<void*>(p)) T(val);
+  }
+  void destroy(pointer p)
+  {
+    p->~T();
+  }
+};
+
+template<typename T1, typename T2, size_t ALIGN>
+inline bool operator==(const aligned_allocator<T1,ALIGN>&, const aligned_allocator<T2,ALIGN>&)
+{
+  return true;
+}
+
+template<typename T1, typename T2, size_t ALIGN>
+inline bool operator!=(const aligned_allocator<T1,ALIGN>&, const aligned_allocator<T2,ALIGN>&)
+{
+  return false;
+}
+
+}
+#endif
+/***************************************************************************
+ * $RCSfile$   $Author$
+ * $Revision$   $Date$
+ * $Id$
+ ***************************************************************************/
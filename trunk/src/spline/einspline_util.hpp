@@ -12,6 +12,16 @@
 #include <OhmmsData/FileUtility.h>
 #include <io/hdf_archive.h>
 #include <einspline/multi_bspline_copy.h>
+#include <stdint.h>
+#include <cstdio>
+#include <cstring>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace qmcplusplus
 {
@@ -43,6 +53,100 @@ namespace qmcplusplus
   }
 
 
+  /** sum the buffers of all the tasks in place
+   * @param comm communicator
+   * @param buffer data of double or complex<double>
+   * @param ntot number of elements of T
+   *
+   * Each task fills a subset of the entries and leaves the rest zero, e.g.,
+   * the coefficients of the orbitals assigned to it. The sum is exact.
+   */
+  template<typename T>
+  inline void chunked_reduce(Communicate* comm, T* buffer, size_t ntot)
+  {
+    if(comm->size()==1) return;
+#if defined(HAVE_MPI)
+    double* dbuf=reinterpret_cast<double*>(buffer);
+    ntot *= sizeof(T)/sizeof(double);
+    size_t chunk_size=(1<<30)/sizeof(double); //1 GB
+    for(size_t offset=0; offset<ntot; offset+=chunk_size)
+    {
+      int n=static_cast<int>(std::min(chunk_size,ntot-offset));
+      MPI_Allreduce(MPI_IN_PLACE,dbuf+offset,n,MPI_DOUBLE,MPI_SUM,comm->getMPI());
+    }
+#endif
+  }
+
+  template<typename ENGT>
+  inline void chunked_reduce(Communicate* comm, ENGT* buffer)
+  {
+    chunked_reduce(comm,buffer->coefs, buffer->coefs_size);
+  }
+
+  /** read a contiguous dataset by mapping the file into memory
+   * @param grp group containing the dataset
+   * @param aname name of the dataset
+   * @param first starting address
+   * @param n number of elements of T
+   * @return false, if the dataset cannot be mapped and h5d_read has to be used
+   *
+   * Only the datasets of native floating-point data without filters
+   * with the matching size are mapped.
+   */
+  template<typename T>
+  inline bool h5d_read_mmap(hid_t grp, const std::string& aname, T* first, size_t n)
+  {
+#if defined(__unix__) || defined(__APPLE__)
+    hid_t h1=H5Dopen(grp,aname.c_str());
+    if(h1<0)
+      return false;
+    const size_t nbytes=n*sizeof(T);
+    hid_t dcpl=H5Dget_create_plist(h1);
+    bool mappable=(H5Pget_layout(dcpl)==H5D_CONTIGUOUS) && (H5Pget_nfilters(dcpl)==0);
+    H5Pclose(dcpl);
+    hid_t dtype=H5Dget_type(h1);
+    mappable &= (H5Tget_class(dtype)==H5T_FLOAT) && (H5Tget_order(dtype)==H5Tget_order(H5T_NATIVE_DOUBLE));
+    H5Tclose(dtype);
+    mappable &= (H5Dget_storage_size(h1)==nbytes);
+    haddr_t offset=H5Dget_offset(h1);
+    mappable &= (offset!=HADDR_UNDEF);
+    char fname[1024];
+    mappable &= (H5Fget_name(h1,fname,sizeof(fname))>0);
+    H5Dclose(h1);
+    if(!mappable)
+      return false;
+    int fd=open(fname,O_RDONLY);
+    if(fd<0)
+      return false;
+    const size_t page=static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t shift=static_cast<size_t>(offset)%page;
+    void* ptr=mmap(0,nbytes+shift,PROT_READ,MAP_PRIVATE,fd,static_cast<off_t>(offset-shift));
+    close(fd);
+    if(ptr==MAP_FAILED)
+      return false;
+    madvise(ptr,nbytes+shift,MADV_SEQUENTIAL);
+    std::memcpy(first,static_cast<char*>(ptr)+shift,nbytes);
+    munmap(ptr,nbytes+shift);
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  /** return the FNV-1a hash of n bytes
+   * @param p first byte
+   * @param n number of the bytes
+   * @param h hash to continue
+   */
+  inline uint64_t hash_bytes(const void* p, size_t n, uint64_t h=14695981039346656037ULL)
+  {
+    const uint64_t prime=1099511628211ULL;
+    const unsigned char* c=static_cast<const unsigned char*>(p);
+    for(size_t i=0; i<n; ++i)
+      h=(h^c[i])*prime;
+    return h;
+  }
+
   /** specialization of h5data_proxy for einspline_engine
    */
   template<typename ENGT>
@@ -67,7 +171,11 @@ namespace qmcplusplus
     inline bool read(hid_t grp, const std::string& aname, hid_t xfer_plist=H5P_DEFAULT)
     {
       if(ref_.spliner) 
+      {
+        if(xfer_plist==H5P_DEFAULT && h5d_read_mmap(grp,aname,ref_.spliner->coefs,ref_.spliner->coefs_size))
+          return true;
         return h5d_read(grp,aname,get_address(ref_.spliner->coefs),xfer_plist);
+      }
       else
         return false;
     }